@@ -43,12 +43,16 @@ impl From<std::ops::RangeInclusive<u32>> for wasmedge::WasmEdge_Limit {
                 Min: start,
                 Max: end,
                 HasMax: false,
+                Shared: false,
+                Is64: false,
             }
         } else {
             Self {
                 Min: start,
                 Max: end,
                 HasMax: true,
+                Shared: false,
+                Is64: false,
             }
         }
     }
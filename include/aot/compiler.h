@@ -18,8 +18,11 @@
 #include "common/errcode.h"
 #include "common/filesystem.h"
 #include "common/span.h"
+#include "common/workerpool.h"
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace WasmEdge {
 namespace AOT {
@@ -27,14 +30,54 @@ namespace AOT {
 /// Compiling Module into loadable executable binary.
 class Compiler {
 public:
-  Compiler(const Configure &Conf) noexcept : Context(nullptr), Conf(Conf) {}
+  Compiler(const Configure &Conf) noexcept;
+  ~Compiler() noexcept;
 
   Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
                        std::filesystem::path OutputPath);
 
+  /// Compile the module in process with the ORC JIT, without writing any
+  /// file. The symbols of the compiled functions are set into the module, and
+  /// keep the JIT code alive. The intrinsics table is set by the caller as the
+  /// loaded compiled modules.
+  Expect<void> compileJIT(AST::Module &Module);
+
+  /// The code compiled in process, which is kept alive by the symbols.
+  struct JITCode {
+    /// Wrappers of the function types indexed by the type section, which are
+    /// empty if not the types of the compiled functions.
+    std::vector<Symbol<AST::FunctionType::Wrapper>> Types;
+    /// Compiled functions indexed by the code section, which are empty if not
+    /// compiled.
+    std::vector<Symbol<void>> Codes;
+    /// Intrinsics table to be set by the caller.
+    Symbol<const AST::Module::IntrinsicsTable *> Intrinsics;
+  };
+
+  /// Compile the functions at the indices of the code section in process,
+  /// without changing the module. The calls to the other functions of the
+  /// module go through the executor, so the compiled functions can run mixed
+  /// with the interpreted ones. Only the requested functions and the stubs
+  /// called by them are generated, and added into the JIT shared by the
+  /// compilations of the module, so the cost is bound by the compiled code.
+  Expect<JITCode> compileJIT(const AST::Module &Module,
+                             Span<const uint32_t> CodeIdxs);
+
+  /// Get the path of the compiled library of the WASM binary in the AOT cache,
+  /// which is keyed by the binary, the configuration, and the host CPU.
+  ///
+  /// \returns the path, or empty if the cache directory is unavailable.
+  static std::filesystem::path getCachePath(Span<const Byte> Data,
+                                            const Configure &Conf);
+
   struct CompileContext;
+  struct CompileVariant;
 
 private:
+  Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
+                       const std::filesystem::path &LLPath,
+                       CompileVariant &Variant);
+  void compile(const AST::Module &Module);
   void compile(const AST::ImportSection &ImportSection);
   void compile(const AST::ExportSection &ExportSection);
   void compile(const AST::TypeSection &TypeSection);
@@ -49,6 +92,10 @@ private:
   std::mutex Mutex;
   CompileContext *Context;
   const Configure Conf;
+  /// Threads to optimize and emit the partitions in parallel, which are
+  /// created at the first parallel compilation and reused by the variants and
+  /// the later compilations.
+  std::unique_ptr<WorkerPool> Pool;
 };
 
 } // namespace AOT
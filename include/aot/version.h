@@ -18,7 +18,11 @@
 namespace WasmEdge {
 namespace AOT {
 
-static inline constexpr const uint32_t kBinaryVersion [[maybe_unused]] = 1;
+static inline constexpr const uint32_t kBinaryVersion [[maybe_unused]] = 5;
+
+/// The CPU level of the code in the universal WASM binary which is not
+/// selected by the running CPU, such as the code for the host CPU.
+static inline constexpr const uint8_t kAnyCPULevel [[maybe_unused]] = 0xFF;
 
 } // namespace AOT
 } // namespace WasmEdge
@@ -67,6 +67,11 @@ typedef struct WasmEdge_Limit {
   uint32_t Min;
   /// Maximum value. Will be ignored if the `HasMax` is false.
   uint32_t Max;
+  /// Boolean to describe the memory is shared or not. Only for memory types.
+  bool Shared;
+  /// Boolean to describe the memory is indexed by 64-bit addresses or not.
+  /// Only for memory types.
+  bool Is64;
 } WasmEdge_Limit;
 
 /// Opaque struct of WasmEdge configure.
@@ -75,6 +80,9 @@ typedef struct WasmEdge_ConfigureContext WasmEdge_ConfigureContext;
 /// Opaque struct of WasmEdge statistics.
 typedef struct WasmEdge_StatisticsContext WasmEdge_StatisticsContext;
 
+/// Opaque struct of WasmEdge memory budget.
+typedef struct WasmEdge_MemoryBudgetContext WasmEdge_MemoryBudgetContext;
+
 /// Opaque struct of WasmEdge AST module.
 typedef struct WasmEdge_ASTModuleContext WasmEdge_ASTModuleContext;
 
@@ -102,6 +110,9 @@ typedef struct WasmEdge_CompilerContext WasmEdge_CompilerContext;
 /// Opaque struct of WasmEdge loader.
 typedef struct WasmEdge_LoaderContext WasmEdge_LoaderContext;
 
+/// Opaque struct of WasmEdge streaming loader.
+typedef struct WasmEdge_LoaderStreamContext WasmEdge_LoaderStreamContext;
+
 /// Opaque struct of WasmEdge validator.
 typedef struct WasmEdge_ValidatorContext WasmEdge_ValidatorContext;
 
@@ -559,6 +570,261 @@ WasmEdge_ConfigureSetMaxMemoryPage(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern uint32_t
 WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the page limit of 64-bit memory instances.
+///
+/// Limit the page count (64KiB per page) in the memory instances of the
+/// memory64 proposal. The address space of their maximum page count, or of
+/// this limit if no maximum, is reserved at their creation. The default value
+/// is 1048576 (64 GiB).
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the maximum page count.
+/// \param Page the maximum page count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetMaxMemory64Page(WasmEdge_ConfigureContext *Cxt,
+                                     const uint64_t Page);
+
+/// Get the page limit of 64-bit memory instances.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the maximum page count
+/// setting.
+///
+/// \returns the page count limitation value.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureGetMaxMemory64Page(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the memory budget of memory instances.
+///
+/// The pages of the memory instances created by the VMs or executors with
+/// this configuration are charged to the memory budget. Memory instantiation
+/// and the `memory.grow` instruction fail when the budget is exhausted. The
+/// same budget can be set into several configurations to limit the total
+/// pages of them. The configuration shares the budget, so the budget context
+/// can be deleted after setting.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the memory budget.
+/// \param BudgetCxt the WasmEdge_MemoryBudgetContext, or NULL to clear.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ConfigureSetMemoryBudget(
+    WasmEdge_ConfigureContext *Cxt,
+    const WasmEdge_MemoryBudgetContext *BudgetCxt);
+
+/// Set the AOT cache option of VM.
+///
+/// When loading a plain WASM module, the VM loads its compiled library from
+/// the AOT cache in the user cache directory if exists. Otherwise, the VM
+/// interprets the module, and compiles it into the cache in background for
+/// the next loading. The cached libraries are keyed by the WASM binary, the
+/// compiler and statistics configurations, the proposals, and the host CPU.
+/// The background compilations are shared by the VMs in the process. Deleting
+/// the VM does not wait for them, and they are cancelled at the process exit.
+/// No effect if the AOT runtime is not built.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsCache the boolean value to determine to use the AOT cache or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetAOTCache(WasmEdge_ConfigureContext *Cxt,
+                              const bool IsCache);
+
+/// Get the AOT cache option of VM.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the AOT cache or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsAOTCache(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the JIT option of VM.
+///
+/// The VM compiles the plain WASM modules into the native code in process
+/// when loading them, and executes the compiled functions. The modules fall
+/// back to the interpreter if the compilation failed. No effect if the AOT
+/// runtime is not built.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsJIT the boolean value to determine to use the JIT or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetJIT(WasmEdge_ConfigureContext *Cxt, const bool IsJIT);
+
+/// Get the JIT option of VM.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the JIT or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsJIT(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the threshold of the tiered execution of VM.
+///
+/// The VM interprets the WASM functions first, and counts their calls and
+/// loop iterations. The functions are compiled into the native code in
+/// background when the count reaches the threshold, and run natively since
+/// then. They are compiled on one worker thread of the VM, batched by their
+/// modules. The threshold 0 disables the tiered execution, which is the
+/// default. No effect if the AOT runtime is not built.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the threshold.
+/// \param Count the count of the calls and the loop iterations.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetTieredThreshold(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Count);
+
+/// Get the threshold of the tiered execution of VM.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the threshold.
+///
+/// \returns the count of the calls and the loop iterations, 0 if disabled.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetTieredThreshold(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the lazy JIT option of VM.
+///
+/// The VM compiles each WASM function into the native code at its first call
+/// instead of the whole module, so the functions never called are not
+/// compiled. The compiled code is cached in memory and shared by the
+/// instances of the module. The functions are interpreted if the compilation
+/// failed, and by the calls on the other threads during the compilation. No
+/// effect if the AOT runtime is not built.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsLazyJIT the boolean value to determine to use the lazy JIT or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetLazyJIT(WasmEdge_ConfigureContext *Cxt,
+                             const bool IsLazyJIT);
+
+/// Get the lazy JIT option of VM.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the lazy JIT or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsLazyJIT(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the thread count of loader to decode the code section.
+///
+/// The function bodies are decoded concurrently by the threads when the count
+/// is larger than 1, and the validator validates them concurrently with the
+/// same count. The loaded modules and the errors are the same as the
+/// sequential decoding and validation. Default is 0 for the sequential
+/// decoding and validation.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Threads the thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureLoaderSetParallelThreads(WasmEdge_ConfigureContext *Cxt,
+                                           const uint32_t Threads);
+
+/// Get the thread count of loader to decode the code section.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ConfigureLoaderGetParallelThreads(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the lazy decoding of the function bodies.
+///
+/// The loader records the function bodies only, which are decoded and
+/// validated at the first call of the functions. Therefore the errors of the
+/// function bodies are reported at the first call instead of the loading and
+/// the validation. This is for the trusted modules. Default is false.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsLazy the boolean value to decode the function bodies lazily.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureLoaderSetLazyFunctionBody(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsLazy);
+
+/// Get the lazy decoding of the function bodies.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to decode the function bodies lazily.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureLoaderIsLazyFunctionBody(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the flat image cache of the loaded modules.
+///
+/// The VM saves the validated modules as the flat images in the cache
+/// directory of the user, and the loader loads the same module binary from
+/// its flat image instead of decoding the binary. The image is parsed and
+/// copied into the module, and is not trusted: the module is validated again.
+/// The image is about ten times larger than the binary, and only saves a part
+/// of the decoding time. The AOT compiled modules and the lazy decoding of
+/// the function bodies are not cached. Default is false.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsCache the boolean value to cache the modules as the flat images.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureLoaderSetFlatImageCache(WasmEdge_ConfigureContext *Cxt,
+                                          const bool IsCache);
+
+/// Get the flat image cache of the loaded modules.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to cache the modules as the flat images.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureLoaderIsFlatImageCache(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the checking of the function bodies while decoding them.
+///
+/// The loader checks each function body while its instructions are decoded,
+/// and the validator skips the passed function bodies. The failed function
+/// bodies are validated again by the validator to report the errors, so the
+/// results of loading and validation are the same. Default is false.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsFused the boolean value to check the function bodies while
+/// decoding.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureLoaderSetFusedValidation(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsFused);
+
+/// Get the checking of the function bodies while decoding them.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to check the function bodies while decoding.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureLoaderIsFusedValidation(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the optimization level of AOT compiler.
 ///
 /// This function is thread-safe.
@@ -666,6 +932,93 @@ WasmEdge_ConfigureCompilerSetInterruptible(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureCompilerIsInterruptible(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the thread count of AOT compiler to optimize and generate codes.
+///
+/// The module is split into the partitions by functions, which are compiled
+/// in parallel and linked into one library. 0 and 1 compile the whole module
+/// in one thread. Default is 0.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Threads the thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetParallelThreads(WasmEdge_ConfigureContext *Cxt,
+                                             const uint32_t Threads);
+
+/// Get the thread count of AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureCompilerGetParallelThreads(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the incremental cache option of AOT compiler.
+///
+/// The module is split into a fixed count of partitions by functions. The
+/// object codes of the partitions are cached in the user cache directory, and
+/// the unchanged partitions are reused when compiling another version of the
+/// module.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsCache the boolean value to determine to cache the object codes of
+/// the partitions or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetIncrementalCache(WasmEdge_ConfigureContext *Cxt,
+                                              const bool IsCache);
+
+/// Get the incremental cache option of AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to cache the object codes of the
+/// partitions or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureCompilerIsIncrementalCache(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Add a code variant of the CPU level into the universal WASM output of AOT
+/// compiler.
+///
+/// The universal WASM output holds the code variants of the added CPU levels
+/// instead of the code for the host CPU, and the loader selects the highest
+/// level supported by the running CPU. The levels above the baseline are only
+/// available on x86-64.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to add the CPU level.
+/// \param Level the CPU level.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ConfigureCompilerAddCPULevel(
+    WasmEdge_ConfigureContext *Cxt, const enum WasmEdge_CompilerCPULevel Level);
+
+/// Check if a code variant of the CPU level is added in AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to check the CPU level.
+/// \param Level the CPU level.
+///
+/// \returns true if the code variant of the CPU level is added, false if not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureCompilerHasCPULevel(
+    const WasmEdge_ConfigureContext *Cxt,
+    const enum WasmEdge_CompilerCPULevel Level);
+
+/// Remove all the code variants of the CPU levels in AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to clear the CPU levels.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerClearCPULevels(WasmEdge_ConfigureContext *Cxt);
+
 /// Set the instruction counting option.
 ///
 /// This function is thread-safe.
@@ -812,6 +1165,78 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt);
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge memory budget functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Creation of the WasmEdge_MemoryBudgetContext.
+///
+/// The caller owns the object and should call `WasmEdge_MemoryBudgetDelete` to
+/// free it.
+///
+/// This function is thread-safe.
+///
+/// \param Page the page count (64KiB per page) limit of the budget.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_MemoryBudgetContext *
+WasmEdge_MemoryBudgetCreate(const uint64_t Page);
+
+/// Set the page count limit of the memory budget.
+///
+/// Lowering the limit below the current usage only fails the further memory
+/// instantiations and growths.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_MemoryBudgetContext to set the limit.
+/// \param Page the page count limit.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_MemoryBudgetSetLimit(WasmEdge_MemoryBudgetContext *Cxt,
+                              const uint64_t Page);
+
+/// Get the page count limit of the memory budget.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_MemoryBudgetContext to get data.
+///
+/// \returns the page count limit.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_MemoryBudgetGetLimit(const WasmEdge_MemoryBudgetContext *Cxt);
+
+/// Get the page count currently charged to the memory budget.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_MemoryBudgetContext to get data.
+///
+/// \returns the charged page count.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_MemoryBudgetGetUsage(const WasmEdge_MemoryBudgetContext *Cxt);
+
+/// Get the high-water mark of the page count charged to the memory budget.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_MemoryBudgetContext to get data.
+///
+/// \returns the maximum charged page count.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_MemoryBudgetGetPeak(const WasmEdge_MemoryBudgetContext *Cxt);
+
+/// Deletion of the WasmEdge_MemoryBudgetContext.
+///
+/// The budget is still alive if it is set into configurations or charged by
+/// memory instances.
+///
+/// After calling this function, the context will be freed and should __NOT__ be
+/// used.
+///
+/// \param Cxt the WasmEdge_MemoryBudgetContext to delete.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_MemoryBudgetDelete(WasmEdge_MemoryBudgetContext *Cxt);
+
+// <<<<<<<< WasmEdge memory budget functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge AST module functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 /// Get the length of imports list of the AST module.
@@ -862,6 +1287,51 @@ WasmEdge_ASTModuleListExports(const WasmEdge_ASTModuleContext *Cxt,
                               const WasmEdge_ExportTypeContext **Exports,
                               const uint32_t Len);
 
+/// Get the length of custom sections list of the AST module.
+///
+/// \param Cxt the WasmEdge_ASTModuleContext.
+///
+/// \returns length of the custom sections list.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ASTModuleListCustomSectionsLength(
+    const WasmEdge_ASTModuleContext *Cxt);
+
+/// Get the name of the custom section of the AST module.
+///
+/// The returned string object is linked to the name of the custom section,
+/// and the caller should __NOT__ call the `WasmEdge_StringDelete`.
+///
+/// \param Cxt the WasmEdge_ASTModuleContext.
+/// \param Index the index of the custom section.
+///
+/// \returns string object. Length will be 0 and Buf will be NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_String
+WasmEdge_ASTModuleGetCustomSectionName(const WasmEdge_ASTModuleContext *Cxt,
+                                       const uint32_t Index);
+
+/// Get the content of the custom section of the AST module.
+///
+/// The contents are kept in the AST module if it is parsed from a file. If it
+/// is parsed from a buffer by `WasmEdge_LoaderParseFromBuffer`, which is
+/// borrowed, only the ranges of the contents are kept, and the same buffer
+/// should be given to get the content. The other buffers are rejected.
+///
+/// \param Cxt the WasmEdge_ASTModuleContext.
+/// \param Index the index of the custom section.
+/// \param Buf the buffer of the module binary the AST module is parsed from.
+/// Can be NULL if the content is kept in the AST module.
+/// \param BufLen the length of the buffer.
+/// \param [out] Content the pointer to the content, which is valid while the
+/// AST module, or the buffer if given, is alive.
+/// \param [out] Length the length of the content.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ASTModuleGetCustomSectionContent(
+    const WasmEdge_ASTModuleContext *Cxt, const uint32_t Index,
+    const uint8_t *Buf, const uint32_t BufLen, const uint8_t **Content,
+    uint32_t *Length);
+
 /// Deletion of the WasmEdge_ASTModuleContext.
 ///
 /// After calling this function, the context will be freed and should __NOT__ be
@@ -1320,6 +1790,15 @@ WasmEdge_LoaderCreate(const WasmEdge_ConfigureContext *ConfCxt);
 /// `WasmEdge_ASTModuleContext` object and should call
 /// `WasmEdge_ASTModuleDelete` to free it.
 ///
+/// The file is mapped, and the data segments and the memories instantiated
+/// from the module share the mapped pages. The file should not be truncated
+/// or written until the module and its instances are deleted. A shared
+/// advisory lock is held on the file until then, and the file locked
+/// exclusively by a writer is read as a copy instead. The lock is advisory
+/// only, and does not stop the writers not taking it: truncating the file
+/// then raises SIGBUS on the next access of the mapped pages. Load the
+/// module from a buffer instead if the file is not under your control.
+///
 /// \param Cxt the WasmEdge_LoaderContext.
 /// \param [out] Module the output WasmEdge_ASTModuleContext if succeeded.
 /// \param Path the NULL-terminated C string of the WASM file path.
@@ -1359,6 +1838,60 @@ WasmEdge_LoaderParseFromBuffer(WasmEdge_LoaderContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern void
 WasmEdge_LoaderDelete(WasmEdge_LoaderContext *Cxt);
 
+/// Creation of the WasmEdge_LoaderStreamContext.
+///
+/// The streaming loader decodes the sections of a WASM module as soon as
+/// their bytes are pushed, so the decoding overlaps with receiving the
+/// module. The caller owns the object and should call
+/// `WasmEdge_LoaderStreamDelete` to free it.
+///
+/// \param ConfCxt the WasmEdge_ConfigureContext as the configuration of Loader.
+/// NULL for the default configuration.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_LoaderStreamContext *
+WasmEdge_LoaderStreamCreate(const WasmEdge_ConfigureContext *ConfCxt);
+
+/// Push the next chunk of the WASM binary into the streaming loader.
+///
+/// The completed sections are decoded in this call. After a failure, the
+/// further pushing fails and `WasmEdge_LoaderStreamFinish` reports the error.
+///
+/// \param Cxt the WasmEdge_LoaderStreamContext.
+/// \param Buf the buffer of the next chunk of the WASM binary.
+/// \param BufLen the length of the buffer.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_LoaderStreamPush(WasmEdge_LoaderStreamContext *Cxt,
+                          const uint8_t *Buf, const uint32_t BufLen);
+
+/// Finish the streaming and get the WasmEdge_ASTModuleContext.
+///
+/// Decode the remaining bytes and return a `WasmEdge_ASTModuleContext` as
+/// result. The caller owns the `WasmEdge_ASTModuleContext` object and should
+/// call `WasmEdge_ASTModuleDelete` to free it. The streaming loader is reset
+/// and can be used for the next module.
+///
+/// \param Cxt the WasmEdge_LoaderStreamContext.
+/// \param [out] Module the output WasmEdge_ASTModuleContext if succeeded.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_LoaderStreamFinish(WasmEdge_LoaderStreamContext *Cxt,
+                            WasmEdge_ASTModuleContext **Module);
+
+/// Deletion of the WasmEdge_LoaderStreamContext.
+///
+/// After calling this function, the context will be freed and should __NOT__ be
+/// used.
+///
+/// \param Cxt the WasmEdge_LoaderStreamContext to delete.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_LoaderStreamDelete(WasmEdge_LoaderStreamContext *Cxt);
+
 // <<<<<<<< WasmEdge loader functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge validator functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -2595,6 +3128,9 @@ WasmEdge_MemoryInstanceGetPointerConst(
 
 /// Get the current page size (64 KiB of each page) of a memory instance.
 ///
+/// The page size of the 64-bit memory instances over `UINT32_MAX` is returned
+/// as `UINT32_MAX`.
+///
 /// \param Cxt the WasmEdge_MemoryInstanceContext.
 ///
 /// \returns the page size of the memory instance.
@@ -3183,6 +3719,9 @@ WasmEdge_VMAsyncRunWasmFromASTModule(WasmEdge_VMContext *Cxt,
 /// Load and parse the WASM module from the file path. You can then call
 /// `WasmEdge_VMValidate` for the next step.
 ///
+/// The file is mapped as in `WasmEdge_LoaderParseFromFile`, and should not be
+/// truncated or written until the module and its instances are cleaned up.
+///
 /// This function is thread-safe.
 ///
 /// \param Cxt the WasmEdge_VMContext.
@@ -3512,6 +4051,28 @@ WasmEdge_VMGetStoreContext(WasmEdge_VMContext *Cxt);
 WASMEDGE_CAPI_EXPORT extern WasmEdge_StatisticsContext *
 WasmEdge_VMGetStatisticsContext(WasmEdge_VMContext *Cxt);
 
+/// Get the page count of the memory instances instantiated by the
+/// WasmEdge_VMContext.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+///
+/// \returns the page count (64KiB per page) of the alive memory instances.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_VMGetMemoryUsage(const WasmEdge_VMContext *Cxt);
+
+/// Get the high-water mark of the page count of the memory instances
+/// instantiated by the WasmEdge_VMContext.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+///
+/// \returns the maximum page count (64KiB per page) in the VM lifetime.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_VMGetMemoryPeak(const WasmEdge_VMContext *Cxt);
+
 /// Deletion of the WasmEdge_VMContext.
 ///
 /// After calling this function, the context will be freed and should __NOT__ be
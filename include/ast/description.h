@@ -32,14 +32,27 @@ public:
   void setExternalType(ExternalType ET) noexcept { ExtType = ET; }
 
   /// Getter and setter of external name.
-  std::string_view getExternalName() const noexcept { return ExtName; }
-  void setExternalName(std::string_view Name) { ExtName = Name; }
+  std::string_view getExternalName() const noexcept {
+    return ExtNameView.data() ? ExtNameView : std::string_view(ExtName);
+  }
+  void setExternalName(std::string_view Name) {
+    ExtName = Name;
+    ExtNameView = {};
+  }
+
+  /// Setter of external name borrowed from the module data, which is kept
+  /// alive by the module. See Module::getDataOwner().
+  void setExternalNameView(std::string_view Name) noexcept {
+    ExtName.clear();
+    ExtNameView = Name;
+  }
 
 protected:
   /// \name Data of Desc: rxternal name and external type.
   /// @{
   ExternalType ExtType;
   std::string ExtName;
+  std::string_view ExtNameView;
   /// @}
 };
 
@@ -47,8 +60,19 @@ protected:
 class ImportDesc : public Desc {
 public:
   /// Getter and setter of module name.
-  std::string_view getModuleName() const noexcept { return ModName; }
-  void setModuleName(std::string_view Name) { ModName = Name; }
+  std::string_view getModuleName() const noexcept {
+    return ModNameView.data() ? ModNameView : std::string_view(ModName);
+  }
+  void setModuleName(std::string_view Name) {
+    ModName = Name;
+    ModNameView = {};
+  }
+
+  /// Setter of module name borrowed from the module data.
+  void setModuleNameView(std::string_view Name) noexcept {
+    ModName.clear();
+    ModNameView = Name;
+  }
 
   /// Getter and setter of external contents.
   uint32_t getExternalFuncTypeIdx() const noexcept { return FuncTypeIdx; }
@@ -64,6 +88,7 @@ private:
   /// \name Data of ImportDesc: Module name, External name, and content node.
   /// @{
   std::string ModName;
+  std::string_view ModNameView;
   uint32_t FuncTypeIdx = 0;
   TableType TabType;
   MemoryType MemType;
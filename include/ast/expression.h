@@ -16,20 +16,45 @@
 
 #include "ast/instruction.h"
 
+#include <memory>
+#include <utility>
+
 namespace WasmEdge {
 namespace AST {
 
 /// AST Expression node.
 class Expression {
 public:
+  Expression() = default;
+  /// Copy the instructions with the capacity larger than the size as the
+  /// loaded ones, which the borrowed instructions rely on.
+  Expression(const Expression &Other) : SideTable(Other.SideTable) {
+    Instrs.reserve(Other.Instrs.size() + 1);
+    Instrs.assign(Other.Instrs.begin(), Other.Instrs.end());
+  }
+  Expression(Expression &&) noexcept = default;
+  Expression &operator=(const Expression &Other) {
+    return *this = Expression(Other);
+  }
+  Expression &operator=(Expression &&) noexcept = default;
+
   /// Getter of instructions vector.
   InstrView getInstrs() const noexcept { return Instrs; }
   InstrVec &getInstrs() noexcept { return Instrs; }
 
+  /// Getter and setter of the side table referred by the instructions.
+  const std::shared_ptr<const InstrSideTable> &getSideTable() const noexcept {
+    return SideTable;
+  }
+  void setSideTable(std::shared_ptr<const InstrSideTable> Table) noexcept {
+    SideTable = std::move(Table);
+  }
+
 private:
   /// \name Data of Expression.
   /// @{
   InstrVec Instrs;
+  std::shared_ptr<const InstrSideTable> SideTable;
   /// @}
 };
 
@@ -17,61 +17,24 @@
 #include "common/span.h"
 #include "common/types.h"
 
-#include <algorithm>
+#include <cstring>
 #include <vector>
 
 namespace WasmEdge {
 namespace AST {
 
 /// Instruction node class.
+///
+/// The node is a fixed-size and trivially copyable record. The variable-length
+/// immediates are stored in the side table of the expression, and the node
+/// only refers to them.
 class Instruction {
 public:
   /// Constructor assigns the OpCode and the Offset.
   Instruction(OpCode Byte, uint32_t Off = 0) noexcept
       : Offset(Off), Code(Byte) {
-#if defined(__x86_64__) || defined(__aarch64__)
-    Data.Num = static_cast<uint128_t>(0);
-#else
     Data.Num.Low = static_cast<uint64_t>(0);
     Data.Num.High = static_cast<uint64_t>(0);
-#endif
-    Flags.IsAllocLabelList = false;
-    Flags.IsAllocValTypeList = false;
-  }
-
-  /// Copy constructor.
-  Instruction(const Instruction &Instr)
-      : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
-    if (Flags.IsAllocLabelList) {
-      Data.BrTable.LabelList = new uint32_t[Data.BrTable.LabelListSize];
-      std::copy_n(Instr.Data.BrTable.LabelList, Data.BrTable.LabelListSize,
-                  Data.BrTable.LabelList);
-    } else if (Flags.IsAllocValTypeList) {
-      Data.SelectT.ValTypeList = new ValType[Data.SelectT.ValTypeListSize];
-      std::copy_n(Instr.Data.SelectT.ValTypeList, Data.SelectT.ValTypeListSize,
-                  Data.SelectT.ValTypeList);
-    }
-  }
-
-  /// Move constructor.
-  Instruction(Instruction &&Instr)
-      : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
-    Instr.Flags.IsAllocLabelList = false;
-    Instr.Flags.IsAllocValTypeList = false;
-  }
-
-  /// Destructor.
-  ~Instruction() { reset(); }
-
-  /// Copy assignment.
-  Instruction &operator=(const Instruction &Instr) {
-    if (this != &Instr) {
-      Instruction Tmp(Instr);
-      Tmp.swap(*this);
-    }
-    return *this;
   }
 
   /// Getter of OpCode.
@@ -99,39 +62,24 @@ public:
   RefType getRefType() const noexcept { return Data.ReferenceType; }
   void setRefType(RefType RType) noexcept { Data.ReferenceType = RType; }
 
-  /// Getter and setter of label list.
-  void setLabelListSize(uint32_t Size) {
-    reset();
-    if (Size > 0) {
-      Data.BrTable.LabelListSize = Size;
-      Data.BrTable.LabelList = new uint32_t[Size];
-      Flags.IsAllocLabelList = true;
-    }
-  }
+  /// Getter and setter of label list in the side table.
   Span<const uint32_t> getLabelList() const noexcept {
     return Span<const uint32_t>(Data.BrTable.LabelList,
                                 Data.BrTable.LabelListSize);
   }
-  Span<uint32_t> getLabelList() noexcept {
-    return Span<uint32_t>(Data.BrTable.LabelList, Data.BrTable.LabelListSize);
+  void setLabelList(Span<const uint32_t> List) noexcept {
+    Data.BrTable.LabelList = List.data();
+    Data.BrTable.LabelListSize = static_cast<uint32_t>(List.size());
   }
 
-  /// Getter and setter of selecting value types list.
-  void setValTypeListSize(uint32_t Size) {
-    reset();
-    if (Size > 0) {
-      Data.SelectT.ValTypeListSize = Size;
-      Data.SelectT.ValTypeList = new ValType[Size];
-      Flags.IsAllocValTypeList = true;
-    }
-  }
+  /// Getter and setter of selecting value types list in the side table.
   Span<const ValType> getValTypeList() const noexcept {
     return Span<const ValType>(Data.SelectT.ValTypeList,
                                Data.SelectT.ValTypeListSize);
   }
-  Span<ValType> getValTypeList() noexcept {
-    return Span<ValType>(Data.SelectT.ValTypeList,
-                         Data.SelectT.ValTypeListSize);
+  void setValTypeList(Span<const ValType> List) noexcept {
+    Data.SelectT.ValTypeList = List.data();
+    Data.SelectT.ValTypeListSize = static_cast<uint32_t>(List.size());
   }
 
   /// Getter and setter of target index.
@@ -143,12 +91,12 @@ public:
   uint32_t &getSourceIndex() noexcept { return Data.Indices.SourceIdx; }
 
   /// Getter and setter of memory alignment.
-  uint32_t getMemoryAlign() const noexcept { return Data.Memories.MemAlign; }
-  uint32_t &getMemoryAlign() noexcept { return Data.Memories.MemAlign; }
+  uint8_t getMemoryAlign() const noexcept { return Data.Memories.MemAlign; }
+  uint8_t &getMemoryAlign() noexcept { return Data.Memories.MemAlign; }
 
   /// Getter of memory offset.
-  uint32_t getMemoryOffset() const noexcept { return Data.Memories.MemOffset; }
-  uint32_t &getMemoryOffset() noexcept { return Data.Memories.MemOffset; }
+  uint64_t getMemoryOffset() const noexcept { return Data.Memories.MemOffset; }
+  uint64_t &getMemoryOffset() noexcept { return Data.Memories.MemOffset; }
 
   /// Getter of memory lane.
   uint8_t getMemoryLane() const noexcept { return Data.Memories.MemLane; }
@@ -156,43 +104,15 @@ public:
 
   /// Getter and setter of the constant value.
   ValVariant getNum() const noexcept {
-#if defined(__x86_64__) || defined(__aarch64__)
-    return ValVariant(Data.Num);
-#else
-    uint128_t N(Data.Num.High, Data.Num.Low);
+    uint128_t N;
+    std::memcpy(&N, &Data.Num, sizeof(uint128_t));
     return ValVariant(N);
-#endif
   }
   void setNum(ValVariant N) noexcept {
-#if defined(__x86_64__) || defined(__aarch64__)
-    Data.Num = N.get<uint128_t>();
-#else
     std::memcpy(&Data.Num, &N.get<uint128_t>(), sizeof(uint128_t));
-#endif
   }
 
 private:
-  /// Release allocated resources.
-  void reset() {
-    if (Flags.IsAllocLabelList) {
-      Data.BrTable.LabelListSize = 0;
-      delete[] Data.BrTable.LabelList;
-    } else if (Flags.IsAllocValTypeList) {
-      Data.SelectT.ValTypeListSize = 0;
-      delete[] Data.SelectT.ValTypeList;
-    }
-    Flags.IsAllocLabelList = false;
-    Flags.IsAllocValTypeList = false;
-  }
-
-  /// Swap function.
-  void swap(Instruction &Instr) noexcept {
-    std::swap(Data, Instr.Data);
-    std::swap(Offset, Instr.Offset);
-    std::swap(Code, Instr.Code);
-    std::swap(Flags, Instr.Flags);
-  }
-
   /// \name Data of instructions.
   /// @{
   union Inner {
@@ -211,41 +131,73 @@ private:
     struct {
       uint32_t TargetIdx;
       uint32_t LabelListSize;
-      uint32_t *LabelList;
+      const uint32_t *LabelList;
     } BrTable;
     // Type 4: RefType.
     RefType ReferenceType;
     // Type 5: ValTypeList.
     struct {
       uint32_t ValTypeListSize;
-      ValType *ValTypeList;
+      const ValType *ValTypeList;
     } SelectT;
     // Type 6: TargetIdx, MemAlign, MemOffset, and MemLane.
     struct {
       uint32_t TargetIdx;
-      uint32_t MemAlign;
-      uint32_t MemOffset;
+      uint8_t MemAlign;
       uint8_t MemLane;
+      uint64_t MemOffset;
     } Memories;
-    // Type 7: Num.
-#if defined(__x86_64__) || defined(__aarch64__)
-    uint128_t Num;
-#else
+    // Type 7: Num. Stored in halves to keep the node 8-byte aligned.
     struct {
       uint64_t Low;
       uint64_t High;
     } Num;
-#endif
   } Data;
   uint32_t Offset = 0;
   OpCode Code = OpCode::End;
-  struct {
-    bool IsAllocLabelList : 1;
-    bool IsAllocValTypeList : 1;
-  } Flags;
   /// @}
 };
 
+/// Side table of the variable-length immediates of the instructions in an
+/// expression. The label lists of br_table and the value type lists of
+/// select t are stored contiguously in the instruction order.
+struct InstrSideTable {
+  std::vector<uint32_t> Labels;
+  std::vector<ValType> ValTypes;
+
+  /// Refer the immediates of the instructions to this side table. The list
+  /// sizes of the instructions are kept.
+  ///
+  /// \returns false if the lists of the instructions exceed this side table.
+  bool bind(Span<Instruction> Instrs) const noexcept {
+    const uint32_t *Label = Labels.data();
+    const uint32_t *LabelEnd = Labels.data() + Labels.size();
+    const ValType *VType = ValTypes.data();
+    const ValType *VTypeEnd = ValTypes.data() + ValTypes.size();
+    for (auto &Instr : Instrs) {
+      if (Label == LabelEnd && VType == VTypeEnd) {
+        break;
+      }
+      if (Instr.getOpCode() == OpCode::Br_table) {
+        const auto Size = Instr.getLabelList().size();
+        if (Size > static_cast<size_t>(LabelEnd - Label)) {
+          return false;
+        }
+        Instr.setLabelList(Span<const uint32_t>(Label, Size));
+        Label += Size;
+      } else if (Instr.getOpCode() == OpCode::Select_t) {
+        const auto Size = Instr.getValTypeList().size();
+        if (Size > static_cast<size_t>(VTypeEnd - VType)) {
+          return false;
+        }
+        Instr.setValTypeList(Span<const ValType>(VType, Size));
+        VType += Size;
+      }
+    }
+    return true;
+  }
+};
+
 // Type aliasing
 using InstrVec = std::vector<Instruction>;
 using InstrView = Span<const Instruction>;
@@ -15,7 +15,14 @@
 #pragma once
 
 #include "ast/section.h"
+#include "common/filesystem.h"
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace WasmEdge {
@@ -86,21 +93,169 @@ public:
     kElemDrop,
     kRefFunc,
     kPtrFunc,
+    kMemAtomicNotify,
+    kMemAtomicWait,
+    kEnterModule,
+    kLeaveModule,
     kIntrinsicMax,
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
 
+  /// Getter and setter of the owner of the module data, such as the mapped
+  /// file, which the names and contents borrowed by the nodes are in.
+  const std::shared_ptr<const void> &getDataOwner() const noexcept {
+    return DataOwner;
+  }
+  void setDataOwner(std::shared_ptr<const void> Owner) noexcept {
+    DataOwner = std::move(Owner);
+  }
+
+  /// Getter and setter of the hash of the module binary, which keys the
+  /// counters of the execution profile. Zero if not profiling.
+  uint64_t getHash() const noexcept { return Hash; }
+  void setHash(uint64_t H) noexcept { Hash = H; }
+
+  /// Getter and setter of the validated flag. The validator marks the module
+  /// after validating it, so the flag is settable on the const module.
+  bool isValidated() const noexcept {
+    return IsValidated.Flag.load(std::memory_order_acquire);
+  }
+  void setIsValidated(bool Validated = true) const noexcept {
+    IsValidated.Flag.store(Validated, std::memory_order_release);
+  }
+
+  /// Getter and setter of the path to save the flat image cache after the
+  /// validation, which is empty if not needed. See Loader::saveFlatImage().
+  const std::filesystem::path &getFlatImagePath() const noexcept {
+    return FlatImagePath;
+  }
+  void setFlatImagePath(std::filesystem::path Path) noexcept {
+    FlatImagePath = std::move(Path);
+  }
+
   /// Getter and sette of compiled symbol.
   const auto &getSymbol() const noexcept { return IntrSymbol; }
   void setSymbol(Symbol<const IntrinsicsTable *> S) noexcept {
     IntrSymbol = std::move(S);
   }
 
+  /// Code of the function compiled in process, which is called through the
+  /// wrapper of its type.
+  struct CompiledCode {
+    Symbol<FunctionType::Wrapper> Wrapper;
+    Symbol<void> Code;
+  };
+  /// Compiler of the functions at the indices of the code section, which
+  /// returns the compiled code of them in the same order.
+  using CodeCompiler =
+      std::function<std::vector<std::shared_ptr<const CompiledCode>>(
+          Span<const uint32_t>)>;
+
+  /// Get the compiled code of the functions at the indices of the code
+  /// section. The functions not compiled yet are compiled together by the
+  /// compiler at the first request, and the code is shared by the instances
+  /// of this module since then. The concurrent requests of the same functions
+  /// wait for the compilation. Thread-safe.
+  ///
+  /// \returns the compiled code in the order of the indices, which is nullptr
+  /// if the compilation failed.
+  std::vector<std::shared_ptr<const CompiledCode>>
+  getCompiledCodes(Span<const uint32_t> CodeIdxs,
+                   const CodeCompiler &Compiler) const {
+    // The entries are locked in the order of the indices, so the concurrent
+    // requests of the overlapped functions never deadlock.
+    std::map<uint32_t, std::shared_ptr<CompiledEntry>> Entries;
+    {
+      std::unique_lock Lock(Compiled->Mutex);
+      for (const auto CodeIdx : CodeIdxs) {
+        auto &Slot = Compiled->Entries[CodeIdx];
+        if (!Slot) {
+          Slot = std::make_shared<CompiledEntry>();
+        }
+        Entries.emplace(CodeIdx, Slot);
+      }
+    }
+    std::vector<std::unique_lock<std::mutex>> Locks;
+    std::vector<uint32_t> Pending;
+    for (const auto &[CodeIdx, Entry] : Entries) {
+      Locks.emplace_back(Entry->Mutex);
+      if (!Entry->Done) {
+        Pending.push_back(CodeIdx);
+      }
+    }
+    if (!Pending.empty()) {
+      auto Codes = Compiler(Pending);
+      for (size_t I = 0; I < Pending.size(); ++I) {
+        auto &Entry = *Entries[Pending[I]];
+        if (I < Codes.size()) {
+          Entry.Code = std::move(Codes[I]);
+        }
+        Entry.Done = true;
+      }
+    }
+    std::vector<std::shared_ptr<const CompiledCode>> Codes;
+    Codes.reserve(CodeIdxs.size());
+    for (const auto CodeIdx : CodeIdxs) {
+      Codes.push_back(Entries[CodeIdx]->Code);
+    }
+    return Codes;
+  }
+
+  /// Get the compiled code of the function at the index of the code section.
+  /// See getCompiledCodes().
+  std::shared_ptr<const CompiledCode>
+  getCompiledCode(const uint32_t CodeIdx, const CodeCompiler &Compiler) const {
+    return getCompiledCodes(Span<const uint32_t>(&CodeIdx, 1), Compiler)
+        .front();
+  }
+
+  /// Get the state of the in-process compiler, such as the JIT owning the
+  /// compiled code, which is shared by the compilations of the functions of
+  /// this module. The state is created at the first request. Thread-safe.
+  std::shared_ptr<void> getCompilerState(
+      const std::function<std::shared_ptr<void>()> &Create) const {
+    std::unique_lock Lock(Compiled->Mutex);
+    if (!Compiled->CompilerState) {
+      Compiled->CompilerState = Create();
+    }
+    return Compiled->CompilerState;
+  }
+
 private:
+  /// Compiled code of a function and its compiling status.
+  struct CompiledEntry {
+    std::mutex Mutex;
+    bool Done = false;
+    std::shared_ptr<const CompiledCode> Code;
+  };
+  /// Validated flag which is copied with the module.
+  struct ValidatedFlag {
+    ValidatedFlag() noexcept = default;
+    ValidatedFlag(const ValidatedFlag &Other) noexcept
+        : Flag(Other.Flag.load(std::memory_order_acquire)) {}
+    ValidatedFlag &operator=(const ValidatedFlag &Other) noexcept {
+      Flag.store(Other.Flag.load(std::memory_order_acquire),
+                 std::memory_order_release);
+      return *this;
+    }
+    std::atomic<bool> Flag = false;
+  };
+  /// Compiled code of the functions requested, and the state of the compiler
+  /// shared by their compilations.
+  struct CompiledCache {
+    std::mutex Mutex;
+    std::unordered_map<uint32_t, std::shared_ptr<CompiledEntry>> Entries;
+    std::shared_ptr<void> CompilerState;
+  };
+
   /// \name Data of Module node.
   /// @{
   std::vector<Byte> Magic;
   std::vector<Byte> Version;
+  std::shared_ptr<const void> DataOwner;
+  uint64_t Hash = 0;
+  mutable ValidatedFlag IsValidated;
+  std::filesystem::path FlatImagePath;
   /// @}
 
   /// \name Section nodes of Module node.
@@ -124,6 +279,7 @@ private:
   /// @{
   AOTSection AOTSec;
   Symbol<const IntrinsicsTable *> IntrSymbol;
+  std::shared_ptr<CompiledCache> Compiled = std::make_shared<CompiledCache>();
   /// @}
 };
 
@@ -38,18 +38,67 @@ protected:
 class CustomSection : public Section {
 public:
   /// Getter and setter of name.
-  std::string_view getName() const noexcept { return Name; }
-  void setName(std::string_view N) { Name = N; }
+  std::string_view getName() const noexcept {
+    return NameView.data() ? NameView : std::string_view(Name);
+  }
+  void setName(std::string_view N) {
+    Name = N;
+    NameView = {};
+  }
 
-  /// Getter of content vector.
-  Span<const Byte> getContent() const noexcept { return Content; }
-  std::vector<Byte> &getContent() noexcept { return Content; }
+  /// Getter and setter of content. The content is empty if not loaded, see
+  /// isContentLoaded().
+  Span<const Byte> getContent() const noexcept {
+    return ContentView.data() ? ContentView : Span<const Byte>(Content);
+  }
+  void setContent(std::vector<Byte> Bytes) noexcept {
+    Content = std::move(Bytes);
+    ContentView = {};
+    IsContentLoaded = true;
+  }
+
+  /// Setters of name and content borrowed from the module data, which is kept
+  /// alive by the module. See Module::getDataOwner().
+  void setNameView(std::string_view N) noexcept {
+    Name.clear();
+    NameView = N;
+  }
+  void setContentView(Span<const Byte> Bytes) noexcept {
+    Content.clear();
+    ContentView = Bytes;
+    IsContentLoaded = true;
+  }
+
+  /// Getters and setter of the content offset and length in the module
+  /// binary.
+  uint64_t getContentOffset() const noexcept { return ContentOffset; }
+  uint32_t getContentLength() const noexcept { return ContentLength; }
+  void setContentRange(uint64_t Offset, uint32_t Length) noexcept {
+    ContentOffset = Offset;
+    ContentLength = Length;
+  }
+
+  /// Getter and setter of the hash of the content, which is recorded with the
+  /// range to check the module binary the content is loaded from.
+  uint64_t getContentHash() const noexcept { return ContentHash; }
+  void setContentHash(uint64_t Hash) noexcept { ContentHash = Hash; }
+
+  /// Check if the content is set or borrowed. Otherwise only the range is
+  /// recorded, and the content can be got by
+  /// Loader::getCustomSectionContent() from the module binary.
+  bool isContentLoaded() const noexcept { return IsContentLoaded; }
 
 private:
   /// \name Data of CustomSection.
   /// @{
   std::string Name;
+  std::string_view NameView;
   std::vector<Byte> Content;
+  Span<const Byte> ContentView;
+  uint64_t ContentOffset = 0;
+  uint32_t ContentLength = 0;
+  uint64_t ContentHash = 0;
+  bool IsContentLoaded = false;
   /// @}
 };
 
@@ -235,6 +284,10 @@ public:
   uint8_t getArchType() const noexcept { return ArchType; }
   void setArchType(uint8_t Type) noexcept { ArchType = Type; }
 
+  /// Getter and setter of CPU level.
+  uint8_t getCPULevel() const noexcept { return CPULevel; }
+  void setCPULevel(uint8_t Level) noexcept { CPULevel = Level; }
+
   /// Getter and setter of version address.
   uint64_t getVersionAddress() const noexcept { return VersionAddress; }
   void setVersionAddress(uint64_t Addr) noexcept { VersionAddress = Addr; }
@@ -267,6 +320,7 @@ private:
   uint32_t Version;
   uint8_t OSType;
   uint8_t ArchType;
+  uint8_t CPULevel;
   uint64_t VersionAddress;
   uint64_t IntrinsicsAddress;
   std::vector<uintptr_t> TypesAddress;
@@ -16,10 +16,18 @@
 
 #include "ast/expression.h"
 #include "ast/type.h"
+#include "common/errcode.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace WasmEdge {
+
+class MMap;
+
 namespace AST {
 
 /// Segment's base class.
@@ -83,16 +91,86 @@ private:
 /// AST CodeSegment node.
 class CodeSegment : public Segment {
 public:
+  using LocalVec = std::vector<std::pair<uint32_t, ValType>>;
+  /// Decoder of the lazy function body into the locals and the expression.
+  using LazyDecoder = std::function<Expect<void>(LocalVec &, Expression &)>;
+  /// Checker of the decoded lazy function body.
+  using LazyChecker = std::function<Expect<void>(
+      Span<const std::pair<uint32_t, ValType>>, InstrView)>;
+
   /// Getter and setter of segment size.
   uint32_t getSegSize() const noexcept { return SegSize; }
   void setSegSize(uint32_t Size) noexcept { SegSize = Size; }
 
-  /// Getter of locals vector.
+  /// Getter of locals vector. The lazy function body should be decoded first.
   Span<const std::pair<uint32_t, ValType>> getLocals() const noexcept {
-    return Locals;
+    return Lazy ? Lazy->Locals : Locals;
+  }
+  LocalVec &getLocals() noexcept { return Lazy ? Lazy->Locals : Locals; }
+
+  /// Getter of the function body. The lazy function body should be decoded
+  /// first.
+  const Expression &getExpr() const noexcept {
+    return Lazy ? Lazy->Expr : Expr;
+  }
+  Expression &getExpr() noexcept { return Lazy ? Lazy->Expr : Expr; }
+
+  /// Getter of checking is the function body decoded lazily.
+  bool isLazy() const noexcept { return static_cast<bool>(Lazy); }
+
+  /// Set the decoder of the lazy function body.
+  void setLazyDecoder(LazyDecoder Decoder) {
+    Lazy = std::make_shared<LazyBody>();
+    Lazy->Decoder = std::move(Decoder);
+  }
+
+  /// Set the checker of the lazy function body if not set. Thread-safe.
+  ///
+  /// The lazy function body is the decoding state shared by the copies of
+  /// this segment rather than the value of this segment, so the checker is
+  /// set on the const segment under the mutex of the lazy function body.
+  ///
+  /// \returns false if the body is decoded already, which the caller should
+  /// check by itself, true otherwise.
+  bool setLazyChecker(LazyChecker Checker) const {
+    std::unique_lock Lock(Lazy->Mutex);
+    if (Lazy->Done.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    if (!Lazy->Checker) {
+      Lazy->Checker = std::move(Checker);
+    }
+    return true;
   }
-  std::vector<std::pair<uint32_t, ValType>> &getLocals() noexcept {
-    return Locals;
+
+  /// Decode and check the lazy function body at the first call. Thread-safe.
+  ///
+  /// \returns void if the body is decoded and checked, error code otherwise.
+  Expect<void> loadLazyBody() const {
+    if (!Lazy) {
+      return {};
+    }
+    if (likely(Lazy->Done.load(std::memory_order_acquire))) {
+      return Lazy->Result;
+    }
+    std::unique_lock Lock(Lazy->Mutex);
+    if (!Lazy->Done.load(std::memory_order_relaxed)) {
+      Lazy->Result = Lazy->Decoder(Lazy->Locals, Lazy->Expr);
+      if (Lazy->Result && Lazy->Checker) {
+        Lazy->Result = Lazy->Checker(Lazy->Locals, Lazy->Expr.getInstrs());
+      }
+      Lazy->Decoder = nullptr;
+      Lazy->Checker = nullptr;
+      Lazy->Done.store(true, std::memory_order_release);
+    }
+    return Lazy->Result;
+  }
+
+  /// Getter and setter of checking is the function body validated while
+  /// loading. See LoaderConfigure::setFusedValidation().
+  bool isValidated() const noexcept { return IsValidated; }
+  void setIsValidated(bool Validated = true) noexcept {
+    IsValidated = Validated;
   }
 
   /// Getter and setter of compiled symbol.
@@ -100,11 +178,24 @@ public:
   void setSymbol(Symbol<void> S) noexcept { FuncSymbol = std::move(S); }
 
 private:
+  /// Lazy function body and its decoding status.
+  struct LazyBody {
+    std::mutex Mutex;
+    std::atomic<bool> Done = false;
+    Expect<void> Result;
+    LazyDecoder Decoder;
+    LazyChecker Checker;
+    LocalVec Locals;
+    Expression Expr;
+  };
+
   /// \name Data of CodeSegment node.
   /// @{
   uint32_t SegSize = 0;
-  std::vector<std::pair<uint32_t, ValType>> Locals;
+  LocalVec Locals;
+  bool IsValidated = false;
   Symbol<void> FuncSymbol;
+  std::shared_ptr<LazyBody> Lazy;
   /// @}
 };
 
@@ -123,8 +214,27 @@ public:
   void setIdx(uint32_t Idx) noexcept { MemoryIdx = Idx; }
 
   /// Getter of data.
-  Span<const Byte> getData() const noexcept { return Data; }
-  std::vector<Byte> &getData() noexcept { return Data; }
+  Span<const Byte> getData() const noexcept {
+    return DataMap ? DataView : Span<const Byte>(Data);
+  }
+
+  /// Setter of the data owned by this segment.
+  void setData(std::vector<Byte> Bytes) noexcept {
+    Data = std::move(Bytes);
+    DataView = {};
+    DataMap.reset();
+  }
+
+  /// Setter of the data borrowed from the mapped module file. The data is
+  /// kept alive by sharing the mapped file.
+  void setData(Span<const Byte> View, std::shared_ptr<MMap> Map) noexcept {
+    Data.clear();
+    DataView = View;
+    DataMap = std::move(Map);
+  }
+
+  /// Getter of the mapped file which the data is borrowed from, or null.
+  const std::shared_ptr<MMap> &getDataMap() const noexcept { return DataMap; }
 
 private:
   /// \name Data of DataSegment node.
@@ -132,6 +242,8 @@ private:
   DataMode Mode = DataMode::Active;
   uint32_t MemoryIdx = 0;
   std::vector<Byte> Data;
+  Span<const Byte> DataView;
+  std::shared_ptr<MMap> DataMap;
   /// @}
 };
 
@@ -26,37 +26,62 @@ namespace AST {
 /// AST Limit node.
 class Limit {
 public:
-  /// Limit type enumeration class.
-  enum class LimitType : uint8_t { HasMin = 0x00, HasMinMax = 0x01 };
+  /// Limit type enumeration class. The bit 0 marks the maximum, the bit 1
+  /// marks the shared memory, and the bit 2 marks the 64-bit index type.
+  enum class LimitType : uint8_t {
+    HasMin = 0x00,
+    HasMinMax = 0x01,
+    SharedNoMax = 0x02,
+    Shared = 0x03,
+    I64HasMin = 0x04,
+    I64HasMinMax = 0x05,
+    I64SharedNoMax = 0x06,
+    I64Shared = 0x07
+  };
 
   /// Constructors.
   Limit() noexcept : Type(LimitType::HasMin), Min(0U), Max(0U) {}
-  Limit(uint32_t MinVal) noexcept
+  Limit(uint64_t MinVal) noexcept
       : Type(LimitType::HasMin), Min(MinVal), Max(MinVal) {}
-  Limit(uint32_t MinVal, uint32_t MaxVal) noexcept
-      : Type(LimitType::HasMinMax), Min(MinVal), Max(MaxVal) {}
+  Limit(uint64_t MinVal, uint64_t MaxVal, bool Shared = false) noexcept
+      : Type(Shared ? LimitType::Shared : LimitType::HasMinMax), Min(MinVal),
+        Max(MaxVal) {}
   Limit(const Limit &L) noexcept : Type(L.Type), Min(L.Min), Max(L.Max) {}
 
   /// Getter and setter of limit mode.
-  bool hasMax() const noexcept { return Type == LimitType::HasMinMax; }
-  void setHasMax(bool HasMax) noexcept {
-    Type = HasMax ? LimitType::HasMinMax : LimitType::HasMin;
-  }
+  bool hasMax() const noexcept { return getFlag(0x01U); }
+  void setHasMax(bool HasMax) noexcept { setFlag(0x01U, HasMax); }
+
+  /// Getter and setter of shared mode.
+  bool isShared() const noexcept { return getFlag(0x02U); }
+  void setShared(bool Shared) noexcept { setFlag(0x02U, Shared); }
+
+  /// Getter and setter of 64-bit index type.
+  bool is64() const noexcept { return getFlag(0x04U); }
+  void setIs64(bool Is64) noexcept { setFlag(0x04U, Is64); }
 
   /// Getter and setter of min value.
-  uint32_t getMin() const noexcept { return Min; }
-  void setMin(uint32_t Val) noexcept { Min = Val; }
+  uint64_t getMin() const noexcept { return Min; }
+  void setMin(uint64_t Val) noexcept { Min = Val; }
 
   /// Getter and setter of max value.
-  uint32_t getMax() const noexcept { return Max; }
-  void setMax(uint32_t Val) noexcept { Max = Val; }
+  uint64_t getMax() const noexcept { return Max; }
+  void setMax(uint64_t Val) noexcept { Max = Val; }
 
 private:
+  bool getFlag(uint8_t Bit) const noexcept {
+    return (static_cast<uint8_t>(Type) & Bit) != 0;
+  }
+  void setFlag(uint8_t Bit, bool Val) noexcept {
+    const uint8_t Flags = static_cast<uint8_t>(Type);
+    Type = static_cast<LimitType>(Val ? (Flags | Bit) : (Flags & ~Bit));
+  }
+
   /// \name Data of Limit.
   /// @{
   LimitType Type;
-  uint32_t Min;
-  uint32_t Max;
+  uint64_t Min;
+  uint64_t Max;
   /// @}
 };
 
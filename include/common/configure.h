@@ -15,16 +15,77 @@
 #pragma once
 
 #include "common/enum_configure.h"
+#include "common/memorybudget.h"
+#include "common/profile.h"
 
 #include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <initializer_list>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 
 namespace WasmEdge {
 
+class LoaderConfigure {
+public:
+  LoaderConfigure() noexcept = default;
+  LoaderConfigure(const LoaderConfigure &RHS) noexcept
+      : ParallelThreads(RHS.ParallelThreads.load(std::memory_order_relaxed)),
+        LazyFunctionBody(RHS.LazyFunctionBody.load(std::memory_order_relaxed)),
+        FlatImageCache(RHS.FlatImageCache.load(std::memory_order_relaxed)),
+        FusedValidation(RHS.FusedValidation.load(std::memory_order_relaxed)) {
+  }
+
+  /// Set the thread count to decode the function bodies in the code section
+  /// and validate them. 0 and 1 decode and validate sequentially.
+  void setParallelThreads(const uint32_t Threads) noexcept {
+    ParallelThreads.store(Threads, std::memory_order_relaxed);
+  }
+
+  uint32_t getParallelThreads() const noexcept {
+    return ParallelThreads.load(std::memory_order_relaxed);
+  }
+
+  /// Set the function bodies to be decoded and validated at the first use
+  /// instead of loading. The errors of them are reported at that time.
+  void setLazyFunctionBody(const bool IsLazy) noexcept {
+    LazyFunctionBody.store(IsLazy, std::memory_order_relaxed);
+  }
+
+  bool isLazyFunctionBody() const noexcept {
+    return LazyFunctionBody.load(std::memory_order_relaxed);
+  }
+
+  /// Set the validated modules to be cached as flat images, which are parsed
+  /// instead of decoding the same module binaries. The modules parsed from the
+  /// images are validated again.
+  void setFlatImageCache(const bool IsCache) noexcept {
+    FlatImageCache.store(IsCache, std::memory_order_relaxed);
+  }
+
+  bool isFlatImageCache() const noexcept {
+    return FlatImageCache.load(std::memory_order_relaxed);
+  }
+
+  /// Set the function bodies to be checked while decoding them. The validator
+  /// skips the checked function bodies.
+  void setFusedValidation(const bool IsFused) noexcept {
+    FusedValidation.store(IsFused, std::memory_order_relaxed);
+  }
+
+  bool isFusedValidation() const noexcept {
+    return FusedValidation.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> ParallelThreads = 0;
+  std::atomic<bool> LazyFunctionBody = false;
+  std::atomic<bool> FlatImageCache = false;
+  std::atomic<bool> FusedValidation = false;
+};
+
 class CompilerConfigure {
 public:
   CompilerConfigure() noexcept = default;
@@ -33,7 +94,11 @@ public:
         OFormat(RHS.OFormat.load(std::memory_order_relaxed)),
         DumpIR(RHS.DumpIR.load(std::memory_order_relaxed)),
         GenericBinary(RHS.GenericBinary.load(std::memory_order_relaxed)),
-        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)) {}
+        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)),
+        ParallelThreads(RHS.ParallelThreads.load(std::memory_order_relaxed)),
+        IncrementalCache(RHS.IncrementalCache.load(std::memory_order_relaxed)),
+        CPULevels(RHS.CPULevels.load(std::memory_order_relaxed)),
+        Prof(std::atomic_load(&RHS.Prof)) {}
 
   /// AOT compiler optimization level enum class.
   enum class OptimizationLevel : uint8_t {
@@ -97,19 +162,93 @@ public:
     return Interruptible.load(std::memory_order_relaxed);
   }
 
+  /// Set the thread count to optimize and generate codes. The module is split
+  /// into the same count of partitions by functions. 0 and 1 compile the
+  /// whole module in one thread.
+  void setParallelThreads(const uint32_t Threads) noexcept {
+    ParallelThreads.store(Threads, std::memory_order_relaxed);
+  }
+
+  uint32_t getParallelThreads() const noexcept {
+    return ParallelThreads.load(std::memory_order_relaxed);
+  }
+
+  /// Set the object codes of the module partitions to be cached, and reused
+  /// when compiling the modules with the same partitions. The module is split
+  /// into a fixed count of partitions by functions.
+  void setIncrementalCache(bool IsCache) noexcept {
+    IncrementalCache.store(IsCache, std::memory_order_relaxed);
+  }
+
+  bool isIncrementalCache() const noexcept {
+    return IncrementalCache.load(std::memory_order_relaxed);
+  }
+
+  /// AOT compiler CPU feature levels of the code variants, which follow the
+  /// x86-64 microarchitecture levels.
+  enum class CPULevel : uint8_t {
+    // x86-64 baseline with SSE2.
+    Baseline,
+    // x86-64-v2 with CMPXCHG16B, LAHF-SAHF, POPCNT, SSE3, SSE4.1, SSE4.2, and
+    // SSSE3.
+    V2,
+    // x86-64-v3 with AVX, AVX2, BMI1, BMI2, F16C, FMA, LZCNT, MOVBE, and
+    // XSAVE.
+    V3,
+    // x86-64-v4 with AVX512F, AVX512BW, AVX512CD, AVX512DQ, and AVX512VL.
+    V4,
+  };
+
+  /// Add a code variant of the CPU level into the universal WASM output. The
+  /// output holds the added variants instead of the code for the host CPU, and
+  /// the loader selects the highest level supported by the running CPU.
+  void addCPULevel(CPULevel Level) noexcept {
+    CPULevels.fetch_or(static_cast<uint8_t>(1U << static_cast<uint8_t>(Level)),
+                       std::memory_order_relaxed);
+  }
+
+  bool hasCPULevel(CPULevel Level) const noexcept {
+    return CPULevels.load(std::memory_order_relaxed) &
+           (1U << static_cast<uint8_t>(Level));
+  }
+
+  void clearCPULevels() noexcept {
+    CPULevels.store(0, std::memory_order_relaxed);
+  }
+
+  /// Set the execution profile to guide the optimizations. The branch weights,
+  /// the function entry counts, and the cold functions are taken from it.
+  void setProfile(std::shared_ptr<const Profile> P) noexcept {
+    std::atomic_store(&Prof, std::move(P));
+  }
+
+  std::shared_ptr<const Profile> getProfile() const noexcept {
+    return std::atomic_load(&Prof);
+  }
+
 private:
   std::atomic<OptimizationLevel> OptLevel = OptimizationLevel::O3;
   std::atomic<OutputFormat> OFormat = OutputFormat::Wasm;
   std::atomic<bool> DumpIR = false;
   std::atomic<bool> GenericBinary = false;
   std::atomic<bool> Interruptible = false;
+  std::atomic<uint32_t> ParallelThreads = 0;
+  std::atomic<bool> IncrementalCache = false;
+  std::atomic<uint8_t> CPULevels = 0;
+  std::shared_ptr<const Profile> Prof;
 };
 
 class RuntimeConfigure {
 public:
   RuntimeConfigure() noexcept = default;
   RuntimeConfigure(const RuntimeConfigure &RHS) noexcept
-      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)) {}
+      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)),
+        MaxMemPage64(RHS.MaxMemPage64.load(std::memory_order_relaxed)),
+        MemBudget(std::atomic_load(&RHS.MemBudget)),
+        AOTCache(RHS.AOTCache.load(std::memory_order_relaxed)),
+        JIT(RHS.JIT.load(std::memory_order_relaxed)),
+        TieredThreshold(RHS.TieredThreshold.load(std::memory_order_relaxed)),
+        LazyJIT(RHS.LazyJIT.load(std::memory_order_relaxed)) {}
 
   void setMaxMemoryPage(const uint32_t Page) noexcept {
     MaxMemPage.store(Page, std::memory_order_relaxed);
@@ -119,8 +258,80 @@ public:
     return MaxMemPage.load(std::memory_order_relaxed);
   }
 
+  /// Set the page limit of the 64-bit memories. The address space of their
+  /// maximum pages, or of this limit if no maximum, is reserved at creation.
+  void setMaxMemory64Page(const uint64_t Page) noexcept {
+    MaxMemPage64.store(Page, std::memory_order_relaxed);
+  }
+
+  uint64_t getMaxMemory64Page() const noexcept {
+    return MaxMemPage64.load(std::memory_order_relaxed);
+  }
+
+  /// Set the memory budget shared by the copies of this configuration. The
+  /// pages of all memory instances created with the copies are charged to it.
+  void setMemoryBudget(std::shared_ptr<MemoryBudget> Budget) noexcept {
+    std::atomic_store(&MemBudget, std::move(Budget));
+  }
+
+  std::shared_ptr<MemoryBudget> getMemoryBudget() const noexcept {
+    return std::atomic_load(&MemBudget);
+  }
+
+  /// Set the VM to load the plain Wasm modules from their compiled libraries
+  /// in the AOT cache. The missing ones are interpreted, and compiled into
+  /// the cache in background for the next loading. The compilations are not
+  /// waited for by the VMs, and are cancelled at the process exit.
+  void setAOTCache(bool IsCache) noexcept {
+    AOTCache.store(IsCache, std::memory_order_relaxed);
+  }
+
+  bool isAOTCache() const noexcept {
+    return AOTCache.load(std::memory_order_relaxed);
+  }
+
+  /// Set the VM to compile the plain Wasm modules into the native code in
+  /// process when loading them, without writing the compiled libraries.
+  void setJIT(bool IsJIT) noexcept {
+    JIT.store(IsJIT, std::memory_order_relaxed);
+  }
+
+  bool isJIT() const noexcept { return JIT.load(std::memory_order_relaxed); }
+
+  /// Set the count of the calls and the loop iterations, after which the
+  /// interpreted functions are compiled in background and run natively since
+  /// then. The VM compiles them on one worker thread, and the functions of a
+  /// module queued together are compiled together. Zero disables the tiered
+  /// execution.
+  void setTieredThreshold(const uint32_t Count) noexcept {
+    TieredThreshold.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getTieredThreshold() const noexcept {
+    return TieredThreshold.load(std::memory_order_relaxed);
+  }
+
+  /// Set the VM to compile each function at its first call, instead of the
+  /// whole module. The compiled code is shared by the instances of the module,
+  /// and the functions never called are not compiled. The calls on the other
+  /// threads during the compilation are interpreted.
+  void setLazyJIT(bool IsLazyJIT) noexcept {
+    LazyJIT.store(IsLazyJIT, std::memory_order_relaxed);
+  }
+
+  bool isLazyJIT() const noexcept {
+    return LazyJIT.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> MaxMemPage = 65536;
+  /// 64 GiB by default.
+  std::atomic<uint64_t> MaxMemPage64 = UINT64_C(1) << 20;
+  std::shared_ptr<MemoryBudget> MemBudget;
+  std::atomic<bool> AOTCache = false;
+  std::atomic<bool> JIT = false;
+  std::atomic<uint32_t> TieredThreshold = 0;
+  std::atomic<bool> LazyJIT = false;
 };
 
 class StatisticsConfigure {
@@ -129,7 +340,8 @@ public:
   StatisticsConfigure(const StatisticsConfigure &RHS) noexcept
       : InstrCounting(RHS.InstrCounting.load(std::memory_order_relaxed)),
         CostMeasuring(RHS.CostMeasuring.load(std::memory_order_relaxed)),
-        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)) {}
+        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)),
+        Prof(std::atomic_load(&RHS.Prof)) {}
 
   void setInstructionCounting(bool IsCount) noexcept {
     InstrCounting.store(IsCount, std::memory_order_relaxed);
@@ -163,11 +375,23 @@ public:
     return CostLimit.load(std::memory_order_relaxed);
   }
 
+  /// Set the execution profile shared by the copies of this configuration.
+  /// The interpreted function entries and conditional branches are counted
+  /// into it.
+  void setProfile(std::shared_ptr<Profile> P) noexcept {
+    std::atomic_store(&Prof, std::move(P));
+  }
+
+  std::shared_ptr<Profile> getProfile() const noexcept {
+    return std::atomic_load(&Prof);
+  }
+
 private:
   std::atomic<bool> InstrCounting = false;
   std::atomic<bool> CostMeasuring = false;
   std::atomic<bool> TimeMeasuring = false;
   std::atomic<uint64_t> CostLimit = UINT64_C(-1);
+  std::shared_ptr<Profile> Prof;
 };
 
 class Configure {
@@ -185,7 +409,7 @@ public:
     (unsafeAddSet(Args), ...);
   }
   Configure(const Configure &RHS) noexcept
-      : Proposals(RHS.Proposals), Hosts(RHS.Hosts),
+      : Proposals(RHS.Proposals), Hosts(RHS.Hosts), LoaderConf(RHS.LoaderConf),
         CompilerConf(RHS.CompilerConf), RuntimeConf(RHS.RuntimeConf),
         StatisticsConf(RHS.StatisticsConf) {}
 
@@ -219,6 +443,11 @@ public:
     return Hosts.test(static_cast<uint8_t>(Host));
   }
 
+  const LoaderConfigure &getLoaderConfigure() const noexcept {
+    return LoaderConf;
+  }
+  LoaderConfigure &getLoaderConfigure() noexcept { return LoaderConf; }
+
   const CompilerConfigure &getCompilerConfigure() const noexcept {
     return CompilerConf;
   }
@@ -254,6 +483,7 @@ private:
   std::bitset<static_cast<uint8_t>(Proposal::Max)> Proposals;
   std::bitset<static_cast<uint8_t>(HostRegistration::Max)> Hosts;
 
+  LoaderConfigure LoaderConf;
   CompilerConfigure CompilerConf;
   RuntimeConfigure RuntimeConf;
   StatisticsConfigure StatisticsConf;
@@ -576,7 +576,76 @@ enum class OpCode : uint16_t {
   F64x2__convert_low_i32x4_s = 0xFDFE,
   F64x2__convert_low_i32x4_u = 0xFDFF,
   F32x4__demote_f64x2_zero = 0xFD5E,
-  F64x2__promote_low_f32x4 = 0xFD5F
+  F64x2__promote_low_f32x4 = 0xFD5F,
+
+  // Threads instructions
+  Memory__atomic__notify = 0xFE00,
+  Memory__atomic__wait32 = 0xFE01,
+  Memory__atomic__wait64 = 0xFE02,
+  Atomic__fence = 0xFE03,
+  I32__atomic__load = 0xFE10,
+  I64__atomic__load = 0xFE11,
+  I32__atomic__load8_u = 0xFE12,
+  I32__atomic__load16_u = 0xFE13,
+  I64__atomic__load8_u = 0xFE14,
+  I64__atomic__load16_u = 0xFE15,
+  I64__atomic__load32_u = 0xFE16,
+  I32__atomic__store = 0xFE17,
+  I64__atomic__store = 0xFE18,
+  I32__atomic__store8 = 0xFE19,
+  I32__atomic__store16 = 0xFE1A,
+  I64__atomic__store8 = 0xFE1B,
+  I64__atomic__store16 = 0xFE1C,
+  I64__atomic__store32 = 0xFE1D,
+  I32__atomic__rmw__add = 0xFE1E,
+  I64__atomic__rmw__add = 0xFE1F,
+  I32__atomic__rmw8__add_u = 0xFE20,
+  I32__atomic__rmw16__add_u = 0xFE21,
+  I64__atomic__rmw8__add_u = 0xFE22,
+  I64__atomic__rmw16__add_u = 0xFE23,
+  I64__atomic__rmw32__add_u = 0xFE24,
+  I32__atomic__rmw__sub = 0xFE25,
+  I64__atomic__rmw__sub = 0xFE26,
+  I32__atomic__rmw8__sub_u = 0xFE27,
+  I32__atomic__rmw16__sub_u = 0xFE28,
+  I64__atomic__rmw8__sub_u = 0xFE29,
+  I64__atomic__rmw16__sub_u = 0xFE2A,
+  I64__atomic__rmw32__sub_u = 0xFE2B,
+  I32__atomic__rmw__and = 0xFE2C,
+  I64__atomic__rmw__and = 0xFE2D,
+  I32__atomic__rmw8__and_u = 0xFE2E,
+  I32__atomic__rmw16__and_u = 0xFE2F,
+  I64__atomic__rmw8__and_u = 0xFE30,
+  I64__atomic__rmw16__and_u = 0xFE31,
+  I64__atomic__rmw32__and_u = 0xFE32,
+  I32__atomic__rmw__or = 0xFE33,
+  I64__atomic__rmw__or = 0xFE34,
+  I32__atomic__rmw8__or_u = 0xFE35,
+  I32__atomic__rmw16__or_u = 0xFE36,
+  I64__atomic__rmw8__or_u = 0xFE37,
+  I64__atomic__rmw16__or_u = 0xFE38,
+  I64__atomic__rmw32__or_u = 0xFE39,
+  I32__atomic__rmw__xor = 0xFE3A,
+  I64__atomic__rmw__xor = 0xFE3B,
+  I32__atomic__rmw8__xor_u = 0xFE3C,
+  I32__atomic__rmw16__xor_u = 0xFE3D,
+  I64__atomic__rmw8__xor_u = 0xFE3E,
+  I64__atomic__rmw16__xor_u = 0xFE3F,
+  I64__atomic__rmw32__xor_u = 0xFE40,
+  I32__atomic__rmw__xchg = 0xFE41,
+  I64__atomic__rmw__xchg = 0xFE42,
+  I32__atomic__rmw8__xchg_u = 0xFE43,
+  I32__atomic__rmw16__xchg_u = 0xFE44,
+  I64__atomic__rmw8__xchg_u = 0xFE45,
+  I64__atomic__rmw16__xchg_u = 0xFE46,
+  I64__atomic__rmw32__xchg_u = 0xFE47,
+  I32__atomic__rmw__cmpxchg = 0xFE48,
+  I64__atomic__rmw__cmpxchg = 0xFE49,
+  I32__atomic__rmw8__cmpxchg_u = 0xFE4A,
+  I32__atomic__rmw16__cmpxchg_u = 0xFE4B,
+  I64__atomic__rmw8__cmpxchg_u = 0xFE4C,
+  I64__atomic__rmw16__cmpxchg_u = 0xFE4D,
+  I64__atomic__rmw32__cmpxchg_u = 0xFE4E
 };
 
 /// Instruction opcode enumeration string mapping.
@@ -1067,6 +1136,75 @@ static inline constexpr const auto OpCodeStr = []() constexpr {
       {OpCode::F64x2__convert_low_i32x4_u, "f64x2.convert_low_i32x4_u"sv},
       {OpCode::F32x4__demote_f64x2_zero, "f32x4.demote_f64x2_zero"sv},
       {OpCode::F64x2__promote_low_f32x4, "f64x2.promote_low_f32x4"sv},
+
+      // Threads instructions
+      {OpCode::Memory__atomic__notify, "memory.atomic.notify"sv},
+      {OpCode::Memory__atomic__wait32, "memory.atomic.wait32"sv},
+      {OpCode::Memory__atomic__wait64, "memory.atomic.wait64"sv},
+      {OpCode::Atomic__fence, "atomic.fence"sv},
+      {OpCode::I32__atomic__load, "i32.atomic.load"sv},
+      {OpCode::I64__atomic__load, "i64.atomic.load"sv},
+      {OpCode::I32__atomic__load8_u, "i32.atomic.load8_u"sv},
+      {OpCode::I32__atomic__load16_u, "i32.atomic.load16_u"sv},
+      {OpCode::I64__atomic__load8_u, "i64.atomic.load8_u"sv},
+      {OpCode::I64__atomic__load16_u, "i64.atomic.load16_u"sv},
+      {OpCode::I64__atomic__load32_u, "i64.atomic.load32_u"sv},
+      {OpCode::I32__atomic__store, "i32.atomic.store"sv},
+      {OpCode::I64__atomic__store, "i64.atomic.store"sv},
+      {OpCode::I32__atomic__store8, "i32.atomic.store8"sv},
+      {OpCode::I32__atomic__store16, "i32.atomic.store16"sv},
+      {OpCode::I64__atomic__store8, "i64.atomic.store8"sv},
+      {OpCode::I64__atomic__store16, "i64.atomic.store16"sv},
+      {OpCode::I64__atomic__store32, "i64.atomic.store32"sv},
+      {OpCode::I32__atomic__rmw__add, "i32.atomic.rmw.add"sv},
+      {OpCode::I64__atomic__rmw__add, "i64.atomic.rmw.add"sv},
+      {OpCode::I32__atomic__rmw8__add_u, "i32.atomic.rmw8.add_u"sv},
+      {OpCode::I32__atomic__rmw16__add_u, "i32.atomic.rmw16.add_u"sv},
+      {OpCode::I64__atomic__rmw8__add_u, "i64.atomic.rmw8.add_u"sv},
+      {OpCode::I64__atomic__rmw16__add_u, "i64.atomic.rmw16.add_u"sv},
+      {OpCode::I64__atomic__rmw32__add_u, "i64.atomic.rmw32.add_u"sv},
+      {OpCode::I32__atomic__rmw__sub, "i32.atomic.rmw.sub"sv},
+      {OpCode::I64__atomic__rmw__sub, "i64.atomic.rmw.sub"sv},
+      {OpCode::I32__atomic__rmw8__sub_u, "i32.atomic.rmw8.sub_u"sv},
+      {OpCode::I32__atomic__rmw16__sub_u, "i32.atomic.rmw16.sub_u"sv},
+      {OpCode::I64__atomic__rmw8__sub_u, "i64.atomic.rmw8.sub_u"sv},
+      {OpCode::I64__atomic__rmw16__sub_u, "i64.atomic.rmw16.sub_u"sv},
+      {OpCode::I64__atomic__rmw32__sub_u, "i64.atomic.rmw32.sub_u"sv},
+      {OpCode::I32__atomic__rmw__and, "i32.atomic.rmw.and"sv},
+      {OpCode::I64__atomic__rmw__and, "i64.atomic.rmw.and"sv},
+      {OpCode::I32__atomic__rmw8__and_u, "i32.atomic.rmw8.and_u"sv},
+      {OpCode::I32__atomic__rmw16__and_u, "i32.atomic.rmw16.and_u"sv},
+      {OpCode::I64__atomic__rmw8__and_u, "i64.atomic.rmw8.and_u"sv},
+      {OpCode::I64__atomic__rmw16__and_u, "i64.atomic.rmw16.and_u"sv},
+      {OpCode::I64__atomic__rmw32__and_u, "i64.atomic.rmw32.and_u"sv},
+      {OpCode::I32__atomic__rmw__or, "i32.atomic.rmw.or"sv},
+      {OpCode::I64__atomic__rmw__or, "i64.atomic.rmw.or"sv},
+      {OpCode::I32__atomic__rmw8__or_u, "i32.atomic.rmw8.or_u"sv},
+      {OpCode::I32__atomic__rmw16__or_u, "i32.atomic.rmw16.or_u"sv},
+      {OpCode::I64__atomic__rmw8__or_u, "i64.atomic.rmw8.or_u"sv},
+      {OpCode::I64__atomic__rmw16__or_u, "i64.atomic.rmw16.or_u"sv},
+      {OpCode::I64__atomic__rmw32__or_u, "i64.atomic.rmw32.or_u"sv},
+      {OpCode::I32__atomic__rmw__xor, "i32.atomic.rmw.xor"sv},
+      {OpCode::I64__atomic__rmw__xor, "i64.atomic.rmw.xor"sv},
+      {OpCode::I32__atomic__rmw8__xor_u, "i32.atomic.rmw8.xor_u"sv},
+      {OpCode::I32__atomic__rmw16__xor_u, "i32.atomic.rmw16.xor_u"sv},
+      {OpCode::I64__atomic__rmw8__xor_u, "i64.atomic.rmw8.xor_u"sv},
+      {OpCode::I64__atomic__rmw16__xor_u, "i64.atomic.rmw16.xor_u"sv},
+      {OpCode::I64__atomic__rmw32__xor_u, "i64.atomic.rmw32.xor_u"sv},
+      {OpCode::I32__atomic__rmw__xchg, "i32.atomic.rmw.xchg"sv},
+      {OpCode::I64__atomic__rmw__xchg, "i64.atomic.rmw.xchg"sv},
+      {OpCode::I32__atomic__rmw8__xchg_u, "i32.atomic.rmw8.xchg_u"sv},
+      {OpCode::I32__atomic__rmw16__xchg_u, "i32.atomic.rmw16.xchg_u"sv},
+      {OpCode::I64__atomic__rmw8__xchg_u, "i64.atomic.rmw8.xchg_u"sv},
+      {OpCode::I64__atomic__rmw16__xchg_u, "i64.atomic.rmw16.xchg_u"sv},
+      {OpCode::I64__atomic__rmw32__xchg_u, "i64.atomic.rmw32.xchg_u"sv},
+      {OpCode::I32__atomic__rmw__cmpxchg, "i32.atomic.rmw.cmpxchg"sv},
+      {OpCode::I64__atomic__rmw__cmpxchg, "i64.atomic.rmw.cmpxchg"sv},
+      {OpCode::I32__atomic__rmw8__cmpxchg_u, "i32.atomic.rmw8.cmpxchg_u"sv},
+      {OpCode::I32__atomic__rmw16__cmpxchg_u, "i32.atomic.rmw16.cmpxchg_u"sv},
+      {OpCode::I64__atomic__rmw8__cmpxchg_u, "i64.atomic.rmw8.cmpxchg_u"sv},
+      {OpCode::I64__atomic__rmw16__cmpxchg_u, "i64.atomic.rmw16.cmpxchg_u"sv},
+      {OpCode::I64__atomic__rmw32__cmpxchg_u, "i64.atomic.rmw32.cmpxchg_u"sv},
   };
   return SpareEnumMap(Array);
 }
@@ -131,4 +131,16 @@ enum WasmEdge_CompilerOutputFormat {
   WasmEdge_CompilerOutputFormat_Wasm
 };
 
+/// AOT compiler CPU feature level C enumeration.
+enum WasmEdge_CompilerCPULevel {
+  // x86-64 baseline with SSE2.
+  WasmEdge_CompilerCPULevel_Baseline = 0,
+  // x86-64-v2 with SSE4.2, SSSE3, and POPCNT.
+  WasmEdge_CompilerCPULevel_V2,
+  // x86-64-v3 with AVX2, BMI2, and FMA.
+  WasmEdge_CompilerCPULevel_V3,
+  // x86-64-v4 with AVX-512.
+  WasmEdge_CompilerCPULevel_V4
+};
+
 #endif // WASMEDGE_C_API_ENUM_CONFIGURE_H
@@ -118,6 +118,8 @@ enum class ErrCode : uint8_t {
   InvalidMemPages = 0x53,    // Memory pages > 65536
   InvalidStartFunc = 0x54,   // Invalid start function signature
   InvalidLaneIdx = 0x55,     // Invalid lane index
+  SharedMemoryNoMax = 0x56,  // Shared memory without maximum limit
+  InvalidMemOffset = 0x57,   // Memory offset out of the index type range
 
   // Instantiation phase
   ModuleNameConflict = 0x60,     // Module name conflicted when importing.
@@ -125,6 +127,8 @@ enum class ErrCode : uint8_t {
   UnknownImport = 0x62,          // Unknown import instances
   DataSegDoesNotFit = 0x63,      // Init failed when instantiating data segment
   ElemSegDoesNotFit = 0x64, // Init failed when instantiating element segment
+  MemoryLimitExceeded = 0x65, // Memory pages exceeded the page limit or budget
+  MemoryAllocFailed = 0x66,   // Allocating the memory instance failed
 
   // Execution phase
   WrongInstanceAddress = 0x80, // Wrong access of instances addresses
@@ -141,7 +145,9 @@ enum class ErrCode : uint8_t {
   UndefinedElement = 0x8B,     // Access undefined element in table instances
   IndirectCallTypeMismatch = 0x8C, // Func type mismatch in call_indirect
   ExecutionFailed = 0x8D,          // Host function execution failed
-  RefTypeMismatch = 0x8E           // Reference type not match
+  RefTypeMismatch = 0x8E,          // Reference type not match
+  UnalignedAtomicAccess = 0x8F,    // Unaligned atomic memory access
+  ExpectSharedMemory = 0x90        // Atomic wait on non-shared memory
 };
 
 static inline constexpr const auto ErrCodeStr = []() constexpr {
@@ -210,12 +216,16 @@ static inline constexpr const auto ErrCodeStr = []() constexpr {
        "memory size must be at most 65536 pages (4GiB)"sv},
       {ErrCode::InvalidStartFunc, "start function"sv},
       {ErrCode::InvalidLaneIdx, "invalid lane index"sv},
+      {ErrCode::SharedMemoryNoMax, "shared memory must have maximum"sv},
+      {ErrCode::InvalidMemOffset, "offset out of range"sv},
       // Instantiation phase
       {ErrCode::ModuleNameConflict, "module name conflict"sv},
       {ErrCode::IncompatibleImportType, "incompatible import type"sv},
       {ErrCode::UnknownImport, "unknown import"sv},
       {ErrCode::DataSegDoesNotFit, "data segment does not fit"sv},
       {ErrCode::ElemSegDoesNotFit, "elements segment does not fit"sv},
+      {ErrCode::MemoryLimitExceeded, "memory limit exceeded"sv},
+      {ErrCode::MemoryAllocFailed, "memory allocation failed"sv},
       // Execution phase
       {ErrCode::WrongInstanceAddress, "wrong instance address"sv},
       {ErrCode::WrongInstanceIndex, "wrong instance index"sv},
@@ -232,6 +242,8 @@ static inline constexpr const auto ErrCodeStr = []() constexpr {
       {ErrCode::IndirectCallTypeMismatch, "indirect call type mismatch"sv},
       {ErrCode::ExecutionFailed, "host function failed"sv},
       {ErrCode::RefTypeMismatch, "reference type mismatch"sv},
+      {ErrCode::UnalignedAtomicAccess, "unaligned atomic"sv},
+      {ErrCode::ExpectSharedMemory, "expected shared memory"sv},
   };
   return SpareEnumMap(Array);
 }
@@ -301,6 +313,8 @@ enum WasmEdge_ErrCode {
   WasmEdge_ErrCode_InvalidMemPages = 0x53,
   WasmEdge_ErrCode_InvalidStartFunc = 0x54,
   WasmEdge_ErrCode_InvalidLaneIdx = 0x55,
+  WasmEdge_ErrCode_SharedMemoryNoMax = 0x56,
+  WasmEdge_ErrCode_InvalidMemOffset = 0x57,
 
   // Instantiation phase
   WasmEdge_ErrCode_ModuleNameConflict = 0x60,
@@ -308,6 +322,8 @@ enum WasmEdge_ErrCode {
   WasmEdge_ErrCode_UnknownImport = 0x62,
   WasmEdge_ErrCode_DataSegDoesNotFit = 0x63,
   WasmEdge_ErrCode_ElemSegDoesNotFit = 0x64,
+  WasmEdge_ErrCode_MemoryLimitExceeded = 0x65,
+  WasmEdge_ErrCode_MemoryAllocFailed = 0x66,
 
   // Execution phase
   WasmEdge_ErrCode_WrongInstanceAddress = 0x80,
@@ -324,7 +340,9 @@ enum WasmEdge_ErrCode {
   WasmEdge_ErrCode_UndefinedElement = 0x8B,
   WasmEdge_ErrCode_IndirectCallTypeMismatch = 0x8C,
   WasmEdge_ErrCode_ExecutionFailed = 0x8D,
-  WasmEdge_ErrCode_RefTypeMismatch = 0x8E
+  WasmEdge_ErrCode_RefTypeMismatch = 0x8E,
+  WasmEdge_ErrCode_UnalignedAtomicAccess = 0x8F,
+  WasmEdge_ErrCode_ExpectSharedMemory = 0x90
 };
 
 #endif // WASMEDGE_C_API_ENUM_ERRCODE_H
@@ -98,15 +98,15 @@ struct InfoExporting {
 
 struct InfoLimit {
   InfoLimit() = delete;
-  InfoLimit(const bool HasMax, const uint32_t Min,
-            const uint32_t Max = 0) noexcept
+  InfoLimit(const bool HasMax, const uint64_t Min,
+            const uint64_t Max = 0) noexcept
       : LimHasMax(HasMax), LimMin(Min), LimMax(Max) {}
 
   friend std::ostream &operator<<(std::ostream &OS,
                                   const struct InfoLimit &Rhs);
 
   bool LimHasMax;
-  uint32_t LimMin, LimMax;
+  uint64_t LimMin, LimMax;
 };
 
 struct InfoRegistering {
@@ -197,10 +197,10 @@ struct InfoMismatch {
         GotLimMax(GotMax) {}
 
   /// Case 8: unexpected memory limits
-  InfoMismatch(const bool ExpHasMax, const uint32_t ExpMin,
-               const uint32_t ExpMax, /// Expect Limit
-               const bool GotHasMax, const uint32_t GotMin,
-               const uint32_t GotMax /// Got limit
+  InfoMismatch(const bool ExpHasMax, const uint64_t ExpMin,
+               const uint64_t ExpMax, /// Expect Limit
+               const bool GotHasMax, const uint64_t GotMin,
+               const uint64_t GotMax /// Got limit
                ) noexcept
       : Category(MismatchCategory::Memory), ExpLimHasMax(ExpHasMax),
         GotLimHasMax(GotHasMax), ExpLimMin(ExpMin), GotLimMin(GotMin),
@@ -238,8 +238,8 @@ struct InfoMismatch {
   /// Case 7 & 8: unexpected table or memory limit
   RefType ExpRefType, GotRefType;
   bool ExpLimHasMax, GotLimHasMax;
-  uint32_t ExpLimMin, GotLimMin;
-  uint32_t ExpLimMax, GotLimMax;
+  uint64_t ExpLimMin, GotLimMin;
+  uint64_t ExpLimMax, GotLimMax;
 
   /// Case 2: unexpected value type
   /// Case 9: unexpected global type: value type
@@ -274,16 +274,16 @@ struct InfoInstruction {
 struct InfoBoundary {
   InfoBoundary() = delete;
   InfoBoundary(
-      const uint64_t Off, const uint32_t Len = 0,
-      const uint32_t Lim = std::numeric_limits<uint32_t>::max()) noexcept
+      const uint64_t Off, const uint64_t Len = 0,
+      const uint64_t Lim = std::numeric_limits<uint32_t>::max()) noexcept
       : Offset(Off), Size(Len), Limit(Lim) {}
 
   friend std::ostream &operator<<(std::ostream &OS,
                                   const struct InfoBoundary &Rhs);
 
   uint64_t Offset;
-  uint32_t Size;
-  uint32_t Limit;
+  uint64_t Size;
+  uint64_t Limit;
 };
 
 struct InfoProposal {
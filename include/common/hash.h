@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/hash.h - Hash function of binary data -------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the non-cryptographic hash function to identify the
+/// module binaries and the parts of them.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+#include "common/types.h"
+
+#include <cstdint>
+
+namespace WasmEdge {
+
+/// Hash the bytes with the 64-bit FNV-1a.
+inline uint64_t hashBytes(Span<const Byte> Bytes) noexcept {
+  uint64_t Hash = UINT64_C(0xCBF29CE484222325);
+  for (const Byte B : Bytes) {
+    Hash = (Hash ^ B) * UINT64_C(0x100000001B3);
+  }
+  return Hash;
+}
+
+} // namespace WasmEdge
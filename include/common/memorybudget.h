@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/memorybudget.h - Memory budget definition ---------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the memory budget class, which accounts the pages of
+/// linear memories shared by several memory instances or VMs.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace WasmEdge {
+
+class MemoryBudget {
+public:
+  MemoryBudget(const uint64_t Lim = UINT64_MAX,
+               std::shared_ptr<MemoryBudget> P = nullptr) noexcept
+      : Parent(std::move(P)), Limit(Lim), Usage(0), Peak(0) {}
+  MemoryBudget(const MemoryBudget &) = delete;
+  MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+  /// Charge pages to this budget and all of its parents.
+  ///
+  /// \param Pages the page count (64KiB per page) to charge.
+  ///
+  /// \returns true if charged, false and nothing charged if any budget in the
+  /// chain is exhausted.
+  bool charge(const uint64_t Pages) noexcept {
+    if (Pages == 0) {
+      return true;
+    }
+    uint64_t Cur = Usage.load(std::memory_order_relaxed);
+    do {
+      const uint64_t Lim = Limit.load(std::memory_order_relaxed);
+      if (Cur > Lim || Pages > Lim - Cur) {
+        return false;
+      }
+    } while (!Usage.compare_exchange_weak(Cur, Cur + Pages,
+                                          std::memory_order_relaxed));
+    if (Parent && !Parent->charge(Pages)) {
+      Usage.fetch_sub(Pages, std::memory_order_relaxed);
+      return false;
+    }
+    // Update the high-water mark.
+    const uint64_t New = Cur + Pages;
+    uint64_t Old = Peak.load(std::memory_order_relaxed);
+    while (Old < New &&
+           !Peak.compare_exchange_weak(Old, New, std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  /// Release pages charged before from this budget and all of its parents.
+  void release(const uint64_t Pages) noexcept {
+    if (Pages == 0) {
+      return;
+    }
+    Usage.fetch_sub(Pages, std::memory_order_relaxed);
+    if (Parent) {
+      Parent->release(Pages);
+    }
+  }
+
+  /// Getter and setter of the page limit. Lowering the limit below the usage
+  /// only fails the further charges.
+  uint64_t getLimit() const noexcept {
+    return Limit.load(std::memory_order_relaxed);
+  }
+  void setLimit(const uint64_t Lim) noexcept {
+    Limit.store(Lim, std::memory_order_relaxed);
+  }
+
+  /// Getter of the charged page count.
+  uint64_t getUsage() const noexcept {
+    return Usage.load(std::memory_order_relaxed);
+  }
+
+  /// Getter of the high-water mark of the charged page count.
+  uint64_t getPeak() const noexcept {
+    return Peak.load(std::memory_order_relaxed);
+  }
+
+private:
+  const std::shared_ptr<MemoryBudget> Parent;
+  std::atomic<uint64_t> Limit;
+  std::atomic<uint64_t> Usage;
+  std::atomic<uint64_t> Peak;
+};
+
+} // namespace WasmEdge
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/profile.h - Execution profile definition ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the execution profile class, which counts the function
+/// entries and the conditional branches in the interpreted Wasm functions to
+/// guide the optimizations of the AOT compiler.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/hash.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+
+/// The counters are keyed by the hashes of the module binaries and the
+/// offsets of the instructions in them, so the modules sharing a profile do
+/// not mix their counters, and a profile only guides the compilation of the
+/// binary it is collected from. The functions are keyed by the offsets of
+/// their first instructions.
+class Profile {
+public:
+  Profile() noexcept;
+  Profile(const Profile &) = delete;
+  Profile &operator=(const Profile &) = delete;
+
+  /// Hash the module binary to key its counters.
+  static uint64_t hashModule(Span<const Byte> Code) noexcept {
+    return hashBytes(Code);
+  }
+
+  /// Count an entry of the function starting at the offset. The counters are
+  /// collected per thread without contention, and merged when read.
+  void addEntry(const uint64_t Hash, const uint32_t Offset) noexcept {
+    auto &Counters = getShard();
+    std::unique_lock Lock(Counters.Mutex);
+    ++Counters.Modules[Hash].Entries[Offset];
+  }
+
+  /// Count an execution of the `if` or `br_if` instruction at the offset.
+  void addBranch(const uint64_t Hash, const uint32_t Offset,
+                 const bool IsTaken) noexcept {
+    auto &Counters = getShard();
+    std::unique_lock Lock(Counters.Mutex);
+    auto &Count = Counters.Modules[Hash].Branches[Offset];
+    ++(IsTaken ? Count.first : Count.second);
+  }
+
+  /// Getter of the entry count of the function starting at the offset.
+  uint64_t getEntryCount(const uint64_t Hash,
+                         const uint32_t Offset) const noexcept {
+    uint64_t Count = 0;
+    forEachModule(Hash, [&Count, Offset](const ModuleCounters &Counters) {
+      if (auto It = Counters.Entries.find(Offset);
+          It != Counters.Entries.end()) {
+        Count += It->second;
+      }
+    });
+    return Count;
+  }
+
+  /// Getter of the taken and not taken counts of the branch at the offset.
+  std::pair<uint64_t, uint64_t>
+  getBranchCount(const uint64_t Hash, const uint32_t Offset) const noexcept {
+    std::pair<uint64_t, uint64_t> Count{0, 0};
+    forEachModule(Hash, [&Count, Offset](const ModuleCounters &Counters) {
+      if (auto It = Counters.Branches.find(Offset);
+          It != Counters.Branches.end()) {
+        Count.first += It->second.first;
+        Count.second += It->second.second;
+      }
+    });
+    return Count;
+  }
+
+  /// Check if anything is counted for the module.
+  bool hasModule(const uint64_t Hash) const noexcept {
+    bool Found = false;
+    forEachModule(Hash, [&Found](const ModuleCounters &) { Found = true; });
+    return Found;
+  }
+
+  /// Check if nothing is counted.
+  bool empty() const noexcept {
+    std::unique_lock Lock(Mutex);
+    for (const auto &Counters : Shards) {
+      std::unique_lock ShardLock(Counters->Mutex);
+      if (!Counters->Modules.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Clear the counters.
+  void clear() noexcept {
+    std::unique_lock Lock(Mutex);
+    for (const auto &Counters : Shards) {
+      std::unique_lock ShardLock(Counters->Mutex);
+      Counters->Modules.clear();
+    }
+  }
+
+  /// Save the counters to a text file.
+  Expect<void> save(const std::filesystem::path &Path) const;
+
+  /// Load the counters from a file saved before. The counters are added to
+  /// the current ones, so the profiles of several runs can be merged by
+  /// loading them in turn.
+  Expect<void> load(const std::filesystem::path &Path);
+
+private:
+  struct ModuleCounters {
+    std::unordered_map<uint32_t, uint64_t> Entries;
+    std::unordered_map<uint32_t, std::pair<uint64_t, uint64_t>> Branches;
+  };
+
+  /// Counters of a thread. The lock is only contended by the readers.
+  struct Shard {
+    std::mutex Mutex;
+    std::unordered_map<uint64_t, ModuleCounters> Modules;
+  };
+
+  /// Get the counters of the calling thread, which are created at the first
+  /// count of the thread.
+  Shard &getShard() noexcept;
+
+  /// Call the function with the counters of the module in every shard.
+  template <typename F>
+  void forEachModule(const uint64_t Hash, F &&Func) const noexcept {
+    std::unique_lock Lock(Mutex);
+    for (const auto &Counters : Shards) {
+      std::unique_lock ShardLock(Counters->Mutex);
+      if (auto It = Counters->Modules.find(Hash);
+          It != Counters->Modules.end()) {
+        Func(It->second);
+      }
+    }
+  }
+
+  /// Merge the counters of all shards.
+  std::unordered_map<uint64_t, ModuleCounters> merge() const;
+
+  /// Identifier of the profile to find the shards of the threads, which is
+  /// not reused like the addresses.
+  const uint64_t Id;
+  /// Guard of the shard list.
+  mutable std::mutex Mutex;
+  std::vector<std::shared_ptr<Shard>> Shards;
+};
+
+} // namespace WasmEdge
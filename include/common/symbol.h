@@ -28,10 +28,12 @@ private:
   friend class Loader::SharedLibrary;
   template <typename> friend class Symbol;
 
-  Symbol(std::shared_ptr<Loader::SharedLibrary> H, T *S) noexcept
+public:
+  /// Construct with the holder of the code, such as the shared library or the
+  /// in-process JIT, which is kept alive by the symbol.
+  Symbol(std::shared_ptr<const void> H, T *S) noexcept
       : Library(std::move(H)), Pointer(S) {}
 
-public:
   Symbol() = default;
   Symbol(const Symbol &) = default;
   Symbol &operator=(const Symbol &) = default;
@@ -57,7 +59,7 @@ public:
   }
 
 private:
-  std::shared_ptr<Loader::SharedLibrary> Library;
+  std::shared_ptr<const void> Library;
   T *Pointer = nullptr;
 };
 
@@ -66,7 +68,7 @@ private:
   friend class Loader::SharedLibrary;
   template <typename> friend class Symbol;
 
-  Symbol(std::shared_ptr<Loader::SharedLibrary> H, T (*S)[]) noexcept
+  Symbol(std::shared_ptr<const void> H, T (*S)[]) noexcept
       : Library(std::move(H)), Pointer(*S) {}
 
 public:
@@ -88,7 +90,7 @@ public:
   }
 
 private:
-  std::shared_ptr<Loader::SharedLibrary> Library;
+  std::shared_ptr<const void> Library;
   T *Pointer = nullptr;
 };
 
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/workerpool.h - Worker pool definition -------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the pool of the threads which run a task in parallel,
+/// shared by the parallel loading, validation, and compilation.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+
+/// Pool of the threads kept by the owner to reuse them across the tasks. The
+/// owner serializes the tasks, so only one task runs on the pool at a time.
+class WorkerPool {
+public:
+  WorkerPool(uint32_t Count) {
+    for (uint32_t I = 0; I < Count; ++I) {
+      Threads.emplace_back(&WorkerPool::work, this);
+    }
+  }
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+  ~WorkerPool() noexcept {
+    {
+      std::unique_lock Lock(Mutex);
+      Stopped = true;
+    }
+    Ready.notify_all();
+    for (auto &Thread : Threads) {
+      Thread.join();
+    }
+  }
+
+  uint32_t size() const noexcept {
+    return static_cast<uint32_t>(Threads.size());
+  }
+
+  /// Run the task on the calling thread and at most Count threads of the
+  /// pool, and wait for all of them to finish.
+  void run(uint32_t Count, const std::function<void()> &Task) {
+    std::unique_lock Lock(Mutex);
+    Current = &Task;
+    Slots = std::min(Count, size());
+    Ready.notify_all();
+    Lock.unlock();
+    Task();
+    Lock.lock();
+    Done.wait(Lock, [this]() { return Slots == 0 && Running == 0; });
+    Current = nullptr;
+  }
+
+  /// Run the task on the calling thread and the threads of the pool, which
+  /// are at most Count threads in total. The pool of Threads - 1 threads is
+  /// created at the first parallel run, and kept by the owner.
+  static void run(std::unique_ptr<WorkerPool> &Pool, uint32_t Threads,
+                  uint32_t Count, const std::function<void()> &Task) {
+    const uint32_t Helpers = std::min(Threads, Count);
+    if (Helpers <= 1) {
+      Task();
+      return;
+    }
+    if (!Pool) {
+      Pool = std::make_unique<WorkerPool>(Threads - 1);
+    }
+    Pool->run(Helpers - 1, Task);
+  }
+
+private:
+  void work() {
+    std::unique_lock Lock(Mutex);
+    while (true) {
+      Ready.wait(Lock, [this]() { return Stopped || Slots > 0; });
+      if (Stopped) {
+        return;
+      }
+      --Slots;
+      ++Running;
+      const auto *Task = Current;
+      Lock.unlock();
+      (*Task)();
+      Lock.lock();
+      if (--Running == 0 && Slots == 0) {
+        Done.notify_all();
+      }
+    }
+  }
+
+  std::mutex Mutex;
+  std::condition_variable Ready;
+  std::condition_variable Done;
+  const std::function<void()> *Current = nullptr;
+  uint32_t Slots = 0;
+  uint32_t Running = 0;
+  bool Stopped = false;
+  std::vector<std::thread> Threads;
+};
+
+} // namespace WasmEdge
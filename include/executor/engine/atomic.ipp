@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/executor.h"
+#include "runtime/instance/memory.h"
+
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Executor {
+
+template <typename I>
+Expect<I *>
+Executor::getAtomicPointer(Runtime::Instance::MemoryInstance &MemInst,
+                           const uint64_t Address,
+                           const uint64_t Offset) noexcept {
+  // Calculate EA = i + offset
+  if (Address > std::numeric_limits<uint64_t>::max() - Offset) {
+    spdlog::error(ErrCode::MemoryOutOfBounds);
+    spdlog::error(
+        ErrInfo::InfoBoundary(Address, sizeof(I), MemInst.getBoundIdx()));
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  const uint64_t EA = Address + Offset;
+
+  // Check the memory boundary.
+  I *Ptr = MemInst.getPointer<I *>(EA);
+  if (unlikely(Ptr == nullptr)) {
+    spdlog::error(ErrCode::MemoryOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(EA, sizeof(I), MemInst.getBoundIdx()));
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+
+  // Atomic accesses must be naturally aligned.
+  if (unlikely(EA % sizeof(I) != 0)) {
+    spdlog::error(ErrCode::UnalignedAtomicAccess);
+    return Unexpect(ErrCode::UnalignedAtomicAccess);
+  }
+  return Ptr;
+}
+
+template <typename T>
+TypeU<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
+                                   Runtime::Instance::MemoryInstance &MemInst,
+                                   const AST::Instruction &Instr) {
+  // Pop the timeout and the expected value.
+  const int64_t Timeout = StackMgr.pop().get<int64_t>();
+  const T Expected = StackMgr.pop().get<T>();
+
+  ValVariant &Val = StackMgr.getTop();
+  if (auto Res = atomicWait<T>(MemInst, getMemAddress(MemInst, Val),
+                               Instr.getMemoryOffset(), Expected, Timeout)) {
+    Val.emplace<uint32_t>(*Res);
+  } else {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicLoadOp(Runtime::StackManager &StackMgr,
+                                   Runtime::Instance::MemoryInstance &MemInst,
+                                   const AST::Instruction &Instr) {
+  static_assert(sizeof(I) <= sizeof(T));
+  ValVariant &Val = StackMgr.getTop();
+  auto Ptr = getAtomicPointer<I>(MemInst, getMemAddress(MemInst, Val),
+                                 Instr.getMemoryOffset());
+  if (unlikely(!Ptr)) {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Ptr);
+  }
+
+  // Value = Mem.Data[EA : N / 8], zero extended.
+  Val.emplace<T>(static_cast<T>(__atomic_load_n(*Ptr, __ATOMIC_SEQ_CST)));
+  return {};
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicStoreOp(Runtime::StackManager &StackMgr,
+                                    Runtime::Instance::MemoryInstance &MemInst,
+                                    const AST::Instruction &Instr) {
+  static_assert(sizeof(I) <= sizeof(T));
+  // Pop the value t.const c from the Stack
+  const T C = StackMgr.pop().get<T>();
+  const uint64_t Address = getMemAddress(MemInst, StackMgr.pop());
+  auto Ptr = getAtomicPointer<I>(MemInst, Address, Instr.getMemoryOffset());
+  if (unlikely(!Ptr)) {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Ptr);
+  }
+
+  // Store the wrapped value.
+  __atomic_store_n(*Ptr, static_cast<I>(C), __ATOMIC_SEQ_CST);
+  return {};
+}
+
+template <typename T, typename I, typename FuncT>
+TypeU<T> Executor::runAtomicRMWOp(Runtime::StackManager &StackMgr,
+                                  Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::Instruction &Instr,
+                                  FuncT &&Func) {
+  static_assert(sizeof(I) <= sizeof(T));
+  // Pop the operand value.
+  const T C = StackMgr.pop().get<T>();
+  ValVariant &Val = StackMgr.getTop();
+  auto Ptr = getAtomicPointer<I>(MemInst, getMemAddress(MemInst, Val),
+                                 Instr.getMemoryOffset());
+  if (unlikely(!Ptr)) {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Ptr);
+  }
+
+  // Apply the operation and push the zero extended old value.
+  Val.emplace<T>(static_cast<T>(Func(*Ptr, static_cast<I>(C))));
+  return {};
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicAddOp(Runtime::StackManager &StackMgr,
+                                  Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_fetch_add(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicSubOp(Runtime::StackManager &StackMgr,
+                                  Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_fetch_sub(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicAndOp(Runtime::StackManager &StackMgr,
+                                  Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_fetch_and(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicOrOp(Runtime::StackManager &StackMgr,
+                                 Runtime::Instance::MemoryInstance &MemInst,
+                                 const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_fetch_or(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicXorOp(Runtime::StackManager &StackMgr,
+                                  Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_fetch_xor(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T>
+Executor::runAtomicExchangeOp(Runtime::StackManager &StackMgr,
+                              Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::Instruction &Instr) {
+  return runAtomicRMWOp<T, I>(StackMgr, MemInst, Instr, [](I *P, I V) {
+    return __atomic_exchange_n(P, V, __ATOMIC_SEQ_CST);
+  });
+}
+
+template <typename T, typename I>
+TypeU<T> Executor::runAtomicCompareExchangeOp(
+    Runtime::StackManager &StackMgr, Runtime::Instance::MemoryInstance &MemInst,
+    const AST::Instruction &Instr) {
+  static_assert(sizeof(I) <= sizeof(T));
+  // Pop the replacement and the expected value.
+  const T Replacement = StackMgr.pop().get<T>();
+  const T Expected = StackMgr.pop().get<T>();
+  ValVariant &Val = StackMgr.getTop();
+  auto Ptr = getAtomicPointer<I>(MemInst, getMemAddress(MemInst, Val),
+                                 Instr.getMemoryOffset());
+  if (unlikely(!Ptr)) {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Ptr);
+  }
+
+  // The expected value is wrapped before comparison. The loaded value is
+  // written back into Old when the comparison failed.
+  I Old = static_cast<I>(Expected);
+  __atomic_compare_exchange_n(*Ptr, &Old, static_cast<I>(Replacement), false,
+                              __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+  Val.emplace<T>(static_cast<T>(Old));
+  return {};
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -16,20 +16,14 @@ TypeT<T> Executor::runLoadOp(Runtime::StackManager &StackMgr,
                              const uint32_t BitWidth) {
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        BitWidth / 8, MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, Val, Instr, BitWidth / 8);
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
 
   // Value = Mem.Data[EA : N / 8]
-  if (auto Res = MemInst.loadValue(Val.emplace<T>(), EA, BitWidth / 8); !Res) {
+  if (auto Res = MemInst.loadValue(Val.emplace<T>(), *EA, BitWidth / 8);
+      !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -46,20 +40,13 @@ TypeN<T> Executor::runStoreOp(Runtime::StackManager &StackMgr,
   T C = StackMgr.pop().get<T>();
 
   // Calculate EA = i + offset
-  uint32_t I = StackMgr.pop().get<uint32_t>();
-  if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        I + static_cast<uint64_t>(Instr.getMemoryOffset()), BitWidth / 8,
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, StackMgr.pop(), Instr, BitWidth / 8);
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  uint32_t EA = I + Instr.getMemoryOffset();
 
   // Store value to bytes.
-  if (auto Res = MemInst.storeValue(C, EA, BitWidth / 8); !Res) {
+  if (auto Res = MemInst.storeValue(C, *EA, BitWidth / 8); !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -75,21 +62,14 @@ Executor::runLoadExpandOp(Runtime::StackManager &StackMgr,
   static_assert(sizeof(TOut) == sizeof(TIn) * 2);
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()), 8,
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, Val, Instr, 8);
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
 
   // Value = Mem.Data[EA : N / 8]
   uint64_t Buffer;
-  if (auto Res = MemInst.loadValue(Buffer, EA, 8); !Res) {
+  if (auto Res = MemInst.loadValue(Buffer, *EA, 8); !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -119,22 +99,15 @@ Executor::runLoadSplatOp(Runtime::StackManager &StackMgr,
                          const AST::Instruction &Instr) {
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        sizeof(T), MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, Val, Instr, sizeof(T));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
 
   // Value = Mem.Data[EA : N / 8]
   using VT [[gnu::vector_size(16)]] = T;
   uint64_t Buffer;
-  if (auto Res = MemInst.loadValue(Buffer, EA, sizeof(T)); !Res) {
+  if (auto Res = MemInst.loadValue(Buffer, *EA, sizeof(T)); !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -163,21 +136,14 @@ Expect<void> Executor::runLoadLaneOp(Runtime::StackManager &StackMgr,
 
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  const uint32_t Offset = Val.get<uint32_t>();
-  if (Offset > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Offset + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, Val, Instr, sizeof(T));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  const uint32_t EA = Offset + Instr.getMemoryOffset();
 
   // Value = Mem.Data[EA : N / 8]
   uint64_t Buffer;
-  if (auto Res = MemInst.loadValue(Buffer, EA, sizeof(T)); !Res) {
+  if (auto Res = MemInst.loadValue(Buffer, *EA, sizeof(T)); !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -198,20 +164,13 @@ Executor::runStoreLaneOp(Runtime::StackManager &StackMgr,
   const TBuf C = StackMgr.pop().get<VT>()[Instr.getMemoryLane()];
 
   // Calculate EA = i + offset
-  uint32_t I = StackMgr.pop().get<uint32_t>();
-  if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        I + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, StackMgr.pop(), Instr, sizeof(T));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  uint32_t EA = I + Instr.getMemoryOffset();
 
   // Store value to bytes.
-  if (auto Res = MemInst.storeValue(C, EA, sizeof(T)); !Res) {
+  if (auto Res = MemInst.storeValue(C, *EA, sizeof(T)); !Res) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
@@ -26,6 +26,8 @@
 #include <atomic>
 #include <csignal>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string_view>
 #include <type_traits>
 #include <utility>
@@ -86,7 +88,13 @@ using TypeNN =
 class Executor {
 public:
   Executor(const Configure &Conf, Statistics::Statistics *S = nullptr) noexcept
-      : Conf(Conf), Stat(S) {
+      : Conf(Conf), Stat(S),
+        MemBudget(std::make_shared<MemoryBudget>(
+            UINT64_MAX, Conf.getRuntimeConfigure().getMemoryBudget())),
+        Prof(Conf.getStatisticsConfigure().getProfile()),
+        TieredThreshold(Conf.getRuntimeConfigure().isLazyJIT()
+                            ? 1
+                            : Conf.getRuntimeConfigure().getTieredThreshold()) {
     assuming(This == nullptr);
     newThread();
     if (Stat) {
@@ -105,6 +113,11 @@ public:
   Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
                                  const AST::Module &Mod);
 
+  /// Instantiate Wasm Module as the anonymous active module. The function
+  /// instances borrow the instructions from the shared module.
+  Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
+                                 std::shared_ptr<const AST::Module> Mod);
+
   /// Register host module.
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const Runtime::ImportObject &Obj);
@@ -113,6 +126,12 @@ public:
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const AST::Module &Mod, std::string_view Name);
 
+  /// Register Wasm module. The function instances borrow the instructions
+  /// from the shared module.
+  Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
+                              std::shared_ptr<const AST::Module> Mod,
+                              std::string_view Name);
+
   /// Invoke function by function address in Store manager.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   invoke(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
@@ -132,6 +151,24 @@ public:
   /// Stop execution
   void stop() noexcept { StopToken.store(1, std::memory_order_relaxed); }
 
+  /// Getter of the accounting of the memory pages instantiated by this
+  /// executor. It is charged to the memory budget in configuration as well.
+  const MemoryBudget &getMemoryBudget() const noexcept { return *MemBudget; }
+
+  /// Handler of the hot native functions in the tiered execution.
+  using HotFunctionHandler =
+      std::function<void(Runtime::StoreManager &,
+                         const Runtime::Instance::FunctionInstance &)>;
+
+  /// Set the handler, which is called once for each native function when its
+  /// calls and loop iterations reach the tiered threshold in configuration,
+  /// or at its first call if the lazy JIT is enabled. The calls before the
+  /// handler sets the compiled code, such as the concurrent first calls on the
+  /// other threads, are interpreted.
+  void setHotFunctionHandler(HotFunctionHandler Handler) noexcept {
+    HotHandler = std::move(Handler);
+  }
+
 private:
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StoreManager &StoreMgr,
@@ -154,7 +191,8 @@ private:
   /// @{
   /// Instantiation of Module Instance.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
-                           const AST::Module &Mod, std::string_view Name);
+                           const AST::Module &Mod, std::string_view Name,
+                           std::shared_ptr<const AST::Module> Owner);
 
   /// Instantiation of Import Section.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -167,7 +205,8 @@ private:
                            Runtime::StackManager &StackMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
                            const AST::FunctionSection &FuncSec,
-                           const AST::CodeSection &CodeSec);
+                           const AST::CodeSection &CodeSec,
+                           const std::shared_ptr<const AST::Module> &Owner);
 
   /// Instantiation of Global Instances.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -227,6 +266,19 @@ private:
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator From);
 
+  /// Helper function for calling the compiled code of function.
+  Expect<AST::InstrView::iterator>
+  enterCompiledFunction(Runtime::StoreManager &StoreMgr,
+                        Runtime::StackManager &StackMgr,
+                        const Runtime::Instance::FunctionInstance &Func,
+                        const Symbol<AST::FunctionType::Wrapper> &Wrapper,
+                        void *Code, const AST::InstrView::iterator From);
+
+  /// Helper function for counting the calls and the loop iterations of the
+  /// native functions in the tiered execution.
+  void countHotFunction(Runtime::StoreManager &StoreMgr,
+                        const Runtime::Instance::FunctionInstance &Func);
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StoreManager &StoreMgr,
                              Runtime::StackManager &StackMgr,
@@ -366,6 +418,85 @@ private:
   Expect<void> runMemoryFillOp(Runtime::StackManager &StackMgr,
                                Runtime::Instance::MemoryInstance &MemInst,
                                const AST::Instruction &Instr);
+  /// Helper function for getting the address operand by the index type of the
+  /// memory instance.
+  static uint64_t
+  getMemAddress(const Runtime::Instance::MemoryInstance &MemInst,
+                const ValVariant &Val) noexcept {
+    return MemInst.is64() ? Val.get<uint64_t>() : Val.get<uint32_t>();
+  }
+  /// Helper function for calculating the effective address = address + offset.
+  Expect<uint64_t>
+  getEffectiveAddress(const Runtime::Instance::MemoryInstance &MemInst,
+                      const ValVariant &Val, const AST::Instruction &Instr,
+                      const uint64_t Length) const noexcept;
+  /// ======= Atomic instructions =======
+  Expect<void> runAtomicNotifyOp(Runtime::StackManager &StackMgr,
+                                 Runtime::Instance::MemoryInstance &MemInst,
+                                 const AST::Instruction &Instr);
+  template <typename T>
+  TypeU<T> runAtomicWaitOp(Runtime::StackManager &StackMgr,
+                           Runtime::Instance::MemoryInstance &MemInst,
+                           const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicLoadOp(Runtime::StackManager &StackMgr,
+                           Runtime::Instance::MemoryInstance &MemInst,
+                           const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicStoreOp(Runtime::StackManager &StackMgr,
+                            Runtime::Instance::MemoryInstance &MemInst,
+                            const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicAddOp(Runtime::StackManager &StackMgr,
+                          Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicSubOp(Runtime::StackManager &StackMgr,
+                          Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicAndOp(Runtime::StackManager &StackMgr,
+                          Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicOrOp(Runtime::StackManager &StackMgr,
+                         Runtime::Instance::MemoryInstance &MemInst,
+                         const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicXorOp(Runtime::StackManager &StackMgr,
+                          Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T> runAtomicExchangeOp(Runtime::StackManager &StackMgr,
+                               Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::Instruction &Instr);
+  template <typename T, typename I>
+  TypeU<T>
+  runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
+                             Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::Instruction &Instr);
+  /// Helper function for calculating the atomic access address and checking
+  /// the boundary and alignment.
+  template <typename I>
+  Expect<I *> getAtomicPointer(Runtime::Instance::MemoryInstance &MemInst,
+                               const uint64_t Address,
+                               const uint64_t Offset) noexcept;
+  /// Helper function for the atomic read-modify-write instructions.
+  template <typename T, typename I, typename FuncT>
+  TypeU<T> runAtomicRMWOp(Runtime::StackManager &StackMgr,
+                          Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr, FuncT &&Func);
+  /// Helper function for waiting on an address in shared memory. Returns 0 for
+  /// woken, 1 for not-equal, and 2 for timed-out.
+  template <typename T>
+  Expect<uint32_t> atomicWait(Runtime::Instance::MemoryInstance &MemInst,
+                              const uint64_t Address, const uint64_t Offset,
+                              const T Expected, const int64_t Timeout) noexcept;
+  /// Helper function for waking up the waiters on an address. Returns the
+  /// count of woken waiters.
+  Expect<uint32_t> atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
+                                const uint64_t Address, const uint64_t Offset,
+                                const uint32_t Count) noexcept;
   /// ======= Test and Relation Numeric instructions =======
   template <typename T> TypeU<T> runEqzOp(ValVariant &Val) const;
   template <typename T>
@@ -559,29 +690,46 @@ public:
                             const uint32_t FuncIdx, const ValVariant *Args,
                             ValVariant *Rets) noexcept;
 
-  Expect<uint32_t> memGrow(Runtime::StoreManager &StoreMgr,
+  Expect<uint64_t> memGrow(Runtime::StoreManager &StoreMgr,
                            Runtime::StackManager &StackMgr,
                            const uint32_t MemIdx,
-                           const uint32_t NewSize) noexcept;
-  Expect<uint32_t> memSize(Runtime::StoreManager &StoreMgr,
+                           const uint64_t NewSize) noexcept;
+  Expect<uint64_t> memSize(Runtime::StoreManager &StoreMgr,
                            Runtime::StackManager &StackMgr,
                            const uint32_t MemIdx) noexcept;
   Expect<void> memCopy(Runtime::StoreManager &StoreMgr,
                        Runtime::StackManager &StackMgr,
                        const uint32_t DstMemIdx, const uint32_t SrcMemIdx,
-                       const uint32_t DstOff, const uint32_t SrcOff,
-                       const uint32_t Len) noexcept;
+                       const uint64_t DstOff, const uint64_t SrcOff,
+                       const uint64_t Len) noexcept;
   Expect<void> memFill(Runtime::StoreManager &StoreMgr,
                        Runtime::StackManager &StackMgr, const uint32_t MemIdx,
-                       const uint32_t Off, const uint8_t Val,
-                       const uint32_t Len) noexcept;
+                       const uint64_t Off, const uint8_t Val,
+                       const uint64_t Len) noexcept;
   Expect<void> memInit(Runtime::StoreManager &StoreMgr,
                        Runtime::StackManager &StackMgr, const uint32_t MemIdx,
-                       const uint32_t DataIdx, const uint32_t DstOff,
+                       const uint32_t DataIdx, const uint64_t DstOff,
                        const uint32_t SrcOff, const uint32_t Len) noexcept;
   Expect<void> dataDrop(Runtime::StoreManager &StoreMgr,
                         Runtime::StackManager &StackMgr,
                         const uint32_t DataIdx) noexcept;
+  Expect<uint32_t> memAtomicNotify(Runtime::StoreManager &StoreMgr,
+                                   Runtime::StackManager &StackMgr,
+                                   const uint32_t MemIdx,
+                                   const uint64_t Address,
+                                   const uint64_t Offset,
+                                   const uint32_t Count) noexcept;
+  Expect<uint32_t> memAtomicWait(Runtime::StoreManager &StoreMgr,
+                                 Runtime::StackManager &StackMgr,
+                                 const uint32_t MemIdx, const uint64_t Address,
+                                 const uint64_t Offset, const uint64_t Expected,
+                                 const int64_t Timeout,
+                                 const uint32_t BitWidth) noexcept;
+  Expect<void> enterModule(Runtime::StoreManager &StoreMgr,
+                           Runtime::StackManager &StackMgr,
+                           const uint32_t ModuleAddr) noexcept;
+  Expect<void> leaveModule(Runtime::StoreManager &StoreMgr,
+                           Runtime::StackManager &StackMgr) noexcept;
 
   Expect<RefVariant> tableGet(Runtime::StoreManager &StoreMgr,
                               Runtime::StackManager &StackMgr,
@@ -634,6 +782,8 @@ private:
     uint64_t *CostTable;
     std::atomic_uint64_t *Gas;
     std::atomic_uint32_t *StopToken;
+    const uint64_t *const *MemorySizes;
+    const Runtime::Instance::ModuleInstance::FuncImportEntry *FuncImports;
   };
 
   /// Pointer to current object.
@@ -655,6 +805,15 @@ private:
   InstantiateMode InsMode;
   /// Executor statistics
   Statistics::Statistics *Stat;
+  /// Memory accounting of the instantiated memories
+  std::shared_ptr<MemoryBudget> MemBudget;
+  /// Execution profile of the interpreted functions
+  std::shared_ptr<Profile> Prof;
+  /// Count of the calls and the loop iterations of the hot functions, which
+  /// is 1 for the lazy JIT
+  uint32_t TieredThreshold;
+  /// Handler of the hot functions in the tiered execution
+  HotFunctionHandler HotHandler;
 
 public:
   /// Callbacks for compiled modules;
@@ -668,6 +827,7 @@ private:
 } // namespace Executor
 } // namespace WasmEdge
 
+#include "engine/atomic.ipp"
 #include "engine/binary_numeric.ipp"
 #include "engine/cast_numeric.ipp"
 #include "engine/memory.ipp"
@@ -21,8 +21,10 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace WasmEdge {
@@ -54,12 +56,21 @@ public:
   /// Set the binary data.
   Expect<void> setCode(std::vector<Byte> CodeData);
 
+  /// Set the binary data as a view of another file manager, starting from the
+  /// offset with the same section limit. The offsets are the same as the
+  /// viewed one, which should outlive this file manager.
+  void setView(const FileMgr &Base, uint64_t Offset);
+
   /// Read one byte.
   Expect<Byte> readByte();
 
   /// Read number of bytes into a vector.
   Expect<std::vector<Byte>> readBytes(size_t SizeToRead);
 
+  /// Read number of bytes as a view into the binary data. The view is valid
+  /// while the binary data is alive, see getFileMap().
+  Expect<Span<const Byte>> readBytesView(size_t SizeToRead);
+
   /// Read an unsigned int.
   Expect<uint32_t> readU32();
 
@@ -81,9 +92,19 @@ public:
   /// Read a string, which is size(unsigned int) + bytes.
   Expect<std::string> readName();
 
+  /// Read a string as a view into the binary data. The view is valid while
+  /// the binary data is alive, see getDataOwner().
+  Expect<std::string_view> readNameView();
+
   /// Get the file header type.
   FileHeader getHeaderType();
 
+  /// Set the current offset to continue reading from.
+  void seek(uint64_t Offset) noexcept {
+    Pos = std::min(Offset, Size);
+    LastPos = Pos;
+  }
+
   /// Get current offset.
   uint64_t getOffset() const noexcept { return Pos; }
 
@@ -93,6 +114,26 @@ public:
   /// Get remain size.
   uint64_t getRemainSize() const noexcept { return Size - Pos; }
 
+  /// Get the mapped file if the binary data is set by a file path, or null.
+  /// Sharing the mapped file keeps the views of the file data valid.
+  std::shared_ptr<MMap> getFileMap() const noexcept { return FileMap; }
+
+  /// Get the owner of the binary data, which is the mapped file or the moved
+  /// vector, or null if the binary data is borrowed.
+  std::shared_ptr<const void> getDataOwner() const noexcept {
+    if (FileMap) {
+      return FileMap;
+    }
+    return DataHolder;
+  }
+
+  /// Check if the binary data is owned. If so, the views can outlive this
+  /// file manager by sharing getDataOwner().
+  bool hasDataOwner() const noexcept { return FileMap || DataHolder; }
+
+  /// Get the whole binary data.
+  Span<const Byte> getData() const noexcept { return {Data, Size}; }
+
   /// Set limit read section size.
   void setSectionSize(uint64_t SecSize) {
     if (likely(UINT64_MAX - Pos >= SecSize)) {
@@ -123,6 +164,9 @@ private:
   /// Helper function for checking boundary.
   Expect<void> testRead(uint64_t Read);
 
+  /// Helper function for checking the read offset after the section end.
+  Expect<void> testSectionEnd();
+
   /// File manager status.
   ErrCode Status = ErrCode::UnexpectedEnd;
 
@@ -144,8 +188,8 @@ private:
 
   /// File or data management.
   const Byte *Data;
-  std::optional<MMap> FileMap;
-  std::optional<std::vector<Byte>> DataHolder;
+  std::shared_ptr<MMap> FileMap;
+  std::shared_ptr<std::vector<Byte>> DataHolder;
 };
 
 } // namespace WasmEdge
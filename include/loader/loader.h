@@ -18,12 +18,16 @@
 #include "common/configure.h"
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "common/workerpool.h"
 #include "loader/filemgr.h"
 #include "loader/ldmgr.h"
+#include "validator/formchecker.h"
 
+#include <bitset>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace WasmEdge {
@@ -93,21 +97,46 @@ public:
   /// Parse module from byte code.
   Expect<std::unique_ptr<AST::Module>> parseModule(Span<const uint8_t> Code);
 
+  /// Parse module from the flat image saved by saveFlatImage().
+  Expect<std::unique_ptr<AST::Module>>
+  parseFlatImage(const std::filesystem::path &FilePath);
+
+  /// Save the validated module as the flat image, which is parsed instead of
+  /// decoding the module binary. The parsed module should be validated again.
+  Expect<void> saveFlatImage(const AST::Module &Mod,
+                             const std::filesystem::path &FilePath);
+
+  /// Get the content of the custom section. If only the range is recorded,
+  /// because the module was parsed from the borrowed binary, the content is
+  /// got from the module binary which the section was parsed from, and the
+  /// binary is checked with the recorded hash of the content. The content is
+  /// valid while the module, or the binary in the latter case, is alive.
+  static Expect<Span<const Byte>>
+  getCustomSectionContent(const AST::CustomSection &Sec,
+                          Span<const uint8_t> Code = {});
+
+  /// Streaming parser of the module binary arriving in chunks.
+  class Stream;
+
 private:
   /// \name Helper functions to print error log when loading AST nodes
   /// @{
   inline auto logLoadError(ErrCode Code, uint64_t Off, ASTNodeAttr Node) {
-    spdlog::error(Code);
-    spdlog::error(ErrInfo::InfoLoading(Off));
-    spdlog::error(ErrInfo::InfoAST(Node));
+    if (!IsWorker) {
+      spdlog::error(Code);
+      spdlog::error(ErrInfo::InfoLoading(Off));
+      spdlog::error(ErrInfo::InfoAST(Node));
+    }
     return Unexpect(Code);
   }
   inline auto logNeedProposal(ErrCode Code, Proposal Prop, uint64_t Off,
                               ASTNodeAttr Node) {
-    spdlog::error(Code);
-    spdlog::error(ErrInfo::InfoProposal(Prop));
-    spdlog::error(ErrInfo::InfoLoading(Off));
-    spdlog::error(ErrInfo::InfoAST(Node));
+    if (!IsWorker) {
+      spdlog::error(Code);
+      spdlog::error(ErrInfo::InfoProposal(Prop));
+      spdlog::error(ErrInfo::InfoLoading(Off));
+      spdlog::error(ErrInfo::InfoAST(Node));
+    }
     return Unexpect(Code);
   }
   Expect<ValType> checkValTypeProposals(ValType VType, uint64_t Off,
@@ -120,9 +149,22 @@ private:
   /// \name Load AST Module functions
   /// @{
   Expect<std::unique_ptr<AST::Module>> loadModule();
+  Expect<void> loadModuleHeader(AST::Module &Mod);
+  Expect<void> loadModuleSections(AST::Module &Mod, std::bitset<0x0DU> &Secs);
+  Expect<void> loadModuleSection(AST::Module &Mod, uint8_t Id,
+                                 std::bitset<0x0DU> &Secs);
+  Expect<void> checkModule(AST::Module &Mod);
   Expect<void> loadCompiled(AST::Module &Mod);
   /// @}
 
+  /// \name Flat image cache functions
+  /// @{
+  Expect<std::unique_ptr<AST::Module>> loadModuleCached();
+  Expect<std::unique_ptr<AST::Module>>
+  loadFlatImage(const std::filesystem::path &FilePath);
+  std::filesystem::path getFlatImageCachePath(Span<const Byte> Code);
+  /// @}
+
   /// \name Load AST section node helper functions
   /// @{
   Expect<uint32_t> loadSectionSize(ASTNodeAttr Node);
@@ -171,6 +213,8 @@ private:
     }
     return {};
   }
+  Expect<void> loadCodeSegmentsParallel(AST::CodeSection &Sec,
+                                        uint32_t Threads);
 
   /// \name Load AST nodes functions
   /// @{
@@ -190,7 +234,9 @@ private:
   static Expect<void> loadSection(FileMgr &VecMgr, AST::AOTSection &Sec);
   Expect<void> loadSegment(AST::GlobalSegment &GlobSeg);
   Expect<void> loadSegment(AST::ElementSegment &ElemSeg);
-  Expect<void> loadSegment(AST::CodeSegment &CodeSeg);
+  Expect<void> loadSegment(AST::CodeSegment &CodeSeg, uint32_t Idx);
+  Expect<void> loadCodeBody(AST::CodeSegment::LocalVec &Locals,
+                            AST::Expression &Expr);
   Expect<void> loadSegment(AST::DataSegment &DataSeg);
   Expect<void> loadDesc(AST::ImportDesc &ImpDesc);
   Expect<void> loadDesc(AST::ExportDesc &ExpDesc);
@@ -201,8 +247,28 @@ private:
   Expect<void> loadType(AST::GlobalType &GlobType);
   Expect<void> loadExpression(AST::Expression &Expr);
   Expect<OpCode> loadOpCode();
-  Expect<AST::InstrVec> loadInstrSeq();
-  Expect<void> loadInstruction(AST::Instruction &Instr);
+  Expect<AST::InstrVec> loadInstrSeq(AST::InstrSideTable &Side);
+  Expect<void> loadInstruction(AST::Instruction &Instr,
+                               AST::InstrSideTable &Side);
+  /// @}
+
+  /// \name Lazy function body decoding
+  /// @{
+  /// Context of decoding the lazy function bodies of a module, which keeps the
+  /// binary data alive.
+  struct LazyContext {
+    LazyContext(const Configure &C, bool HasData,
+                std::shared_ptr<const void> O, Span<const Byte> D) noexcept
+        : Conf(C), HasDataSection(HasData), Owner(std::move(O)), Data(D) {}
+    const Configure Conf;
+    const bool HasDataSection;
+    const std::shared_ptr<const void> Owner;
+    const Span<const Byte> Data;
+  };
+  static Expect<void> loadLazyBody(const LazyContext &Ctx, uint64_t Offset,
+                                   uint32_t Size,
+                                   AST::CodeSegment::LocalVec &Locals,
+                                   AST::Expression &Expr);
   /// @}
 
   /// \name Loader members
@@ -213,6 +279,58 @@ private:
   const AST::Module::IntrinsicsTable *IntrinsicsTable;
   std::recursive_mutex Mutex;
   bool HasDataSection;
+  /// Worker of the parallel decoding, which doesn't log the errors. The
+  /// failed segment is decoded again sequentially to report them.
+  bool IsWorker = false;
+  /// Context of the code section to decode the function bodies lazily.
+  std::shared_ptr<const LazyContext> LazyCtx;
+  /// Checker of the function bodies while decoding them, and the type index
+  /// of the function being decoded and checked.
+  std::optional<Validator::FormChecker> FusedChecker;
+  std::optional<uint32_t> FusedTypeIdx;
+  /// Threads to decode the code segments in parallel, which are created at
+  /// the first parallel decoding and reused by the later ones.
+  std::unique_ptr<WorkerPool> Pool;
+  /// @}
+};
+
+/// Streaming parser which decodes the sections of a module binary as soon as
+/// their bytes arrive, so the decoding overlaps with the I/O.
+class Loader::Stream {
+public:
+  Stream(const Configure &Conf,
+         const AST::Module::IntrinsicsTable *IT = nullptr) noexcept
+      : Ldr(Conf, IT) {}
+
+  /// Push the next chunk of the module binary and decode the completed
+  /// sections.
+  ///
+  /// \param Chunk the next bytes of the module binary.
+  ///
+  /// \returns void if succeeded, error code if any completed section failed.
+  Expect<void> push(Span<const Byte> Chunk);
+
+  /// Decode the remaining bytes and get the module. The stream is reset and
+  /// can be used for the next module.
+  ///
+  /// \returns unique pointer to the module if succeeded, error code if failed.
+  Expect<std::unique_ptr<AST::Module>> finish();
+
+private:
+  /// Reset the stream status.
+  void reset() noexcept;
+
+  /// \name Stream members
+  /// @{
+  Loader Ldr;
+  /// Received bytes of the module binary.
+  std::vector<Byte> Buf;
+  /// Offset of the first not decoded section.
+  uint64_t Decoded = 0;
+  std::unique_ptr<AST::Module> Mod;
+  std::bitset<0x0DU> Secs;
+  /// Error of the decoding, which fails the further pushing.
+  ErrCode Status = ErrCode::Success;
   /// @}
 };
 
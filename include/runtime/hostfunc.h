@@ -35,6 +35,19 @@ public:
                            Span<const ValVariant> Args,
                            Span<ValVariant> Rets) = 0;
 
+  /// Native entry of host functions, which runs the function with the raw
+  /// argument and return arrays. The compiled functions call it directly
+  /// instead of going through the executor.
+  ///
+  /// \returns ErrCode::Success, or the error code to trap with.
+  using NativeEntry = ErrCode (*)(HostFunctionBase *Func,
+                                  Instance::MemoryInstance *MemInst,
+                                  const ValVariant *Args,
+                                  ValVariant *Rets) noexcept;
+
+  /// Getter of the native entry, or nullptr if not supported.
+  NativeEntry getNativeEntry() const noexcept { return Native; }
+
   /// Getter of function type.
   const AST::FunctionType &getFuncType() const { return FuncType; }
 
@@ -44,12 +57,14 @@ public:
 protected:
   AST::FunctionType FuncType;
   const uint64_t Cost;
+  NativeEntry Native = nullptr;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
 public:
   HostFunction(const uint64_t FuncCost = 0) : HostFunctionBase(FuncCost) {
     initializeFuncType();
+    Native = &nativeEntry;
   }
 
   Expect<void> run(Instance::MemoryInstance *MemInst,
@@ -65,6 +80,18 @@ public:
     return invoke(MemInst, Args.first<F::ArgsN>(), Rets.first<F::RetsN>());
   }
 
+  static ErrCode nativeEntry(HostFunctionBase *Func,
+                             Instance::MemoryInstance *MemInst,
+                             const ValVariant *Args,
+                             ValVariant *Rets) noexcept {
+    using F = FuncTraits<decltype(&T::body)>;
+    // The function type is matched with the import when instantiating.
+    auto Res = static_cast<HostFunction *>(Func)->invoke(
+        MemInst, Span<const ValVariant, F::ArgsN>(Args, F::ArgsN),
+        Span<ValVariant, F::RetsN>(Rets, F::RetsN));
+    return Res ? ErrCode::Success : Res.error();
+  }
+
 protected:
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(Instance::MemoryInstance *MemInst, SpanA &&Args,
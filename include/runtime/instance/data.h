@@ -15,7 +15,9 @@
 
 #include "common/span.h"
 #include "common/types.h"
+#include "system/mmap.h"
 
+#include <memory>
 #include <vector>
 
 namespace WasmEdge {
@@ -25,23 +27,42 @@ namespace Instance {
 class DataInstance {
 public:
   DataInstance() = delete;
-  DataInstance(const uint32_t Offset, Span<const Byte> Init)
-      : Off(Offset), Data(Init.begin(), Init.end()) {}
+  DataInstance(const uint64_t Offset, Span<const Byte> Init,
+               std::shared_ptr<MMap> Map = nullptr)
+      : Off(Offset), DataMap(std::move(Map)) {
+    if (DataMap) {
+      // Borrow the data from the mapped module file.
+      DataView = Init;
+    } else {
+      Data.assign(Init.begin(), Init.end());
+    }
+  }
 
   /// Get offset in data instance.
-  uint32_t getOffset() const noexcept { return Off; }
+  uint64_t getOffset() const noexcept { return Off; }
 
   /// Get data in data instance.
-  Span<const Byte> getData() const noexcept { return Data; }
+  Span<const Byte> getData() const noexcept {
+    return DataMap ? DataView : Span<const Byte>(Data);
+  }
+
+  /// Get the mapped module file which the data is borrowed from, or null.
+  const MMap *getDataMap() const noexcept { return DataMap.get(); }
 
   /// Clear data in data instance.
-  void clear() { Data.clear(); }
+  void clear() {
+    Data.clear();
+    DataView = {};
+    DataMap.reset();
+  }
 
 private:
   /// \name Data of data instance.
   /// @{
-  const uint32_t Off;
+  const uint64_t Off;
   std::vector<Byte> Data;
+  Span<const Byte> DataView;
+  std::shared_ptr<MMap> DataMap;
   /// @}
 };
 
@@ -13,11 +13,15 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "ast/expression.h"
 #include "ast/instruction.h"
+#include "ast/module.h"
+#include "ast/segment.h"
 #include "common/symbol.h"
 #include "runtime/hostfunc.h"
 #include "runtime/instance/module.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,17 +34,37 @@ class FunctionInstance {
 public:
   using CompiledFunction = void;
 
+  /// Compiled code of the native function in the tiered execution, which is
+  /// shared by the instances of the owner module.
+  using TieredCode = AST::Module::CompiledCode;
+
   FunctionInstance() = delete;
   /// Move constructor.
   FunctionInstance(FunctionInstance &&Inst) noexcept
       : ModuleAddr(Inst.ModuleAddr), FuncType(Inst.FuncType),
-        Data(std::move(Inst.Data)) {}
-  /// Constructor for native function.
+        Data(std::move(Inst.Data)),
+        HotCount(Inst.HotCount.load(std::memory_order_relaxed)),
+        Tiered(Inst.Tiered.load(std::memory_order_relaxed)),
+        TieredOwner(std::move(Inst.TieredOwner)) {}
+  /// Constructor for native function of the code segment at CodeIdx. The
+  /// locals and instructions are borrowed if the owner module is given, or
+  /// copied otherwise.
   FunctionInstance(const uint32_t ModAddr, const AST::FunctionType &Type,
+                   const uint32_t CodeIdx,
                    Span<const std::pair<uint32_t, ValType>> Locs,
-                   AST::InstrView Expr) noexcept
+                   const AST::Expression &Expr,
+                   std::shared_ptr<const AST::Module> Owner = nullptr) noexcept
+      : ModuleAddr(ModAddr), FuncType(Type),
+        Data(std::in_place_type_t<WasmFunction>(), CodeIdx, Locs, Expr,
+             std::move(Owner)) {}
+  /// Constructor for native function with the lazy function body, which is
+  /// borrowed from the owner module and decoded at the first call.
+  FunctionInstance(const uint32_t ModAddr, const AST::FunctionType &Type,
+                   const uint32_t CodeIdx, const AST::CodeSegment &Seg,
+                   std::shared_ptr<const AST::Module> Owner) noexcept
       : ModuleAddr(ModAddr), FuncType(Type),
-        Data(std::in_place_type_t<WasmFunction>(), Locs, Expr) {}
+        Data(std::in_place_type_t<WasmFunction>(), CodeIdx, Seg,
+             std::move(Owner)) {}
   /// Constructor for compiled function.
   FunctionInstance(const uint32_t ModAddr, const AST::FunctionType &Type,
                    Symbol<CompiledFunction> S) noexcept
@@ -75,15 +99,32 @@ public:
   /// Getter of function type.
   const AST::FunctionType &getFuncType() const { return FuncType; }
 
+  /// Getter of the index of the native function in the code section of its
+  /// module.
+  uint32_t getCodeIdx() const noexcept {
+    return std::get_if<WasmFunction>(&Data)->CodeIdx;
+  }
+
+  /// Decode the lazy function body at the first call. Thread-safe.
+  Expect<void> loadLazyBody() const {
+    if (const auto *Func = std::get_if<WasmFunction>(&Data);
+        Func && Func->LazySeg) {
+      return Func->LazySeg->loadLazyBody();
+    }
+    return {};
+  }
+
   /// Getter of function local variables.
   Span<const std::pair<uint32_t, ValType>> getLocals() const noexcept {
-    return std::get_if<WasmFunction>(&Data)->Locals;
+    const auto *Func = std::get_if<WasmFunction>(&Data);
+    return Func->LazySeg ? Func->LazySeg->getLocals() : Func->Locals;
   }
 
   /// Getter of function body instrs.
   AST::InstrView getInstrs() const noexcept {
-    if (std::holds_alternative<WasmFunction>(Data)) {
-      return std::get<WasmFunction>(Data).Instrs;
+    if (const auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return Func->LazySeg ? Func->LazySeg->getExpr().getInstrs()
+                           : Func->Instrs;
     } else {
       return {};
     }
@@ -99,16 +140,73 @@ public:
     return *std::get_if<std::unique_ptr<HostFunctionBase>>(&Data)->get();
   }
 
+  /// Getter of the module owning the borrowed instructions of the native
+  /// function, or nullptr if copied.
+  std::shared_ptr<const AST::Module> getOwner() const noexcept {
+    if (const auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return Func->Owner;
+    }
+    return nullptr;
+  }
+
+  /// Count a call or a loop iteration of the native function, and return true
+  /// only once when the count reaches the threshold. Thread-safe.
+  bool countHot(const uint32_t Threshold) const noexcept {
+    if (HotCount.load(std::memory_order_relaxed) >= Threshold) {
+      return false;
+    }
+    return HotCount.fetch_add(1, std::memory_order_relaxed) + 1 == Threshold;
+  }
+
+  /// Set the compiled code of the native function, which is run instead of
+  /// the instructions by the later calls. Only set once. Thread-safe.
+  void setTieredCode(std::shared_ptr<const TieredCode> Code) const noexcept {
+    TieredOwner = std::move(Code);
+    Tiered.store(TieredOwner.get(), std::memory_order_release);
+  }
+
+  /// Getter of the compiled code of the native function, or nullptr if not
+  /// compiled yet. Thread-safe.
+  const TieredCode *getTieredCode() const noexcept {
+    return Tiered.load(std::memory_order_acquire);
+  }
+
 private:
   struct WasmFunction {
-    const std::vector<std::pair<uint32_t, ValType>> Locals;
-    AST::InstrVec Instrs;
-    WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
-                 AST::InstrView Expr) noexcept
-        : Locals(Locs.begin(), Locs.end()) {
+    /// Index in the code section of the module.
+    uint32_t CodeIdx;
+    /// Module which owns the borrowed locals and instructions.
+    std::shared_ptr<const AST::Module> Owner;
+    /// Storage of the copied locals and instructions if not borrowed.
+    std::vector<std::pair<uint32_t, ValType>> LocalsBuf;
+    AST::InstrVec InstrsBuf;
+    std::shared_ptr<const AST::InstrSideTable> SideTable;
+    Span<const std::pair<uint32_t, ValType>> Locals;
+    AST::InstrView Instrs;
+    /// Segment of the lazy function body borrowed from the owner.
+    const AST::CodeSegment *LazySeg = nullptr;
+    WasmFunction(const uint32_t Idx, const AST::CodeSegment &Seg,
+                 std::shared_ptr<const AST::Module> O) noexcept
+        : CodeIdx(Idx), Owner(std::move(O)), LazySeg(&Seg) {}
+    WasmFunction(const uint32_t Idx,
+                 Span<const std::pair<uint32_t, ValType>> Locs,
+                 const AST::Expression &Expr,
+                 std::shared_ptr<const AST::Module> O) noexcept
+        : CodeIdx(Idx), Owner(std::move(O)) {
+      if (Owner) {
+        // The loader keeps the capacity larger than the size.
+        Locals = Locs;
+        Instrs = Expr.getInstrs();
+        return;
+      }
+      LocalsBuf.assign(Locs.begin(), Locs.end());
+      // The copied instructions still refer to the side table.
+      SideTable = Expr.getSideTable();
       // FIXME: Modify the capacity to prevent from connection of 2 vectors.
-      Instrs.reserve(Expr.size() + 1);
-      Instrs.assign(Expr.begin(), Expr.end());
+      InstrsBuf.reserve(Expr.getInstrs().size() + 1);
+      InstrsBuf.assign(Expr.getInstrs().begin(), Expr.getInstrs().end());
+      Locals = LocalsBuf;
+      Instrs = InstrsBuf;
     }
   };
 
@@ -120,6 +218,13 @@ private:
                std::unique_ptr<HostFunctionBase>>
       Data;
   /// @}
+
+  /// \name Data of the tiered execution of native function.
+  /// @{
+  mutable std::atomic<uint32_t> HotCount = 0;
+  mutable std::atomic<const TieredCode *> Tiered = nullptr;
+  mutable std::shared_ptr<const TieredCode> TieredOwner;
+  /// @}
 };
 
 } // namespace Instance
@@ -17,13 +17,16 @@
 #include "common/errcode.h"
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "common/memorybudget.h"
 #include "system/allocator.h"
+#include "system/mmap.h"
 
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <utility>
 
@@ -36,67 +39,115 @@ class MemoryInstance {
 public:
   static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
   static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
+  static inline constexpr const uint64_t kMaxPage64 = UINT64_C(1) << 48;
   MemoryInstance() = delete;
   MemoryInstance(MemoryInstance &&Inst) noexcept
-      : MemType(Inst.MemType), DataPtr(Inst.DataPtr),
-        PageLimit(Inst.PageLimit) {
+      : MemType(Inst.MemType), DataPtr(Inst.DataPtr), DataSize(Inst.DataSize),
+        PageLimit(Inst.PageLimit), Budget(std::move(Inst.Budget)),
+        CreateErr(Inst.CreateErr) {
     Inst.DataPtr = nullptr;
   }
   MemoryInstance(const AST::MemoryType &MType,
-                 const uint32_t PageLim = UINT32_C(65536)) noexcept
-      : MemType(MType), PageLimit(PageLim) {
+                 const uint64_t PageLim = UINT32_C(65536),
+                 std::shared_ptr<MemoryBudget> B = nullptr) noexcept
+      : MemType(MType), PageLimit(PageLim), Budget(std::move(B)) {
     if (MemType.getLimit().getMin() > PageLimit) {
       spdlog::error(
           "Create memory instance failed -- exceeded limit page size: {}",
           PageLimit);
+      Budget.reset();
+      CreateErr = ErrCode::MemoryLimitExceeded;
       return;
     }
-    DataPtr = Allocator::allocate(MemType.getLimit().getMin());
-    if (DataPtr == nullptr) {
+    if (Budget && !Budget->charge(MemType.getLimit().getMin())) {
+      spdlog::error(
+          "Create memory instance failed -- exceeded memory budget: {}",
+          Budget->getLimit());
+      Budget.reset();
+      CreateErr = ErrCode::MemoryLimitExceeded;
+      return;
+    }
+    if (is64()) {
+      DataPtr = Allocator::allocate64(MemType.getLimit().getMin(),
+                                      getReservedPageSize());
+    } else {
+      DataPtr = Allocator::allocate(
+          static_cast<uint32_t>(MemType.getLimit().getMin()));
+    }
+    // The fallback allocator may return null for a memory with no pages.
+    if (DataPtr == nullptr &&
+        (Allocator::isPageMapped() || MemType.getLimit().getMin() > 0)) {
       spdlog::error("Unable to find usable memory address");
+      if (Budget) {
+        Budget->release(MemType.getLimit().getMin());
+        Budget.reset();
+      }
+      CreateErr = ErrCode::MemoryAllocFailed;
       return;
     }
+    DataSize = MemType.getLimit().getMin() * kPageSize;
   }
   ~MemoryInstance() noexcept {
-    Allocator::release(DataPtr, MemType.getLimit().getMin());
+    if (Budget) {
+      Budget->release(MemType.getLimit().getMin());
+    }
+    if (is64()) {
+      Allocator::release64(DataPtr, getReservedPageSize());
+    } else {
+      Allocator::release(DataPtr,
+                         static_cast<uint32_t>(MemType.getLimit().getMin()));
+    }
   }
 
   /// Get page size of memory.data
-  uint32_t getPageSize() const noexcept {
-    // The memory page size is binded with the limit in memory type.
-    return MemType.getLimit().getMin();
+  uint64_t getPageSize() const noexcept {
+    // Read from the data size, which is published after growing the shared
+    // memories on the other threads.
+    return getDataSize() / kPageSize;
   }
 
   /// Getter of memory type.
   const AST::MemoryType &getMemoryType() const { return MemType; }
 
+  /// Check the memory is shared between threads.
+  bool isShared() const noexcept { return MemType.getLimit().isShared(); }
+
+  /// Check the memory is indexed by 64-bit addresses.
+  bool is64() const noexcept { return MemType.getLimit().is64(); }
+
   /// Check access size is valid.
-  bool checkAccessBound(uint32_t Offset, uint32_t Length) const noexcept {
-    const uint64_t AccessLen =
-        static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length);
-    return AccessLen <= MemType.getLimit().getMin() * kPageSize;
+  bool checkAccessBound(uint64_t Offset, uint64_t Length) const noexcept {
+    // Avoid the overflow of the 64-bit addresses.
+    const uint64_t Size = getDataSize();
+    return Length <= Size && Offset <= Size - Length;
   }
 
   /// Get boundary index.
-  uint32_t getBoundIdx() const noexcept {
-    return MemType.getLimit().getMin() > 0
-               ? MemType.getLimit().getMin() * kPageSize - 1
-               : 0;
+  uint64_t getBoundIdx() const noexcept {
+    const uint64_t Size = getDataSize();
+    return Size > 0 ? Size - 1 : 0;
   }
 
-  /// Grow page
-  bool growPage(const uint32_t Count) {
+  /// Grow page. The shared memories can be grown and accessed concurrently:
+  /// the pages are mapped in place, and the new data size is published after
+  /// them.
+  bool growPage(const uint64_t Count) {
     if (Count == 0) {
       return true;
     }
-    // Maximum pages count, 65536
-    uint32_t MaxPageCaped = k4G / kPageSize;
-    uint32_t Min = MemType.getLimit().getMin();
-    uint32_t Max = MemType.getLimit().getMax();
+    // Shared memories can be grown by several threads at the same time.
+    std::unique_lock<std::mutex> Lock(GrowMutex, std::defer_lock);
+    if (isShared()) {
+      Lock.lock();
+    }
+    // Maximum pages count, 65536 for 32-bit memories and 2^48 for 64-bit.
+    uint64_t MaxPageCaped = is64() ? kMaxPage64 : k4G / kPageSize;
+    const uint64_t Min = MemType.getLimit().getMin();
+    const uint64_t Max = MemType.getLimit().getMax();
     if (MemType.getLimit().hasMax()) {
       MaxPageCaped = std::min(Max, MaxPageCaped);
     }
-    if (Count + Min > MaxPageCaped) {
+    if (Count > MaxPageCaped - Min) {
       return false;
     }
     if (Count + Min > PageLimit) {
@@ -104,19 +155,28 @@ public:
                     PageLimit);
       return false;
     }
+    if (Budget && !Budget->charge(Count)) {
+      spdlog::error("Memory grow page failed -- exceeded memory budget: {}",
+                    Budget->getLimit());
+      return false;
+    }
     if (auto NewPtr = Allocator::resize(DataPtr, Min, Min + Count);
         NewPtr == nullptr) {
+      if (Budget) {
+        Budget->release(Count);
+      }
       return false;
     } else {
       DataPtr = NewPtr;
     }
     MemType.getLimit().setMin(Min + Count);
+    __atomic_store_n(&DataSize, (Min + Count) * kPageSize, __ATOMIC_RELEASE);
     return true;
   }
 
   /// Get slice of Data[Offset : Offset + Length - 1]
-  Expect<Span<Byte>> getBytes(const uint32_t Offset,
-                              const uint32_t Length) const noexcept {
+  Expect<Span<Byte>> getBytes(const uint64_t Offset,
+                              const uint64_t Length) const noexcept {
     // Check the memory boundary.
     if (!checkAccessBound(Offset, Length)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -127,8 +187,8 @@ public:
   }
 
   /// Replace the bytes of Data[Offset :] by Slice[Start : Start + Legnth - 1]
-  Expect<void> setBytes(Span<const Byte> Slice, const uint32_t Offset,
-                        const uint32_t Start, const uint32_t Length) {
+  Expect<void> setBytes(Span<const Byte> Slice, const uint64_t Offset,
+                        const uint64_t Start, const uint64_t Length) {
     // Check the memory boundary.
     if (!checkAccessBound(Offset, Length)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -151,9 +211,41 @@ public:
     return {};
   }
 
+  /// Replace the bytes of Data[Offset :] by Slice, which is a view into the
+  /// mapped file Map. The whole pages covered by the slice are mapped from the
+  /// file copy-on-write if the file offset and Offset are equally aligned.
+  Expect<void> setBytes(const MMap &Map, Span<const Byte> Slice,
+                        const uint64_t Offset) {
+    // Check the memory boundary.
+    if (!checkAccessBound(Offset, Slice.size())) {
+      spdlog::error(ErrCode::MemoryOutOfBounds);
+      spdlog::error(ErrInfo::InfoBoundary(Offset, Slice.size(), getBoundIdx()));
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+
+    const uint64_t Page = MMap::pageSize();
+    const uint64_t FileOff = static_cast<uint64_t>(
+        Slice.data() - reinterpret_cast<const Byte *>(Map.address()));
+    if (Allocator::isPageMapped() && FileOff % Page == Offset % Page &&
+        reinterpret_cast<uintptr_t>(DataPtr) % Page == 0) {
+      const uint64_t Head = (Page - Offset % Page) % Page;
+      const uint64_t Body =
+          Slice.size() > Head ? (Slice.size() - Head) / Page * Page : 0;
+      if (Body > 0 &&
+          Map.mapPrivate(DataPtr + Offset + Head, FileOff + Head, Body)) {
+        // Copy the partial pages at both ends.
+        std::copy(Slice.begin(), Slice.begin() + Head, DataPtr + Offset);
+        std::copy(Slice.begin() + Head + Body, Slice.end(),
+                  DataPtr + Offset + Head + Body);
+        return {};
+      }
+    }
+    return setBytes(Slice, Offset, 0, Slice.size());
+  }
+
   /// Fill the bytes of Data[Offset : Offset + Length - 1] by Val.
-  Expect<void> fillBytes(const uint8_t Val, const uint32_t Offset,
-                         const uint32_t Length) {
+  Expect<void> fillBytes(const uint8_t Val, const uint64_t Offset,
+                         const uint64_t Length) {
     // Check the memory boundary.
     if (!checkAccessBound(Offset, Length)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -169,8 +261,8 @@ public:
   }
 
   /// Get an uint8 array from Data[Offset : Offset + Length - 1]
-  Expect<void> getArray(uint8_t *Arr, const uint32_t Offset,
-                        const uint32_t Length,
+  Expect<void> getArray(uint8_t *Arr, const uint64_t Offset,
+                        const uint64_t Length,
                         const bool IsReverse = false) const noexcept {
     // Check the memory boundary.
     if (!checkAccessBound(Offset, Length)) {
@@ -190,8 +282,8 @@ public:
   }
 
   /// Replace Data[Offset : Offset + Length - 1] to an uint8 array
-  Expect<void> setArray(const uint8_t *Arr, const uint32_t Offset,
-                        const uint32_t Length, const bool IsReverse = false) {
+  Expect<void> setArray(const uint8_t *Arr, const uint64_t Offset,
+                        const uint64_t Length, const bool IsReverse = false) {
     // Check the memory boundary.
     if (!checkAccessBound(Offset, Length)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -212,7 +304,7 @@ public:
   /// Get pointer to specific offset of memory or null.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
-  getPointerOrNull(const uint32_t Offset) const {
+  getPointerOrNull(const uint64_t Offset) const {
     if (Offset == 0 ||
         !checkAccessBound(Offset, sizeof(std::remove_pointer_t<T>))) {
       return nullptr;
@@ -223,9 +315,9 @@ public:
   /// Get pointer to specific offset of memory.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
-  getPointer(const uint32_t Offset, const uint32_t Size = 1) const {
+  getPointer(const uint64_t Offset, const uint32_t Size = 1) const {
     using Type = std::remove_pointer_t<T>;
-    uint32_t ByteSize = static_cast<uint32_t>(sizeof(Type)) * Size;
+    const uint64_t ByteSize = static_cast<uint64_t>(sizeof(Type)) * Size;
     if (!checkAccessBound(Offset, ByteSize)) {
       return nullptr;
     }
@@ -245,8 +337,8 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T>
   typename std::enable_if_t<IsWasmNumV<T>, Expect<void>>
-  loadValue(T &Value, const uint32_t Offset,
-            const uint32_t Length) const noexcept {
+  loadValue(T &Value, const uint64_t Offset,
+            const uint64_t Length) const noexcept {
     // Check the data boundary.
     if (Length > sizeof(T)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -299,7 +391,7 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T>
   typename std::enable_if_t<IsWasmNativeNumV<T>, Expect<void>>
-  storeValue(const T &Value, const uint32_t Offset, const uint32_t Length) {
+  storeValue(const T &Value, const uint64_t Offset, const uint64_t Length) {
     // Check the data boundary.
     if (Length > sizeof(T)) {
       spdlog::error(ErrCode::MemoryOutOfBounds);
@@ -322,12 +414,40 @@ public:
 
   uint8_t *getDataPtr() const noexcept { return DataPtr; }
 
+  /// Get the error of creating the memory instance, or Success if created.
+  ErrCode getCreateError() const noexcept { return CreateErr; }
+
+  /// Get the pointer to the data size in bytes for the bound checks in the
+  /// compiled functions.
+  const uint64_t *getDataSizePtr() const noexcept { return &DataSize; }
+
 private:
+  /// Get the data size in bytes, which is grown concurrently in the shared
+  /// memories.
+  uint64_t getDataSize() const noexcept {
+    return __atomic_load_n(&DataSize, __ATOMIC_ACQUIRE);
+  }
+
+  /// Get the reserved page size of the 64-bit memories. The 64-bit memories
+  /// are always bound checked, so no guard region is reserved.
+  uint64_t getReservedPageSize() const noexcept {
+    if (MemType.getLimit().hasMax()) {
+      return std::min(MemType.getLimit().getMax(),
+                      static_cast<uint64_t>(PageLimit));
+    }
+    return PageLimit;
+  }
+
   /// \name Data of memory instance.
   /// @{
   AST::MemoryType MemType;
   uint8_t *DataPtr = nullptr;
-  const uint32_t PageLimit;
+  uint64_t DataSize = 0;
+  const uint64_t PageLimit;
+  /// The budget charged with the pages, or null if not accounted.
+  std::shared_ptr<MemoryBudget> Budget;
+  ErrCode CreateErr = ErrCode::Success;
+  std::mutex GrowMutex;
   /// @}
 };
 
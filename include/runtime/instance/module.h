@@ -272,13 +272,40 @@ public:
     return {StartAddr};
   }
 
+  /// Getter and setter of the hash of the module binary, which keys the
+  /// counters of the execution profile.
+  uint64_t getHash() const noexcept { return Hash; }
+  void setHash(const uint64_t H) noexcept { Hash = H; }
+
   /// Module Instance address in store manager.
   uint32_t Addr;
 
   /// \name Data for compiled functions.
+  /// They are sized in the instantiation of this module and never resized
+  /// since then, because the import entries of the compiled functions of the
+  /// other modules keep the pointers to them.
   /// @{
   std::vector<uint8_t *> MemoryPtrs;
+  std::vector<const uint64_t *> MemorySizePtrs;
   std::vector<ValVariant *> GlobalPtrs;
+  /// Entries of the imported functions called directly by the compiled
+  /// functions. The native entries of the host functions are called with the
+  /// host function and the memory instance. The symbols of the compiled
+  /// functions of the other modules are called with the execution context
+  /// switched to the data of their modules. All null for the other imports,
+  /// which are called through the executor.
+  struct FuncImportEntry {
+    void *Entry;
+    void *Func;
+    void *Memory;
+    void *Symbol;
+    uint8_t *const *Memories;
+    ValVariant *const *Globals;
+    const uint64_t *const *MemorySizes;
+    const FuncImportEntry *FuncImports;
+    uint32_t ModuleAddr;
+  };
+  std::vector<FuncImportEntry> FuncImportEntries;
   /// @}
 
 private:
@@ -340,6 +367,9 @@ private:
   /// Start function address
   bool HasStartFunc = false;
   uint32_t StartAddr;
+
+  /// Hash of the module binary.
+  uint64_t Hash = 0;
 };
 
 } // namespace Instance
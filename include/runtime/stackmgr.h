@@ -21,6 +21,10 @@
 namespace WasmEdge {
 namespace Runtime {
 
+namespace Instance {
+class FunctionInstance;
+} // namespace Instance
+
 class StackManager {
 public:
   struct Label {
@@ -37,14 +41,16 @@ public:
   struct Frame {
     Frame() = delete;
     Frame(const uint32_t Addr, const uint32_t VS, const uint32_t LS,
-          const uint32_t A, const bool Dummy = false)
+          const uint32_t A, const bool Dummy = false,
+          const Instance::FunctionInstance *F = nullptr)
         : ModAddr(Addr), VStackOff(VS), LStackOff(LS), Arity(A),
-          IsDummy(Dummy) {}
+          IsDummy(Dummy), Func(F) {}
     uint32_t ModAddr;
     uint32_t VStackOff;
     uint32_t LStackOff;
     uint32_t Arity;
     bool IsDummy;
+    const Instance::FunctionInstance *Func;
   };
 
   using Value = ValVariant;
@@ -87,9 +93,10 @@ public:
 
   /// Push a new frame entry to stack.
   void pushFrame(const uint32_t ModuleAddr, const uint32_t LocalNum = 0,
-                 const uint32_t ArityNum = 0) {
+                 const uint32_t ArityNum = 0,
+                 const Instance::FunctionInstance *Func = nullptr) {
     FrameStack.emplace_back(ModuleAddr, ValueStack.size() - LocalNum,
-                            LabelStack.size(), ArityNum);
+                            LabelStack.size(), ArityNum, false, Func);
   }
 
   /// Push a dummy frame for invokation base.
@@ -143,6 +150,12 @@ public:
   /// Unsafe getter of module address.
   uint32_t getModuleAddr() const { return FrameStack.back().ModAddr; }
 
+  /// Unsafe getter of the native function of the top frame, or nullptr if not
+  /// pushed by a native function.
+  const Instance::FunctionInstance *getFunction() const {
+    return FrameStack.back().Func;
+  }
+
   /// Unsafe getter for stack offset of local values by index.
   uint32_t getOffset(uint32_t Idx) const {
     return FrameStack.back().VStackOff + Idx;
@@ -20,10 +20,20 @@ namespace WasmEdge {
 class Allocator {
 public:
   static uint8_t *allocate(uint32_t PageCount) noexcept;
-  static uint8_t *resize(uint8_t *Pointer, uint32_t OldPageCount,
-                         uint32_t NewPageCount) noexcept;
+  static uint8_t *resize(uint8_t *Pointer, uint64_t OldPageCount,
+                         uint64_t NewPageCount) noexcept;
   static void release(uint8_t *Pointer, uint32_t PageCount) noexcept;
 
+  /// Allocate and release the 64-bit memories. The address space of the
+  /// maximum pages is reserved without guard regions.
+  static uint8_t *allocate64(uint64_t PageCount,
+                             uint64_t ReservedPageCount) noexcept;
+  static void release64(uint8_t *Pointer, uint64_t ReservedPageCount) noexcept;
+
+  /// Check the memories are mapped by pages of the virtual memory, so the
+  /// committed pages can be replaced by file mappings in place.
+  static bool isPageMapped() noexcept;
+
   static uint8_t *allocate_chunk(uint64_t Size) noexcept;
   static void release_chunk(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_executable(uint8_t *Pointer, uint64_t Size) noexcept;
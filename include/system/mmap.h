@@ -16,8 +16,19 @@
 
 #include "common/filesystem.h"
 
+#include <cstdint>
+
 namespace WasmEdge {
 
+/// Read-only mapping of a whole file. The file must not be truncated or
+/// written while mapped, since the views of it and the pages mapped by
+/// mapPrivate() are backed by the file. A shared advisory lock (flock) is held
+/// on POSIX systems, and the mapping fails if the file is locked exclusively.
+/// The lock is advisory only: it keeps out the writers taking an exclusive
+/// lock, but not the others. Truncating the file by such a writer raises
+/// SIGBUS on the next access of the mapped pages, which is a hard limitation
+/// of mapping the files not controlled by the runtime. On Windows the file is
+/// opened without sharing the write access.
 class MMap {
 public:
   MMap(const std::filesystem::path &Path) noexcept;
@@ -25,6 +36,16 @@ public:
   void *address() const noexcept;
   static bool supported() noexcept;
 
+  /// Get the page size of the operating system.
+  static uint64_t pageSize() noexcept;
+
+  /// Map the file pages of [Offset, Offset + Size) to Target as private
+  /// copy-on-write pages. Target, Offset and Size should be page aligned, and
+  /// the mapping replaces the pages at Target.
+  ///
+  /// \returns true if mapped, false if failed or not supported.
+  bool mapPrivate(void *Target, uint64_t Offset, uint64_t Size) const noexcept;
+
 private:
   void *Handle;
 };
@@ -17,10 +17,13 @@
 #include "ast/instruction.h"
 #include "ast/module.h"
 #include "common/errcode.h"
+#include "common/errinfo.h"
+#include "common/log.h"
 #include "common/span.h"
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -50,13 +53,51 @@ static inline constexpr bool isRefType(const VType V) {
 
 class FormChecker {
 public:
-  FormChecker() = default;
+  /// Module context of checking the function bodies. It is read-only after
+  /// the module-level sections are checked, so it is shared by the copies of
+  /// the checker and copied when added again.
+  struct ModuleContext {
+    std::vector<std::pair<std::vector<VType>, std::vector<VType>>> Types;
+    std::vector<uint32_t> Funcs;
+    std::vector<RefType> Tables;
+    std::vector<VType> Mems;
+    std::vector<std::pair<VType, ValMut>> Globals;
+    std::vector<RefType> Elems;
+    std::vector<uint32_t> Datas;
+    std::unordered_set<uint32_t> Refs;
+    uint32_t NumImportFuncs = 0;
+    uint32_t NumImportGlobals = 0;
+  };
+
+  FormChecker() : Ctx(std::make_shared<ModuleContext>()) {}
   ~FormChecker() = default;
 
   void reset(bool CleanGlobal = false);
   Expect<void> validate(AST::InstrView Instrs, Span<const ValType> RetVals);
   Expect<void> validate(AST::InstrView Instrs, Span<const VType> RetVals);
 
+  /// Add the contexts of the module for checking the function bodies, which
+  /// are the sections before the code section. The sections are not
+  /// validated, and the data count is got from the data count section.
+  void addModuleContext(const AST::Module &Mod);
+
+  /// Start checking the function body instruction by instruction, which is
+  /// used to check the instructions while decoding them.
+  void startFunction(uint32_t TypeIdx,
+                     Span<const std::pair<uint32_t, ValType>> Locals);
+  Expect<void> checkNext(const AST::Instruction &Instr) {
+    return checkInstr(Instr);
+  }
+
+  /// Create the checker of a worker, which shares the module context and
+  /// doesn't log the errors.
+  FormChecker createWorker() const {
+    FormChecker Worker;
+    Worker.Ctx = Ctx;
+    Worker.IsWorker = true;
+    return Worker;
+  }
+
   /// Adder of contexts
   void addType(const AST::FunctionType &Func);
   void addFunc(const uint32_t TypeIdx, const bool IsImport = false);
@@ -70,13 +111,13 @@ public:
   void addLocal(const VType &V);
 
   std::vector<VType> result() { return ValStack; }
-  auto &getTypes() { return Types; }
-  auto &getFunctions() { return Funcs; }
-  auto &getTables() { return Tables; }
-  auto &getMemories() { return Mems; }
-  auto &getGlobals() { return Globals; }
-  uint32_t getNumImportFuncs() const { return NumImportFuncs; }
-  uint32_t getNumImportGlobals() const { return NumImportGlobals; }
+  const auto &getTypes() const { return Ctx->Types; }
+  const auto &getFunctions() const { return Ctx->Funcs; }
+  const auto &getTables() const { return Ctx->Tables; }
+  const auto &getMemories() const { return Ctx->Mems; }
+  const auto &getGlobals() const { return Ctx->Globals; }
+  uint32_t getNumImportFuncs() const { return Ctx->NumImportFuncs; }
+  uint32_t getNumImportGlobals() const { return Ctx->NumImportGlobals; }
 
   /// Helper function
   VType ASTToVType(const ValType &V);
@@ -126,19 +167,23 @@ private:
   Expect<void> unreachable();
   Expect<void> StackTrans(Span<const VType> Take, Span<const VType> Put);
 
+  /// Helper functions of logging, which are silent for the workers.
+  template <typename T> void logError(T &&Info) const {
+    if (!IsWorker) {
+      spdlog::error(std::forward<T>(Info));
+    }
+  }
+  Unexpected<ErrCode> logOutOfRange(ErrCode Code, ErrInfo::IndexCategory Cate,
+                                    uint32_t Idx, uint32_t Bound) const;
+
+  /// Get the module context to add into, which is copied if shared.
+  ModuleContext &getMutableContext();
+
   /// Contexts.
-  std::vector<std::pair<std::vector<VType>, std::vector<VType>>> Types;
-  std::vector<uint32_t> Funcs;
-  std::vector<RefType> Tables;
-  uint32_t Mems = 0;
-  std::vector<std::pair<VType, ValMut>> Globals;
-  std::vector<RefType> Elems;
-  std::vector<uint32_t> Datas;
-  std::unordered_set<uint32_t> Refs;
-  uint32_t NumImportFuncs = 0;
-  uint32_t NumImportGlobals = 0;
+  std::shared_ptr<ModuleContext> Ctx;
   std::vector<VType> Locals;
   std::vector<VType> Returns;
+  bool IsWorker = false;
 
   /// Running stack.
   std::vector<CtrlFrame> CtrlStack;
@@ -16,6 +16,7 @@
 
 #include "ast/module.h"
 #include "common/configure.h"
+#include "common/workerpool.h"
 #include "validator/formchecker.h"
 
 #include <cstdint>
@@ -59,6 +60,9 @@ private:
   Expect<void> validate(const AST::GlobalSection &GlobSec);
   Expect<void> validate(const AST::ElementSection &ElemSec);
   Expect<void> validate(const AST::CodeSection &CodeSec);
+  /// Validate the function bodies by the threads, and return the count of the
+  /// leading functions which are valid and not lazy.
+  uint32_t validateParallel(const AST::CodeSection &CodeSec, uint32_t Threads);
   Expect<void> validate(const AST::DataSection &DataSec);
   Expect<void> validate(const AST::StartSection &StartSec);
   Expect<void> validate(const AST::ExportSection &ExportSec);
@@ -68,10 +72,14 @@ private:
                                  Span<const ValType> Returns);
 
   static inline const uint32_t LIMIT_MEMORYTYPE = 1U << 16;
+  static inline const uint64_t LIMIT_MEMORYTYPE64 = UINT64_C(1) << 48;
   /// Proposal configure
   const Configure Conf;
   /// Formal checker
   FormChecker Checker;
+  /// Threads to validate the function bodies in parallel, which are created
+  /// at the first parallel validation and reused by the later ones.
+  std::unique_ptr<WorkerPool> Pool;
 };
 
 } // namespace Validator
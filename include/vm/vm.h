@@ -25,12 +25,15 @@
 #include "runtime/importobj.h"
 #include "runtime/storemgr.h"
 
+#include <condition_variable>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,7 +47,9 @@ public:
   VM() = delete;
   VM(const Configure &Conf);
   VM(const Configure &Conf, Runtime::StoreManager &S);
-  ~VM() = default;
+  /// Wait for the background compilations of the AOT cache, and the running
+  /// compilation of the hot functions.
+  ~VM();
 
   /// ======= Functions can be called before instantiated stage. =======
   /// Register wasm modules and host modules.
@@ -62,6 +67,11 @@ public:
     std::unique_lock Lock(Mutex);
     return unsafeRegisterModule(Name, Module);
   }
+  Expect<void> registerModule(std::string_view Name,
+                              std::shared_ptr<const AST::Module> Module) {
+    std::unique_lock Lock(Mutex);
+    return unsafeRegisterModule(Name, std::move(Module));
+  }
   Expect<void> registerModule(const Runtime::ImportObject &Obj) {
     std::unique_lock Lock(Mutex);
     return unsafeRegisterModule(Obj);
@@ -89,6 +99,13 @@ public:
     std::unique_lock Lock(Mutex);
     return unsafeRunWasmFile(Module, Func, Params, ParamTypes);
   }
+  Expect<std::vector<std::pair<ValVariant, ValType>>>
+  runWasmFile(std::shared_ptr<const AST::Module> Module, std::string_view Func,
+              Span<const ValVariant> Params = {},
+              Span<const ValType> ParamTypes = {}) {
+    std::unique_lock Lock(Mutex);
+    return unsafeRunWasmFile(std::move(Module), Func, Params, ParamTypes);
+  }
 
   Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
   asyncRunWasmFile(const std::filesystem::path &Path, std::string_view Func,
@@ -102,8 +119,14 @@ public:
   asyncRunWasmFile(const AST::Module &Module, std::string_view Func,
                    Span<const ValVariant> Params = {},
                    Span<const ValType> ParamTypes = {});
+  Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+  asyncRunWasmFile(std::shared_ptr<const AST::Module> Module,
+                   std::string_view Func, Span<const ValVariant> Params = {},
+                   Span<const ValType> ParamTypes = {});
 
-  /// Load given wasm file, wasm bytecode, or wasm module.
+  /// Load given wasm file, wasm bytecode, or wasm module. The shared module
+  /// is referenced instead of copied, and the instantiated functions borrow
+  /// its instructions.
   Expect<void> loadWasm(const std::filesystem::path &Path) {
     std::unique_lock Lock(Mutex);
     return unsafeLoadWasm(Path);
@@ -116,6 +139,10 @@ public:
     std::unique_lock Lock(Mutex);
     return unsafeLoadWasm(Module);
   }
+  Expect<void> loadWasm(std::shared_ptr<const AST::Module> Module) {
+    std::unique_lock Lock(Mutex);
+    return unsafeLoadWasm(std::move(Module));
+  }
 
   /// ======= Functions can be called after loaded stage. =======
   /// Validate loaded wasm module.
@@ -191,6 +218,11 @@ public:
   /// Getter of statistics.
   Statistics::Statistics &getStatistics() { return Stat; }
 
+  /// Getter of the memory accounting of this VM.
+  const MemoryBudget &getMemoryBudget() const {
+    return ExecutorEngine.getMemoryBudget();
+  }
+
 private:
   Expect<void> unsafeRegisterModule(std::string_view Name,
                                     const std::filesystem::path &Path);
@@ -198,6 +230,8 @@ private:
                                     Span<const Byte> Code);
   Expect<void> unsafeRegisterModule(std::string_view Name,
                                     const AST::Module &Module);
+  Expect<void> unsafeRegisterModule(std::string_view Name,
+                                    std::shared_ptr<const AST::Module> Module);
   Expect<void> unsafeRegisterModule(const Runtime::ImportObject &Obj);
 
   Expect<std::vector<std::pair<ValVariant, ValType>>>
@@ -212,12 +246,19 @@ private:
   unsafeRunWasmFile(const AST::Module &Module, std::string_view Func,
                     Span<const ValVariant> Params = {},
                     Span<const ValType> ParamTypes = {});
+  Expect<std::vector<std::pair<ValVariant, ValType>>>
+  unsafeRunWasmFile(std::shared_ptr<const AST::Module> Module,
+                    std::string_view Func, Span<const ValVariant> Params = {},
+                    Span<const ValType> ParamTypes = {});
 
   Expect<void> unsafeLoadWasm(const std::filesystem::path &Path);
   Expect<void> unsafeLoadWasm(Span<const Byte> Code);
   Expect<void> unsafeLoadWasm(const AST::Module &Module);
+  Expect<void> unsafeLoadWasm(std::shared_ptr<const AST::Module> Module);
 
   Expect<void> unsafeValidate();
+  /// Validate the module and save its flat image if requested by the loader.
+  Expect<void> unsafeValidate(const AST::Module &Module);
 
   Expect<void> unsafeInstantiate();
 
@@ -242,6 +283,36 @@ private:
 
   void unsafeInitVM();
 
+  /// Helper functions to parse the module, or load its compiled library if
+  /// found in the AOT cache.
+  Expect<std::unique_ptr<AST::Module>>
+  unsafeParseModule(const std::filesystem::path &Path);
+  Expect<std::unique_ptr<AST::Module>> unsafeParseModule(Span<const Byte> Code);
+  Expect<std::unique_ptr<AST::Module>>
+  unsafeParseModule(Span<const Byte> Code, const std::filesystem::path *Path);
+
+  /// Compile the parsed module in process if the JIT is enabled.
+  void unsafeCompileJIT(AST::Module &Mod);
+
+  /// Compile the hot function in background for the tiered execution, or at
+  /// its first call for the lazy JIT.
+  void unsafeCompileHotFunction(
+      Runtime::StoreManager &StoreMgr,
+      const Runtime::Instance::FunctionInstance &Func);
+
+  /// Compile the queued hot functions in background, which are batched by
+  /// their modules.
+  void runHotWorker();
+
+  /// Drop the queued hot functions and the running compilation before the
+  /// store is reset.
+  void unsafeCancelHotCompilations();
+
+  /// Compile the WASM binary into the AOT cache in background. The
+  /// compilation is shared by the VMs in the process, and is not waited for.
+  void unsafeCompileInBackground(Span<const Byte> Code,
+                                 std::filesystem::path CachePath);
+
   /// Helper function for execution.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   unsafeExecute(Runtime::Instance::ModuleInstance *ModInst,
@@ -261,10 +332,34 @@ private:
   Executor::Executor ExecutorEngine;
 
   /// VM Storage.
-  std::unique_ptr<AST::Module> Mod;
+  std::shared_ptr<const AST::Module> Mod;
   std::unique_ptr<Runtime::StoreManager> Store;
   Runtime::StoreManager &StoreRef;
   std::map<HostRegistration, std::unique_ptr<Runtime::ImportObject>> ImpObjs;
+
+  /// Hot function queued for the background compilation. The function
+  /// instance is looked up again by the module address and the code index
+  /// after compiled, since the store may be reset meanwhile.
+  struct HotFunction {
+    std::shared_ptr<const AST::Module> Owner;
+    uint32_t ModuleAddr;
+    uint32_t CodeIdx;
+    /// Generation of the store when queued.
+    uint64_t Generation;
+  };
+  /// Background worker of the hot functions, started at the first request.
+  std::thread HotWorker;
+  std::vector<HotFunction> HotQueue;
+  /// Generation of the store, increased before every reset of the store.
+  uint64_t HotGeneration = 0;
+  bool HotStopped = false;
+  std::mutex HotMutex;
+  std::condition_variable HotCond;
+
+  /// Look up the queued hot function again in the store, or nullptr if it is
+  /// gone. The HotMutex should be locked.
+  Runtime::Instance::FunctionInstance *
+  findHotFunction(const HotFunction &Hot);
 };
 
 } // namespace VM
@@ -3,6 +3,7 @@
 
 #include "aot/compiler.h"
 
+#include "aot/cache.h"
 #include "aot/version.h"
 #include "common/defines.h"
 #include "common/filesystem.h"
@@ -10,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <charconv>
 #include <cinttypes>
 #include <cstdint>
@@ -17,12 +19,20 @@
 #include <limits>
 #include <lld/Common/Driver.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/MC/SubtargetFeature.h>
 #include <llvm/Object/ObjectFile.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/ProfileCommon.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/TargetRegistry.h>
@@ -30,11 +40,16 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 #if WASMEDGE_OS_WINDOWS
 #include <llvm/Object/COFF.h>
@@ -133,6 +148,9 @@ static inline constexpr const bool kForceUnalignment = true;
 // force checking div/rem on zero
 static inline constexpr const bool kForceDivCheck = true;
 
+// partition count of the incrementally cached compilation
+static inline constexpr const uint32_t kCachePartitions = 64;
+
 // Size of a ValVariant
 static inline constexpr const uint32_t kValSize = sizeof(WasmEdge::ValVariant);
 
@@ -225,6 +243,7 @@ struct WasmEdge::AOT::Compiler::CompileContext {
   llvm::PointerType *Int32PtrTy;
   llvm::PointerType *Int64PtrTy;
   llvm::PointerType *Int128PtrTy;
+  llvm::StructType *FuncImportTy;
   llvm::StructType *ExecCtxTy;
   llvm::PointerType *ExecCtxPtrTy;
   llvm::ArrayType *IntrinsicsTableTy;
@@ -271,6 +290,15 @@ struct WasmEdge::AOT::Compiler::CompileContext {
                          const WasmEdge::AST::CodeSegment *>>
       Functions;
   std::vector<llvm::Type *> Globals;
+  std::vector<bool> IsMemory64;
+  /// Flags of the functions in the code section to compile, or empty for all.
+  /// The others call through the executor.
+  std::vector<bool> CompiledCodes;
+  /// Flags of the types of the compiled functions, whose wrappers are
+  /// compiled, or empty for all.
+  std::vector<bool> CompiledTypes;
+  /// Hash of the module binary, which keys the counters in the profile.
+  uint64_t ModuleHash = 0;
   llvm::GlobalVariable *IntrinsicsTable;
   llvm::Function *Trap;
   CompileContext(llvm::Module &M, bool IsGenericBinary)
@@ -294,6 +322,22 @@ struct WasmEdge::AOT::Compiler::CompileContext {
         Int32PtrTy(llvm::Type::getInt32PtrTy(LLContext)),
         Int64PtrTy(Int64Ty->getPointerTo()),
         Int128PtrTy(Int128Ty->getPointerTo()),
+        FuncImportTy(llvm::StructType::create(
+            "FuncImport",
+            // Entry, Func, Memory
+            Int8PtrTy, Int8PtrTy, Int8PtrTy,
+            // Symbol
+            Int8PtrTy,
+            // Memories
+            Int8PtrTy->getPointerTo(),
+            // Globals
+            Int128PtrTy->getPointerTo(),
+            // MemorySizes
+            Int64PtrTy->getPointerTo(),
+            // FuncImports
+            Int8PtrTy,
+            // ModuleAddr
+            Int32Ty)),
         ExecCtxTy(llvm::StructType::create(
             "ExecCtx",
             // Memory
@@ -307,7 +351,11 @@ struct WasmEdge::AOT::Compiler::CompileContext {
             // Gas
             Int64PtrTy,
             // StopToken
-            llvm::Type::getInt32PtrTy(LLContext))),
+            llvm::Type::getInt32PtrTy(LLContext),
+            // MemorySizes
+            Int64PtrTy->getPointerTo(),
+            // FuncImports
+            FuncImportTy->getPointerTo())),
         ExecCtxPtrTy(ExecCtxTy->getPointerTo()),
         IntrinsicsTableTy(llvm::ArrayType::get(
             Int8PtrTy, uint32_t(AST::Module::Intrinsics::kIntrinsicMax))),
@@ -368,6 +416,16 @@ struct WasmEdge::AOT::Compiler::CompileContext {
       Builder.CreateUnreachable();
     }
   }
+  /// Target the generic CPU of the level instead of the features of the host
+  /// and the build.
+  void setCPULevel([[maybe_unused]] CompilerConfigure::CPULevel Level) {
+#if defined(__x86_64__)
+    SupportXOP = false;
+    SupportSSE4_1 = Level >= CompilerConfigure::CPULevel::V2;
+    SupportSSSE3 = Level >= CompilerConfigure::CPULevel::V2;
+    SupportSSE2 = true;
+#endif
+  }
   llvm::Value *getMemory(llvm::IRBuilder<> &Builder, llvm::LoadInst *ExecCtx,
                          uint32_t Index) {
     auto *Array = Builder.CreateExtractValue(ExecCtx, {0});
@@ -375,6 +433,14 @@ struct WasmEdge::AOT::Compiler::CompileContext {
         Int8PtrTy, Builder.CreateConstInBoundsGEP1_64(Int8PtrTy, Array, Index));
     return Builder.CreateBitCast(VPtr, Int8PtrTy);
   }
+  llvm::Value *getMemorySize(llvm::IRBuilder<> &Builder,
+                             llvm::LoadInst *ExecCtx, uint32_t Index) {
+    auto *Array = Builder.CreateExtractValue(ExecCtx, {6});
+    auto *VPtr = Builder.CreateLoad(
+        Int64PtrTy,
+        Builder.CreateConstInBoundsGEP1_64(Int64PtrTy, Array, Index));
+    return Builder.CreateLoad(Int64Ty, VPtr);
+  }
   std::pair<llvm::Type *, llvm::Value *> getGlobal(llvm::IRBuilder<> &Builder,
                                                    llvm::LoadInst *ExecCtx,
                                                    uint32_t Index) {
@@ -434,6 +500,15 @@ struct WasmEdge::AOT::Compiler::CompileContext {
   }
 };
 
+struct WasmEdge::AOT::Compiler::CompileVariant {
+  /// The CPU level tagged in the universal WASM output.
+  uint8_t Level;
+  /// The target CPU, which is the host CPU with its features if empty.
+  std::string CPUName;
+  /// The object codes of the module partitions.
+  std::vector<llvm::SmallString<0>> Objects;
+};
+
 namespace {
 
 using namespace WasmEdge;
@@ -531,9 +606,10 @@ class FunctionCompiler {
 public:
   FunctionCompiler(AOT::Compiler::CompileContext &Context, llvm::Function *F,
                    Span<const ValType> Locals, bool Interruptible,
-                   bool InstructionCounting, bool GasMeasuring, bool OptNone)
+                   bool InstructionCounting, bool GasMeasuring, bool OptNone,
+                   const Profile *Prof = nullptr)
       : Context(Context), LLContext(Context.LLContext),
-        Interruptible(Interruptible), OptNone(OptNone), F(F),
+        Interruptible(Interruptible), OptNone(OptNone), Prof(Prof), F(F),
         Builder(llvm::BasicBlock::Create(LLContext, "entry", F)) {
     if (F) {
       setIsFPConstrained(Builder);
@@ -672,7 +748,7 @@ public:
         } else {
           Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         }
-        Builder.CreateCondBr(Cond, Then, Else);
+        Builder.CreateCondBr(Cond, Then, Else, getBranchWeights(Instr));
 
         Builder.SetInsertPoint(Then);
         auto Type = Context.resolveBlockType(Instr.getBlockType());
@@ -748,7 +824,8 @@ public:
         auto *Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         setLableJumpPHI(Label);
         auto *Next = llvm::BasicBlock::Create(LLContext, "br_if.end", F);
-        Builder.CreateCondBr(Cond, getLabel(Label), Next);
+        Builder.CreateCondBr(Cond, getLabel(Label), Next,
+                             getBranchWeights(Instr));
         Builder.SetInsertPoint(Next);
         break;
       }
@@ -1027,34 +1104,39 @@ public:
                        Instr.getMemoryAlign(), Context.Int32Ty, true);
         break;
       case OpCode::Memory__size:
-        stackPush(Builder.CreateCall(
-            Context.getIntrinsic(Builder, AST::Module::Intrinsics::kMemSize,
-                                 llvm::FunctionType::get(Context.Int32Ty,
-                                                         {Context.Int32Ty},
-                                                         false)),
-            {Builder.getInt32(Instr.getTargetIndex())}));
+        stackPush(Builder.CreateTrunc(
+            Builder.CreateCall(
+                Context.getIntrinsic(Builder,
+                                     AST::Module::Intrinsics::kMemSize,
+                                     llvm::FunctionType::get(Context.Int64Ty,
+                                                             {Context.Int32Ty},
+                                                             false)),
+                {Builder.getInt32(Instr.getTargetIndex())}),
+            getIndexType(Instr.getTargetIndex())));
         break;
       case OpCode::Memory__grow: {
-        auto *Diff = stackPop();
-        stackPush(Builder.CreateCall(
-            Context.getIntrinsic(
-                Builder, AST::Module::Intrinsics::kMemGrow,
-                llvm::FunctionType::get(Context.Int32Ty,
-                                        {Context.Int32Ty, Context.Int32Ty},
-                                        false)),
-            {Builder.getInt32(Instr.getTargetIndex()), Diff}));
+        auto *Diff = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+        stackPush(Builder.CreateTrunc(
+            Builder.CreateCall(
+                Context.getIntrinsic(
+                    Builder, AST::Module::Intrinsics::kMemGrow,
+                    llvm::FunctionType::get(Context.Int64Ty,
+                                            {Context.Int32Ty, Context.Int64Ty},
+                                            false)),
+                {Builder.getInt32(Instr.getTargetIndex()), Diff}),
+            getIndexType(Instr.getTargetIndex())));
         break;
       }
       case OpCode::Memory__init: {
         auto *Len = stackPop();
         auto *Src = stackPop();
-        auto *Dst = stackPop();
+        auto *Dst = Builder.CreateZExt(stackPop(), Context.Int64Ty);
         Builder.CreateCall(
             Context.getIntrinsic(
                 Builder, AST::Module::Intrinsics::kMemInit,
                 llvm::FunctionType::get(Context.VoidTy,
                                         {Context.Int32Ty, Context.Int32Ty,
-                                         Context.Int32Ty, Context.Int32Ty,
+                                         Context.Int64Ty, Context.Int32Ty,
                                          Context.Int32Ty},
                                         false)),
             {Builder.getInt32(Instr.getTargetIndex()),
@@ -1070,31 +1152,31 @@ public:
         break;
       }
       case OpCode::Memory__copy: {
-        auto *Len = stackPop();
-        auto *Src = stackPop();
-        auto *Dst = stackPop();
+        auto *Len = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+        auto *Src = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+        auto *Dst = Builder.CreateZExt(stackPop(), Context.Int64Ty);
         Builder.CreateCall(
             Context.getIntrinsic(
                 Builder, AST::Module::Intrinsics::kMemCopy,
                 llvm::FunctionType::get(Context.VoidTy,
                                         {Context.Int32Ty, Context.Int32Ty,
-                                         Context.Int32Ty, Context.Int32Ty,
-                                         Context.Int32Ty},
+                                         Context.Int64Ty, Context.Int64Ty,
+                                         Context.Int64Ty},
                                         false)),
             {Builder.getInt32(Instr.getTargetIndex()),
              Builder.getInt32(Instr.getSourceIndex()), Dst, Src, Len});
         break;
       }
       case OpCode::Memory__fill: {
-        auto *Len = stackPop();
+        auto *Len = Builder.CreateZExt(stackPop(), Context.Int64Ty);
         auto *Val = Builder.CreateTrunc(stackPop(), Context.Int8Ty);
-        auto *Off = stackPop();
+        auto *Off = Builder.CreateZExt(stackPop(), Context.Int64Ty);
         Builder.CreateCall(
             Context.getIntrinsic(
                 Builder, AST::Module::Intrinsics::kMemFill,
                 llvm::FunctionType::get(Context.VoidTy,
-                                        {Context.Int32Ty, Context.Int32Ty,
-                                         Context.Int8Ty, Context.Int32Ty},
+                                        {Context.Int32Ty, Context.Int64Ty,
+                                         Context.Int8Ty, Context.Int64Ty},
                                         false)),
             {Builder.getInt32(Instr.getTargetIndex()), Off, Val, Len});
         break;
@@ -2696,6 +2778,321 @@ public:
         compileVectorPromote();
         break;
 
+      // Threads instructions
+      case OpCode::Atomic__fence:
+        Builder.CreateFence(llvm::AtomicOrdering::SequentiallyConsistent);
+        break;
+      case OpCode::Memory__atomic__notify:
+        compileAtomicNotify(Instr.getTargetIndex(), Instr.getMemoryOffset());
+        break;
+      case OpCode::Memory__atomic__wait32:
+        compileAtomicWait(Instr.getTargetIndex(), Instr.getMemoryOffset(), 32);
+        break;
+      case OpCode::Memory__atomic__wait64:
+        compileAtomicWait(Instr.getTargetIndex(), Instr.getMemoryOffset(), 64);
+        break;
+      case OpCode::I32__atomic__load:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int32Ty, Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__load:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int64Ty, Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__load8_u:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int8Ty, Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__load16_u:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int16Ty, Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__load8_u:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int8Ty, Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__load16_u:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int16Ty, Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__load32_u:
+        compileAtomicLoadOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                            Context.Int32Ty, Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__store:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__store:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__store8:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int8Ty);
+        break;
+      case OpCode::I32__atomic__store16:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int16Ty);
+        break;
+      case OpCode::I64__atomic__store8:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int8Ty);
+        break;
+      case OpCode::I64__atomic__store16:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int16Ty);
+        break;
+      case OpCode::I64__atomic__store32:
+        compileAtomicStoreOp(Instr.getTargetIndex(),
+                             Instr.getMemoryOffset(), Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw__add:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__add:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__add_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__add_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__add_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__add_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__add_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Add, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__sub:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__sub:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__sub_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__sub_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__sub_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__sub_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__sub_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Sub, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__and:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__and:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__and_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__and_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__and_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__and_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__and_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::And, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__or:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__or:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__or_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__or_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__or_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__or_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__or_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Or, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__xor:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__xor:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__xor_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__xor_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__xor_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__xor_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__xor_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xor, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__xchg:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int32Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__xchg:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int64Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__xchg_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int8Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__xchg_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int16Ty,
+                           Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__xchg_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int8Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__xchg_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int16Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__xchg_u:
+        compileAtomicRMWOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
+                           llvm::AtomicRMWInst::Xchg, Context.Int32Ty,
+                           Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw__cmpxchg:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int32Ty, Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw__cmpxchg:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int64Ty, Context.Int64Ty);
+        break;
+      case OpCode::I32__atomic__rmw8__cmpxchg_u:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int8Ty, Context.Int32Ty);
+        break;
+      case OpCode::I32__atomic__rmw16__cmpxchg_u:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int16Ty, Context.Int32Ty);
+        break;
+      case OpCode::I64__atomic__rmw8__cmpxchg_u:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int8Ty, Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw16__cmpxchg_u:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int16Ty, Context.Int64Ty);
+        break;
+      case OpCode::I64__atomic__rmw32__cmpxchg_u:
+        compileAtomicCompareExchangeOp(Instr.getTargetIndex(),
+                                       Instr.getMemoryOffset(),
+                                       Context.Int32Ty, Context.Int64Ty);
+        break;
+
       default:
         assumingUnreachable();
       }
@@ -3073,15 +3470,51 @@ private:
     }
   }
 
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
-                     llvm::Type *LoadTy) {
-    if constexpr (kForceUnalignment) {
-      Alignment = 0;
-    }
+  llvm::Type *getIndexType(unsigned MemoryIndex) {
+    return Context.IsMemory64[MemoryIndex] ? Context.Int64Ty : Context.Int32Ty;
+  }
+  /// Pop the address operand and calculate the effective address. The 32-bit
+  /// memories are protected by the guard pages, and the 64-bit memories are
+  /// bound checked explicitly.
+  llvm::Value *getEffectiveAddress(unsigned MemoryIndex, uint64_t Offset,
+                                   uint64_t Size) {
     auto *Off = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+    if (!Context.IsMemory64[MemoryIndex]) {
+      if (Offset != 0) {
+        Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
+      }
+      return Off;
+    }
+
+    auto *OkBB = llvm::BasicBlock::Create(LLContext, "mem.inbound", F);
+    if (Offset > std::numeric_limits<uint64_t>::max() - Size) {
+      Builder.CreateBr(getTrapBB(ErrCode::MemoryOutOfBounds));
+    } else {
+      // Check EA + Size <= memory size without overflow.
+      auto *End = Builder.CreateBinaryIntrinsic(
+          llvm::Intrinsic::uadd_with_overflow, Off,
+          Builder.getInt64(Offset + Size));
+      auto *InBound = Builder.CreateAnd(
+          Builder.CreateNot(Builder.CreateExtractValue(End, {1})),
+          Builder.CreateICmpULE(
+              Builder.CreateExtractValue(End, {0}),
+              Context.getMemorySize(Builder, ExecCtx, MemoryIndex)));
+      Builder.CreateCondBr(createLikely(Builder, InBound), OkBB,
+                           getTrapBB(ErrCode::MemoryOutOfBounds));
+    }
+    Builder.SetInsertPoint(OkBB);
     if (Offset != 0) {
       Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
     }
+    return Off;
+  }
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
+                     llvm::Type *LoadTy) {
+    if constexpr (kForceUnalignment) {
+      Alignment = 0;
+    }
+    auto *Off = getEffectiveAddress(MemoryIndex, Offset,
+                                    LoadTy->getPrimitiveSizeInBits() / 8);
 
     auto *VPtr = Builder.CreateInBoundsGEP(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
@@ -3090,7 +3523,7 @@ private:
     LoadInst->setAlignment(Align(UINT64_C(1) << Alignment));
     stackPush(LoadInst);
   }
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                      llvm::Type *LoadTy, llvm::Type *ExtendTy, bool Signed) {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     if (Signed) {
@@ -3099,24 +3532,24 @@ private:
       Stack.back() = Builder.CreateZExt(Stack.back(), ExtendTy);
     }
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, llvm::Type *LoadTy) {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     Stack.back() = Builder.CreateBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, llvm::Type *LoadTy,
                            llvm::Type *ExtendTy, bool Signed) {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy, ExtendTy, Signed);
     Stack.back() = Builder.CreateBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileSplatLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileSplatLoadOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, llvm::Type *LoadTy,
                           llvm::VectorType *VectorTy) {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     compileSplatOp(VectorTy);
   }
-  void compileLoadLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileLoadLaneOp(unsigned MemoryIndex, uint64_t Offset,
                          unsigned Alignment, unsigned Index, llvm::Type *LoadTy,
                          llvm::VectorType *VectorTy) {
     auto *Vector = stackPop();
@@ -3127,7 +3560,7 @@ private:
                                     Value, Index),
         Context.Int64x2Ty);
   }
-  void compileStoreLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileStoreLaneOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, unsigned Index,
                           llvm::Type *LoadTy, llvm::VectorType *VectorTy) {
     auto *Vector = Stack.back();
@@ -3135,17 +3568,15 @@ private:
         Builder.CreateBitCast(Vector, VectorTy), Index);
     compileStoreOp(MemoryIndex, Offset, Alignment, LoadTy);
   }
-  void compileStoreOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileStoreOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                       llvm::Type *LoadTy, bool Trunc = false,
                       bool BitCast = false) {
     if constexpr (kForceUnalignment) {
       Alignment = 0;
     }
     auto *V = stackPop();
-    auto *Off = Builder.CreateZExt(stackPop(), Context.Int64Ty);
-    if (Offset != 0) {
-      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
-    }
+    auto *Off = getEffectiveAddress(MemoryIndex, Offset,
+                                    LoadTy->getPrimitiveSizeInBits() / 8);
 
     if (Trunc) {
       V = Builder.CreateTrunc(V, LoadTy);
@@ -3159,6 +3590,108 @@ private:
     auto *StoreInst = Builder.CreateStore(V, Ptr, OptNone);
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
   }
+  llvm::Value *getAtomicPointer(unsigned MemoryIndex, uint64_t Offset,
+                                llvm::Type *AccessTy) {
+    const uint64_t Size = AccessTy->getPrimitiveSizeInBits() / 8;
+    auto *Off = getEffectiveAddress(MemoryIndex, Offset, Size);
+
+    // Atomic accesses must be naturally aligned.
+    if (Size > 1) {
+      auto *OkBB = llvm::BasicBlock::Create(LLContext, "atomic.aligned", F);
+      auto *Mask = Builder.CreateAnd(Off, Builder.getInt64(Size - 1));
+      auto *IsAligned = createLikely(
+          Builder, Builder.CreateICmpEQ(Mask, Builder.getInt64(0)));
+      Builder.CreateCondBr(IsAligned, OkBB,
+                           getTrapBB(ErrCode::UnalignedAtomicAccess));
+      Builder.SetInsertPoint(OkBB);
+    }
+
+    auto *VPtr = Builder.CreateInBoundsGEP(
+        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
+    return Builder.CreateBitCast(VPtr, AccessTy->getPointerTo());
+  }
+  void compileAtomicLoadOp(unsigned MemoryIndex, uint64_t Offset,
+                           llvm::Type *LoadTy, llvm::Type *ExtendTy) {
+    auto *Ptr = getAtomicPointer(MemoryIndex, Offset, LoadTy);
+    auto *LoadInst = Builder.CreateLoad(LoadTy, Ptr, OptNone);
+    LoadInst->setAlignment(Align(LoadTy->getPrimitiveSizeInBits() / 8));
+    LoadInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+    stackPush(Builder.CreateZExt(LoadInst, ExtendTy));
+  }
+  void compileAtomicStoreOp(unsigned MemoryIndex, uint64_t Offset,
+                            llvm::Type *StoreTy) {
+    auto *V = Builder.CreateTrunc(stackPop(), StoreTy);
+    auto *Ptr = getAtomicPointer(MemoryIndex, Offset, StoreTy);
+    auto *StoreInst = Builder.CreateStore(V, Ptr, OptNone);
+    StoreInst->setAlignment(Align(StoreTy->getPrimitiveSizeInBits() / 8));
+    StoreInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+  }
+  void compileAtomicRMWOp(unsigned MemoryIndex, uint64_t Offset,
+                          llvm::AtomicRMWInst::BinOp BinOp, llvm::Type *RMWTy,
+                          llvm::Type *ExtendTy) {
+    auto *V = Builder.CreateTrunc(stackPop(), RMWTy);
+    auto *Ptr = getAtomicPointer(MemoryIndex, Offset, RMWTy);
+#if LLVM_VERSION_MAJOR >= 13
+    auto *Ret = Builder.CreateAtomicRMW(
+        BinOp, Ptr, V, Align(RMWTy->getPrimitiveSizeInBits() / 8),
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#else
+    auto *Ret = Builder.CreateAtomicRMW(
+        BinOp, Ptr, V, llvm::AtomicOrdering::SequentiallyConsistent);
+#endif
+    Ret->setVolatile(OptNone);
+    stackPush(Builder.CreateZExt(Ret, ExtendTy));
+  }
+  void compileAtomicCompareExchangeOp(unsigned MemoryIndex, uint64_t Offset,
+                                      llvm::Type *CmpTy, llvm::Type *ExtendTy) {
+    auto *Replacement = Builder.CreateTrunc(stackPop(), CmpTy);
+    auto *Expected = Builder.CreateTrunc(stackPop(), CmpTy);
+    auto *Ptr = getAtomicPointer(MemoryIndex, Offset, CmpTy);
+#if LLVM_VERSION_MAJOR >= 13
+    auto *Ret = Builder.CreateAtomicCmpXchg(
+        Ptr, Expected, Replacement, Align(CmpTy->getPrimitiveSizeInBits() / 8),
+        llvm::AtomicOrdering::SequentiallyConsistent,
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#else
+    auto *Ret = Builder.CreateAtomicCmpXchg(
+        Ptr, Expected, Replacement,
+        llvm::AtomicOrdering::SequentiallyConsistent,
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#endif
+    Ret->setVolatile(OptNone);
+    // The first element of the result is the loaded value.
+    stackPush(
+        Builder.CreateZExt(Builder.CreateExtractValue(Ret, {0}), ExtendTy));
+  }
+  void compileAtomicNotify(unsigned MemoryIndex, uint64_t Offset) {
+    auto *Count = stackPop();
+    auto *Addr = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+    stackPush(Builder.CreateCall(
+        Context.getIntrinsic(
+            Builder, AST::Module::Intrinsics::kMemAtomicNotify,
+            llvm::FunctionType::get(Context.Int32Ty,
+                                    {Context.Int32Ty, Context.Int64Ty,
+                                     Context.Int64Ty, Context.Int32Ty},
+                                    false)),
+        {Builder.getInt32(MemoryIndex), Addr, Builder.getInt64(Offset),
+         Count}));
+  }
+  void compileAtomicWait(unsigned MemoryIndex, uint64_t Offset,
+                         unsigned BitWidth) {
+    auto *Timeout = stackPop();
+    auto *Expected = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+    auto *Addr = Builder.CreateZExt(stackPop(), Context.Int64Ty);
+    stackPush(Builder.CreateCall(
+        Context.getIntrinsic(
+            Builder, AST::Module::Intrinsics::kMemAtomicWait,
+            llvm::FunctionType::get(Context.Int32Ty,
+                                    {Context.Int32Ty, Context.Int64Ty,
+                                     Context.Int64Ty, Context.Int64Ty,
+                                     Context.Int64Ty, Context.Int32Ty},
+                                    false)),
+        {Builder.getInt32(MemoryIndex), Addr, Builder.getInt64(Offset),
+         Expected, Timeout, Builder.getInt32(BitWidth)}));
+  }
   void compileSplatOp(llvm::VectorType *VectorTy) {
     auto *Undef = llvm::UndefValue::get(VectorTy);
     auto *Zeros = llvm::ConstantAggregateZero::get(
@@ -3904,6 +4437,25 @@ private:
     return (ControlStack.rbegin() + Index)->JumpBlock;
   }
 
+  /// Get the branch weights of the `if` or `br_if` instruction from the
+  /// profile, or nullptr if it is not executed in the profiled runs.
+  llvm::MDNode *getBranchWeights(const AST::Instruction &Instr) {
+    if (!Prof) {
+      return nullptr;
+    }
+    const auto [Taken, NotTaken] =
+        Prof->getBranchCount(Context.ModuleHash, Instr.getOffset());
+    if (Taken == 0 && NotTaken == 0) {
+      return nullptr;
+    }
+    // Scale the counts down to fit the 32-bit weights.
+    const uint64_t Scale =
+        std::max(Taken, NotTaken) / std::numeric_limits<uint32_t>::max() + 1;
+    return llvm::MDBuilder(LLContext).createBranchWeights(
+        static_cast<uint32_t>(Taken / Scale),
+        static_cast<uint32_t>(NotTaken / Scale));
+  }
+
   void stackPush(llvm::Value *Value) { Stack.push_back(Value); }
   llvm::Value *stackPop() {
     assuming(!ControlStack.empty() || !Stack.empty());
@@ -3924,6 +4476,7 @@ private:
   bool IsUnreachable = false;
   bool Interruptible = false;
   bool OptNone = false;
+  const Profile *Prof = nullptr;
   struct Control {
     size_t StackSize;
     llvm::BasicBlock *JumpBlock;
@@ -3969,14 +4522,14 @@ static llvm::Value *createLikely(llvm::IRBuilder<> &Builder,
                                        Builder.getTrue());
 }
 
-// Write output object and link
+// Write output objects and link
 Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
-                                 const llvm::SmallString<0> &OSVec) {
+                                 Span<const llvm::SmallString<0>> Objects) {
   using namespace std::literals;
 
   spdlog::info("output start");
-  std::string ObjectName;
-  {
+  std::vector<std::string> ObjectNames;
+  for (const auto &OSVec : Objects) {
     // tempfile
     std::filesystem::path OPath(OutputPath);
 #if WASMEDGE_OS_WINDOWS
@@ -3989,6 +4542,9 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
       // TODO:return error
       spdlog::error("so file creation failed:{}", OPath.u8string());
       llvm::consumeError(Object.takeError());
+      for (const auto &Name : ObjectNames) {
+        llvm::sys::fs::remove(Name);
+      }
       return WasmEdge::Unexpect(WasmEdge::ErrCode::IllegalPath);
     }
     llvm::raw_fd_ostream OS(Object->FD, false);
@@ -3998,35 +4554,45 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #else
     OS.close();
 #endif
-    ObjectName = Object->TmpName;
+    ObjectNames.push_back(Object->TmpName);
     llvm::consumeError(Object->keep());
   }
 
   // link
+  const std::string OutputName = OutputPath.u8string();
 #if WASMEDGE_OS_MACOS
-  lld::mach_o::link(
-      std::array {
-        "lld", "-arch",
+  std::vector<const char *> Args = {
+    "lld", "-arch",
 #if defined(__x86_64__)
-            "x86_64",
+        "x86_64",
 #elif defined(__aarch64__)
-            "arm64",
+        "arm64",
 #else
 #error Unsupported platform!
 #endif
-            "-dylib", "-demangle", "-macosx_version_min", "10.0.0",
-            "-sdk_version", "11.3", "-syslibroot",
-            "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
-            ObjectName.c_str(), "-o", OutputPath.u8string().c_str(), "-lSystem"
-      },
+        "-dylib", "-demangle", "-macosx_version_min", "10.0.0", "-sdk_version",
+        "11.3", "-syslibroot",
+        "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk", "-o",
+        OutputName.c_str(), "-lSystem"
+  };
+#elif WASMEDGE_OS_LINUX
+  std::vector<const char *> Args = {"ld.lld",      "--shared",
+                                    "--gc-sections", "--discard-all",
+                                    "-o",          OutputName.c_str()};
+#elif WASMEDGE_OS_WINDOWS
+  const std::string OutArg = "-out:" + OutputName;
+  std::vector<const char *> Args = {"lld-link", "-dll", "-defaultlib:libcmt",
+                                    "-base:0",  "-nologo", OutArg.c_str()};
+#endif
+  for (const auto &Name : ObjectNames) {
+    Args.push_back(Name.c_str());
+  }
+#if WASMEDGE_OS_MACOS
+  lld::mach_o::link(Args,
 #elif WASMEDGE_OS_LINUX
-  lld::elf::link(
-      std::array{"ld.lld", "--shared", "--gc-sections", "--discard-all",
-                 ObjectName.c_str(), "-o", OutputPath.u8string().c_str()},
+  lld::elf::link(Args,
 #elif WASMEDGE_OS_WINDOWS
-  lld::coff::link(
-      std::array{"lld-link", "-dll", "-defaultlib:libcmt", "-base:0", "-nologo",
-                 ObjectName.c_str(), ("-out:" + OutputPath.u8string()).c_str()},
+  lld::coff::link(Args,
 #endif
       false,
 #if LLVM_VERSION_MAJOR >= 10
@@ -4036,7 +4602,9 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #endif
   );
 
-  llvm::sys::fs::remove(ObjectName);
+  for (const auto &Name : ObjectNames) {
+    llvm::sys::fs::remove(Name);
+  }
 #if WASMEDGE_OS_WINDOWS
   std::filesystem::path LibPath(OutputPath);
   LibPath.replace_extension(".lib"sv);
@@ -4067,14 +4635,17 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
   return {};
 }
 
-Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
-                               Span<const Byte> Data,
-                               const llvm::SmallString<0> &OSVec) {
+// Link the objects of a code variant, and write the content of its custom
+// section
+Expect<void> outputWasmSection(const std::filesystem::path &OutputPath,
+                               Span<const llvm::SmallString<0>> Objects,
+                               uint8_t Level,
+                               llvm::SmallString<0> &OSCustomSecVec) {
   using namespace std::literals;
 
   std::string SharedObjectName;
   {
-    // tempfile
+    // tempfile, which is overwritten by the linker.
     std::filesystem::path SOPath(OutputPath);
     SOPath.replace_extension("%%%%%%%%%%" EXTENSION);
     auto Object = llvm::sys::fs::TempFile::create(SOPath.u8string());
@@ -4084,19 +4655,12 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
       llvm::consumeError(Object.takeError());
       return WasmEdge::Unexpect(WasmEdge::ErrCode::IllegalPath);
     }
-    llvm::raw_fd_ostream OS(Object->FD, false);
-    OS.write(OSVec.data(), OSVec.size());
-#if WASMEDGE_OS_WINDOWS
-    OS.flush();
-#else
-    OS.close();
-#endif
     SharedObjectName = Object->TmpName;
     llvm::consumeError(Object->keep());
   }
 
-  if (auto Res =
-          outputNativeLibrary(std::filesystem::u8path(SharedObjectName), OSVec);
+  if (auto Res = outputNativeLibrary(std::filesystem::u8path(SharedObjectName),
+                                     Objects);
       unlikely(!Res)) {
     return Unexpect(Res);
   }
@@ -4119,7 +4683,6 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     ObjFile = std::move(*Res);
   }
 
-  llvm::SmallString<0> OSCustomSecVec;
   {
     llvm::raw_svector_ostream OS(OSCustomSecVec);
 
@@ -4139,6 +4702,7 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
 #elif defined(__aarch64__)
     WriteByte(OS, UINT8_C(2));
 #endif
+    WriteByte(OS, Level);
 
     std::vector<std::pair<std::string, uint64_t>> SymbolTable;
 #if !WASMEDGE_OS_WINDOWS
@@ -4254,6 +4818,22 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     }
   }
 
+  llvm::sys::fs::remove(SharedObjectName);
+  return {};
+}
+
+Expect<void> outputWasmLibrary(
+    const std::filesystem::path &OutputPath, Span<const Byte> Data,
+    Span<const WasmEdge::AOT::Compiler::CompileVariant> Variants) {
+  std::vector<llvm::SmallString<0>> OSCustomSecVecs(Variants.size());
+  for (size_t I = 0; I < Variants.size(); ++I) {
+    if (auto Res = outputWasmSection(OutputPath, Variants[I].Objects,
+                                     Variants[I].Level, OSCustomSecVecs[I]);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+  }
+
   spdlog::info("output start");
 
   std::error_code EC;
@@ -4263,11 +4843,203 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     return Unexpect(ErrCode::IllegalPath);
   }
   OS.write(reinterpret_cast<const char *>(Data.data()), Data.size());
-  // Custom section id
-  WriteByte(OS, UINT8_C(0x00));
-  WriteName(OS, std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
+  // One custom section per code variant, in the order of selection.
+  for (const auto &OSCustomSecVec : OSCustomSecVecs) {
+    // Custom section id
+    WriteByte(OS, UINT8_C(0x00));
+    WriteName(OS,
+              std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
+  }
+  return {};
+}
 
-  llvm::sys::fs::remove(SharedObjectName);
+// Get the cache path of the object code of a partition, which is keyed by the
+// partition bitcode and the code generation options.
+std::filesystem::path getObjectCachePath(const llvm::SmallString<0> &Bitcode,
+                                         const CompilerConfigure &CompilerConf,
+                                         llvm::StringRef CPUName,
+                                         const std::string &Features,
+                                         bool DefineIntrinsics) {
+  using namespace std::literals;
+  std::vector<Byte> Key(Bitcode.begin(), Bitcode.end());
+  auto Append = [&Key](std::string_view Str) {
+    Key.insert(Key.end(), Str.begin(), Str.end());
+    Key.push_back(0);
+  };
+  Key.push_back(static_cast<Byte>(CompilerConf.getOptimizationLevel()));
+  Key.push_back(static_cast<Byte>(DefineIntrinsics ? 1 : 0));
+  for (uint32_t I = 0; I < 32; I += 8) {
+    Key.push_back(static_cast<Byte>(AOT::kBinaryVersion >> I));
+  }
+  Append(std::string_view(CPUName.data(), CPUName.size()));
+  Append(Features);
+  if (auto Res = AOT::Cache::getPath(Key, AOT::Cache::StorageScope::Local,
+                                     "objects"sv);
+      Res && Res->is_absolute()) {
+    return std::move(*Res);
+  }
+  return {};
+}
+
+// Load the cached object code
+bool loadCachedObject(const std::filesystem::path &Path,
+                      llvm::SmallString<0> &OSVec) {
+  if (Path.empty()) {
+    return false;
+  }
+  auto Res = llvm::MemoryBuffer::getFile(Path.u8string());
+  if (!Res) {
+    return false;
+  }
+  OSVec.assign((*Res)->getBufferStart(), (*Res)->getBufferEnd());
+  return true;
+}
+
+// Save the object code into the cache. The failures only miss the cache.
+void saveCachedObject(const std::filesystem::path &Path,
+                      const llvm::SmallString<0> &OSVec) {
+  std::error_code EC;
+  std::filesystem::create_directories(Path.parent_path(), EC);
+  // Write into a temporary file and rename it, so the concurrent compilers
+  // never see the partial object.
+  auto Object = llvm::sys::fs::TempFile::create(Path.u8string() +
+                                                ".%%%%%%%%%%.tmp");
+  if (!Object) {
+    llvm::consumeError(Object.takeError());
+    return;
+  }
+  {
+    llvm::raw_fd_ostream OS(Object->FD, false);
+    OS.write(OSVec.data(), OSVec.size());
+    OS.flush();
+  }
+  llvm::consumeError(Object->keep(Path.u8string()));
+}
+
+// Optimize the module with the optimization level
+void optimizeModule(llvm::Module &LLModule,
+                    const CompilerConfigure &CompilerConf,
+                    llvm::TargetMachine &TM,
+                    llvm::TargetLibraryInfoImpl &TLII) {
+#if LLVM_VERSION_MAJOR == 12
+  llvm::PassBuilder PB(false, &TM);
+#else
+  llvm::PassBuilder PB(&TM);
+#endif
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  // Register the AA manager first so that our version is the one
+  // used.
+  FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+
+  // Register the target library analysis directly and give it a
+  // customized preset TLI.
+  FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#if LLVM_VERSION_MAJOR <= 9
+  MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#endif
+
+  // Register all the basic analyses with the managers.
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM;
+  if (CompilerConf.getOptimizationLevel() ==
+      CompilerConfigure::OptimizationLevel::O0) {
+    MPM.addPass(llvm::AlwaysInlinerPass(false));
+  } else {
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(
+        toLLVMLevel(CompilerConf.getOptimizationLevel())));
+  }
+
+  MPM.run(LLModule, MAM);
+}
+
+// Define the intrinsics table, which is set when the compiled module is loaded
+/// The JIT shared by the compilations of the functions of a module.
+struct JITState {
+  std::mutex Mutex;
+  std::shared_ptr<llvm::orc::LLJIT> JIT;
+  /// Count of the compilations added into the JIT.
+  uint32_t Generation = 0;
+};
+
+void defineIntrinsicsTable(llvm::Module &LLModule) {
+  if (auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics")) {
+    IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
+        llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
+    IntrinsicsTable->setConstant(false);
+  }
+}
+
+// Optimize the module and generate the object code
+Expect<void> optimizeAndEmit(llvm::Module &LLModule,
+                             const CompilerConfigure &CompilerConf,
+                             llvm::StringRef CPUName,
+                             const std::string &Features,
+                             bool DefineIntrinsics, const std::string &DumpName,
+                             llvm::SmallString<0> &OSVec) {
+  llvm::Triple Triple(LLModule.getTargetTriple());
+  std::string Error;
+  const llvm::Target *TheTarget =
+      llvm::TargetRegistry::lookupTarget(Triple.getTriple(), Error);
+  if (!TheTarget) {
+    // TODO:return error
+    spdlog::error("lookupTarget failed:{}", Error);
+    return Unexpect(ErrCode::IllegalPath);
+  }
+
+  llvm::TargetOptions Options;
+  llvm::Reloc::Model RM = llvm::Reloc::PIC_;
+  std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
+      Triple.str(), CPUName, Features, Options, RM, llvm::None,
+      llvm::CodeGenOpt::Level::Aggressive));
+  LLModule.setDataLayout(TM->createDataLayout());
+
+  llvm::TargetLibraryInfoImpl TLII(Triple);
+
+  optimizeModule(LLModule, CompilerConf, *TM, TLII);
+
+  // Set initializer for constant value
+  if (DefineIntrinsics) {
+    defineIntrinsicsTable(LLModule);
+  }
+
+  llvm::legacy::PassManager CodeGenPasses;
+  CodeGenPasses.add(
+      llvm::createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
+
+  // Add LibraryInfo.
+  CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
+
+  llvm::raw_svector_ostream OS(OSVec);
+#if LLVM_VERSION_MAJOR >= 10
+  using llvm::CGFT_ObjectFile;
+#else
+  const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+  if (TM->addPassesToEmitFile(CodeGenPasses, OS, nullptr, CGFT_ObjectFile,
+                              false)) {
+    // TODO:return error
+    spdlog::error("addPassesToEmitFile failed");
+    return Unexpect(ErrCode::IllegalPath);
+  }
+
+  if (CompilerConf.isDumpIR()) {
+    int Fd;
+    llvm::sys::fs::openFileForWrite(DumpName, Fd);
+    llvm::raw_fd_ostream LLOS(Fd, true);
+    LLModule.print(LLOS, nullptr);
+  }
+  spdlog::info("codegen start");
+  CodeGenPasses.run(LLModule);
   return {};
 }
 
@@ -4276,18 +5048,323 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
 namespace WasmEdge {
 namespace AOT {
 
+namespace {
+/// Set the compile context in the scope.
+struct RAIICleanup {
+  RAIICleanup(Compiler::CompileContext *&Context,
+              Compiler::CompileContext &NewContext)
+      : Context(Context) {
+    Context = &NewContext;
+  }
+  ~RAIICleanup() { Context = nullptr; }
+  Compiler::CompileContext *&Context;
+};
+
+/// Compile the function body which calls the imported function, through the
+/// native entry of the host function, the symbol of the compiled function, or
+/// the executor.
+void compileImportCall(Compiler::CompileContext &Context, llvm::Function *F,
+                       const AST::FunctionType &FuncType,
+                       const uint32_t FuncID) {
+  auto *FTy = F->getFunctionType();
+  auto *RTy = FTy->getReturnType();
+  auto *Entry = llvm::BasicBlock::Create(Context.LLContext, "entry", F);
+  llvm::IRBuilder<> Builder(Entry);
+  setIsFPConstrained(Builder);
+
+  const auto ArgSize = FuncType.getParamTypes().size();
+  const auto RetSize = RTy->isVoidTy() ? 0 : FuncType.getReturnTypes().size();
+
+  llvm::Value *Args;
+  if (ArgSize == 0) {
+    Args = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
+  } else {
+    auto *Alloca = Builder.CreateAlloca(Context.Int8Ty,
+                                        Builder.getInt64(ArgSize * kValSize));
+    Alloca->setAlignment(Align(kValSize));
+    Args = Alloca;
+  }
+
+  llvm::Value *Rets;
+  if (RetSize == 0) {
+    Rets = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
+  } else {
+    auto *Alloca = Builder.CreateAlloca(Context.Int8Ty,
+                                        Builder.getInt64(RetSize * kValSize));
+    Alloca->setAlignment(Align(kValSize));
+    Rets = Alloca;
+  }
+
+  for (unsigned I = 0; I < ArgSize; ++I) {
+    llvm::Argument *Arg = F->arg_begin() + 1 + I;
+    llvm::Value *Ptr =
+        Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Args, I * kValSize);
+    Builder.CreateStore(
+        Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
+  }
+
+  // Call the native entry of the host function or the symbol of the compiled
+  // function directly if resolved in instantiation, otherwise call through the
+  // executor.
+  auto *NativeBB = llvm::BasicBlock::Create(Context.LLContext, "native", F);
+  auto *TrapBB = llvm::BasicBlock::Create(Context.LLContext, "trap", F);
+  auto *CheckBB = llvm::BasicBlock::Create(Context.LLContext, "check", F);
+  auto *DirectBB = llvm::BasicBlock::Create(Context.LLContext, "direct", F);
+  auto *CallBB = llvm::BasicBlock::Create(Context.LLContext, "call", F);
+  auto *RetBB = llvm::BasicBlock::Create(Context.LLContext, "ret", F);
+  auto *CalleeCtxPtr = Builder.CreateAlloca(Context.ExecCtxTy);
+  auto *ExecCtx = Builder.CreateLoad(Context.ExecCtxTy, F->arg_begin());
+  auto *FuncImports = Builder.CreateExtractValue(ExecCtx, {7});
+  auto *EntryTy = Context.FuncImportTy;
+  auto *EntryPtr =
+      Builder.CreateConstInBoundsGEP1_64(EntryTy, FuncImports, FuncID);
+  auto LoadField = [&](unsigned Index) {
+    return Builder.CreateLoad(
+        EntryTy->getElementType(Index),
+        Builder.CreateConstInBoundsGEP2_32(EntryTy, EntryPtr, 0, Index));
+  };
+  auto *NativeEntry = LoadField(0);
+  Builder.CreateCondBr(Builder.CreateIsNull(NativeEntry), CheckBB, NativeBB);
+
+  Builder.SetInsertPoint(NativeBB);
+  auto *HostFunc = LoadField(1);
+  auto *Memory = LoadField(2);
+  auto *EntryFTy = llvm::FunctionType::get(
+      Context.Int8Ty,
+      {Context.Int8PtrTy, Context.Int8PtrTy, Context.Int8PtrTy,
+       Context.Int8PtrTy},
+      false);
+  auto *Err = Builder.CreateCall(
+      EntryFTy, Builder.CreateBitCast(NativeEntry, EntryFTy->getPointerTo()),
+      {HostFunc, Memory, Builder.CreateBitCast(Args, Context.Int8PtrTy),
+       Builder.CreateBitCast(Rets, Context.Int8PtrTy)});
+  Builder.CreateCondBr(
+      createLikely(Builder, Builder.CreateICmpEQ(Err, Builder.getInt8(0))),
+      RetBB, TrapBB);
+
+  Builder.SetInsertPoint(TrapBB);
+  auto *CallTrap = Builder.CreateCall(Context.Trap, {Err});
+  CallTrap->setDoesNotReturn();
+  Builder.CreateUnreachable();
+
+  Builder.SetInsertPoint(CheckBB);
+  auto *Symbol = LoadField(3);
+  Builder.CreateCondBr(Builder.CreateIsNull(Symbol), CallBB, DirectBB);
+
+  // Switch the execution context and the module of the top frame to the
+  // ones of the callee, and pass the arguments in registers.
+  Builder.SetInsertPoint(DirectBB);
+  llvm::Value *CalleeCtx = ExecCtx;
+  for (const auto &[Field, Index] :
+       {std::pair<unsigned, unsigned>{4, 0}, {5, 1}, {6, 6}, {7, 7}}) {
+    CalleeCtx = Builder.CreateInsertValue(
+        CalleeCtx,
+        Builder.CreateBitCast(LoadField(Field),
+                              Context.ExecCtxTy->getElementType(Index)),
+        {Index});
+  }
+  Builder.CreateStore(CalleeCtx, CalleeCtxPtr);
+  Builder.CreateCall(
+      Context.getIntrinsic(
+          Builder, AST::Module::Intrinsics::kEnterModule,
+          llvm::FunctionType::get(Context.VoidTy, {Context.Int32Ty}, false)),
+      {LoadField(8)});
+  std::vector<llvm::Value *> CallArgs = {CalleeCtxPtr};
+  for (unsigned I = 0; I < ArgSize; ++I) {
+    CallArgs.push_back(F->arg_begin() + 1 + I);
+  }
+  auto *DirectRet = Builder.CreateCall(
+      FTy, Builder.CreateBitCast(Symbol, FTy->getPointerTo()), CallArgs);
+  Builder.CreateCall(Context.getIntrinsic(
+      Builder, AST::Module::Intrinsics::kLeaveModule,
+      llvm::FunctionType::get(Context.VoidTy, {}, false)));
+  if (RTy->isVoidTy()) {
+    Builder.CreateRetVoid();
+  } else {
+    Builder.CreateRet(DirectRet);
+  }
+
+  Builder.SetInsertPoint(CallBB);
+  Builder.CreateCall(
+      Context.getIntrinsic(
+          Builder, AST::Module::Intrinsics::kCall,
+          llvm::FunctionType::get(
+              Context.VoidTy,
+              {Context.Int32Ty, Context.Int8PtrTy, Context.Int8PtrTy},
+              false)),
+      {Builder.getInt32(FuncID), Args, Rets});
+  Builder.CreateBr(RetBB);
+
+  Builder.SetInsertPoint(RetBB);
+  if (RetSize == 0) {
+    Builder.CreateRetVoid();
+  } else if (RetSize == 1) {
+    llvm::Value *VPtr =
+        Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Rets, 0);
+    llvm::Value *Ptr =
+        Builder.CreateBitCast(VPtr, F->getReturnType()->getPointerTo());
+    Builder.CreateRet(Builder.CreateLoad(F->getReturnType(), Ptr));
+  } else {
+    std::vector<llvm::Value *> Ret;
+    Ret.reserve(RetSize);
+    for (unsigned I = 0; I < RetSize; ++I) {
+      llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+        Context.Int8Ty, Rets, I * kValSize);
+      llvm::Value *Ptr = Builder.CreateBitCast(
+          VPtr, RTy->getStructElementType(I)->getPointerTo());
+      Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
+    }
+    Builder.CreateAggregateRet(Ret.data(), static_cast<uint32_t>(RetSize));
+  }
+}
+
+/// Compile the function body which calls the function through the executor,
+/// so the function runs interpreted or in its own compiled code.
+void compileExecutorCall(Compiler::CompileContext &Context, llvm::Function *F,
+                         const AST::FunctionType &FuncType,
+                         const uint32_t FuncID) {
+  llvm::IRBuilder<> Builder(
+      llvm::BasicBlock::Create(Context.LLContext, "entry", F));
+  setIsFPConstrained(Builder);
+  auto *RTy = F->getReturnType();
+  const auto ArgSize = FuncType.getParamTypes().size();
+  const auto RetSize = RTy->isVoidTy() ? 0 : FuncType.getReturnTypes().size();
+
+  llvm::Value *Args;
+  if (ArgSize == 0) {
+    Args = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
+  } else {
+    auto *Alloca = Builder.CreateAlloca(Context.Int8Ty,
+                                        Builder.getInt64(ArgSize * kValSize));
+    Alloca->setAlignment(Align(kValSize));
+    Args = Alloca;
+  }
+
+  llvm::Value *Rets;
+  if (RetSize == 0) {
+    Rets = llvm::ConstantPointerNull::get(Context.Int8PtrTy);
+  } else {
+    auto *Alloca = Builder.CreateAlloca(Context.Int8Ty,
+                                        Builder.getInt64(RetSize * kValSize));
+    Alloca->setAlignment(Align(kValSize));
+    Rets = Alloca;
+  }
+
+  for (unsigned I = 0; I < ArgSize; ++I) {
+    llvm::Argument *Arg = F->arg_begin() + 1 + I;
+    llvm::Value *Ptr =
+        Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Args, I * kValSize);
+    Builder.CreateStore(
+        Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
+  }
+
+  Builder.CreateCall(
+      Context.getIntrinsic(
+          Builder, AST::Module::Intrinsics::kCall,
+          llvm::FunctionType::get(
+              Context.VoidTy,
+              {Context.Int32Ty, Context.Int8PtrTy, Context.Int8PtrTy}, false)),
+      {Builder.getInt32(FuncID), Args, Rets});
+
+  if (RetSize == 0) {
+    Builder.CreateRetVoid();
+  } else if (RetSize == 1) {
+    llvm::Value *VPtr =
+        Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Rets, 0);
+    llvm::Value *Ptr = Builder.CreateBitCast(VPtr, RTy->getPointerTo());
+    Builder.CreateRet(Builder.CreateLoad(RTy, Ptr));
+  } else {
+    std::vector<llvm::Value *> Ret;
+    Ret.reserve(RetSize);
+    for (unsigned I = 0; I < RetSize; ++I) {
+      llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+          Context.Int8Ty, Rets, I * kValSize);
+      llvm::Value *Ptr = Builder.CreateBitCast(
+          VPtr, RTy->getStructElementType(I)->getPointerTo());
+      Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
+    }
+    Builder.CreateAggregateRet(Ret.data(), static_cast<uint32_t>(RetSize));
+  }
+}
+} // namespace
+
+Compiler::Compiler(const Configure &Conf) noexcept
+    : Context(nullptr), Conf(Conf) {}
+
+Compiler::~Compiler() noexcept = default;
+
 Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
                                std::filesystem::path OutputPath) {
   using namespace std::literals;
 
   std::unique_lock Lock(Mutex);
   spdlog::info("compile start");
+  // The lazy function bodies are required in compilation.
+  for (const auto &CodeSeg : Module.getCodeSection().getContent()) {
+    if (auto Res = CodeSeg.loadLazyBody(); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+  }
   std::filesystem::path LLPath(OutputPath);
   LLPath.replace_extension("ll"sv);
 
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
 
+  // The universal WASM output holds the code variants of the CPU levels from
+  // the highest, otherwise the code for the host or the generic CPU.
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  std::vector<CompileVariant> Variants;
+  if (CompilerConf.getOutputFormat() == CompilerConfigure::OutputFormat::Wasm) {
+    using CPULevel = CompilerConfigure::CPULevel;
+#if defined(__x86_64__)
+    const std::array<std::pair<CPULevel, std::string_view>, 4> Levels = {
+        std::pair{CPULevel::V4, "x86-64-v4"sv},
+        std::pair{CPULevel::V3, "x86-64-v3"sv},
+        std::pair{CPULevel::V2, "x86-64-v2"sv},
+        std::pair{CPULevel::Baseline, "x86-64"sv}};
+#else
+    const std::array<std::pair<CPULevel, std::string_view>, 1> Levels = {
+        std::pair{CPULevel::Baseline, "generic"sv}};
+#endif
+    for (const auto &[Level, CPUName] : Levels) {
+      if (CompilerConf.hasCPULevel(Level)) {
+        Variants.push_back(
+            {static_cast<uint8_t>(Level), std::string(CPUName), {}});
+      }
+    }
+  }
+  if (Variants.empty()) {
+    Variants.push_back(
+        {kAnyCPULevel, CompilerConf.isGenericBinary() ? "generic" : "", {}});
+  }
+  for (auto &Variant : Variants) {
+    if (auto Res = compile(Data, Module, LLPath, Variant); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+  }
+
+  switch (CompilerConf.getOutputFormat()) {
+  case CompilerConfigure::OutputFormat::Native:
+    if (auto Res = outputNativeLibrary(OutputPath, Variants.front().Objects);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  case CompilerConfigure::OutputFormat::Wasm:
+    if (auto Res = outputWasmLibrary(OutputPath, Data, Variants);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  }
+
+  return {};
+}
+
+Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                               const std::filesystem::path &LLPath,
+                               CompileVariant &Variant) {
   llvm::LLVMContext LLContext;
   llvm::Module LLModule(LLPath.u8string(), LLContext);
   LLModule.setTargetTriple(llvm::sys::getProcessTriple());
@@ -4296,33 +5373,14 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
 #elif WASMEDGE_OS_LINUX | WASMEDGE_OS_WINDOWS
   LLModule.setPICLevel(llvm::PICLevel::Level::SmallPIC);
 #endif
-  CompileContext NewContext(LLModule,
-                            Conf.getCompilerConfigure().isGenericBinary());
-  struct RAIICleanup {
-    RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
-        : Context(Context) {
-      Context = &NewContext;
-    }
-    ~RAIICleanup() { Context = nullptr; }
-    CompileContext *&Context;
-  };
+  CompileContext NewContext(LLModule, !Variant.CPUName.empty());
+  if (Variant.Level != kAnyCPULevel) {
+    NewContext.setCPULevel(
+        static_cast<CompilerConfigure::CPULevel>(Variant.Level));
+  }
+  NewContext.ModuleHash = Profile::hashModule(Data);
   RAIICleanup Cleanup(Context, NewContext);
-
-  // Compile Function Types
-  compile(Module.getTypeSection());
-  // Compile ImportSection
-  compile(Module.getImportSection());
-  // Compile GlobalSection
-  compile(Module.getGlobalSection());
-  // Compile MemorySection (MemorySec, DataSec)
-  compile(Module.getMemorySection(), Module.getDataSection());
-  // Compile TableSection (TableSec, ElemSec)
-  compile(Module.getTableSection(), Module.getElementSection());
-  // compile Functions in module. (FunctionSec, CodeSec)
-  compile(Module.getFunctionSection(), Module.getCodeSection());
-  // Compile ExportSection
-  compile(Module.getExportSection());
-  // StartSection is not required to compile
+  compile(Module);
 
   if (Conf.getCompilerConfigure().getOutputFormat() ==
       CompilerConfigure::OutputFormat::Native) {
@@ -4360,125 +5418,344 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   llvm::verifyModule(LLModule, &llvm::errs());
   spdlog::info("optimize start");
 
-  llvm::SmallString<0> OSVec;
-
-  // optimize + codegen
-  llvm::Triple Triple(LLModule.getTargetTriple());
-  {
-    std::string Error;
-    const llvm::Target *TheTarget =
-        llvm::TargetRegistry::lookupTarget(Triple.getTriple(), Error);
-    if (!TheTarget) {
-      // TODO:return error
-      spdlog::error("lookupTarget failed:{}", Error);
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const std::string CPUName = Variant.CPUName.empty()
+                                  ? llvm::sys::getHostCPUName().str()
+                                  : Variant.CPUName;
+  const std::string Features = Context->SubtargetFeatures.getString();
+  const uint32_t Threads = CompilerConf.getParallelThreads();
+  const bool IsCached = CompilerConf.isIncrementalCache();
+  auto &Objects = Variant.Objects;
+  if (Threads > 1 || IsCached) {
+    // Split the module by functions, and serialize the partitions to optimize
+    // and generate codes in separated contexts. The cached partitions are
+    // split into a fixed count, so the unchanged ones are the same.
+    std::vector<llvm::SmallString<0>> Bitcodes;
+    auto Serialize = [&Bitcodes](std::unique_ptr<llvm::Module> Part) {
+      // Remove the unused declarations, which are cloned into all partitions
+      // and change the cache keys of them.
+      for (auto &F : llvm::make_early_inc_range(Part->functions())) {
+        if (F.isDeclaration() && F.use_empty()) {
+          F.eraseFromParent();
+        }
+      }
+      for (auto &GV : llvm::make_early_inc_range(Part->globals())) {
+        if (GV.isDeclaration() && GV.use_empty() &&
+            GV.getName() != "intrinsics") {
+          GV.eraseFromParent();
+        }
+      }
+      llvm::raw_svector_ostream OS(Bitcodes.emplace_back());
+      llvm::WriteBitcodeToFile(*Part, OS);
+    };
+    const uint32_t Partitions = IsCached ? kCachePartitions : Threads;
+    // The partitions keep the source file name of the module in the bitcode,
+    // so name it regardless of the output path to share the cache.
+    LLModule.setModuleIdentifier("wasm");
+    LLModule.setSourceFileName("wasm");
+#if LLVM_VERSION_MAJOR >= 13
+    llvm::SplitModule(LLModule, Partitions, Serialize);
+#else
+    llvm::SplitModule(llvm::CloneModule(LLModule), Partitions, Serialize);
+#endif
+    Objects.resize(Bitcodes.size());
+
+    std::atomic<uint32_t> Next = 0;
+    std::atomic<bool> Failed = false;
+    auto Work = [&]() {
+      for (uint32_t I = Next.fetch_add(1); I < Bitcodes.size();
+           I = Next.fetch_add(1)) {
+        std::filesystem::path CachePath;
+        if (IsCached) {
+          CachePath = getObjectCachePath(Bitcodes[I], CompilerConf, CPUName,
+                                         Features, I == 0);
+          if (loadCachedObject(CachePath, Objects[I])) {
+            continue;
+          }
+        }
+        llvm::LLVMContext PartContext;
+        auto Part = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(Bitcodes[I].str(), LLPath.u8string()),
+            PartContext);
+        if (!Part) {
+          spdlog::error("parse partition failed:{}",
+                        llvm::toString(Part.takeError()));
+          Failed = true;
+          continue;
+        }
+        // The intrinsics table is declared in all partitions and defined in
+        // the first one.
+        if (!optimizeAndEmit(**Part, CompilerConf, CPUName, Features, I == 0,
+                             "wasm-opt-" + std::to_string(I) + ".ll",
+                             Objects[I])) {
+          Failed = true;
+        } else if (!CachePath.empty()) {
+          saveCachedObject(CachePath, Objects[I]);
+        }
+      }
+    };
+    // The calling thread works with the helpers from the pool.
+    WorkerPool::run(Pool, Threads, static_cast<uint32_t>(Bitcodes.size()),
+                    Work);
+    if (Failed) {
       return Unexpect(ErrCode::IllegalPath);
     }
+  } else if (auto Res = optimizeAndEmit(LLModule, CompilerConf, CPUName,
+                                        Features, true, "wasm-opt.ll",
+                                        Objects.emplace_back());
+             unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  return {};
+}
 
-    llvm::TargetOptions Options;
-    llvm::Reloc::Model RM = llvm::Reloc::PIC_;
-    llvm::StringRef CPUName("generic");
-    if (!Conf.getCompilerConfigure().isGenericBinary()) {
-      CPUName = llvm::sys::getHostCPUName();
-    }
-    std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
-        Triple.str(), CPUName, Context->SubtargetFeatures.getString(), Options,
-        RM, llvm::None, llvm::CodeGenOpt::Level::Aggressive));
-    LLModule.setDataLayout(TM->createDataLayout());
-
-    llvm::TargetLibraryInfoImpl TLII(Triple);
+Expect<void> Compiler::compileJIT(AST::Module &Module) {
+  std::vector<uint32_t> CodeIdxs(Module.getCodeSection().getContent().size());
+  std::iota(CodeIdxs.begin(), CodeIdxs.end(), UINT32_C(0));
+  auto Res = compileJIT(std::as_const(Module), CodeIdxs);
+  if (unlikely(!Res)) {
+    return Unexpect(Res);
+  }
 
-    {
-#if LLVM_VERSION_MAJOR == 12
-      llvm::PassBuilder PB(false, TM.get());
-#else
-      llvm::PassBuilder PB(TM.get());
-#endif
+  auto &FuncTypes = Module.getTypeSection().getContent();
+  for (size_t I = 0; I < FuncTypes.size(); ++I) {
+    FuncTypes[I].setSymbol(std::move(Res->Types[I]));
+  }
+  auto &CodeSegs = Module.getCodeSection().getContent();
+  for (size_t I = 0; I < CodeSegs.size(); ++I) {
+    CodeSegs[I].setSymbol(std::move(Res->Codes[I]));
+  }
+  Module.setSymbol(std::move(Res->Intrinsics));
+  return {};
+}
 
-      llvm::LoopAnalysisManager LAM;
-      llvm::FunctionAnalysisManager FAM;
-      llvm::CGSCCAnalysisManager CGAM;
-      llvm::ModuleAnalysisManager MAM;
+Expect<Compiler::JITCode> Compiler::compileJIT(const AST::Module &Module,
+                                               Span<const uint32_t> CodeIdxs) {
+  std::unique_lock Lock(Mutex);
+  spdlog::info("jit compile start");
+  const auto &CodeSegs = Module.getCodeSection().getContent();
+  const auto &TypeIdxs = Module.getFunctionSection().getContent();
+  std::vector<bool> CompiledCodes(CodeSegs.size());
+  std::vector<bool> CompiledTypes(Module.getTypeSection().getContent().size());
+  // The lazy function bodies are required in compilation.
+  for (const auto CodeIdx : CodeIdxs) {
+    assuming(CodeIdx < CodeSegs.size() && CodeIdx < TypeIdxs.size());
+    CompiledCodes[CodeIdx] = true;
+    CompiledTypes[TypeIdxs[CodeIdx]] = true;
+    if (auto Res = CodeSegs[CodeIdx].loadLazyBody(); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+  }
+  // Only the requested functions and the wrappers of their types are
+  // compiled, unless all of the functions are requested.
+  if (std::all_of(CompiledCodes.begin(), CompiledCodes.end(),
+                  [](bool Compiled) { return Compiled; })) {
+    CompiledCodes.clear();
+    CompiledTypes.clear();
+  }
 
-      // Register the AA manager first so that our version is the one
-      // used.
-      FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
 
-      // Register the target library analysis directly and give it a
-      // customized preset TLI.
-      FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#if LLVM_VERSION_MAJOR <= 9
-      MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#endif
+  auto JTMB = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    spdlog::error("detect host failed:{}", llvm::toString(JTMB.takeError()));
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  JTMB->setCodeGenOptLevel(llvm::CodeGenOpt::Level::Aggressive);
+  auto TM = JTMB->createTargetMachine();
+  if (!TM) {
+    spdlog::error("create target machine failed:{}",
+                  llvm::toString(TM.takeError()));
+    return Unexpect(ErrCode::IllegalPath);
+  }
 
-      // Register all the basic analyses with the managers.
-      PB.registerModuleAnalyses(MAM);
-      PB.registerCGSCCAnalyses(CGAM);
-      PB.registerFunctionAnalyses(FAM);
-      PB.registerLoopAnalyses(LAM);
-      PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
-
-      llvm::ModulePassManager MPM;
-      if (Conf.getCompilerConfigure().getOptimizationLevel() ==
-          CompilerConfigure::OptimizationLevel::O0) {
-        MPM.addPass(llvm::AlwaysInlinerPass(false));
-      } else {
-        MPM.addPass(PB.buildPerModuleDefaultPipeline(
-            toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel())));
-      }
+  auto LLContext = std::make_unique<llvm::LLVMContext>();
+  auto LLModule = std::make_unique<llvm::Module>("wasm", *LLContext);
+  LLModule->setTargetTriple(llvm::sys::getProcessTriple());
+  LLModule->setDataLayout((*TM)->createDataLayout());
+  {
+    CompileContext NewContext(*LLModule, false);
+    NewContext.CompiledCodes = std::move(CompiledCodes);
+    NewContext.ModuleHash = Module.getHash();
+    NewContext.CompiledTypes = CompiledTypes;
+    RAIICleanup Cleanup(Context, NewContext);
+    compile(Module);
+  }
 
-      MPM.run(LLModule, MAM);
+  spdlog::info("verify start");
+  if (llvm::verifyModule(*LLModule, &llvm::errs())) {
+    spdlog::error("verify module failed");
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  spdlog::info("optimize start");
+  llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule->getTargetTriple()));
+  optimizeModule(*LLModule, Conf.getCompilerConfigure(), **TM, TLII);
+
+  // The functions of a module are compiled into the same JIT, which owns the
+  // generated code kept alive by the symbols. The libm and memory functions
+  // called by the generated code are resolved in the current process.
+  auto State = std::static_pointer_cast<JITState>(Module.getCompilerState(
+      []() -> std::shared_ptr<void> { return std::make_shared<JITState>(); }));
+  std::unique_lock StateLock(State->Mutex);
+  if (!State->JIT) {
+    auto JIT = llvm::orc::LLJITBuilder()
+                   .setJITTargetMachineBuilder(std::move(*JTMB))
+                   .create();
+    if (!JIT) {
+      spdlog::error("create jit failed:{}", llvm::toString(JIT.takeError()));
+      return Unexpect(ErrCode::IllegalPath);
     }
-
-    // Set initializer for constant value
-    if (auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics")) {
-      IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
-          llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
-      IntrinsicsTable->setConstant(false);
+    auto Generator =
+        llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            (*JIT)->getDataLayout().getGlobalPrefix());
+    if (!Generator) {
+      spdlog::error("create generator failed:{}",
+                    llvm::toString(Generator.takeError()));
+      return Unexpect(ErrCode::IllegalPath);
     }
+    (*JIT)->getMainJITDylib().addGenerator(std::move(*Generator));
+    State->JIT = std::move(*JIT);
+  }
+  std::shared_ptr<llvm::orc::LLJIT> Owner = State->JIT;
 
-    llvm::legacy::PassManager CodeGenPasses;
-    CodeGenPasses.add(
-        llvm::createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
-
-    // Add LibraryInfo.
-    CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
-
-    llvm::raw_svector_ostream OS(OSVec);
-#if LLVM_VERSION_MAJOR >= 10
-    using llvm::CGFT_ObjectFile;
+  // The intrinsics table is defined by the first compilation and shared by the
+  // later ones. The other definitions are suffixed by the generation, so the
+  // symbols of the compilations do not collide.
+  if (State->Generation == 0) {
+    defineIntrinsicsTable(*LLModule);
+  }
+  const auto Suffix = "." + std::to_string(State->Generation);
+  for (auto &GV : LLModule->global_values()) {
+    if (!GV.isDeclaration() && GV.hasExternalLinkage() &&
+        GV.getName() != "intrinsics") {
+      GV.setName(GV.getName() + Suffix);
+    }
+  }
+  if (auto Err = Owner->addIRModule(llvm::orc::ThreadSafeModule(
+          std::move(LLModule), std::move(LLContext)))) {
+    spdlog::error("add module failed:{}", llvm::toString(std::move(Err)));
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  ++State->Generation;
+
+  spdlog::info("codegen start");
+  auto Lookup = [&Owner](const std::string &Name) -> void * {
+    auto Sym = Owner->lookup(Name);
+    if (!Sym) {
+      spdlog::error("lookup {} failed:{}", Name,
+                    llvm::toString(Sym.takeError()));
+      return nullptr;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    return reinterpret_cast<void *>(Sym->getValue());
 #else
-    const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
+    return reinterpret_cast<void *>(Sym->getAddress());
 #endif
-    if (TM->addPassesToEmitFile(CodeGenPasses, OS, nullptr, CGFT_ObjectFile,
-                                false)) {
-      // TODO:return error
-      spdlog::error("addPassesToEmitFile failed");
+  };
+
+  JITCode Code;
+  const auto &FuncTypes = Module.getTypeSection().getContent();
+  Code.Types.resize(FuncTypes.size());
+  for (size_t I = 0; I < FuncTypes.size(); ++I) {
+    if (!CompiledTypes.empty() && !CompiledTypes[I]) {
+      continue;
+    }
+    auto *Ptr = Lookup("t" + std::to_string(I) + Suffix);
+    if (unlikely(!Ptr)) {
       return Unexpect(ErrCode::IllegalPath);
     }
-
-    if (Conf.getCompilerConfigure().isDumpIR()) {
-      int Fd;
-      llvm::sys::fs::openFileForWrite("wasm-opt.ll", Fd);
-      llvm::raw_fd_ostream LLOS(Fd, true);
-      LLModule.print(LLOS, nullptr);
+    Code.Types[I] = Symbol<AST::FunctionType::Wrapper>(
+        Owner, reinterpret_cast<AST::FunctionType::Wrapper *>(Ptr));
+  }
+  size_t Offset = 0;
+  for (const auto &ImpDesc : Module.getImportSection().getContent()) {
+    if (ImpDesc.getExternalType() == ExternalType::Function) {
+      ++Offset;
     }
-    spdlog::info("codegen start");
-    CodeGenPasses.run(LLModule);
   }
+  Code.Codes.resize(CodeSegs.size());
+  for (const auto CodeIdx : CodeIdxs) {
+    auto *Ptr = Lookup("f" + std::to_string(CodeIdx + Offset) + Suffix);
+    if (unlikely(!Ptr)) {
+      return Unexpect(ErrCode::IllegalPath);
+    }
+    Code.Codes[CodeIdx] = Symbol<void>(Owner, Ptr);
+  }
+  auto *Intrinsics = Lookup("intrinsics");
+  if (unlikely(!Intrinsics)) {
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  Code.Intrinsics = Symbol<const AST::Module::IntrinsicsTable *>(
+      Owner,
+      reinterpret_cast<const AST::Module::IntrinsicsTable **>(Intrinsics));
+  spdlog::info("jit compile done");
+  return Code;
+}
 
-  switch (Conf.getCompilerConfigure().getOutputFormat()) {
-  case CompilerConfigure::OutputFormat::Native:
-    if (auto Res = outputNativeLibrary(OutputPath, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
+void Compiler::compile(const AST::Module &Module) {
+  // Compile Function Types
+  compile(Module.getTypeSection());
+  // Compile ImportSection
+  compile(Module.getImportSection());
+  // Compile GlobalSection
+  compile(Module.getGlobalSection());
+  // Compile MemorySection (MemorySec, DataSec)
+  compile(Module.getMemorySection(), Module.getDataSection());
+  // Compile TableSection (TableSec, ElemSec)
+  compile(Module.getTableSection(), Module.getElementSection());
+  // compile Functions in module. (FunctionSec, CodeSec)
+  compile(Module.getFunctionSection(), Module.getCodeSection());
+  // Compile ExportSection
+  compile(Module.getExportSection());
+  // StartSection is not required to compile
+}
+
+std::filesystem::path Compiler::getCachePath(Span<const Byte> Data,
+                                             const Configure &Conf) {
+  using namespace std::literals;
+  std::vector<Byte> Key(Data.begin(), Data.end());
+  auto Append = [&Key](std::string_view Str) {
+    Key.insert(Key.end(), Str.begin(), Str.end());
+    Key.push_back(0);
+  };
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    Key.push_back(
+        static_cast<Byte>(Conf.hasProposal(static_cast<Proposal>(I)) ? 1 : 0));
+  }
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const auto &StatConf = Conf.getStatisticsConfigure();
+  Key.push_back(static_cast<Byte>(CompilerConf.getOptimizationLevel()));
+  Key.push_back(static_cast<Byte>(CompilerConf.isInterruptible() ? 1 : 0));
+  Key.push_back(static_cast<Byte>(StatConf.isInstructionCounting() ? 1 : 0));
+  Key.push_back(static_cast<Byte>(StatConf.isCostMeasuring() ? 1 : 0));
+  Key.push_back(static_cast<Byte>(StatConf.isTimeMeasuring() ? 1 : 0));
+  for (uint32_t I = 0; I < 32; I += 8) {
+    Key.push_back(static_cast<Byte>(kBinaryVersion >> I));
+  }
+  if (CompilerConf.isGenericBinary()) {
+    Append("generic"sv);
+  } else {
+    const auto CPUName = llvm::sys::getHostCPUName();
+    Append(std::string_view(CPUName.data(), CPUName.size()));
+    llvm::StringMap<bool> FeatureMap;
+    llvm::sys::getHostCPUFeatures(FeatureMap);
+    std::vector<std::string_view> Features;
+    for (const auto &Feature : FeatureMap) {
+      if (Feature.second) {
+        Features.emplace_back(Feature.first().data(), Feature.first().size());
+      }
     }
-    break;
-  case CompilerConfigure::OutputFormat::Wasm:
-    if (auto Res = outputWasmLibrary(OutputPath, Data, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
+    // The order of the string map is unspecified.
+    std::sort(Features.begin(), Features.end());
+    for (const auto Feature : Features) {
+      Append(Feature);
     }
-    break;
   }
-
+  if (auto Res = Cache::getPath(Key, Cache::StorageScope::Local, "vm"sv);
+      Res && Res->is_absolute()) {
+    return Res->replace_extension(EXTENSION);
+  }
   return {};
 }
 
@@ -4501,12 +5778,19 @@ void Compiler::compile(const AST::TypeSection &TypeSec) {
     const auto &FuncType = FuncTypes[I];
     const auto Name = "t" + std::to_string(Context->FunctionTypes.size());
 
+    // Skip the wrappers not required by the compiled functions.
+    if (!Context->CompiledTypes.empty() && !Context->CompiledTypes[I]) {
+      Context->FunctionTypes.push_back(&FuncType);
+      Context->FunctionWrappers.push_back(nullptr);
+      continue;
+    }
+
     // Check function type is unique
     {
       bool Unique = true;
       for (size_t J = 0; J < I; ++J) {
         const auto &OldFuncType = *Context->FunctionTypes[J];
-        if (OldFuncType == FuncType) {
+        if (Context->FunctionWrappers[J] && OldFuncType == FuncType) {
           Unique = false;
           Context->FunctionTypes.push_back(&OldFuncType);
           auto *F = Context->FunctionWrappers[J];
@@ -4602,78 +5886,18 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       const auto &FuncType = *Context->FunctionTypes[TypeIdx];
 
       auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
-      auto *RTy = FTy->getReturnType();
       auto *F = llvm::Function::Create(FTy, llvm::Function::PrivateLinkage,
                                        "f" + std::to_string(FuncID),
                                        Context->LLModule);
       F->addFnAttr(llvm::Attribute::StrictFP);
       F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
       F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
-
-      auto *Entry = llvm::BasicBlock::Create(Context->LLContext, "entry", F);
-      llvm::IRBuilder<> Builder(Entry);
-      setIsFPConstrained(Builder);
-
-      const auto ArgSize = FuncType.getParamTypes().size();
-      const auto RetSize =
-          RTy->isVoidTy() ? 0 : FuncType.getReturnTypes().size();
-
-      llvm::Value *Args;
-      if (ArgSize == 0) {
-        Args = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
-      } else {
-        auto *Alloca = Builder.CreateAlloca(
-            Context->Int8Ty, Builder.getInt64(ArgSize * kValSize));
-        Alloca->setAlignment(Align(kValSize));
-        Args = Alloca;
-      }
-
-      llvm::Value *Rets;
-      if (RetSize == 0) {
-        Rets = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
-      } else {
-        auto *Alloca = Builder.CreateAlloca(
-            Context->Int8Ty, Builder.getInt64(RetSize * kValSize));
-        Alloca->setAlignment(Align(kValSize));
-        Rets = Alloca;
-      }
-
-      for (unsigned I = 0; I < ArgSize; ++I) {
-        llvm::Argument *Arg = F->arg_begin() + 1 + I;
-        llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
-            Context->Int8Ty, Args, I * kValSize);
-        Builder.CreateStore(
-            Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
-      }
-
-      Builder.CreateCall(
-          Context->getIntrinsic(
-              Builder, AST::Module::Intrinsics::kCall,
-              llvm::FunctionType::get(
-                  Context->VoidTy,
-                  {Context->Int32Ty, Context->Int8PtrTy, Context->Int8PtrTy},
-                  false)),
-          {Builder.getInt32(FuncID), Args, Rets});
-
-      if (RetSize == 0) {
-        Builder.CreateRetVoid();
-      } else if (RetSize == 1) {
-        llvm::Value *VPtr =
-            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, Rets, 0);
-        llvm::Value *Ptr =
-            Builder.CreateBitCast(VPtr, F->getReturnType()->getPointerTo());
-        Builder.CreateRet(Builder.CreateLoad(F->getReturnType(), Ptr));
+      // Only the imports called by the compiled functions are defined if a
+      // part of the functions are compiled.
+      if (Context->CompiledCodes.empty()) {
+        compileImportCall(*Context, F, FuncType, FuncID);
       } else {
-        std::vector<llvm::Value *> Ret;
-        Ret.reserve(RetSize);
-        for (unsigned I = 0; I < RetSize; ++I) {
-          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
-              Context->Int8Ty, Rets, I * kValSize);
-          llvm::Value *Ptr = Builder.CreateBitCast(
-              VPtr, RTy->getStructElementType(I)->getPointerTo());
-          Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
-        }
-        Builder.CreateAggregateRet(Ret.data(), static_cast<uint32_t>(RetSize));
+        F->setLinkage(llvm::Function::ExternalLinkage);
       }
 
       Context->Functions.emplace_back(TypeIdx, F, nullptr);
@@ -4686,7 +5910,8 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
     }
     case ExternalType::Memory: // Memory type
     {
-      // Nothing to do.
+      const auto &MemType = ImpDesc.getExternalMemoryType();
+      Context->IsMemory64.push_back(MemType.getLimit().is64());
       break;
     }
     case ExternalType::Global: // Global type
@@ -4714,7 +5939,12 @@ void Compiler::compile(const AST::GlobalSection &GlobalSec) {
   }
 }
 
-void Compiler::compile(const AST::MemorySection &, const AST::DataSection &) {}
+void Compiler::compile(const AST::MemorySection &MemorySec,
+                       const AST::DataSection &) {
+  for (const auto &MemType : MemorySec.getContent()) {
+    Context->IsMemory64.push_back(MemType.getLimit().is64());
+  }
+}
 
 void Compiler::compile(const AST::TableSection &, const AST::ElementSection &) {
 }
@@ -4744,10 +5974,52 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
     Context->Functions.emplace_back(TypeIdx, F, &Code);
   }
 
-  for (auto [T, F, Code] : Context->Functions) {
+  // The function entry counts and the profile summary let the optimizations
+  // and the code placement tell the hot functions from the cold ones. The
+  // profile collected from another binary is rejected, because the offsets
+  // of its counters do not match the instructions of this one.
+  const auto Prof = Conf.getCompilerConfigure().getProfile();
+  const uint64_t Hash = Context->ModuleHash;
+  std::optional<llvm::InstrProfSummaryBuilder> SummaryBuilder;
+  if (Prof && Prof->hasModule(Hash)) {
+    SummaryBuilder.emplace(llvm::ProfileSummaryBuilder::DefaultCutoffs);
+  } else if (Prof && !Prof->empty()) {
+    spdlog::warn("profile mismatch: no counters of the module {:016x}, "
+                 "compiling without the profile",
+                 Hash);
+  }
+
+  uint32_t CodeIdx = 0;
+  for (uint32_t FuncID = 0; FuncID < Context->Functions.size(); ++FuncID) {
+    auto [T, F, Code] = Context->Functions[FuncID];
     if (!Code) {
       continue;
     }
+    if (!Context->CompiledCodes.empty() &&
+        !Context->CompiledCodes[CodeIdx++]) {
+      continue;
+    }
+
+    if (SummaryBuilder) {
+      // The first count of the record is the entry count, and the others are
+      // the counts of the branch targets.
+      const auto Instrs = Code->getExpr().getInstrs();
+      llvm::InstrProfRecord Record;
+      Record.Counts.push_back(
+          Prof->getEntryCount(Hash, Instrs.begin()->getOffset()));
+      for (const auto &Instr : Instrs) {
+        if (Instr.getOpCode() == OpCode::If ||
+            Instr.getOpCode() == OpCode::Br_if) {
+          const auto [Taken, NotTaken] =
+              Prof->getBranchCount(Hash, Instr.getOffset());
+          Record.Counts.push_back(Taken);
+          Record.Counts.push_back(NotTaken);
+        }
+      }
+      F->setEntryCount(llvm::Function::ProfileCount(
+          Record.Counts.front(), llvm::Function::PCT_Real));
+      SummaryBuilder->addRecord(Record);
+    }
 
     std::vector<ValType> Locals;
     for (const auto &Local : Code->getLocals()) {
@@ -4760,11 +6032,41 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
                         Conf.getStatisticsConfigure().isInstructionCounting(),
                         Conf.getStatisticsConfigure().isCostMeasuring(),
                         Conf.getCompilerConfigure().getOptimizationLevel() ==
-                            CompilerConfigure::OptimizationLevel::O0);
+                            CompilerConfigure::OptimizationLevel::O0,
+                        SummaryBuilder ? Prof.get() : nullptr);
     auto Type = Context->resolveBlockType(T);
     FC.compile(*Code, std::move(Type));
     llvm::EliminateUnreachableBlocks(*F);
   }
+
+  if (SummaryBuilder) {
+    Context->LLModule.setProfileSummary(
+        SummaryBuilder->getSummary()->getMD(Context->LLContext),
+        llvm::ProfileSummary::PSK_Instr);
+  }
+
+  // Only the functions called by the compiled ones are defined if a part of
+  // the functions are compiled, which call through the executor or the
+  // resolved imports.
+  if (!Context->CompiledCodes.empty()) {
+    for (uint32_t FuncID = 0; FuncID < Context->Functions.size(); ++FuncID) {
+      auto [T, F, Code] = Context->Functions[FuncID];
+      if (!F->isDeclaration()) {
+        continue;
+      }
+      if (F->use_empty()) {
+        F->eraseFromParent();
+        std::get<1>(Context->Functions[FuncID]) = nullptr;
+        continue;
+      }
+      F->setLinkage(llvm::Function::InternalLinkage);
+      if (Code) {
+        compileExecutorCall(*Context, F, *Context->FunctionTypes[T], FuncID);
+      } else {
+        compileImportCall(*Context, F, *Context->FunctionTypes[T], FuncID);
+      }
+    }
+  }
 }
 
 } // namespace AOT
@@ -29,11 +29,20 @@ struct WasmEdge_ConfigureContext {
 // WasmEdge_StatisticsContext implementation.
 struct WasmEdge_StatisticsContext {};
 
+// WasmEdge_MemoryBudgetContext implementation.
+struct WasmEdge_MemoryBudgetContext {
+  WasmEdge_MemoryBudgetContext(const uint64_t Page) noexcept
+      : Budget(std::make_shared<WasmEdge::MemoryBudget>(Page)) {}
+  std::shared_ptr<WasmEdge::MemoryBudget> Budget;
+};
+
 // WasmEdge_ASTModuleContext implementation.
 struct WasmEdge_ASTModuleContext {
   WasmEdge_ASTModuleContext(std::unique_ptr<WasmEdge::AST::Module> Mod) noexcept
       : Module(std::move(Mod)) {}
-  std::unique_ptr<WasmEdge::AST::Module> Module;
+  /// The loaded module is immutable and shared with the instantiated functions
+  /// and the VMs.
+  std::shared_ptr<const WasmEdge::AST::Module> Module;
 };
 
 // WasmEdge_FunctionTypeContext implementation.
@@ -72,6 +81,13 @@ struct WasmEdge_LoaderContext {
   WasmEdge::Loader::Loader Load;
 };
 
+// WasmEdge_LoaderStreamContext implementation.
+struct WasmEdge_LoaderStreamContext {
+  WasmEdge_LoaderStreamContext(const WasmEdge::Configure &Conf) noexcept
+      : Stream(Conf) {}
+  WasmEdge::Loader::Loader::Stream Stream;
+};
+
 // WasmEdge_ValidatorContext implementation.
 struct WasmEdge_ValidatorContext {
   WasmEdge_ValidatorContext(const WasmEdge::Configure &Conf) noexcept
@@ -620,7 +636,8 @@ WasmEdge_ResultGetMessage(const WasmEdge_Result Res) {
 WASMEDGE_CAPI_EXPORT bool WasmEdge_LimitIsEqual(const WasmEdge_Limit Lim1,
                                                 const WasmEdge_Limit Lim2) {
   return Lim1.HasMax == Lim2.HasMax && Lim1.Min == Lim2.Min &&
-         Lim1.Max == Lim2.Max;
+         Lim1.Max == Lim2.Max && Lim1.Shared == Lim2.Shared &&
+         Lim1.Is64 == Lim2.Is64;
 }
 
 // <<<<<<<< WasmEdge limit functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -700,6 +717,158 @@ WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt) {
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetMaxMemory64Page(WasmEdge_ConfigureContext *Cxt,
+                                     const uint64_t Page) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMaxMemory64Page(Page);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_ConfigureGetMaxMemory64Page(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMaxMemory64Page();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureSetMemoryBudget(
+    WasmEdge_ConfigureContext *Cxt,
+    const WasmEdge_MemoryBudgetContext *BudgetCxt) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMemoryBudget(
+        BudgetCxt ? BudgetCxt->Budget : nullptr);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetAOTCache(WasmEdge_ConfigureContext *Cxt,
+                              const bool IsCache) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setAOTCache(IsCache);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsAOTCache(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isAOTCache();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetJIT(WasmEdge_ConfigureContext *Cxt, const bool IsJIT) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setJIT(IsJIT);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsJIT(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isJIT();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetTieredThreshold(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setTieredThreshold(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetTieredThreshold(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getTieredThreshold();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetLazyJIT(WasmEdge_ConfigureContext *Cxt,
+                             const bool IsLazyJIT) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setLazyJIT(IsLazyJIT);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsLazyJIT(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isLazyJIT();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureLoaderSetParallelThreads(WasmEdge_ConfigureContext *Cxt,
+                                           const uint32_t Threads) {
+  if (Cxt) {
+    Cxt->Conf.getLoaderConfigure().setParallelThreads(Threads);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureLoaderGetParallelThreads(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getLoaderConfigure().getParallelThreads();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureLoaderSetLazyFunctionBody(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsLazy) {
+  if (Cxt) {
+    Cxt->Conf.getLoaderConfigure().setLazyFunctionBody(IsLazy);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureLoaderIsLazyFunctionBody(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getLoaderConfigure().isLazyFunctionBody();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureLoaderSetFlatImageCache(WasmEdge_ConfigureContext *Cxt,
+                                          const bool IsCache) {
+  if (Cxt) {
+    Cxt->Conf.getLoaderConfigure().setFlatImageCache(IsCache);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureLoaderIsFlatImageCache(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getLoaderConfigure().isFlatImageCache();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureLoaderSetFusedValidation(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsFused) {
+  if (Cxt) {
+    Cxt->Conf.getLoaderConfigure().setFusedValidation(IsFused);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureLoaderIsFusedValidation(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getLoaderConfigure().isFusedValidation();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureCompilerSetOptimizationLevel(
     WasmEdge_ConfigureContext *Cxt,
     const enum WasmEdge_CompilerOptimizationLevel Level) {
@@ -786,6 +955,64 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsInterruptible(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetParallelThreads(WasmEdge_ConfigureContext *Cxt,
+                                             const uint32_t Threads) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setParallelThreads(Threads);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureCompilerGetParallelThreads(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getParallelThreads();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetIncrementalCache(WasmEdge_ConfigureContext *Cxt,
+                                              const bool IsCache) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setIncrementalCache(IsCache);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsIncrementalCache(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().isIncrementalCache();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureCompilerAddCPULevel(
+    WasmEdge_ConfigureContext *Cxt,
+    const enum WasmEdge_CompilerCPULevel Level) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().addCPULevel(
+        static_cast<WasmEdge::CompilerConfigure::CPULevel>(Level));
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerHasCPULevel(
+    const WasmEdge_ConfigureContext *Cxt,
+    const enum WasmEdge_CompilerCPULevel Level) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().hasCPULevel(
+        static_cast<WasmEdge::CompilerConfigure::CPULevel>(Level));
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerClearCPULevels(WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().clearCPULevels();
+  }
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetInstructionCounting(
     WasmEdge_ConfigureContext *Cxt, const bool IsCount) {
   if (Cxt) {
@@ -894,6 +1121,52 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt) {
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge memory budget functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT WasmEdge_MemoryBudgetContext *
+WasmEdge_MemoryBudgetCreate(const uint64_t Page) {
+  return new WasmEdge_MemoryBudgetContext(Page);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_MemoryBudgetSetLimit(WasmEdge_MemoryBudgetContext *Cxt,
+                              const uint64_t Page) {
+  if (Cxt) {
+    Cxt->Budget->setLimit(Page);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_MemoryBudgetGetLimit(const WasmEdge_MemoryBudgetContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Budget->getLimit();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_MemoryBudgetGetUsage(const WasmEdge_MemoryBudgetContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Budget->getUsage();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_MemoryBudgetGetPeak(const WasmEdge_MemoryBudgetContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Budget->getPeak();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_MemoryBudgetDelete(WasmEdge_MemoryBudgetContext *Cxt) {
+  delete Cxt;
+}
+
+// <<<<<<<< WasmEdge memory budget functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge AST module functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT uint32_t
@@ -944,6 +1217,46 @@ WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ASTModuleListExports(
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ASTModuleListCustomSectionsLength(
+    const WasmEdge_ASTModuleContext *Cxt) {
+  if (Cxt) {
+    return static_cast<uint32_t>(Cxt->Module->getCustomSections().size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_String
+WasmEdge_ASTModuleGetCustomSectionName(const WasmEdge_ASTModuleContext *Cxt,
+                                       const uint32_t Index) {
+  if (Cxt && Index < Cxt->Module->getCustomSections().size()) {
+    auto StrView = Cxt->Module->getCustomSections()[Index].getName();
+    return WasmEdge_String{.Length = static_cast<uint32_t>(StrView.length()),
+                           .Buf = StrView.data()};
+  }
+  return WasmEdge_String{.Length = 0, .Buf = nullptr};
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ASTModuleGetCustomSectionContent(
+    const WasmEdge_ASTModuleContext *Cxt, const uint32_t Index,
+    const uint8_t *Buf, const uint32_t BufLen, const uint8_t **Content,
+    uint32_t *Length) {
+  return wrap(
+      [&]() -> Expect<Span<const Byte>> {
+        const auto &Secs = Cxt->Module->getCustomSections();
+        if (Index >= Secs.size()) {
+          return Unexpect(ErrCode::WrongVMWorkflow);
+        }
+        return Loader::Loader::getCustomSectionContent(
+            Secs[Index], Buf ? genSpan(Buf, BufLen) : Span<const Byte>());
+      },
+      [&](auto &&Res) {
+        *Content = Res->data();
+        *Length = static_cast<uint32_t>(Res->size());
+      },
+      Cxt, Content, Length);
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ASTModuleDelete(WasmEdge_ASTModuleContext *Cxt) {
   delete Cxt;
@@ -1049,10 +1362,14 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Limit
 WasmEdge_TableTypeGetLimit(const WasmEdge_TableTypeContext *Cxt) {
   if (Cxt) {
     const auto &Lim = fromTabTypeCxt(Cxt)->getLimit();
-    return WasmEdge_Limit{
-        .HasMax = Lim.hasMax(), .Min = Lim.getMin(), .Max = Lim.getMax()};
+    return WasmEdge_Limit{.HasMax = Lim.hasMax(),
+                          .Min = static_cast<uint32_t>(Lim.getMin()),
+                          .Max = static_cast<uint32_t>(Lim.getMax()),
+                          .Shared = false,
+                          .Is64 = false};
   }
-  return WasmEdge_Limit{.HasMax = false, .Min = 0, .Max = 0};
+  return WasmEdge_Limit{
+      .HasMax = false, .Min = 0, .Max = 0, .Shared = false, .Is64 = false};
 }
 
 WASMEDGE_CAPI_EXPORT void
@@ -1066,21 +1383,26 @@ WasmEdge_TableTypeDelete(WasmEdge_TableTypeContext *Cxt) {
 
 WASMEDGE_CAPI_EXPORT WasmEdge_MemoryTypeContext *
 WasmEdge_MemoryTypeCreate(const WasmEdge_Limit Limit) {
-  if (Limit.HasMax) {
-    return toMemTypeCxt(new WasmEdge::AST::MemoryType(Limit.Min, Limit.Max));
-  } else {
-    return toMemTypeCxt(new WasmEdge::AST::MemoryType(Limit.Min));
-  }
+  WasmEdge::AST::Limit Lim = Limit.HasMax
+                                 ? WasmEdge::AST::Limit(Limit.Min, Limit.Max)
+                                 : WasmEdge::AST::Limit(Limit.Min);
+  Lim.setShared(Limit.Shared);
+  Lim.setIs64(Limit.Is64);
+  return toMemTypeCxt(new WasmEdge::AST::MemoryType(Lim));
 }
 
 WASMEDGE_CAPI_EXPORT WasmEdge_Limit
 WasmEdge_MemoryTypeGetLimit(const WasmEdge_MemoryTypeContext *Cxt) {
   if (Cxt) {
     const auto &Lim = fromMemTypeCxt(Cxt)->getLimit();
-    return WasmEdge_Limit{
-        .HasMax = Lim.hasMax(), .Min = Lim.getMin(), .Max = Lim.getMax()};
+    return WasmEdge_Limit{.HasMax = Lim.hasMax(),
+                          .Min = static_cast<uint32_t>(Lim.getMin()),
+                          .Max = static_cast<uint32_t>(Lim.getMax()),
+                          .Shared = Lim.isShared(),
+                          .Is64 = Lim.is64()};
   }
-  return WasmEdge_Limit{.HasMax = false, .Min = 0, .Max = 0};
+  return WasmEdge_Limit{
+      .HasMax = false, .Min = 0, .Max = 0, .Shared = false, .Is64 = false};
 }
 
 WASMEDGE_CAPI_EXPORT void
@@ -1419,6 +1741,37 @@ WASMEDGE_CAPI_EXPORT void WasmEdge_LoaderDelete(WasmEdge_LoaderContext *Cxt) {
   delete Cxt;
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_LoaderStreamContext *
+WasmEdge_LoaderStreamCreate(const WasmEdge_ConfigureContext *ConfCxt) {
+  if (ConfCxt) {
+    return new WasmEdge_LoaderStreamContext(ConfCxt->Conf);
+  } else {
+    return new WasmEdge_LoaderStreamContext(WasmEdge::Configure());
+  }
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_LoaderStreamPush(WasmEdge_LoaderStreamContext *Cxt,
+                          const uint8_t *Buf, const uint32_t BufLen) {
+  return wrap([&]() { return Cxt->Stream.push(genSpan(Buf, BufLen)); },
+              EmptyThen, Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_LoaderStreamFinish(WasmEdge_LoaderStreamContext *Cxt,
+                            WasmEdge_ASTModuleContext **Module) {
+  return wrap([&]() { return Cxt->Stream.finish(); },
+              [&](auto &&Res) {
+                *Module = new WasmEdge_ASTModuleContext(std::move(*Res));
+              },
+              Cxt, Module);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_LoaderStreamDelete(WasmEdge_LoaderStreamContext *Cxt) {
+  delete Cxt;
+}
+
 // <<<<<<<< WasmEdge loader functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge validator functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -1435,7 +1788,7 @@ WasmEdge_ValidatorCreate(const WasmEdge_ConfigureContext *ConfCxt) {
 WASMEDGE_CAPI_EXPORT WasmEdge_Result
 WasmEdge_ValidatorValidate(WasmEdge_ValidatorContext *Cxt,
                            const WasmEdge_ASTModuleContext *ModuleCxt) {
-  return wrap([&]() { return Cxt->Valid.validate(*ModuleCxt->Module.get()); },
+  return wrap([&]() { return Cxt->Valid.validate(*ModuleCxt->Module); },
               EmptyThen, Cxt, ModuleCxt);
 }
 
@@ -1473,7 +1826,7 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorInstantiate(
   return wrap(
       [&]() {
         return Cxt->Exec.instantiateModule(*fromStoreCxt(StoreCxt),
-                                           *ASTCxt->Module.get());
+                                           ASTCxt->Module);
       },
       EmptyThen, Cxt, StoreCxt, ASTCxt);
 }
@@ -1495,8 +1848,7 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorRegisterModule(
   return wrap(
       [&]() {
         return Cxt->Exec.registerModule(*fromStoreCxt(StoreCxt),
-                                        *ASTCxt->Module.get(),
-                                        genStrView(ModuleName));
+                                        ASTCxt->Module, genStrView(ModuleName));
       },
       EmptyThen, Cxt, StoreCxt, ASTCxt);
 }
@@ -2197,8 +2549,12 @@ WasmEdge_TableInstanceDelete(WasmEdge_TableInstanceContext *Cxt) {
 WASMEDGE_CAPI_EXPORT WasmEdge_MemoryInstanceContext *
 WasmEdge_MemoryInstanceCreate(const WasmEdge_MemoryTypeContext *MemType) {
   if (MemType) {
-    return toMemCxt(new WasmEdge::Runtime::Instance::MemoryInstance(
-        *fromMemTypeCxt(MemType)));
+    const auto &Type = *fromMemTypeCxt(MemType);
+    if (Type.getLimit().is64()) {
+      return toMemCxt(new WasmEdge::Runtime::Instance::MemoryInstance(
+          Type, WasmEdge::RuntimeConfigure().getMaxMemory64Page()));
+    }
+    return toMemCxt(new WasmEdge::Runtime::Instance::MemoryInstance(Type));
   }
   return nullptr;
 }
@@ -2253,7 +2609,8 @@ WASMEDGE_CAPI_EXPORT const uint8_t *WasmEdge_MemoryInstanceGetPointerConst(
 WASMEDGE_CAPI_EXPORT uint32_t
 WasmEdge_MemoryInstanceGetPageSize(const WasmEdge_MemoryInstanceContext *Cxt) {
   if (Cxt) {
-    return fromMemCxt(Cxt)->getPageSize();
+    return static_cast<uint32_t>(std::min(fromMemCxt(Cxt)->getPageSize(),
+                                          uint64_t(UINT32_MAX)));
   }
   return 0;
 }
@@ -2589,8 +2946,7 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMRegisterModuleFromASTModule(
     const WasmEdge_ASTModuleContext *ASTCxt) {
   return wrap(
       [&]() {
-        return Cxt->VM.registerModule(genStrView(ModuleName),
-                                      *ASTCxt->Module.get());
+        return Cxt->VM.registerModule(genStrView(ModuleName), ASTCxt->Module);
       },
       EmptyThen, Cxt, ASTCxt);
 }
@@ -2632,7 +2988,7 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMRunWasmFromASTModule(
   auto ParamPair = genParamPair(Params, ParamLen);
   return wrap(
       [&]() {
-        return Cxt->VM.runWasmFile(*ASTCxt->Module.get(), genStrView(FuncName),
+        return Cxt->VM.runWasmFile(ASTCxt->Module, genStrView(FuncName),
                                    ParamPair.first, ParamPair.second);
       },
       [&](auto &&Res) { fillWasmEdge_ValueArr(*Res, Returns, ReturnLen); }, Cxt,
@@ -2671,7 +3027,7 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Async *WasmEdge_VMAsyncRunWasmFromASTModule(
   auto ParamPair = genParamPair(Params, ParamLen);
   if (Cxt && ASTCxt) {
     return new WasmEdge_Async(
-        Cxt->VM.asyncRunWasmFile(*ASTCxt->Module.get(), genStrView(FuncName),
+        Cxt->VM.asyncRunWasmFile(ASTCxt->Module, genStrView(FuncName),
                                  ParamPair.first, ParamPair.second));
   }
   return nullptr;
@@ -2692,8 +3048,8 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMLoadWasmFromBuffer(
 
 WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMLoadWasmFromASTModule(
     WasmEdge_VMContext *Cxt, const WasmEdge_ASTModuleContext *ASTCxt) {
-  return wrap([&]() { return Cxt->VM.loadWasm(*ASTCxt->Module.get()); },
-              EmptyThen, Cxt, ASTCxt);
+  return wrap([&]() { return Cxt->VM.loadWasm(ASTCxt->Module); }, EmptyThen,
+              Cxt, ASTCxt);
 }
 
 WASMEDGE_CAPI_EXPORT WasmEdge_Result
@@ -2861,6 +3217,22 @@ WasmEdge_VMGetStatisticsContext(WasmEdge_VMContext *Cxt) {
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_VMGetMemoryUsage(const WasmEdge_VMContext *Cxt) {
+  if (Cxt) {
+    return Cxt->VM.getMemoryBudget().getUsage();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_VMGetMemoryPeak(const WasmEdge_VMContext *Cxt) {
+  if (Cxt) {
+    return Cxt->VM.getMemoryBudget().getPeak();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_VMDelete(WasmEdge_VMContext *Cxt) {
   delete Cxt;
 }
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/profile.h"
+#include "common/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace WasmEdge {
+
+namespace {
+using namespace std::literals;
+
+/// The header line of the profile files with the format version.
+constexpr std::string_view kMagic = "wasmedge-profile"sv;
+constexpr uint32_t kVersion = 2;
+
+/// Source of the profile identifiers.
+std::atomic<uint64_t> NextProfileId = 1;
+
+template <typename K, typename T>
+std::vector<std::pair<K, T>>
+sortedCounters(const std::unordered_map<K, T> &Map) {
+  std::vector<std::pair<K, T>> Vec(Map.begin(), Map.end());
+  std::sort(Vec.begin(), Vec.end(), [](const auto &LHS, const auto &RHS) {
+    return LHS.first < RHS.first;
+  });
+  return Vec;
+}
+} // namespace
+
+Profile::Profile() noexcept
+    : Id(NextProfileId.fetch_add(1, std::memory_order_relaxed)) {}
+
+// Get the counters of the calling thread. See "include/common/profile.h".
+Profile::Shard &Profile::getShard() noexcept {
+  // The shards of the destroyed profiles are dropped at the next miss.
+  thread_local std::unordered_map<uint64_t, std::weak_ptr<Shard>> Cache;
+  if (auto It = Cache.find(Id); It != Cache.end()) {
+    if (auto Counters = It->second.lock()) {
+      // The profile owns the shard while alive.
+      return *Counters;
+    }
+  }
+  for (auto It = Cache.begin(); It != Cache.end();) {
+    It = It->second.expired() ? Cache.erase(It) : std::next(It);
+  }
+  auto Counters = std::make_shared<Shard>();
+  {
+    std::unique_lock Lock(Mutex);
+    Shards.push_back(Counters);
+  }
+  Cache[Id] = Counters;
+  return *Counters;
+}
+
+// Merge the counters of all shards. See "include/common/profile.h".
+std::unordered_map<uint64_t, Profile::ModuleCounters> Profile::merge() const {
+  std::unordered_map<uint64_t, ModuleCounters> Merged;
+  std::unique_lock Lock(Mutex);
+  for (const auto &Counters : Shards) {
+    std::unique_lock ShardLock(Counters->Mutex);
+    for (const auto &[Hash, Module] : Counters->Modules) {
+      auto &Target = Merged[Hash];
+      for (const auto &[Offset, Count] : Module.Entries) {
+        Target.Entries[Offset] += Count;
+      }
+      for (const auto &[Offset, Count] : Module.Branches) {
+        auto &Branch = Target.Branches[Offset];
+        Branch.first += Count.first;
+        Branch.second += Count.second;
+      }
+    }
+  }
+  return Merged;
+}
+
+// Save the counters to a text file. See "include/common/profile.h".
+Expect<void> Profile::save(const std::filesystem::path &Path) const {
+  std::ofstream Fout(Path, std::ios::out | std::ios::trunc);
+  if (!Fout) {
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error("    Profile path: {}", Path.u8string());
+    return Unexpect(ErrCode::IllegalPath);
+  }
+
+  // One line per counter after the line of the module hash, sorted by the
+  // hashes and the offsets for the stable outputs:
+  //   m <module hash>
+  //   e <offset> <entry count>
+  //   b <offset> <taken count> <not taken count>
+  Fout << kMagic << ' ' << kVersion << '\n';
+  for (const auto &[Hash, Counters] : sortedCounters(merge())) {
+    Fout << "m " << Hash << '\n';
+    for (const auto &[Offset, Count] : sortedCounters(Counters.Entries)) {
+      Fout << "e " << Offset << ' ' << Count << '\n';
+    }
+    for (const auto &[Offset, Count] : sortedCounters(Counters.Branches)) {
+      Fout << "b " << Offset << ' ' << Count.first << ' ' << Count.second
+           << '\n';
+    }
+  }
+  if (!Fout.flush()) {
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error("    Profile path: {}", Path.u8string());
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  return {};
+}
+
+// Load the counters from a file. See "include/common/profile.h".
+Expect<void> Profile::load(const std::filesystem::path &Path) {
+  std::ifstream Fin(Path, std::ios::in);
+  if (!Fin) {
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error("    Profile path: {}", Path.u8string());
+    return Unexpect(ErrCode::IllegalPath);
+  }
+
+  auto LogError = [&Path](ErrCode Code) {
+    spdlog::error(Code);
+    spdlog::error("    Profile path: {}", Path.u8string());
+    return Unexpect(Code);
+  };
+
+  std::string Magic;
+  uint32_t Version = 0;
+  if (!(Fin >> Magic) || Magic != kMagic) {
+    return LogError(ErrCode::MalformedMagic);
+  }
+  if (!(Fin >> Version) || Version != kVersion) {
+    return LogError(ErrCode::MalformedVersion);
+  }
+
+  // Parse all lines before merging to keep the counters on errors.
+  std::unordered_map<uint64_t, ModuleCounters> NewModules;
+  ModuleCounters *Counters = nullptr;
+  std::string Line;
+  std::getline(Fin, Line);
+  while (std::getline(Fin, Line)) {
+    if (Line.empty()) {
+      continue;
+    }
+    std::istringstream SS(Line);
+    char Kind = '\0';
+    if (!(SS >> Kind)) {
+      return LogError(ErrCode::IllegalGrammar);
+    }
+    if (Kind == 'm') {
+      uint64_t Hash = 0;
+      if (!(SS >> Hash)) {
+        return LogError(ErrCode::IllegalGrammar);
+      }
+      Counters = &NewModules[Hash];
+      continue;
+    }
+    // The counters must follow the hash of their module.
+    uint32_t Offset = 0;
+    uint64_t Count = 0, NotTaken = 0;
+    if (!Counters || !(SS >> Offset >> Count)) {
+      return LogError(ErrCode::IllegalGrammar);
+    }
+    if (Kind == 'e') {
+      Counters->Entries[Offset] += Count;
+    } else if (Kind == 'b' && (SS >> NotTaken)) {
+      auto &Branch = Counters->Branches[Offset];
+      Branch.first += Count;
+      Branch.second += NotTaken;
+    } else {
+      return LogError(ErrCode::IllegalGrammar);
+    }
+  }
+
+  // The loaded counters are added to the shard of the calling thread.
+  auto &Loaded = getShard();
+  std::unique_lock Lock(Loaded.Mutex);
+  for (const auto &[Hash, NewCounters] : NewModules) {
+    auto &Merged = Loaded.Modules[Hash];
+    for (const auto &[Offset, Count] : NewCounters.Entries) {
+      Merged.Entries[Offset] += Count;
+    }
+    for (const auto &[Offset, Count] : NewCounters.Branches) {
+      auto &Branch = Merged.Branches[Offset];
+      Branch.first += Count.first;
+      Branch.second += Count.second;
+    }
+  }
+  return {};
+}
+
+} // namespace WasmEdge
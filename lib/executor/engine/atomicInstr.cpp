@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/executor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+
+/// Waiter of the atomic wait instructions.
+struct Waiter {
+  std::condition_variable Cond;
+  bool Notified = false;
+};
+
+/// Waiter table keyed by the host address. Shared memories can be imported
+/// into several modules and stores, so the table is process-wide. The waiters
+/// of an address are woken in the order of their waiting.
+std::mutex WaiterMutex;
+std::unordered_map<const void *, std::list<Waiter *>> WaiterMap;
+
+} // namespace
+
+Expect<void>
+Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
+                            Runtime::Instance::MemoryInstance &MemInst,
+                            const AST::Instruction &Instr) {
+  // Pop the count of waiters to wake up.
+  const uint32_t Count = StackMgr.pop().get<uint32_t>();
+
+  ValVariant &Val = StackMgr.getTop();
+  if (auto Res = atomicNotify(MemInst, getMemAddress(MemInst, Val),
+                              Instr.getMemoryOffset(), Count)) {
+    Val.emplace<uint32_t>(*Res);
+  } else {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T>
+Expect<uint32_t>
+Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
+                     const uint64_t Address, const uint64_t Offset,
+                     const T Expected, const int64_t Timeout) noexcept {
+  auto Ptr = getAtomicPointer<T>(MemInst, Address, Offset);
+  if (unlikely(!Ptr)) {
+    return Unexpect(Ptr);
+  }
+  // Waiting is only allowed on shared memories.
+  if (unlikely(!MemInst.isShared())) {
+    spdlog::error(ErrCode::ExpectSharedMemory);
+    return Unexpect(ErrCode::ExpectSharedMemory);
+  }
+
+  std::unique_lock<std::mutex> Lock(WaiterMutex);
+  // Compare under the lock to prevent missing the notifications.
+  if (__atomic_load_n(*Ptr, __ATOMIC_SEQ_CST) != Expected) {
+    return UINT32_C(1);
+  }
+
+  Waiter W;
+  auto &Queue = WaiterMap[*Ptr];
+  auto It = Queue.insert(Queue.end(), &W);
+  auto IsNotified = [&W]() { return W.Notified; };
+
+  // The deadline of the timeout is clamped to prevent the overflow, and the
+  // timeouts beyond it wait infinitely.
+  const auto Now = std::chrono::steady_clock::now();
+  const auto Duration = std::chrono::nanoseconds(Timeout);
+  if (Timeout < 0 ||
+      Duration >= std::chrono::steady_clock::time_point::max() - Now) {
+    W.Cond.wait(Lock, IsNotified);
+  } else if (!W.Cond.wait_until(
+                 Lock,
+                 Now + std::chrono::duration_cast<
+                           std::chrono::steady_clock::duration>(Duration),
+                 IsNotified)) {
+    // Timed out. The waiter is still in the table.
+    Queue.erase(It);
+    if (Queue.empty()) {
+      WaiterMap.erase(*Ptr);
+    }
+    return UINT32_C(2);
+  }
+  return UINT32_C(0);
+}
+
+template Expect<uint32_t>
+Executor::atomicWait<uint32_t>(Runtime::Instance::MemoryInstance &,
+                               const uint64_t, const uint64_t, const uint32_t,
+                               const int64_t) noexcept;
+template Expect<uint32_t>
+Executor::atomicWait<uint64_t>(Runtime::Instance::MemoryInstance &,
+                               const uint64_t, const uint64_t, const uint64_t,
+                               const int64_t) noexcept;
+
+Expect<uint32_t>
+Executor::atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
+                       const uint64_t Address, const uint64_t Offset,
+                       const uint32_t Count) noexcept {
+  auto Ptr = getAtomicPointer<uint32_t>(MemInst, Address, Offset);
+  if (unlikely(!Ptr)) {
+    return Unexpect(Ptr);
+  }
+  // Non-shared memories have no waiters.
+  if (!MemInst.isShared()) {
+    return UINT32_C(0);
+  }
+
+  std::unique_lock<std::mutex> Lock(WaiterMutex);
+  uint32_t Woken = 0;
+  auto Found = WaiterMap.find(*Ptr);
+  if (Found == WaiterMap.end()) {
+    return Woken;
+  }
+  auto &Waiters = Found->second;
+  while (!Waiters.empty() && Woken < Count) {
+    Waiters.front()->Notified = true;
+    Waiters.front()->Cond.notify_all();
+    Waiters.pop_front();
+    ++Woken;
+  }
+  if (Waiters.empty()) {
+    WaiterMap.erase(Found);
+  }
+  return Woken;
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -40,6 +40,10 @@ Expect<void> Executor::runIfElseOp(Runtime::StoreManager &StoreMgr,
                                    AST::InstrView::iterator &PC) {
   // Get condition.
   uint32_t Cond = StackMgr.pop().get<uint32_t>();
+  if (Prof) {
+    const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+    Prof->addBranch(ModInst->getHash(), Instr.getOffset(), Cond != 0);
+  }
 
   // Get result type for arity.
   auto BlockSig = getBlockArity(StoreMgr, StackMgr, Instr.getBlockType());
@@ -76,7 +80,12 @@ Expect<void> Executor::runBrIfOp(Runtime::StoreManager &StoreMgr,
                                  Runtime::StackManager &StackMgr,
                                  const AST::Instruction &Instr,
                                  AST::InstrView::iterator &PC) {
-  if (StackMgr.pop().get<uint32_t>() != 0) {
+  const bool IsTaken = StackMgr.pop().get<uint32_t>() != 0;
+  if (Prof) {
+    const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+    Prof->addBranch(ModInst->getHash(), Instr.getOffset(), IsTaken);
+  }
+  if (IsTaken) {
     return runBrOp(StoreMgr, StackMgr, Instr, PC);
   }
   return {};
@@ -36,6 +36,11 @@ Executor::runFunction(Runtime::StoreManager &StoreMgr,
     StackMgr.push(Val);
   }
 
+  // Decode the lazy function body before getting the instructions.
+  if (auto Res = Func.loadLazyBody(); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   // Enter and execute function.
   AST::InstrView::iterator StartIt;
   if (auto Res =
@@ -138,6 +143,13 @@ Expect<void> Executor::execute(Runtime::StoreManager &StoreMgr,
     case OpCode::Ref__func: {
       const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
       const uint32_t FuncAddr = *ModInst->getFuncAddr(Instr.getTargetIndex());
+      // The referenced lazy function body is checked at reference.
+      const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+      if (auto Res = FuncInst->loadLazyBody(); unlikely(!Res)) {
+        spdlog::error(
+            ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+        return Unexpect(Res);
+      }
       StackMgr.push(FuncRef(FuncAddr));
       return {};
     }
@@ -1662,6 +1674,275 @@ Expect<void> Executor::execute(Runtime::StoreManager &StoreMgr,
     case OpCode::F64x2__nearest:
       return runVectorNearestOp<double>(StackMgr.getTop());
 
+    // Threads instructions
+    case OpCode::Atomic__fence:
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      return {};
+    case OpCode::Memory__atomic__notify:
+      return runAtomicNotifyOp(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::Memory__atomic__wait32:
+      return runAtomicWaitOp<uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::Memory__atomic__wait64:
+      return runAtomicWaitOp<uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__load:
+      return runAtomicLoadOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__load:
+      return runAtomicLoadOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__load8_u:
+      return runAtomicLoadOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__load16_u:
+      return runAtomicLoadOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__load8_u:
+      return runAtomicLoadOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__load16_u:
+      return runAtomicLoadOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__load32_u:
+      return runAtomicLoadOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__store:
+      return runAtomicStoreOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__store:
+      return runAtomicStoreOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__store8:
+      return runAtomicStoreOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__store16:
+      return runAtomicStoreOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__store8:
+      return runAtomicStoreOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__store16:
+      return runAtomicStoreOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__store32:
+      return runAtomicStoreOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__add:
+      return runAtomicAddOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__add:
+      return runAtomicAddOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__add_u:
+      return runAtomicAddOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__add_u:
+      return runAtomicAddOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__add_u:
+      return runAtomicAddOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__add_u:
+      return runAtomicAddOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__add_u:
+      return runAtomicAddOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__sub:
+      return runAtomicSubOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__sub:
+      return runAtomicSubOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__sub_u:
+      return runAtomicSubOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__sub_u:
+      return runAtomicSubOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__sub_u:
+      return runAtomicSubOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__sub_u:
+      return runAtomicSubOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__sub_u:
+      return runAtomicSubOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__and:
+      return runAtomicAndOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__and:
+      return runAtomicAndOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__and_u:
+      return runAtomicAndOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__and_u:
+      return runAtomicAndOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__and_u:
+      return runAtomicAndOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__and_u:
+      return runAtomicAndOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__and_u:
+      return runAtomicAndOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__or:
+      return runAtomicOrOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__or:
+      return runAtomicOrOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__or_u:
+      return runAtomicOrOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__or_u:
+      return runAtomicOrOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__or_u:
+      return runAtomicOrOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__or_u:
+      return runAtomicOrOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__or_u:
+      return runAtomicOrOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__xor:
+      return runAtomicXorOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__xor:
+      return runAtomicXorOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__xor_u:
+      return runAtomicXorOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__xor_u:
+      return runAtomicXorOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__xor_u:
+      return runAtomicXorOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__xor_u:
+      return runAtomicXorOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__xor_u:
+      return runAtomicXorOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__xchg:
+      return runAtomicExchangeOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__xchg:
+      return runAtomicExchangeOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__xchg_u:
+      return runAtomicExchangeOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__xchg_u:
+      return runAtomicExchangeOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__xchg_u:
+      return runAtomicExchangeOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__xchg_u:
+      return runAtomicExchangeOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__xchg_u:
+      return runAtomicExchangeOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw__cmpxchg:
+      return runAtomicCompareExchangeOp<uint32_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw__cmpxchg:
+      return runAtomicCompareExchangeOp<uint64_t, uint64_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw8__cmpxchg_u:
+      return runAtomicCompareExchangeOp<uint32_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I32__atomic__rmw16__cmpxchg_u:
+      return runAtomicCompareExchangeOp<uint32_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw8__cmpxchg_u:
+      return runAtomicCompareExchangeOp<uint64_t, uint8_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw16__cmpxchg_u:
+      return runAtomicCompareExchangeOp<uint64_t, uint16_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+    case OpCode::I64__atomic__rmw32__cmpxchg_u:
+      return runAtomicCompareExchangeOp<uint64_t, uint32_t>(
+          StackMgr,
+          *getMemInstByIdx(StoreMgr, StackMgr, Instr.getTargetIndex()), Instr);
+
     default:
       return {};
     }
@@ -3,14 +3,39 @@
 
 #include "executor/executor.h"
 
+#include <cstdint>
+#include <limits>
+
 namespace WasmEdge {
 namespace Executor {
 
+Expect<uint64_t> Executor::getEffectiveAddress(
+    const Runtime::Instance::MemoryInstance &MemInst, const ValVariant &Val,
+    const AST::Instruction &Instr, const uint64_t Length) const noexcept {
+  // The EA of 32-bit memories never overflows, and is bound checked when
+  // accessing the memory.
+  const uint64_t Address = getMemAddress(MemInst, Val);
+  const uint64_t Offset = Instr.getMemoryOffset();
+  if (Address > std::numeric_limits<uint64_t>::max() - Offset) {
+    spdlog::error(ErrCode::MemoryOutOfBounds);
+    spdlog::error(
+        ErrInfo::InfoBoundary(Address, Length, MemInst.getBoundIdx()));
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  return Address + Offset;
+}
+
 Expect<void>
 Executor::runMemorySizeOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
   // Push SZ = page size to stack.
-  StackMgr.push(MemInst.getPageSize());
+  if (MemInst.is64()) {
+    StackMgr.push(MemInst.getPageSize());
+  } else {
+    StackMgr.push(static_cast<uint32_t>(MemInst.getPageSize()));
+  }
   return {};
 }
 
@@ -18,14 +43,16 @@ Expect<void>
 Executor::runMemoryGrowOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
   // Pop N for growing page size.
-  uint32_t &N = StackMgr.getTop().get<uint32_t>();
+  ValVariant &N = StackMgr.getTop();
 
   // Grow page and push result.
-  const uint32_t CurrPageSize = static_cast<uint32_t>(MemInst.getPageSize());
-  if (MemInst.growPage(N)) {
-    N = CurrPageSize;
+  const uint64_t CurrPageSize = MemInst.getPageSize();
+  const bool Success = MemInst.growPage(getMemAddress(MemInst, N));
+  if (MemInst.is64()) {
+    N.emplace<uint64_t>(Success ? CurrPageSize : static_cast<uint64_t>(-1));
   } else {
-    N = static_cast<uint32_t>(-1);
+    N.emplace<uint32_t>(Success ? static_cast<uint32_t>(CurrPageSize)
+                                : static_cast<uint32_t>(-1));
   }
   return {};
 }
@@ -36,7 +63,7 @@ Expect<void> Executor::runMemoryInitOp(
   // Pop the length, source, and destination from stack.
   uint32_t Len = StackMgr.pop().get<uint32_t>();
   uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  uint64_t Dst = getMemAddress(MemInst, StackMgr.pop());
 
   // Replace mem[Dst : Dst + Len] with data[Src : Src + Len].
   if (auto Res = MemInst.setBytes(DataInst.getData(), Dst, Src, Len)) {
@@ -60,10 +87,14 @@ Executor::runMemoryCopyOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInstDst,
                           Runtime::Instance::MemoryInstance &MemInstSrc,
                           const AST::Instruction &Instr) {
-  // Pop the length, source, and destination from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
-  uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  // Pop the length, source, and destination from stack. The length is 64-bit
+  // only when both memories are 64-bit indexed.
+  ValVariant LenVal = StackMgr.pop();
+  uint64_t Len = (MemInstDst.is64() && MemInstSrc.is64())
+                     ? LenVal.get<uint64_t>()
+                     : LenVal.get<uint32_t>();
+  uint64_t Src = getMemAddress(MemInstSrc, StackMgr.pop());
+  uint64_t Dst = getMemAddress(MemInstDst, StackMgr.pop());
 
   // Replace mem[Dst : Dst + Len] with mem[Src : Src + Len].
   if (auto Data = MemInstSrc.getBytes(Src, Len)) {
@@ -86,9 +117,9 @@ Executor::runMemoryFillOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst,
                           const AST::Instruction &Instr) {
   // Pop the length, value, and offset from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
+  uint64_t Len = getMemAddress(MemInst, StackMgr.pop());
   uint8_t Val = static_cast<uint8_t>(StackMgr.pop().get<uint32_t>());
-  uint32_t Off = StackMgr.pop().get<uint32_t>();
+  uint64_t Off = getMemAddress(MemInst, StackMgr.pop());
 
   // Fill data with Val.
   if (auto Res = MemInst.fillBytes(Val, Off, Len)) {
@@ -67,6 +67,10 @@ const AST::Module::IntrinsicsTable Executor::Intrinsics = {
     ENTRY(kElemDrop, elemDrop),
     ENTRY(kRefFunc, refFunc),
     ENTRY(kPtrFunc, ptrFunc),
+    ENTRY(kMemAtomicNotify, memAtomicNotify),
+    ENTRY(kMemAtomicWait, memAtomicWait),
+    ENTRY(kEnterModule, enterModule),
+    ENTRY(kLeaveModule, leaveModule),
 #undef ENTRY
 };
 
@@ -210,21 +214,21 @@ Executor::callIndirect(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
-Expect<uint32_t> Executor::memGrow(Runtime::StoreManager &StoreMgr,
+Expect<uint64_t> Executor::memGrow(Runtime::StoreManager &StoreMgr,
                                    Runtime::StackManager &StackMgr,
                                    const uint32_t MemIdx,
-                                   const uint32_t NewSize) noexcept {
+                                   const uint64_t NewSize) noexcept {
   auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
   assuming(MemInst);
-  const uint32_t CurrPageSize = MemInst->getPageSize();
+  const uint64_t CurrPageSize = MemInst->getPageSize();
   if (MemInst->growPage(NewSize)) {
     return CurrPageSize;
   } else {
-    return static_cast<uint32_t>(-1);
+    return static_cast<uint64_t>(-1);
   }
 }
 
-Expect<uint32_t> Executor::memSize(Runtime::StoreManager &StoreMgr,
+Expect<uint64_t> Executor::memSize(Runtime::StoreManager &StoreMgr,
                                    Runtime::StackManager &StackMgr,
                                    const uint32_t MemIdx) noexcept {
   auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
@@ -235,9 +239,9 @@ Expect<uint32_t> Executor::memSize(Runtime::StoreManager &StoreMgr,
 Expect<void> Executor::memCopy(Runtime::StoreManager &StoreMgr,
                                Runtime::StackManager &StackMgr,
                                const uint32_t DstMemIdx,
-                               const uint32_t SrcMemIdx, const uint32_t DstOff,
-                               const uint32_t SrcOff,
-                               const uint32_t Len) noexcept {
+                               const uint32_t SrcMemIdx, const uint64_t DstOff,
+                               const uint64_t SrcOff,
+                               const uint64_t Len) noexcept {
   auto *MemInstDst = getMemInstByIdx(StoreMgr, StackMgr, DstMemIdx);
   assuming(MemInstDst);
   auto *MemInstSrc = getMemInstByIdx(StoreMgr, StackMgr, SrcMemIdx);
@@ -257,8 +261,8 @@ Expect<void> Executor::memCopy(Runtime::StoreManager &StoreMgr,
 
 Expect<void> Executor::memFill(Runtime::StoreManager &StoreMgr,
                                Runtime::StackManager &StackMgr,
-                               const uint32_t MemIdx, const uint32_t Off,
-                               const uint8_t Val, const uint32_t Len) noexcept {
+                               const uint32_t MemIdx, const uint64_t Off,
+                               const uint8_t Val, const uint64_t Len) noexcept {
   auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
   assuming(MemInst);
   if (auto Res = MemInst->fillBytes(Val, Off, Len); unlikely(!Res)) {
@@ -271,7 +275,7 @@ Expect<void> Executor::memFill(Runtime::StoreManager &StoreMgr,
 Expect<void> Executor::memInit(Runtime::StoreManager &StoreMgr,
                                Runtime::StackManager &StackMgr,
                                const uint32_t MemIdx, const uint32_t DataIdx,
-                               const uint32_t DstOff, const uint32_t SrcOff,
+                               const uint64_t DstOff, const uint32_t SrcOff,
                                const uint32_t Len) noexcept {
   auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
   assuming(MemInst);
@@ -296,6 +300,46 @@ Expect<void> Executor::dataDrop(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
+Expect<uint32_t> Executor::memAtomicNotify(Runtime::StoreManager &StoreMgr,
+                                           Runtime::StackManager &StackMgr,
+                                           const uint32_t MemIdx,
+                                           const uint64_t Address,
+                                           const uint64_t Offset,
+                                           const uint32_t Count) noexcept {
+  auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
+  assuming(MemInst);
+  return atomicNotify(*MemInst, Address, Offset, Count);
+}
+
+Expect<uint32_t> Executor::memAtomicWait(
+    Runtime::StoreManager &StoreMgr, Runtime::StackManager &StackMgr,
+    const uint32_t MemIdx, const uint64_t Address, const uint64_t Offset,
+    const uint64_t Expected, const int64_t Timeout,
+    const uint32_t BitWidth) noexcept {
+  auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, MemIdx);
+  assuming(MemInst);
+  if (BitWidth == 64) {
+    return atomicWait<uint64_t>(*MemInst, Address, Offset, Expected, Timeout);
+  }
+  return atomicWait<uint32_t>(*MemInst, Address, Offset,
+                              static_cast<uint32_t>(Expected), Timeout);
+}
+
+Expect<void> Executor::enterModule(Runtime::StoreManager &,
+                                   Runtime::StackManager &StackMgr,
+                                   const uint32_t ModuleAddr) noexcept {
+  // The compiled functions called directly from the other modules resolve
+  // their instances by the module address of the top frame.
+  StackMgr.pushFrame(ModuleAddr);
+  return {};
+}
+
+Expect<void> Executor::leaveModule(Runtime::StoreManager &,
+                                   Runtime::StackManager &StackMgr) noexcept {
+  StackMgr.popFrame();
+  return {};
+}
+
 Expect<RefVariant> Executor::tableGet(Runtime::StoreManager &StoreMgr,
                                       Runtime::StackManager &StackMgr,
                                       const uint32_t TableIdx,
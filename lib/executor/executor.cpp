@@ -13,7 +13,7 @@ namespace Executor {
 Expect<void> Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
                                          const AST::Module &Mod) {
   InsMode = InstantiateMode::Instantiate;
-  if (auto Res = instantiate(StoreMgr, Mod, ""); !Res) {
+  if (auto Res = instantiate(StoreMgr, Mod, "", nullptr); !Res) {
     // If Statistics is enabled, then dump it here.
     // When there is an error happened, the following execution will not
     // execute.
@@ -25,6 +25,20 @@ Expect<void> Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
+// Instantiate shared Wasm Module. See "include/executor/executor.h".
+Expect<void>
+Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
+                            std::shared_ptr<const AST::Module> Mod) {
+  InsMode = InstantiateMode::Instantiate;
+  if (auto Res = instantiate(StoreMgr, *Mod, "", Mod); !Res) {
+    if (Stat) {
+      Stat->dumpToLog(Conf);
+    }
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 // Register host module. See "include/executor/executor.h".
 Expect<void> Executor::registerModule(Runtime::StoreManager &StoreMgr,
                                       const Runtime::ImportObject &Obj) {
@@ -66,7 +80,7 @@ Expect<void> Executor::registerModule(Runtime::StoreManager &StoreMgr,
                                       const AST::Module &Mod,
                                       std::string_view Name) {
   InsMode = InstantiateMode::ImportWasm;
-  if (auto Res = instantiate(StoreMgr, Mod, Name); !Res) {
+  if (auto Res = instantiate(StoreMgr, Mod, Name, nullptr); !Res) {
     spdlog::error(ErrInfo::InfoRegistering(Name));
     // If Statistics is enabled, then dump it here.
     // When there is an error happened, the following execution will not
@@ -79,6 +93,21 @@ Expect<void> Executor::registerModule(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
+// Register shared Wasm module. See "include/executor/executor.h".
+Expect<void> Executor::registerModule(Runtime::StoreManager &StoreMgr,
+                                      std::shared_ptr<const AST::Module> Mod,
+                                      std::string_view Name) {
+  InsMode = InstantiateMode::ImportWasm;
+  if (auto Res = instantiate(StoreMgr, *Mod, Name, Mod); !Res) {
+    spdlog::error(ErrInfo::InfoRegistering(Name));
+    if (Stat) {
+      Stat->dumpToLog(Conf);
+    }
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 // Invoke function. See "include/executor/executor.h".
 Expect<std::vector<std::pair<ValVariant, ValType>>>
 Executor::invoke(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
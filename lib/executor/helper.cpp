@@ -77,57 +77,35 @@ Executor::enterFunction(Runtime::StoreManager &StoreMgr,
     // For host function case, the continuation will be the next.
     return From;
   } else if (Func.isCompiledFunction()) {
-    // Compiled function case: Push frame with locals and args.
-    StackMgr.pushFrame(Func.getModuleAddr(), // Module address
-                       ArgsN,                // No Arguments in stack
-                       RetsN                 // Returns num
-    );
-
-    Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
-    std::vector<ValVariant> Rets(RetsN);
-
-    {
-      CurrentStore = &StoreMgr;
-      CurrentStack = &StackMgr;
-      auto &ModInst = *(*StoreMgr.getModule(Func.getModuleAddr()));
-      for (uint32_t I = 0; I < ModInst.getMemNum(); ++I) {
-        auto MemoryPtr =
-            reinterpret_cast<std::atomic<uint8_t *> *>(&ModInst.MemoryPtrs[I]);
-        uint8_t *const DataPtr =
-            (*(StoreMgr.getMemory(*ModInst.getMemAddr(I))))->getDataPtr();
-        std::atomic_store_explicit(MemoryPtr, DataPtr,
-                                   std::memory_order_relaxed);
+    return enterCompiledFunction(StoreMgr, StackMgr, Func, FuncType.getSymbol(),
+                                 Func.getSymbol().get(), From);
+  } else if (const auto *Tiered = Func.getTieredCode()) {
+    // Native function compiled in the tiered execution case.
+    return enterCompiledFunction(StoreMgr, StackMgr, Func, Tiered->Wrapper,
+                                 Tiered->Code.get(), From);
+  } else {
+    if (TieredThreshold) {
+      countHotFunction(StoreMgr, Func);
+      // The lazy JIT compiles the function in the handler at the first call.
+      if (const auto *Tiered = Func.getTieredCode()) {
+        return enterCompiledFunction(StoreMgr, StackMgr, Func,
+                                     Tiered->Wrapper, Tiered->Code.get(), From);
       }
-      ExecutionContext.Memories = ModInst.MemoryPtrs.data();
-      ExecutionContext.Globals = ModInst.GlobalPtrs.data();
     }
-
-    {
-      Fault FaultHandler;
-      if (auto Err = PREPARE_FAULT(FaultHandler);
-          unlikely(Err != ErrCode::Success)) {
-        if (Err != ErrCode::Terminated) {
-          spdlog::error(Err);
-        }
-        return Unexpect(Err);
-      }
-      auto &Wrapper = FuncType.getSymbol();
-      Wrapper(&ExecutionContext, Func.getSymbol().get(), Args.data(),
-              Rets.data());
+    // Native function case: Decode the lazy function body at the first call.
+    if (auto Res = Func.loadLazyBody(); unlikely(!Res)) {
+      return Unexpect(Res);
     }
-
-    for (uint32_t I = 0; I < Rets.size(); ++I) {
-      StackMgr.push(Rets[I]);
+    if (Prof) {
+      const auto *ModInst = *StoreMgr.getModule(Func.getModuleAddr());
+      Prof->addEntry(ModInst->getHash(), Func.getInstrs().begin()->getOffset());
     }
 
-    StackMgr.popFrame();
-    // For compiled function case, the continuation will be the next.
-    return From;
-  } else {
-    // Native function case: Push frame with locals and args.
+    // Push frame with locals and args.
     StackMgr.pushFrame(Func.getModuleAddr(), // Module address
                        ArgsN,                // Arguments num
-                       RetsN                 // Returns num
+                       RetsN,                // Returns num
+                       &Func                 // Function for the hot counts
     );
 
     // Push local variables to stack.
@@ -145,6 +123,80 @@ Executor::enterFunction(Runtime::StoreManager &StoreMgr,
   }
 }
 
+Expect<AST::InstrView::iterator> Executor::enterCompiledFunction(
+    Runtime::StoreManager &StoreMgr, Runtime::StackManager &StackMgr,
+    const Runtime::Instance::FunctionInstance &Func,
+    const Symbol<AST::FunctionType::Wrapper> &Wrapper, void *Code,
+    const AST::InstrView::iterator From) {
+  const auto &FuncType = Func.getFuncType();
+  const uint32_t ArgsN = static_cast<uint32_t>(FuncType.getParamTypes().size());
+  const uint32_t RetsN =
+      static_cast<uint32_t>(FuncType.getReturnTypes().size());
+
+  // Compiled function case: Push frame with locals and args.
+  StackMgr.pushFrame(Func.getModuleAddr(), // Module address
+                     ArgsN,                // No Arguments in stack
+                     RetsN                 // Returns num
+  );
+
+  Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
+  std::vector<ValVariant> Rets(RetsN);
+
+  // The import stubs of the compiled caller read the context after this
+  // call returns, so restore it then.
+  const auto CallerContext = ExecutionContext;
+  {
+    CurrentStore = &StoreMgr;
+    CurrentStack = &StackMgr;
+    auto &ModInst = *(*StoreMgr.getModule(Func.getModuleAddr()));
+    for (uint32_t I = 0; I < ModInst.getMemNum(); ++I) {
+      auto MemoryPtr =
+          reinterpret_cast<std::atomic<uint8_t *> *>(&ModInst.MemoryPtrs[I]);
+      auto *MemInst = *StoreMgr.getMemory(*ModInst.getMemAddr(I));
+      uint8_t *const DataPtr = MemInst->getDataPtr();
+      std::atomic_store_explicit(MemoryPtr, DataPtr, std::memory_order_relaxed);
+      auto MemorySizePtr = reinterpret_cast<std::atomic<const uint64_t *> *>(
+          &ModInst.MemorySizePtrs[I]);
+      std::atomic_store_explicit(MemorySizePtr, MemInst->getDataSizePtr(),
+                                 std::memory_order_relaxed);
+    }
+    ExecutionContext.Memories = ModInst.MemoryPtrs.data();
+    ExecutionContext.MemorySizes = ModInst.MemorySizePtrs.data();
+    ExecutionContext.Globals = ModInst.GlobalPtrs.data();
+    ExecutionContext.FuncImports = ModInst.FuncImportEntries.data();
+  }
+
+  {
+    Fault FaultHandler;
+    if (auto Err = PREPARE_FAULT(FaultHandler);
+        unlikely(Err != ErrCode::Success)) {
+      ExecutionContext = CallerContext;
+      if (Err != ErrCode::Terminated) {
+        spdlog::error(Err);
+      }
+      return Unexpect(Err);
+    }
+    Wrapper(&ExecutionContext, Code, Args.data(), Rets.data());
+  }
+  ExecutionContext = CallerContext;
+
+  for (uint32_t I = 0; I < Rets.size(); ++I) {
+    StackMgr.push(Rets[I]);
+  }
+
+  StackMgr.popFrame();
+  // For compiled function case, the continuation will be the next.
+  return From;
+}
+
+void Executor::countHotFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func) {
+  if (HotHandler && Func.countHot(TieredThreshold)) {
+    HotHandler(StoreMgr, Func);
+  }
+}
+
 std::pair<uint32_t, uint32_t>
 Executor::getBlockArity(Runtime::StoreManager &StoreMgr,
                         Runtime::StackManager &StackMgr,
@@ -180,6 +232,13 @@ Expect<void> Executor::branchToLabel(Runtime::StoreManager &StoreMgr,
 
   // Jump to the continuation of Label if is a loop.
   if (ContIt) {
+    // Count the loop iteration of the native function.
+    if (TieredThreshold) {
+      if (const auto *Func = StackMgr.getFunction()) {
+        countHotFunction(StoreMgr, *Func);
+      }
+    }
+
     // Get result type for arity.
     auto BlockSig =
         getBlockArity(StoreMgr, StackMgr, (*ContIt)->getBlockType());
@@ -19,7 +19,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
   // A frame with module is pushed into stack outside.
   // Instantiate data instances.
   for (const auto &DataSeg : DataSec.getContent()) {
-    uint32_t Offset = 0;
+    uint64_t Offset = 0;
     // Initialize memory if data mode is active.
     if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
       // Run initialize expression.
@@ -30,16 +30,16 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
         return Unexpect(Res);
       }
-      Offset = StackMgr.pop().get<uint32_t>();
+      // The offset is 64-bit for the 64-bit memories.
+      auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, DataSeg.getIdx());
+      assuming(MemInst);
+      Offset = getMemAddress(*MemInst, StackMgr.pop());
 
       // Check boundary unless ReferenceTypes or BulkMemoryOperations proposal
       // enabled.
       if (!Conf.hasProposal(Proposal::ReferenceTypes) &&
           !Conf.hasProposal(Proposal::BulkMemoryOperations)) {
-        // Memory index should be 0. Checked in validation phase.
-        auto *MemInst = getMemInstByIdx(StoreMgr, StackMgr, DataSeg.getIdx());
         // Check data fits.
-        assuming(MemInst);
         if (!MemInst->checkAccessBound(
                 Offset, static_cast<uint32_t>(DataSeg.getData().size()))) {
           spdlog::error(ErrCode::DataSegDoesNotFit);
@@ -52,9 +52,11 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
     // Insert data instance to store manager.
     uint32_t NewDataInstAddr;
     if (InsMode == InstantiateMode::Instantiate) {
-      NewDataInstAddr = StoreMgr.pushData(Offset, DataSeg.getData());
+      NewDataInstAddr =
+          StoreMgr.pushData(Offset, DataSeg.getData(), DataSeg.getDataMap());
     } else {
-      NewDataInstAddr = StoreMgr.importData(Offset, DataSeg.getData());
+      NewDataInstAddr =
+          StoreMgr.importData(Offset, DataSeg.getData(), DataSeg.getDataMap());
     }
     ModInst.addDataAddr(NewDataInstAddr);
   }
@@ -78,12 +80,16 @@ Expect<void> Executor::initMemory(Runtime::StoreManager &StoreMgr,
 
       auto *DataInst = getDataInstByIdx(StoreMgr, StackMgr, Idx);
       assuming(DataInst);
-      const uint32_t Off = DataInst->getOffset();
+      const uint64_t Off = DataInst->getOffset();
 
-      // Replace mem[Off : Off + n] with data[0 : n].
-      if (auto Res = MemInst->setBytes(
-              DataInst->getData(), Off, 0,
-              static_cast<uint32_t>(DataInst->getData().size()));
+      // Replace mem[Off : Off + n] with data[0 : n]. The data borrowed from
+      // the mapped module file is mapped copy-on-write where page aligned.
+      if (auto Res =
+              DataInst->getDataMap()
+                  ? MemInst->setBytes(*DataInst->getDataMap(),
+                                      DataInst->getData(), Off)
+                  : MemInst->setBytes(DataInst->getData(), Off, 0,
+                                      DataInst->getData().size());
           !Res) {
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
         return Unexpect(Res);
@@ -10,11 +10,12 @@ namespace WasmEdge {
 namespace Executor {
 
 // Instantiate function instance. See "include/executor/executor.h".
-Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
-                                   Runtime::StackManager &,
-                                   Runtime::Instance::ModuleInstance &ModInst,
-                                   const AST::FunctionSection &FuncSec,
-                                   const AST::CodeSection &CodeSec) {
+Expect<void>
+Executor::instantiate(Runtime::StoreManager &StoreMgr, Runtime::StackManager &,
+                      Runtime::Instance::ModuleInstance &ModInst,
+                      const AST::FunctionSection &FuncSec,
+                      const AST::CodeSection &CodeSec,
+                      const std::shared_ptr<const AST::Module> &Owner) {
 
   // Get the function type indices.
   auto TypeIdxs = FuncSec.getContent();
@@ -25,24 +26,26 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
     // Insert function instance to store manager.
     uint32_t NewFuncInstAddr;
     auto *FuncType = *ModInst.getFuncType(TypeIdxs[I]);
-    if (InsMode == InstantiateMode::Instantiate) {
-      if (auto Symbol = CodeSegs[I].getSymbol()) {
-        NewFuncInstAddr =
-            StoreMgr.pushFunction(ModInst.Addr, *FuncType, std::move(Symbol));
+    auto Push = [this, &StoreMgr](auto &&...Args) {
+      if (InsMode == InstantiateMode::Instantiate) {
+        return StoreMgr.pushFunction(std::forward<decltype(Args)>(Args)...);
       } else {
-        NewFuncInstAddr = StoreMgr.pushFunction(
-            ModInst.Addr, *FuncType, CodeSegs[I].getLocals(),
-            CodeSegs[I].getExpr().getInstrs());
+        return StoreMgr.importFunction(std::forward<decltype(Args)>(Args)...);
       }
+    };
+    if (auto Symbol = CodeSegs[I].getSymbol()) {
+      NewFuncInstAddr = Push(ModInst.Addr, *FuncType, std::move(Symbol));
+    } else if (CodeSegs[I].isLazy() && Owner) {
+      // Borrow the lazy function body and decode it at the first call.
+      NewFuncInstAddr = Push(ModInst.Addr, *FuncType, I, CodeSegs[I], Owner);
     } else {
-      if (auto Symbol = CodeSegs[I].getSymbol()) {
-        NewFuncInstAddr =
-            StoreMgr.importFunction(ModInst.Addr, *FuncType, std::move(Symbol));
-      } else {
-        NewFuncInstAddr = StoreMgr.importFunction(
-            ModInst.Addr, *FuncType, CodeSegs[I].getLocals(),
-            CodeSegs[I].getExpr().getInstrs());
+      // The lazy function body should be decoded before copying.
+      if (auto Res = CodeSegs[I].loadLazyBody(); unlikely(!Res)) {
+        return Unexpect(Res);
       }
+      NewFuncInstAddr = Push(ModInst.Addr, *FuncType, I,
+                             CodeSegs[I].getLocals(), CodeSegs[I].getExpr(),
+                             Owner);
     }
     ModInst.addFuncAddr(NewFuncInstAddr);
   }
@@ -15,19 +15,29 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
                                    const AST::MemorySection &MemSec) {
   // Prepare pointers vector for compiled functions.
   ModInst.MemoryPtrs.resize(ModInst.getMemNum() + MemSec.getContent().size());
+  ModInst.MemorySizePtrs.resize(ModInst.MemoryPtrs.size());
 
   // Iterate and istantiate memory types.
   for (const auto &MemType : MemSec.getContent()) {
     // Insert memory instance to store manager.
     uint32_t NewMemInstAddr;
+    const uint64_t PageLimit =
+        MemType.getLimit().is64()
+            ? Conf.getRuntimeConfigure().getMaxMemory64Page()
+            : Conf.getRuntimeConfigure().getMaxMemoryPage();
     if (InsMode == InstantiateMode::Instantiate) {
-      NewMemInstAddr = StoreMgr.pushMemory(
-          MemType, Conf.getRuntimeConfigure().getMaxMemoryPage());
+      NewMemInstAddr = StoreMgr.pushMemory(MemType, PageLimit, MemBudget);
     } else {
-      NewMemInstAddr = StoreMgr.importMemory(
-          MemType, Conf.getRuntimeConfigure().getMaxMemoryPage());
+      NewMemInstAddr = StoreMgr.importMemory(MemType, PageLimit, MemBudget);
     }
     ModInst.addMemAddr(NewMemInstAddr);
+    // The memory instance is not allocated if the page limit or the memory
+    // budget is exceeded, or the allocation failed.
+    auto *MemInst = *StoreMgr.getMemory(NewMemInstAddr);
+    if (const auto Err = MemInst->getCreateError(); Err != ErrCode::Success) {
+      spdlog::error(Err);
+      return Unexpect(Err);
+    }
   }
   return {};
 }
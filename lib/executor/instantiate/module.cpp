@@ -15,7 +15,8 @@ namespace Executor {
 // Instantiate module instance. See "include/executor/Executor.h".
 Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
                                    const AST::Module &Mod,
-                                   std::string_view Name) {
+                                   std::string_view Name,
+                                   std::shared_ptr<const AST::Module> Owner) {
   // Reset store manager and stack manager.
   StoreMgr.reset();
   Runtime::StackManager StackMgr;
@@ -35,6 +36,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
     ModInstAddr = StoreMgr.importModule(Name);
   }
   auto *ModInst = *StoreMgr.getModule(ModInstAddr);
+  ModInst->setHash(Mod.getHash());
 
   // Instantiate Function Types in Module Instance. (TypeSec)
   for (auto &FuncType : Mod.getTypeSection().getContent()) {
@@ -53,7 +55,8 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
   // Instantiate Functions in module. (FunctionSec, CodeSec)
   const AST::FunctionSection &FuncSec = Mod.getFunctionSection();
   const AST::CodeSection &CodeSec = Mod.getCodeSection();
-  if (auto Res = instantiate(StoreMgr, StackMgr, *ModInst, FuncSec, CodeSec);
+  if (auto Res =
+          instantiate(StoreMgr, StackMgr, *ModInst, FuncSec, CodeSec, Owner);
       !Res) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Function));
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
@@ -76,6 +79,57 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
+  // Resolve the entries of the imported functions for the compiled functions.
+  // The memory pointers are set here for the compiled functions called
+  // directly from the other modules, which are not entered by the executor.
+  // The functions compiled in the tiered execution call the imported
+  // functions through the executor with the empty entries.
+  if (Mod.getSymbol() || TieredThreshold) {
+    for (uint32_t I = 0; I < ModInst->getMemNum(); ++I) {
+      auto *MemInst = *StoreMgr.getMemory(*ModInst->getMemAddr(I));
+      ModInst->MemoryPtrs[I] = MemInst->getDataPtr();
+      ModInst->MemorySizePtrs[I] = MemInst->getDataSizePtr();
+    }
+    ModInst->FuncImportEntries.resize(ModInst->getFuncImportNum());
+  }
+  // The executor charges the cost of a host function and records its time if
+  // the statistics are given. The native entry skips them, so it is called
+  // directly only if the host function has no cost and no time is measured.
+  const bool IsTimed = Stat && Conf.getStatisticsConfigure().isTimeMeasuring();
+  for (uint32_t I = 0; Mod.getSymbol() && I < ModInst->getFuncImportNum();
+       ++I) {
+    const auto *FuncInst = *StoreMgr.getFunction(*ModInst->getFuncAddr(I));
+    auto &Entry = ModInst->FuncImportEntries[I];
+    if (FuncInst->isHostFunction()) {
+      auto &HostFunc = FuncInst->getHostFunc();
+      if (IsTimed || (Stat && HostFunc.getCost() > 0)) {
+        continue;
+      }
+      if (auto NativeEntry = HostFunc.getNativeEntry()) {
+        Entry.Entry = reinterpret_cast<void *>(NativeEntry);
+        Entry.Func = &HostFunc;
+        if (ModInst->getMemNum() > 0) {
+          Entry.Memory = *StoreMgr.getMemory(*ModInst->getMemAddr(0));
+        }
+      }
+    } else if (FuncInst->isCompiledFunction()) {
+      // The module of the compiled function was instantiated before, so its
+      // data for the compiled functions are complete. The entry keeps the
+      // pointers to them, which are never resized since then.
+      const auto *CalleeModInst =
+          *StoreMgr.getModule(FuncInst->getModuleAddr());
+      assuming(CalleeModInst->MemoryPtrs.size() == CalleeModInst->getMemNum());
+      assuming(CalleeModInst->GlobalPtrs.size() ==
+               CalleeModInst->getGlobalNum());
+      Entry.Symbol = FuncInst->getSymbol().get();
+      Entry.Memories = CalleeModInst->MemoryPtrs.data();
+      Entry.Globals = CalleeModInst->GlobalPtrs.data();
+      Entry.MemorySizes = CalleeModInst->MemorySizePtrs.data();
+      Entry.FuncImports = CalleeModInst->FuncImportEntries.data();
+      Entry.ModuleAddr = FuncInst->getModuleAddr();
+    }
+  }
+
   // Add a temp module to Store with only imported globals for initialization.
   uint32_t TmpModInstAddr = StoreMgr.pushModule("");
   auto *TmpModInst = *StoreMgr.getModule(TmpModInstAddr);
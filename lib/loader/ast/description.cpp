@@ -8,17 +8,25 @@ namespace Loader {
 
 // Load binary of Import description. See "include/loader/loader.h".
 Expect<void> Loader::loadDesc(AST::ImportDesc &ImpDesc) {
-  // Read the module name.
-  if (auto Res = FMgr.readName()) {
-    ImpDesc.setModuleName(*Res);
+  // Read the module name. Borrow the names if the module data is owned.
+  if (auto Res = FMgr.readNameView()) {
+    if (FMgr.hasDataOwner()) {
+      ImpDesc.setModuleNameView(*Res);
+    } else {
+      ImpDesc.setModuleName(*Res);
+    }
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(),
                         ASTNodeAttr::Desc_Import);
   }
 
   // Read the external name.
-  if (auto Res = FMgr.readName()) {
-    ImpDesc.setExternalName(*Res);
+  if (auto Res = FMgr.readNameView()) {
+    if (FMgr.hasDataOwner()) {
+      ImpDesc.setExternalNameView(*Res);
+    } else {
+      ImpDesc.setExternalName(*Res);
+    }
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(),
                         ASTNodeAttr::Desc_Import);
@@ -76,8 +84,12 @@ Expect<void> Loader::loadDesc(AST::ImportDesc &ImpDesc) {
 // Load binary of Export description. See "include/loader/loader.h".
 Expect<void> Loader::loadDesc(AST::ExportDesc &ExpDesc) {
   // Read external name to export.
-  if (auto Res = FMgr.readName()) {
-    ExpDesc.setExternalName(*Res);
+  if (auto Res = FMgr.readNameView()) {
+    if (FMgr.hasDataOwner()) {
+      ExpDesc.setExternalNameView(*Res);
+    } else {
+      ExpDesc.setExternalName(*Res);
+    }
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(),
                         ASTNodeAttr::Desc_Export);
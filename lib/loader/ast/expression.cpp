@@ -3,6 +3,7 @@
 
 #include "loader/loader.h"
 
+#include <memory>
 #include <utility>
 
 namespace WasmEdge {
@@ -10,10 +11,25 @@ namespace Loader {
 
 // Load to construct Expression node. See "include/loader/loader.h".
 Expect<void> Loader::loadExpression(AST::Expression &Expr) {
-  if (auto Res = loadInstrSeq()) {
+  AST::InstrSideTable Side;
+  if (auto Res = loadInstrSeq(Side)) {
     Expr.getInstrs() = std::move(*Res);
+    // Moving the side table keeps the storage referred by the instructions.
+    if (!Side.Labels.empty() || !Side.ValTypes.empty()) {
+      Expr.setSideTable(
+          std::make_shared<const AST::InstrSideTable>(std::move(Side)));
+    } else {
+      Expr.setSideTable(nullptr);
+    }
+    // Keep the capacity larger than the size to prevent from connection of 2
+    // vectors, because the function instances may borrow the instructions.
+    if (Expr.getInstrs().capacity() == Expr.getInstrs().size()) {
+      Expr.getInstrs().reserve(Expr.getInstrs().size() + 1);
+    }
   } else {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+    if (!IsWorker) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+    }
     return Unexpect(Res);
   }
   return {};
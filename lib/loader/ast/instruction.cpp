@@ -3,6 +3,7 @@
 
 #include "loader/loader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -20,7 +21,10 @@ Expect<OpCode> Loader::loadOpCode() {
                         ASTNodeAttr::Instruction);
   }
 
-  if (Payload == 0xFCU || Payload == 0xFDU) {
+  // Most of the opcodes are in 1 byte.
+  if (unlikely(Payload >= 0xFCU) &&
+      (Payload == 0xFCU || Payload == 0xFDU ||
+       (Payload == 0xFEU && Conf.hasProposal(Proposal::Threads)))) {
     // 2-bytes OpCode case.
     if (auto B2 = FMgr.readU32()) {
       Payload <<= 8;
@@ -34,7 +38,7 @@ Expect<OpCode> Loader::loadOpCode() {
 }
 
 // Load instruction sequence. See "include/loader/loader.h".
-Expect<AST::InstrVec> Loader::loadInstrSeq() {
+Expect<AST::InstrVec> Loader::loadInstrSeq(AST::InstrSideTable &Side) {
   OpCode Code;
   AST::InstrVec Instrs;
   std::vector<std::pair<OpCode, uint32_t>> BlockStack;
@@ -88,16 +92,26 @@ Expect<AST::InstrVec> Loader::loadInstrSeq() {
 
     // Create the instruction node and load contents.
     Instrs.emplace_back(Code, Offset);
-    if (auto Res = loadInstruction(Instrs.back()); !Res) {
+    if (auto Res = loadInstruction(Instrs.back(), Side); !Res) {
       return Unexpect(Res);
     }
+    // Check the instruction while decoding. The function body is checked
+    // again by the validator to report the error if failed.
+    if (FusedTypeIdx && !FusedChecker->checkNext(Instrs.back())) {
+      FusedTypeIdx.reset();
+    }
     Cnt++;
   } while (!IsReachEnd);
+
+  // The side table may be reallocated during loading. Refer the immediates
+  // after all of them are loaded, which are stored in the instruction order.
+  Side.bind(Instrs);
   return Instrs;
 }
 
 // Load instruction node. See "include/loader/loader.h".
-Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
+Expect<void> Loader::loadInstruction(AST::Instruction &Instr,
+                                     AST::InstrSideTable &Side) {
   // Node: The instruction has checked for the proposals. Need to check their
   // immediates.
 
@@ -123,17 +137,35 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
 
   auto readMemImmediate = [this, readU32, &Instr]() -> Expect<void> {
     Instr.getTargetIndex() = 0;
-    if (auto Res = readU32(Instr.getMemoryAlign()); unlikely(!Res)) {
+    uint32_t Align = 0;
+    if (auto Res = readU32(Align); unlikely(!Res)) {
       return Unexpect(Res);
     }
-    if (auto Res = readU32(Instr.getMemoryOffset()); unlikely(!Res)) {
-      return Unexpect(Res);
+    // The offset is encoded in u64 for the Memory64 proposal. The range of the
+    // offset for 32-bit memories is checked in validation phase.
+    if (Conf.hasProposal(Proposal::Memory64)) {
+      if (auto Res = FMgr.readU64()) {
+        Instr.getMemoryOffset() = *Res;
+      } else {
+        return logLoadError(Res.error(), FMgr.getLastOffset(),
+                            ASTNodeAttr::Instruction);
+      }
+    } else {
+      uint32_t Offset = 0;
+      if (auto Res = readU32(Offset); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      Instr.getMemoryOffset() = Offset;
     }
-    if (Conf.hasProposal(Proposal::MultiMemories) &&
-        Instr.getMemoryAlign() >= 64) {
-      Instr.getMemoryAlign() -= 64;
-      return readU32(Instr.getTargetIndex());
+    if (Conf.hasProposal(Proposal::MultiMemories) && Align >= 64) {
+      Align -= 64;
+      if (auto Res = readU32(Instr.getTargetIndex()); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
     }
+    // The alignment larger than 2^255 is always invalid in validation phase.
+    Instr.getMemoryAlign() =
+        static_cast<uint8_t>(std::min(Align, UINT32_C(255)));
     return {};
   };
 
@@ -198,15 +230,16 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
     if (auto Res = readU32(VecCnt); unlikely(!Res)) {
       return Unexpect(Res);
     }
-    Instr.setLabelListSize(VecCnt);
     for (uint32_t I = 0; I < VecCnt; ++I) {
       uint32_t Label = 0;
       if (auto Res = readU32(Label); unlikely(!Res)) {
         return Unexpect(Res);
       } else {
-        Instr.getLabelList()[I] = Label;
+        Side.Labels.push_back(Label);
       }
     }
+    // The reference is updated at the end of loadInstrSeq().
+    Instr.setLabelList(Span<const uint32_t>(Side.Labels).last(VecCnt));
     // Read default label.
     return readU32(Instr.getTargetIndex());
   }
@@ -263,7 +296,6 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
     if (auto Res = readU32(VecCnt); unlikely(!Res)) {
       return Unexpect(Res);
     }
-    Instr.setValTypeListSize(VecCnt);
     for (uint32_t I = 0; I < VecCnt; ++I) {
       ValType VType;
       if (auto T = FMgr.readByte(); unlikely(!T)) {
@@ -277,8 +309,10 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
           unlikely(!Check)) {
         return Unexpect(Check);
       }
-      Instr.getValTypeList()[I] = VType;
+      Side.ValTypes.push_back(VType);
     }
+    // The reference is updated at the end of loadInstrSeq().
+    Instr.setValTypeList(Span<const ValType>(Side.ValTypes).last(VecCnt));
     return {};
   }
 
@@ -827,6 +861,79 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
   case OpCode::F64x2__nearest:
     return {};
 
+  // Threads instructions.
+  case OpCode::Atomic__fence: {
+    uint32_t Dummy;
+    return readCheckZero(Dummy);
+  }
+  case OpCode::Memory__atomic__notify:
+  case OpCode::Memory__atomic__wait32:
+  case OpCode::Memory__atomic__wait64:
+  case OpCode::I32__atomic__load:
+  case OpCode::I64__atomic__load:
+  case OpCode::I32__atomic__load8_u:
+  case OpCode::I32__atomic__load16_u:
+  case OpCode::I64__atomic__load8_u:
+  case OpCode::I64__atomic__load16_u:
+  case OpCode::I64__atomic__load32_u:
+  case OpCode::I32__atomic__store:
+  case OpCode::I64__atomic__store:
+  case OpCode::I32__atomic__store8:
+  case OpCode::I32__atomic__store16:
+  case OpCode::I64__atomic__store8:
+  case OpCode::I64__atomic__store16:
+  case OpCode::I64__atomic__store32:
+  case OpCode::I32__atomic__rmw__add:
+  case OpCode::I64__atomic__rmw__add:
+  case OpCode::I32__atomic__rmw8__add_u:
+  case OpCode::I32__atomic__rmw16__add_u:
+  case OpCode::I64__atomic__rmw8__add_u:
+  case OpCode::I64__atomic__rmw16__add_u:
+  case OpCode::I64__atomic__rmw32__add_u:
+  case OpCode::I32__atomic__rmw__sub:
+  case OpCode::I64__atomic__rmw__sub:
+  case OpCode::I32__atomic__rmw8__sub_u:
+  case OpCode::I32__atomic__rmw16__sub_u:
+  case OpCode::I64__atomic__rmw8__sub_u:
+  case OpCode::I64__atomic__rmw16__sub_u:
+  case OpCode::I64__atomic__rmw32__sub_u:
+  case OpCode::I32__atomic__rmw__and:
+  case OpCode::I64__atomic__rmw__and:
+  case OpCode::I32__atomic__rmw8__and_u:
+  case OpCode::I32__atomic__rmw16__and_u:
+  case OpCode::I64__atomic__rmw8__and_u:
+  case OpCode::I64__atomic__rmw16__and_u:
+  case OpCode::I64__atomic__rmw32__and_u:
+  case OpCode::I32__atomic__rmw__or:
+  case OpCode::I64__atomic__rmw__or:
+  case OpCode::I32__atomic__rmw8__or_u:
+  case OpCode::I32__atomic__rmw16__or_u:
+  case OpCode::I64__atomic__rmw8__or_u:
+  case OpCode::I64__atomic__rmw16__or_u:
+  case OpCode::I64__atomic__rmw32__or_u:
+  case OpCode::I32__atomic__rmw__xor:
+  case OpCode::I64__atomic__rmw__xor:
+  case OpCode::I32__atomic__rmw8__xor_u:
+  case OpCode::I32__atomic__rmw16__xor_u:
+  case OpCode::I64__atomic__rmw8__xor_u:
+  case OpCode::I64__atomic__rmw16__xor_u:
+  case OpCode::I64__atomic__rmw32__xor_u:
+  case OpCode::I32__atomic__rmw__xchg:
+  case OpCode::I64__atomic__rmw__xchg:
+  case OpCode::I32__atomic__rmw8__xchg_u:
+  case OpCode::I32__atomic__rmw16__xchg_u:
+  case OpCode::I64__atomic__rmw8__xchg_u:
+  case OpCode::I64__atomic__rmw16__xchg_u:
+  case OpCode::I64__atomic__rmw32__xchg_u:
+  case OpCode::I32__atomic__rmw__cmpxchg:
+  case OpCode::I64__atomic__rmw__cmpxchg:
+  case OpCode::I32__atomic__rmw8__cmpxchg_u:
+  case OpCode::I32__atomic__rmw16__cmpxchg_u:
+  case OpCode::I64__atomic__rmw8__cmpxchg_u:
+  case OpCode::I64__atomic__rmw16__cmpxchg_u:
+  case OpCode::I64__atomic__rmw32__cmpxchg_u:
+    return readMemImmediate();
+
   default:
     return logLoadError(ErrCode::IllegalOpCode, Instr.getOffset(),
                         ASTNodeAttr::Instruction);
@@ -875,6 +982,13 @@ Expect<void> Loader::checkInstrProposals(OpCode Code, uint64_t Offset) {
       return logNeedProposal(ErrCode::IllegalOpCode, Proposal::SIMD, Offset,
                              ASTNodeAttr::Instruction);
     }
+  } else if (Code >= OpCode::Memory__atomic__notify &&
+             Code <= OpCode::I64__atomic__rmw32__cmpxchg_u) {
+    // These instructions are for Threads proposal.
+    if (!Conf.hasProposal(Proposal::Threads)) {
+      return logNeedProposal(ErrCode::IllegalOpCode, Proposal::Threads, Offset,
+                             ASTNodeAttr::Instruction);
+    }
   }
   return {};
 }
@@ -3,20 +3,110 @@
 
 #include "loader/loader.h"
 
+#include "aot/version.h"
+
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#endif
+
 namespace WasmEdge {
 namespace Loader {
 
+namespace {
+// Check if the running CPU supports the code of the CPU level in the universal
+// WASM binary.
+bool isCPULevelSupported(uint8_t Level) noexcept {
+  using CPULevel = CompilerConfigure::CPULevel;
+  if (Level == AOT::kAnyCPULevel ||
+      Level == static_cast<uint8_t>(CPULevel::Baseline)) {
+    return true;
+  }
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  // Check all the features of the x86-64 microarchitecture levels in the
+  // psABI, and the register states enabled by the OS for AVX and AVX-512.
+  uint32_t EAX, EBX, ECX, EDX;
+  if (!__get_cpuid(1, &EAX, &EBX, &ECX, &EDX)) {
+    return false;
+  }
+  const uint32_t ECX1 = ECX;
+  uint32_t EBX7 = 0;
+  if (__get_cpuid_count(7, 0, &EAX, &EBX, &ECX, &EDX)) {
+    EBX7 = EBX;
+  }
+  uint32_t ECX81 = 0;
+  if (__get_cpuid(0x80000001U, &EAX, &EBX, &ECX, &EDX)) {
+    ECX81 = ECX;
+  }
+  auto Has = [](uint32_t Reg, std::initializer_list<uint32_t> Bits) {
+    return std::all_of(Bits.begin(), Bits.end(),
+                       [Reg](uint32_t Bit) { return (Reg >> Bit) & 1U; });
+  };
+  uint64_t XCR0 = 0;
+  // OSXSAVE
+  if (Has(ECX1, {27})) {
+    uint32_t Lo, Hi;
+    __asm__("xgetbv" : "=a"(Lo), "=d"(Hi) : "c"(0));
+    XCR0 = (static_cast<uint64_t>(Hi) << 32) | Lo;
+  }
+  // CMPXCHG16B, LAHF-SAHF, POPCNT, SSE3, SSE4.1, SSE4.2, SSSE3
+  const bool V2 = Has(ECX1, {0, 9, 13, 19, 20, 23}) && Has(ECX81, {0});
+  // AVX, AVX2, BMI1, BMI2, F16C, FMA, LZCNT, MOVBE, and the YMM states.
+  const bool V3 = V2 && Has(ECX1, {12, 22, 27, 28, 29}) &&
+                  Has(EBX7, {3, 5, 8}) && Has(ECX81, {5}) &&
+                  (XCR0 & 0x6U) == 0x6U;
+  // AVX512F, AVX512BW, AVX512CD, AVX512DQ, AVX512VL, and the ZMM states.
+  const bool V4 = V3 && Has(EBX7, {16, 17, 28, 30, 31}) &&
+                  (XCR0 & 0xE0U) == 0xE0U;
+  switch (static_cast<CPULevel>(Level)) {
+  case CPULevel::V2:
+    return V2;
+  case CPULevel::V3:
+    return V3;
+  case CPULevel::V4:
+    return V4;
+  default:
+    return false;
+  }
+#else
+  return false;
+#endif
+}
+} // namespace
+
 // Load binary to construct Module node. See "include/loader/loader.h".
 Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   auto Mod = std::make_unique<AST::Module>();
+  // The nodes borrow the names and contents from the owned module data.
+  Mod->setDataOwner(FMgr.getDataOwner());
+  if (auto Res = loadModuleHeader(*Mod); !Res) {
+    return Unexpect(Res);
+  }
+
+  // Variables to record the loaded section types.
+  HasDataSection = false;
+  std::bitset<0x0DU> Secs;
+
+  if (auto Res = loadModuleSections(*Mod, Secs); !Res) {
+    return Unexpect(Res);
+  }
+  if (auto Res = checkModule(*Mod); !Res) {
+    return Unexpect(Res);
+  }
+  return Mod;
+}
+
+// Load magic and version of Module node. See "include/loader/loader.h".
+Expect<void> Loader::loadModuleHeader(AST::Module &Mod) {
   // Read Magic and Version sequences.
   if (auto Res = FMgr.readBytes(4)) {
     std::vector<Byte> WasmMagic = {0x00, 0x61, 0x73, 0x6D};
@@ -24,7 +114,7 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
       return logLoadError(ErrCode::MalformedMagic, FMgr.getLastOffset(),
                           ASTNodeAttr::Module);
     }
-    Mod->getMagic() = *Res;
+    Mod.getMagic() = *Res;
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(), ASTNodeAttr::Module);
   }
@@ -34,15 +124,16 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
       return logLoadError(ErrCode::MalformedVersion, FMgr.getLastOffset(),
                           ASTNodeAttr::Module);
     }
-    Mod->getVersion() = *Res;
+    Mod.getVersion() = *Res;
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(), ASTNodeAttr::Module);
   }
+  return {};
+}
 
-  // Variables to record the loaded section types.
-  HasDataSection = false;
-  std::bitset<0x0DU> Secs;
-
+// Load sections of Module node until the end. See "include/loader/loader.h".
+Expect<void> Loader::loadModuleSections(AST::Module &Mod,
+                                        std::bitset<0x0DU> &Secs) {
   // Read Section index and create Section nodes.
   while (true) {
     uint8_t NewSectionId = 0x00;
@@ -57,132 +148,154 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
                             ASTNodeAttr::Module);
       }
     }
-
-    // Sections except the custom section should be unique.
-    if (NewSectionId > 0x00U && NewSectionId < 0x0DU &&
-        Secs.test(NewSectionId)) {
-      return logLoadError(ErrCode::JunkSection, FMgr.getLastOffset(),
-                          ASTNodeAttr::Module);
+    if (auto Res = loadModuleSection(Mod, NewSectionId, Secs); !Res) {
+      return Unexpect(Res);
     }
+  }
+  return {};
+}
 
-    switch (NewSectionId) {
-    case 0x00:
-      Mod->getCustomSections().emplace_back();
-      if (auto Res = loadSection(Mod->getCustomSections().back()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      break;
-    case 0x01:
-      if (auto Res = loadSection(Mod->getTypeSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x02:
-      if (auto Res = loadSection(Mod->getImportSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x03:
-      if (auto Res = loadSection(Mod->getFunctionSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x04:
-      if (auto Res = loadSection(Mod->getTableSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x05:
-      if (auto Res = loadSection(Mod->getMemorySection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x06:
-      if (auto Res = loadSection(Mod->getGlobalSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x07:
-      if (auto Res = loadSection(Mod->getExportSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x08:
-      if (auto Res = loadSection(Mod->getStartSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x09:
-      if (auto Res = loadSection(Mod->getElementSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0A:
-      if (auto Res = loadSection(Mod->getCodeSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0B:
-      if (auto Res = loadSection(Mod->getDataSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0C:
-      // This section is for BulkMemoryOperations or ReferenceTypes proposal.
-      if (!Conf.hasProposal(Proposal::BulkMemoryOperations) &&
-          !Conf.hasProposal(Proposal::ReferenceTypes)) {
-        return logNeedProposal(ErrCode::MalformedSection,
-                               Proposal::BulkMemoryOperations,
-                               FMgr.getLastOffset(), ASTNodeAttr::Module);
-      }
-      if (auto Res = loadSection(Mod->getDataCountSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      HasDataSection = true;
-      Secs.set(NewSectionId);
-      break;
-    default:
-      return logLoadError(ErrCode::MalformedSection, FMgr.getLastOffset(),
-                          ASTNodeAttr::Module);
+// Load a section of Module node. See "include/loader/loader.h".
+Expect<void> Loader::loadModuleSection(AST::Module &Mod, uint8_t Id,
+                                       std::bitset<0x0DU> &Secs) {
+  // Sections except the custom section should be unique.
+  if (Id > 0x00U && Id < 0x0DU && Secs.test(Id)) {
+    return logLoadError(ErrCode::JunkSection, FMgr.getLastOffset(),
+                        ASTNodeAttr::Module);
+  }
+
+  switch (Id) {
+  case 0x00:
+    Mod.getCustomSections().emplace_back();
+    if (auto Res = loadSection(Mod.getCustomSections().back()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    break;
+  case 0x01:
+    if (auto Res = loadSection(Mod.getTypeSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x02:
+    if (auto Res = loadSection(Mod.getImportSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x03:
+    if (auto Res = loadSection(Mod.getFunctionSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x04:
+    if (auto Res = loadSection(Mod.getTableSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x05:
+    if (auto Res = loadSection(Mod.getMemorySection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
     }
+    Secs.set(Id);
+    break;
+  case 0x06:
+    if (auto Res = loadSection(Mod.getGlobalSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x07:
+    if (auto Res = loadSection(Mod.getExportSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x08:
+    if (auto Res = loadSection(Mod.getStartSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x09:
+    if (auto Res = loadSection(Mod.getElementSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x0A: {
+    // The sections before the code section are loaded, so the function bodies
+    // can be checked while decoding.
+    if (Conf.getLoaderConfigure().isFusedValidation() &&
+        !Conf.getLoaderConfigure().isLazyFunctionBody()) {
+      Validator::FormChecker Checker;
+      Checker.addModuleContext(Mod);
+      FusedChecker.emplace(Checker.createWorker());
+    }
+    auto Res = loadSection(Mod.getCodeSection());
+    FusedChecker.reset();
+    if (!Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  }
+  case 0x0B:
+    if (auto Res = loadSection(Mod.getDataSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(Id);
+    break;
+  case 0x0C:
+    // This section is for BulkMemoryOperations or ReferenceTypes proposal.
+    if (!Conf.hasProposal(Proposal::BulkMemoryOperations) &&
+        !Conf.hasProposal(Proposal::ReferenceTypes)) {
+      return logNeedProposal(ErrCode::MalformedSection,
+                             Proposal::BulkMemoryOperations,
+                             FMgr.getLastOffset(), ASTNodeAttr::Module);
+    }
+    if (auto Res = loadSection(Mod.getDataCountSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    HasDataSection = true;
+    Secs.set(Id);
+    break;
+  default:
+    return logLoadError(ErrCode::MalformedSection, FMgr.getLastOffset(),
+                        ASTNodeAttr::Module);
   }
+  return {};
+}
 
+// Verify the loaded sections of Module node. See "include/loader/loader.h".
+Expect<void> Loader::checkModule(AST::Module &Mod) {
   // Verify the function section and code section are matched.
-  if (Mod->getFunctionSection().getContent().size() !=
-      Mod->getCodeSection().getContent().size()) {
+  if (Mod.getFunctionSection().getContent().size() !=
+      Mod.getCodeSection().getContent().size()) {
     spdlog::error(ErrCode::IncompatibleFuncCode);
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return Unexpect(ErrCode::IncompatibleFuncCode);
   }
 
   // Verify the data count section and data segments are matched.
-  if (Mod->getDataCountSection().getContent()) {
-    if (Mod->getDataSection().getContent().size() !=
-        *(Mod->getDataCountSection().getContent())) {
+  if (Mod.getDataCountSection().getContent()) {
+    if (Mod.getDataSection().getContent().size() !=
+        *(Mod.getDataCountSection().getContent())) {
       spdlog::error(ErrCode::IncompatibleDataCount);
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
       return Unexpect(ErrCode::IncompatibleDataCount);
@@ -190,26 +303,31 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   }
 
   // Load Custom Sections
-  for (const auto &CustomSec : Mod->getCustomSections()) {
+  for (const auto &CustomSec : Mod.getCustomSections()) {
     const auto &Name = CustomSec.getName();
     if (Name == "wasmedge") {
       {
         FileMgr VecMgr;
         VecMgr.setCode(CustomSec.getContent());
-        if (auto Res = loadSection(VecMgr, Mod->getAOTSection());
+        if (auto Res = loadSection(VecMgr, Mod.getAOTSection());
             unlikely(!Res)) {
           spdlog::error("load failed:{}", Res.error());
           continue;
         }
       }
+      // The variants are ordered by the CPU levels from the highest, so the
+      // first one supported by the running CPU is selected.
+      if (!isCPULevelSupported(Mod.getAOTSection().getCPULevel())) {
+        continue;
+      }
 
       auto Library = std::make_shared<SharedLibrary>();
-      if (auto Res = Library->load(Mod->getAOTSection()); unlikely(!Res)) {
+      if (auto Res = Library->load(Mod.getAOTSection()); unlikely(!Res)) {
         spdlog::error("library load failed:{}", Res.error());
         continue;
       }
 
-      auto &FuncTypes = Mod->getTypeSection().getContent();
+      auto &FuncTypes = Mod.getTypeSection().getContent();
       if (auto Symbols = Library->getTypes<AST::FunctionType::Wrapper>();
           unlikely(Symbols.size() != FuncTypes.size())) {
         spdlog::error("number of types not matching:{} {}", Symbols.size(),
@@ -220,7 +338,7 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
           FuncTypes[I].setSymbol(std::move(Symbols[I]));
         }
       }
-      auto &CodeSegs = Mod->getCodeSection().getContent();
+      auto &CodeSegs = Mod.getCodeSection().getContent();
       if (auto Symbols = Library->getCodes<void>();
           unlikely(Symbols.size() != CodeSegs.size())) {
         spdlog::error("number of codes not matching:{} {}", Symbols.size(),
@@ -237,13 +355,12 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
         spdlog::error("intrinsics table symbol not found");
         continue;
       } else {
-        Mod->setSymbol(std::move(Symbol));
+        Mod.setSymbol(std::move(Symbol));
       }
       break;
     }
   }
-
-  return Mod;
+  return {};
 }
 
 // Load compiled function from loadable manager. See "include/loader/loader.h".
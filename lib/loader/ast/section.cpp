@@ -5,9 +5,14 @@
 
 #include "aot/version.h"
 #include "common/defines.h"
+#include "common/hash.h"
+
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace WasmEdge {
 namespace Loader {
@@ -24,19 +29,33 @@ Expect<uint32_t> Loader::loadSectionSize(ASTNodeAttr Node) {
 // Load content of custom section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::CustomSection &Sec) {
   return loadSectionContent(Sec, [this, &Sec]() -> Expect<void> {
+    // Borrow the name and the content if the module data is owned.
+    const bool Borrow = FMgr.hasDataOwner();
     // Read name.
     auto StartOffset = FMgr.getOffset();
-    if (auto Res = FMgr.readName()) {
-      Sec.setName(*Res);
+    if (auto Res = FMgr.readNameView()) {
+      if (Borrow) {
+        Sec.setNameView(*Res);
+      } else {
+        Sec.setName(*Res);
+      }
     } else {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Sec_Custom);
     }
     auto ReadSize = FMgr.getOffset() - StartOffset;
-    // Read remain bytes.
-    if (auto Res = FMgr.readBytes(Sec.getContentSize() - ReadSize)) {
-      Sec.getContent().insert(Sec.getContent().end(), (*Res).begin(),
-                              (*Res).end());
+    // Read remain bytes. The contents are unused in execution except the AOT
+    // section, so only record the range of the others if not borrowed.
+    const auto Offset = FMgr.getOffset();
+    if (auto Res = FMgr.readBytesView(Sec.getContentSize() - ReadSize)) {
+      Sec.setContentRange(Offset, static_cast<uint32_t>((*Res).size()));
+      if (Borrow) {
+        Sec.setContentView(*Res);
+      } else if (Sec.getName() == "wasmedge") {
+        Sec.setContent(std::vector<Byte>((*Res).begin(), (*Res).end()));
+      } else {
+        Sec.setContentHash(hashBytes(*Res));
+      }
     } else {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Sec_Custom);
@@ -138,12 +157,106 @@ Expect<void> Loader::loadSection(AST::ElementSection &Sec) {
 // Load vector of code section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::CodeSection &Sec) {
   return loadSectionContent(Sec, [this, &Sec]() {
-    return loadSectionContentVec(Sec, [this](AST::CodeSegment &CodeSeg) {
-      return loadSegment(CodeSeg);
-    });
+    if (Conf.getLoaderConfigure().isLazyFunctionBody()) {
+      // Record the function bodies to decode them at the first use.
+      if (auto Owner = FMgr.getDataOwner()) {
+        LazyCtx = std::make_shared<const LazyContext>(
+            Conf, HasDataSection, std::move(Owner), FMgr.getData());
+      }
+      auto Res = loadSectionContentVec(
+          Sec, [this, Idx = UINT32_C(0)](AST::CodeSegment &CodeSeg) mutable {
+            return loadSegment(CodeSeg, Idx++);
+          });
+      LazyCtx.reset();
+      return Res;
+    }
+    if (const uint32_t Threads =
+            Conf.getLoaderConfigure().getParallelThreads();
+        Threads > 1) {
+      return loadCodeSegmentsParallel(Sec, Threads);
+    }
+    return loadSectionContentVec(
+        Sec, [this, Idx = UINT32_C(0)](AST::CodeSegment &CodeSeg) mutable {
+          return loadSegment(CodeSeg, Idx++);
+        });
   });
 }
 
+// Load vector of code section in parallel. See "include/loader/loader.h".
+Expect<void> Loader::loadCodeSegmentsParallel(AST::CodeSection &Sec,
+                                              uint32_t Threads) {
+  uint32_t VecCnt = 0;
+  // Read the vector size.
+  if (auto Res = FMgr.readU32()) {
+    VecCnt = *Res;
+    Sec.getContent().resize(VecCnt);
+  } else {
+    return logLoadError(Res.error(), FMgr.getLastOffset(),
+                        ASTNodeAttr::Sec_Code);
+  }
+
+  // Scan the start offsets of the code segments by the segment sizes. The
+  // scanning stops before the first segment with malformed size, and the
+  // segments from it are decoded sequentially to report the error.
+  std::vector<uint64_t> Starts;
+  {
+    FileMgr ScanMgr;
+    ScanMgr.setView(FMgr, FMgr.getOffset());
+    Starts.push_back(ScanMgr.getOffset());
+    for (uint32_t I = 0; I < VecCnt; ++I) {
+      auto Res = ScanMgr.readU32();
+      if (!Res || !ScanMgr.readBytesView(*Res)) {
+        break;
+      }
+      Starts.push_back(ScanMgr.getOffset());
+    }
+  }
+  const uint32_t ScanCnt = static_cast<uint32_t>(Starts.size() - 1);
+
+  // Decode the scanned segments by the workers with their own file managers.
+  // A segment fails if its decoding fails or doesn't end at the next start,
+  // and the segments after the first failed one are decoded sequentially.
+  std::atomic<uint32_t> Next = 0;
+  std::atomic<uint32_t> Failed = ScanCnt;
+  auto Decode = [this, &Sec, &Starts, &Next, &Failed]() {
+    Loader Worker(Conf);
+    Worker.HasDataSection = HasDataSection;
+    Worker.IsWorker = true;
+    if (FusedChecker) {
+      Worker.FusedChecker.emplace(FusedChecker->createWorker());
+    }
+    uint32_t I;
+    while ((I = Next.fetch_add(1, std::memory_order_relaxed)) <
+           Failed.load(std::memory_order_relaxed)) {
+      Worker.FMgr.setView(FMgr, Starts[I]);
+      if (!Worker.loadSegment(Sec.getContent()[I], I) ||
+          Worker.FMgr.getOffset() != Starts[I + 1]) {
+        uint32_t Cur = Failed.load(std::memory_order_relaxed);
+        while (I < Cur && !Failed.compare_exchange_weak(
+                              Cur, I, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  };
+  WorkerPool::run(Pool, Threads, ScanCnt, Decode);
+
+  // Skip the decoded segments and decode the remaining ones sequentially.
+  const uint32_t Decoded = Failed.load(std::memory_order_relaxed);
+  if (auto Res = FMgr.readBytesView(Starts[Decoded] - FMgr.getOffset());
+      unlikely(!Res)) {
+    return logLoadError(Res.error(), FMgr.getLastOffset(),
+                        ASTNodeAttr::Sec_Code);
+  }
+  for (uint32_t I = Decoded; I < VecCnt; ++I) {
+    Sec.getContent()[I] = AST::CodeSegment();
+    if (auto Res = loadSegment(Sec.getContent()[I], I); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
 // Load vector of data section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::DataSection &Sec) {
   return loadSectionContent(Sec, [this, &Sec]() {
@@ -239,6 +352,14 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     return Unexpect(ErrCode::MalformedSection);
   }
 
+  if (auto Res = VecMgr.readByte(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("AOT CPU level read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.setCPULevel(*Res);
+  }
+
   if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
     spdlog::error(Res.error());
     spdlog::error("AOT version address read error:{}", Res.error());
@@ -147,12 +147,14 @@ Expect<void> Loader::loadSegment(AST::ElementSegment &ElemSeg) {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Seg_Element);
     }
+    // The ref.func instructions have no variable-length immediates.
+    AST::InstrSideTable Side;
     for (uint32_t I = 0; I < VecCnt; ++I) {
       // For each element in vec(funcidx), make expr(ref.func idx end).
       ElemSeg.getInitExprs().emplace_back();
       AST::Instruction RefFunc(OpCode::Ref__func);
       AST::Instruction End(OpCode::End);
-      if (auto Res = loadInstruction(RefFunc); unlikely(!Res)) {
+      if (auto Res = loadInstruction(RefFunc, Side); unlikely(!Res)) {
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
         return Unexpect(Res);
       }
@@ -213,7 +215,7 @@ Expect<void> Loader::loadSegment(AST::ElementSegment &ElemSeg) {
 }
 
 // Load binary of CodeSegment node. See "include/loader/loader.h".
-Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
+Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg, uint32_t Idx) {
   // Read the code segment size.
   if (auto Res = FMgr.readU32()) {
     CodeSeg.setSegSize(*Res);
@@ -222,11 +224,47 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
                         ASTNodeAttr::Seg_Code);
   }
 
+  if (LazyCtx) {
+    // Skip the function body and decode it at the first use.
+    const uint64_t Offset = FMgr.getOffset();
+    const uint32_t Size = CodeSeg.getSegSize();
+    if (auto Res = FMgr.readBytesView(Size); unlikely(!Res)) {
+      return logLoadError(Res.error(), FMgr.getLastOffset(),
+                          ASTNodeAttr::Seg_Code);
+    }
+    CodeSeg.setLazyDecoder(
+        [Ctx = LazyCtx, Offset, Size](AST::CodeSegment::LocalVec &Locals,
+                                      AST::Expression &Expr) {
+          return loadLazyBody(*Ctx, Offset, Size, Locals, Expr);
+        });
+    return {};
+  }
+
+  // Check the function body while decoding if its function type is known.
+  if (FusedChecker) {
+    const auto &FuncVec = FusedChecker->getFunctions();
+    const uint64_t FuncIdx =
+        static_cast<uint64_t>(FusedChecker->getNumImportFuncs()) + Idx;
+    if (FuncIdx < FuncVec.size()) {
+      FusedTypeIdx = FuncVec[FuncIdx];
+    }
+  }
+  auto Res = loadCodeBody(CodeSeg.getLocals(), CodeSeg.getExpr());
+  if (Res && FusedTypeIdx) {
+    CodeSeg.setIsValidated();
+  }
+  FusedTypeIdx.reset();
+  return Res;
+}
+
+// Load locals and body of CodeSegment node. See "include/loader/loader.h".
+Expect<void> Loader::loadCodeBody(AST::CodeSegment::LocalVec &Locals,
+                                  AST::Expression &Expr) {
   // Read the vector of local variable counts and types.
   uint32_t VecCnt = 0;
   if (auto Res = FMgr.readU32()) {
     VecCnt = *Res;
-    CodeSeg.getLocals().reserve(VecCnt);
+    Locals.reserve(VecCnt);
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(),
                         ASTNodeAttr::Seg_Code);
@@ -259,18 +297,42 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
         unlikely(!Res)) {
       return Unexpect(Res);
     }
-    CodeSeg.getLocals().push_back(std::make_pair(LocalCnt, LocalType));
+    Locals.push_back(std::make_pair(LocalCnt, LocalType));
+  }
+  if (FusedTypeIdx) {
+    FusedChecker->startFunction(*FusedTypeIdx, Locals);
   }
 
   // Read function body.
-  if (auto Res = loadExpression(CodeSeg.getExpr()); unlikely(!Res)) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+  if (auto Res = loadExpression(Expr); unlikely(!Res)) {
+    if (!IsWorker) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+    }
     return Unexpect(Res);
   }
 
   return {};
 }
 
+// Decode the lazy function body. See "include/loader/loader.h".
+Expect<void> Loader::loadLazyBody(const LazyContext &Ctx, uint64_t Offset,
+                                  uint32_t Size,
+                                  AST::CodeSegment::LocalVec &Locals,
+                                  AST::Expression &Expr) {
+  Loader Ldr(Ctx.Conf);
+  Ldr.HasDataSection = Ctx.HasDataSection;
+  // Keep the offsets in the binary data for the error messages.
+  FileMgr DataMgr;
+  DataMgr.setCode(Ctx.Data);
+  Ldr.FMgr.setView(DataMgr, Offset);
+  Ldr.FMgr.setSectionSize(Size);
+  if (auto Res = Ldr.loadCodeBody(Locals, Expr); unlikely(!Res)) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 // Load binary of DataSegment node. See "include/loader/loader.h".
 Expect<void> Loader::loadSegment(AST::DataSegment &DataSeg) {
   DataSeg.setMode(AST::DataSegment::DataMode::Passive);
@@ -334,8 +396,16 @@ Expect<void> Loader::loadSegment(AST::DataSegment &DataSeg) {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Seg_Data);
     }
-    if (auto Res = FMgr.readBytes(VecCnt)) {
-      DataSeg.getData() = std::move(*Res);
+    if (auto Map = FMgr.getFileMap()) {
+      // Borrow the data from the mapped file instead of copying.
+      if (auto Res = FMgr.readBytesView(VecCnt)) {
+        DataSeg.setData(*Res, std::move(Map));
+      } else {
+        return logLoadError(Res.error(), FMgr.getLastOffset(),
+                            ASTNodeAttr::Seg_Data);
+      }
+    } else if (auto Res = FMgr.readBytes(VecCnt)) {
+      DataSeg.setData(std::move(*Res));
     } else {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Seg_Data);
@@ -11,30 +11,42 @@ namespace Loader {
 Expect<void> Loader::loadLimit(AST::Limit &Lim) {
   // Read limit.
   if (auto Res = FMgr.readByte()) {
-    switch (static_cast<AST::Limit::LimitType>(*Res)) {
-    case AST::Limit::LimitType::HasMin:
-      Lim.setHasMax(false);
-      break;
-    case AST::Limit::LimitType::HasMinMax:
-      Lim.setHasMax(true);
-      break;
-    default:
-      if (*Res == 0x80 || *Res == 0x81) {
-        // LEB128 cases will fail.
-        return logLoadError(ErrCode::IntegerTooLong, FMgr.getLastOffset(),
-                            ASTNodeAttr::Type_Limit);
-      } else {
-        return logLoadError(ErrCode::IntegerTooLarge, FMgr.getLastOffset(),
-                            ASTNodeAttr::Type_Limit);
-      }
+    // The shared flag is for the Threads proposal, and the 64-bit index type
+    // flag is for the Memory64 proposal.
+    const bool IsValidShared =
+        (*Res & 0x02U) == 0 || Conf.hasProposal(Proposal::Threads);
+    const bool IsValid64 =
+        (*Res & 0x04U) == 0 || Conf.hasProposal(Proposal::Memory64);
+    if (*Res <= static_cast<uint8_t>(AST::Limit::LimitType::I64Shared) &&
+        IsValidShared && IsValid64) {
+      Lim.setHasMax(*Res & 0x01U);
+      Lim.setShared(*Res & 0x02U);
+      Lim.setIs64(*Res & 0x04U);
+    } else if (*Res == 0x80 || *Res == 0x81) {
+      // LEB128 cases will fail.
+      return logLoadError(ErrCode::IntegerTooLong, FMgr.getLastOffset(),
+                          ASTNodeAttr::Type_Limit);
+    } else {
+      return logLoadError(ErrCode::IntegerTooLarge, FMgr.getLastOffset(),
+                          ASTNodeAttr::Type_Limit);
     }
   } else {
     return logLoadError(Res.error(), FMgr.getLastOffset(),
                         ASTNodeAttr::Type_Limit);
   }
 
-  // Read min and max number.
-  if (auto Res = FMgr.readU32()) {
+  // Read min and max number. The 64-bit limits are encoded in u64.
+  auto readLimitNum = [this, &Lim]() -> Expect<uint64_t> {
+    if (Lim.is64()) {
+      return FMgr.readU64();
+    }
+    if (auto Res = FMgr.readU32()) {
+      return *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  };
+  if (auto Res = readLimitNum()) {
     Lim.setMin(*Res);
     Lim.setMax(*Res);
   } else {
@@ -42,7 +54,7 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
                         ASTNodeAttr::Type_Limit);
   }
   if (Lim.hasMax()) {
-    if (auto Res = FMgr.readU32()) {
+    if (auto Res = readLimitNum()) {
       Lim.setMax(*Res);
     } else {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
@@ -150,6 +162,11 @@ Expect<void> Loader::loadType(AST::TableType &TabType) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Type_Table));
     return Unexpect(Res);
   }
+  // Tables cannot be shared or 64-bit indexed.
+  if (TabType.getLimit().isShared() || TabType.getLimit().is64()) {
+    return logLoadError(ErrCode::IntegerTooLarge, FMgr.getLastOffset(),
+                        ASTNodeAttr::Type_Table);
+  }
   return {};
 }
 
@@ -4,12 +4,68 @@
 #include "loader/filemgr.h"
 
 #include <algorithm>
+#include <boost/predef/other/endian.h>
+#include <cstring>
+#include <fstream>
 #include <iterator>
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 // Error logging of file manager need to be handled in caller.
 
 namespace WasmEdge {
 
+namespace {
+
+/// Size of the window of the fast LEB128 decoding.
+inline constexpr uint64_t kLEB128Window = 8;
+
+/// Decode a LEB128 in the 8-byte window without checking each byte.
+///
+/// \param Ptr the start of the window, which should have 8 readable bytes.
+/// \param [out] Value the decoded bits, zero extended.
+///
+/// \returns the byte length of the LEB128, 0 if longer than the window.
+inline uint32_t decodeLEB128Window(const Byte *Ptr, uint64_t &Value) noexcept {
+  uint64_t Word;
+  std::memcpy(&Word, Ptr, sizeof(Word));
+#if BOOST_ENDIAN_BIG_BYTE
+  Word = __builtin_bswap64(Word);
+#endif
+  // The last byte is the first one without the continuation bit.
+  const uint64_t Stops = ~Word & UINT64_C(0x8080808080808080);
+  if (unlikely(Stops == 0)) {
+    return 0;
+  }
+  const uint32_t Len = (static_cast<uint32_t>(__builtin_ctzll(Stops)) >> 3) + 1;
+  if (Len < 8) {
+    Word &= (UINT64_C(1) << (Len * 8)) - 1;
+  }
+#if defined(__BMI2__)
+  Value = _pext_u64(Word, UINT64_C(0x7F7F7F7F7F7F7F7F));
+#else
+  Value = (Word & UINT64_C(0x000000000000007F)) |
+          ((Word >> 1) & UINT64_C(0x0000000000003F80)) |
+          ((Word >> 2) & UINT64_C(0x00000000001FC000)) |
+          ((Word >> 3) & UINT64_C(0x000000000FE00000)) |
+          ((Word >> 4) & UINT64_C(0x00000007F0000000)) |
+          ((Word >> 5) & UINT64_C(0x000003F800000000)) |
+          ((Word >> 6) & UINT64_C(0x0001FC0000000000)) |
+          ((Word >> 7) & UINT64_C(0x00FE000000000000));
+#endif
+  return Len;
+}
+
+/// Sign extend the decoded bits of a LEB128 in the given byte length.
+inline int64_t signExtendLEB128(uint64_t Value, uint32_t Len) noexcept {
+  const uint32_t Shift = 64 - Len * 7;
+  return static_cast<int64_t>(Value << Shift) >> Shift;
+}
+
+} // namespace
+
 // Set path to file manager. See "include/loader/filemgr.h".
 Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
   reset();
@@ -21,15 +77,28 @@ Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
       Status = ErrCode::IllegalPath;
       return Unexpect(Status);
     }
-    FileMap.emplace(FilePath);
+    FileMap = std::make_shared<MMap>(FilePath);
     if (auto *Pointer = FileMap->address(); likely(Pointer)) {
       Data = reinterpret_cast<const Byte *>(Pointer);
       Status = ErrCode::Success;
-    } else {
-      // File size is 0, mmap failed.
-      // Will get 'UnexpectedEnd' error while the first reading.
-      FileMap.reset();
+      return {};
     }
+    FileMap.reset();
+    if (Size > 0) {
+      // The file cannot be mapped, e.g. locked by a writer. Read a copy.
+      std::ifstream File(FilePath, std::ios::binary);
+      auto Holder = std::make_shared<std::vector<Byte>>(Size);
+      if (File.read(reinterpret_cast<char *>(Holder->data()),
+                    static_cast<std::streamsize>(Size))) {
+        DataHolder = std::move(Holder);
+        Data = DataHolder->data();
+        Status = ErrCode::Success;
+        return {};
+      }
+    }
+    // File size is 0, or failed to read.
+    // Will get 'UnexpectedEnd' error while the first reading.
+    Size = 0;
     return {};
   }
   Size = 0;
@@ -49,13 +118,26 @@ Expect<void> FileMgr::setCode(Span<const Byte> CodeData) {
 // Set code data. See "include/loader/filemgr.h".
 Expect<void> FileMgr::setCode(std::vector<Byte> CodeData) {
   reset();
-  DataHolder.emplace(std::move(CodeData));
+  DataHolder = std::make_shared<std::vector<Byte>>(std::move(CodeData));
   Data = DataHolder->data();
   Size = DataHolder->size();
   Status = ErrCode::Success;
   return {};
 }
 
+// Set view of another file manager. See "include/loader/filemgr.h".
+void FileMgr::setView(const FileMgr &Base, uint64_t Offset) {
+  reset();
+  Data = Base.Data;
+  Size = Base.Size;
+  FileMap = Base.FileMap;
+  DataHolder = Base.DataHolder;
+  SecPos = Base.SecPos;
+  LastPos = Offset;
+  Pos = Offset;
+  Status = ErrCode::Success;
+}
+
 // Read one byte. See "include/loader/filemgr.h".
 Expect<Byte> FileMgr::readByte() {
   if (unlikely(Status != ErrCode::Success)) {
@@ -82,6 +164,22 @@ Expect<std::vector<Byte>> FileMgr::readBytes(size_t SizeToRead) {
   return Buf;
 }
 
+// Read number of bytes as a view. See "include/loader/filemgr.h".
+Expect<Span<const Byte>> FileMgr::readBytesView(size_t SizeToRead) {
+  if (unlikely(Status != ErrCode::Success)) {
+    return Unexpect(Status);
+  }
+  // Set the flag to the start offset.
+  LastPos = Pos;
+  // Check if exceed the data boundary and section boundary.
+  if (auto Res = testRead(SizeToRead); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  Span<const Byte> View(Data + Pos, SizeToRead);
+  Pos += SizeToRead;
+  return View;
+}
+
 // Decode and read an unsigned int. See "include/loader/filemgr.h".
 Expect<uint32_t> FileMgr::readU32() {
   if (unlikely(Status != ErrCode::Success)) {
@@ -90,6 +188,21 @@ Expect<uint32_t> FileMgr::readU32() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Fast path: decode without checking each byte if far from the data end.
+  // The too long or too large cases fall back to report the errors.
+  if (likely(Size - Pos >= kLEB128Window)) {
+    uint64_t Value;
+    const uint32_t Len = decodeLEB128Window(Data + Pos, Value);
+    if (likely(Len != 0 && Len <= 5 &&
+               (Len < 5 || (Data[Pos + 4] & 0x70U) == 0))) {
+      Pos += Len;
+      if (auto Res = testSectionEnd(); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      return static_cast<uint32_t>(Value);
+    }
+  }
+
   // Read and decode U32.
   uint32_t Result = 0;
   uint32_t Offset = 0;
@@ -115,10 +228,8 @@ Expect<uint32_t> FileMgr::readU32() {
     Offset += 7;
   }
   // Check if the variable length exceed the set section boundary.
-  if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
-    LastPos = SecPos.value();
-    Status = ErrCode::UnexpectedEnd;
-    return Unexpect(Status);
+  if (auto Res = testSectionEnd(); unlikely(!Res)) {
+    return Unexpect(Res);
   }
   return Result;
 }
@@ -131,6 +242,20 @@ Expect<uint64_t> FileMgr::readU64() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Fast path: decode without checking each byte if far from the data end.
+  // The LEB128 longer than the window falls back.
+  if (likely(Size - Pos >= kLEB128Window)) {
+    uint64_t Value;
+    if (const uint32_t Len = decodeLEB128Window(Data + Pos, Value);
+        likely(Len != 0)) {
+      Pos += Len;
+      if (auto Res = testSectionEnd(); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      return Value;
+    }
+  }
+
   // Read and decode U64.
   uint64_t Result = 0;
   uint64_t Offset = 0;
@@ -156,10 +281,8 @@ Expect<uint64_t> FileMgr::readU64() {
     Offset += 7;
   }
   // Check if the variable length exceed the set section boundary.
-  if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
-    LastPos = SecPos.value();
-    Status = ErrCode::UnexpectedEnd;
-    return Unexpect(Status);
+  if (auto Res = testSectionEnd(); unlikely(!Res)) {
+    return Unexpect(Res);
   }
   return Result;
 }
@@ -172,6 +295,20 @@ Expect<int32_t> FileMgr::readS32() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Fast path: decode without checking each byte if far from the data end.
+  // The 5-byte LEB128 needs the extra checks and falls back.
+  if (likely(Size - Pos >= kLEB128Window)) {
+    uint64_t Value;
+    if (const uint32_t Len = decodeLEB128Window(Data + Pos, Value);
+        likely(Len != 0 && Len < 5)) {
+      Pos += Len;
+      if (auto Res = testSectionEnd(); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      return static_cast<int32_t>(signExtendLEB128(Value, Len));
+    }
+  }
+
   // Read and decode S32.
   int32_t Result = 0;
   uint32_t Offset = 0;
@@ -205,10 +342,8 @@ Expect<int32_t> FileMgr::readS32() {
     Result |= static_cast<int32_t>(UINT32_C(0xFFFFFFFF) << Offset);
   }
   // Check if the variable length exceed the set section boundary.
-  if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
-    LastPos = SecPos.value();
-    Status = ErrCode::UnexpectedEnd;
-    return Unexpect(Status);
+  if (auto Res = testSectionEnd(); unlikely(!Res)) {
+    return Unexpect(Res);
   }
   return Result;
 }
@@ -221,6 +356,20 @@ Expect<int64_t> FileMgr::readS64() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Fast path: decode without checking each byte if far from the data end.
+  // The LEB128 longer than the window falls back.
+  if (likely(Size - Pos >= kLEB128Window)) {
+    uint64_t Value;
+    if (const uint32_t Len = decodeLEB128Window(Data + Pos, Value);
+        likely(Len != 0)) {
+      Pos += Len;
+      if (auto Res = testSectionEnd(); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      return signExtendLEB128(Value, Len);
+    }
+  }
+
   // Read and decode S64.
   int64_t Result = 0;
   uint64_t Offset = 0;
@@ -254,10 +403,8 @@ Expect<int64_t> FileMgr::readS64() {
     Result |= static_cast<int64_t>(UINT64_C(0xFFFFFFFFFFFFFFFF) << Offset);
   }
   // Check if the variable length exceed the set section boundary.
-  if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
-    LastPos = SecPos.value();
-    Status = ErrCode::UnexpectedEnd;
-    return Unexpect(Status);
+  if (auto Res = testSectionEnd(); unlikely(!Res)) {
+    return Unexpect(Res);
   }
   return Result;
 }
@@ -312,11 +459,21 @@ Expect<double> FileMgr::readF64() {
 
 // Read a vector of bytes. See "include/loader/filemgr.h".
 Expect<std::string> FileMgr::readName() {
+  if (auto Res = readNameView()) {
+    return std::string(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+// Read a string as a view into the binary data. See
+// "include/loader/filemgr.h".
+Expect<std::string_view> FileMgr::readNameView() {
   if (unlikely(Status != ErrCode::Success)) {
     return Unexpect(Status);
   }
-  // If UTF-8 validation or readU32() or readBytes() failed, the last succeeded
-  // reading offset will be at the start of `Name`.
+  // If UTF-8 validation or readU32() or readBytesView() failed, the last
+  // succeeded reading offset will be at the start of `Name`.
   LastPos = Pos;
 
   // Read the name size.
@@ -332,13 +489,10 @@ Expect<std::string> FileMgr::readName() {
     return Unexpect(ErrCode::NameSizeOutOfBounds);
   }
 
-  // Read the UTF-8 bytes.
-  std::string Str(SizeToRead, '\0');
-  if (auto Res = readBytes(
-          Span<Byte>(reinterpret_cast<Byte *>(Str.data()), Str.size()));
-      unlikely(!Res)) {
-    return Unexpect(Res);
-  }
+  // Take the UTF-8 bytes.
+  std::string_view Str(reinterpret_cast<const char *>(Data + Pos),
+                       SizeToRead);
+  Pos += SizeToRead;
 
   // UTF-8 validation.
   bool Valid = true;
@@ -447,6 +601,17 @@ Expect<void> FileMgr::readBytes(Span<Byte> Buffer) {
   return {};
 }
 
+// Helper function for checking section end. See "include/loader/filemgr.h".
+Expect<void> FileMgr::testSectionEnd() {
+  // Check if the variable length exceed the set section boundary.
+  if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
+    LastPos = SecPos.value();
+    Status = ErrCode::UnexpectedEnd;
+    return Unexpect(Status);
+  }
+  return {};
+}
+
 // Helper function for checking boundary. See "include/loader/filemgr.h".
 Expect<void> FileMgr::testRead(uint64_t Read) {
   // Check if exceed the set section boundary first
@@ -0,0 +1,801 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "loader/loader.h"
+
+#include "aot/cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Loader {
+
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+/// Magic and version of the flat image. The version should be increased when
+/// the layout of the image or the AST nodes is changed.
+constexpr std::array<Byte, 8> kFlatMagic = {0x00U, 'w', 'f', 'l',
+                                            'a',   't', 0x00U, 0x00U};
+constexpr uint32_t kFlatVersion = 4;
+/// Byte order mark of the flat image.
+constexpr uint32_t kFlatEndian = 0x01020304U;
+/// Alignment of the arrays in the flat image.
+constexpr size_t kFlatAlign = 8;
+/// Size of an instruction in the flat image, which is the opcode, the offset,
+/// and the immediates.
+constexpr uint64_t kFlatInstrSize = sizeof(OpCode) + sizeof(uint32_t) +
+                                    sizeof(uint64_t) * 2;
+
+/// Bitmask of the enabled proposals, which the decoding depends on.
+uint64_t getProposalMask(const Configure &Conf) noexcept {
+  static_assert(static_cast<uint8_t>(Proposal::Max) <= 64);
+  uint64_t Mask = 0;
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    if (Conf.hasProposal(static_cast<Proposal>(I))) {
+      Mask |= UINT64_C(1) << I;
+    }
+  }
+  return Mask;
+}
+
+/// Writer of the flat image. The fixed-size fields are written in the native
+/// layout, and the variable-length fields are written as the count and the
+/// aligned array. The instructions are written field by field without the
+/// pointers and the padding, so the image is deterministic.
+class FlatWriter {
+public:
+  template <typename T> void write(const T &Val) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *Ptr = reinterpret_cast<const Byte *>(&Val);
+    Buf.insert(Buf.end(), Ptr, Ptr + sizeof(T));
+  }
+
+  template <typename T> void writeArray(Span<const T> Arr) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write(static_cast<uint32_t>(Arr.size()));
+    Buf.resize((Buf.size() + kFlatAlign - 1) / kFlatAlign * kFlatAlign);
+    const auto *Ptr = reinterpret_cast<const Byte *>(Arr.data());
+    Buf.insert(Buf.end(), Ptr, Ptr + Arr.size() * sizeof(T));
+  }
+
+  void writeName(std::string_view Name) {
+    writeArray(Span<const Byte>(reinterpret_cast<const Byte *>(Name.data()),
+                                Name.size()));
+  }
+
+  void writeLimit(const AST::Limit &Lim) {
+    write(static_cast<uint8_t>((Lim.hasMax() ? 0x01U : 0x00U) |
+                               (Lim.isShared() ? 0x02U : 0x00U) |
+                               (Lim.is64() ? 0x04U : 0x00U)));
+    write(Lim.getMin());
+    write(Lim.getMax());
+  }
+
+  void writeInstr(AST::Instruction Instr) {
+    // Only the list sizes are kept, which are bound to the side table again.
+    if (Instr.getOpCode() == OpCode::Br_table) {
+      Instr.setLabelList(
+          Span<const uint32_t>(static_cast<const uint32_t *>(nullptr),
+                               Instr.getLabelList().size()));
+    } else if (Instr.getOpCode() == OpCode::Select_t) {
+      Instr.setValTypeList(
+          Span<const ValType>(static_cast<const ValType *>(nullptr),
+                              Instr.getValTypeList().size()));
+    }
+    const auto Num = Instr.getNum().get<uint128_t>();
+    write(Instr.getOpCode());
+    write(Instr.getOffset());
+    write(static_cast<uint64_t>(Num));
+    write(static_cast<uint64_t>(Num >> 64));
+  }
+
+  void writeExpr(const AST::Expression &Expr) {
+    write(static_cast<uint32_t>(Expr.getInstrs().size()));
+    for (const auto &Instr : Expr.getInstrs()) {
+      writeInstr(Instr);
+    }
+    if (const auto &Side = Expr.getSideTable()) {
+      writeArray(Span<const uint32_t>(Side->Labels));
+      writeArray(Span<const ValType>(Side->ValTypes));
+    } else {
+      writeArray(Span<const uint32_t>());
+      writeArray(Span<const ValType>());
+    }
+  }
+
+  std::vector<Byte> Buf;
+};
+
+/// Reader of the flat image. The arrays of bytes are borrowed from the image,
+/// and the others are copied.
+class FlatReader {
+public:
+  FlatReader(Span<const Byte> D) noexcept : Data(D) {}
+
+  template <typename T> Expect<T> read() noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (unlikely(Data.size() - Pos < sizeof(T))) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    T Val;
+    std::memcpy(&Val, Data.data() + Pos, sizeof(T));
+    Pos += sizeof(T);
+    return Val;
+  }
+
+  template <typename T> Expect<Span<const Byte>> readArray() noexcept {
+    uint32_t Cnt = 0;
+    if (auto Res = read<uint32_t>()) {
+      Cnt = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    Pos = std::min(Data.size(),
+                   (Pos + kFlatAlign - 1) / kFlatAlign * kFlatAlign);
+    const uint64_t Size = static_cast<uint64_t>(Cnt) * sizeof(T);
+    if (unlikely(Data.size() - Pos < Size)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    auto Arr = Data.subspan(Pos, static_cast<size_t>(Size));
+    Pos += static_cast<size_t>(Size);
+    return Arr;
+  }
+
+  template <typename T> Expect<void> readVec(std::vector<T> &Vec) {
+    if (auto Res = readArray<T>()) {
+      Vec.resize(Res->size() / sizeof(T));
+      std::memcpy(Vec.data(), Res->data(), Res->size());
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+  }
+
+  Expect<std::string_view> readName() noexcept {
+    if (auto Res = readArray<Byte>()) {
+      return std::string_view(reinterpret_cast<const char *>(Res->data()),
+                              Res->size());
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  Expect<void> readLimit(AST::Limit &Lim) noexcept {
+    auto Flags = read<uint8_t>();
+    auto Min = read<uint64_t>();
+    auto Max = read<uint64_t>();
+    if (unlikely(!Flags || !Min || !Max)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Lim.setHasMax(*Flags & 0x01U);
+    Lim.setShared(*Flags & 0x02U);
+    Lim.setIs64(*Flags & 0x04U);
+    Lim.setMin(*Min);
+    Lim.setMax(*Max);
+    return {};
+  }
+
+  Expect<AST::Instruction> readInstr() noexcept {
+    auto Code = read<OpCode>();
+    auto Offset = read<uint32_t>();
+    auto Low = read<uint64_t>();
+    auto High = read<uint64_t>();
+    if (unlikely(!Code || !Offset || !Low || !High)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    if (unlikely(OpCodeStr.find(*Code) == OpCodeStr.end())) {
+      return Unexpect(ErrCode::IllegalOpCode);
+    }
+    AST::Instruction Instr(*Code, *Offset);
+    Instr.setNum((static_cast<uint128_t>(*High) << 64) |
+                 static_cast<uint128_t>(*Low));
+    return Instr;
+  }
+
+  Expect<void> readExpr(AST::Expression &Expr) {
+    uint32_t Cnt = 0;
+    if (auto Res = read<uint32_t>()) {
+      Cnt = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    if (unlikely(Data.size() - Pos <
+                 static_cast<uint64_t>(Cnt) * kFlatInstrSize)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    auto &Vec = Expr.getInstrs();
+    // Keep the capacity larger than the size as the loader.
+    Vec.reserve(Cnt + 1);
+    for (uint32_t I = 0; I < Cnt; ++I) {
+      auto Instr = readInstr();
+      if (unlikely(!Instr)) {
+        return Unexpect(Instr);
+      }
+      // The jumps of the blocks should be in the expression.
+      switch (Instr->getOpCode()) {
+      case OpCode::If:
+        if (unlikely(Instr->getJumpElse() >= Cnt - I)) {
+          return Unexpect(ErrCode::MalformedSection);
+        }
+        [[fallthrough]];
+      case OpCode::Block:
+      case OpCode::Loop:
+        if (unlikely(Instr->getJumpEnd() >= Cnt - I)) {
+          return Unexpect(ErrCode::MalformedSection);
+        }
+        break;
+      default:
+        break;
+      }
+      Vec.push_back(*Instr);
+    }
+    AST::InstrSideTable Side;
+    if (auto Res = readVec(Side.Labels); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    if (auto Res = readVec(Side.ValTypes); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    if (unlikely(!Side.bind(Vec))) {
+      return Unexpect(ErrCode::MalformedSection);
+    }
+    if (!Side.Labels.empty() || !Side.ValTypes.empty()) {
+      Expr.setSideTable(
+          std::make_shared<const AST::InstrSideTable>(std::move(Side)));
+    }
+    return {};
+  }
+
+  bool isEnd() const noexcept { return Pos == Data.size(); }
+
+private:
+  Span<const Byte> Data;
+  size_t Pos = 0;
+};
+
+/// Helper macro of returning the error of the expression.
+#define FLAT_TRY(Expr)                                                         \
+  if (auto Res_ = (Expr); unlikely(!Res_)) {                                   \
+    return Unexpect(Res_);                                                     \
+  }
+
+} // namespace
+
+// Serialize module into flat image. See "include/loader/loader.h".
+Expect<void> Loader::saveFlatImage(const AST::Module &Mod,
+                                   const std::filesystem::path &FilePath) {
+  // Only the validated modules are saved, which are validated again after
+  // loading because the image is not trusted.
+  if (!Mod.isValidated()) {
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error("    The module should be validated before saving.");
+    spdlog::error(ErrInfo::InfoFile(FilePath));
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  // The symbols of the AOT compiled modules are not serializable.
+  if (Mod.getSymbol()) {
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error("    The AOT compiled module cannot be saved as flat image.");
+    spdlog::error(ErrInfo::InfoFile(FilePath));
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  for (const auto &CodeSeg : Mod.getCodeSection().getContent()) {
+    // The lazy function bodies are not validated yet.
+    if (CodeSeg.isLazy()) {
+      spdlog::error(ErrCode::IllegalPath);
+      spdlog::error("    The lazy function bodies cannot be saved as flat "
+                    "image.");
+      spdlog::error(ErrInfo::InfoFile(FilePath));
+      return Unexpect(ErrCode::IllegalPath);
+    }
+  }
+
+  FlatWriter W;
+  // Header.
+  W.write(kFlatMagic);
+  W.write(kFlatVersion);
+  W.write(kFlatEndian);
+  W.write(getProposalMask(Conf));
+  W.writeArray(Span<const Byte>(Mod.getMagic()));
+  W.writeArray(Span<const Byte>(Mod.getVersion()));
+
+  // Custom sections.
+  W.write(static_cast<uint32_t>(Mod.getCustomSections().size()));
+  for (const auto &Sec : Mod.getCustomSections()) {
+    W.write(Sec.getContentSize());
+    W.writeName(Sec.getName());
+    W.write(Sec.getContentOffset());
+    W.write(Sec.getContentLength());
+    W.write(Sec.getContentHash());
+    W.write(static_cast<uint8_t>(Sec.isContentLoaded() ? 1 : 0));
+    W.writeArray(Sec.getContent());
+  }
+
+  // Type section.
+  W.write(Mod.getTypeSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getTypeSection().getContent().size()));
+  for (const auto &Type : Mod.getTypeSection().getContent()) {
+    W.writeArray(Span<const ValType>(Type.getParamTypes()));
+    W.writeArray(Span<const ValType>(Type.getReturnTypes()));
+  }
+
+  // Import section.
+  W.write(Mod.getImportSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getImportSection().getContent().size()));
+  for (const auto &Desc : Mod.getImportSection().getContent()) {
+    W.writeName(Desc.getModuleName());
+    W.writeName(Desc.getExternalName());
+    W.write(Desc.getExternalType());
+    W.write(Desc.getExternalFuncTypeIdx());
+    W.write(Desc.getExternalTableType().getRefType());
+    W.writeLimit(Desc.getExternalTableType().getLimit());
+    W.writeLimit(Desc.getExternalMemoryType().getLimit());
+    W.write(Desc.getExternalGlobalType().getValType());
+    W.write(Desc.getExternalGlobalType().getValMut());
+  }
+
+  // Function section.
+  W.write(Mod.getFunctionSection().getContentSize());
+  W.writeArray(Mod.getFunctionSection().getContent());
+
+  // Table section.
+  W.write(Mod.getTableSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getTableSection().getContent().size()));
+  for (const auto &Type : Mod.getTableSection().getContent()) {
+    W.write(Type.getRefType());
+    W.writeLimit(Type.getLimit());
+  }
+
+  // Memory section.
+  W.write(Mod.getMemorySection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getMemorySection().getContent().size()));
+  for (const auto &Type : Mod.getMemorySection().getContent()) {
+    W.writeLimit(Type.getLimit());
+  }
+
+  // Global section.
+  W.write(Mod.getGlobalSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getGlobalSection().getContent().size()));
+  for (const auto &Seg : Mod.getGlobalSection().getContent()) {
+    W.write(Seg.getGlobalType().getValType());
+    W.write(Seg.getGlobalType().getValMut());
+    W.writeExpr(Seg.getExpr());
+  }
+
+  // Export section.
+  W.write(Mod.getExportSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getExportSection().getContent().size()));
+  for (const auto &Desc : Mod.getExportSection().getContent()) {
+    W.writeName(Desc.getExternalName());
+    W.write(Desc.getExternalType());
+    W.write(Desc.getExternalIndex());
+  }
+
+  // Start section.
+  W.write(Mod.getStartSection().getContentSize());
+  W.write(static_cast<uint8_t>(Mod.getStartSection().getContent() ? 1 : 0));
+  W.write(Mod.getStartSection().getContent().value_or(0));
+
+  // Element section.
+  W.write(Mod.getElementSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getElementSection().getContent().size()));
+  for (const auto &Seg : Mod.getElementSection().getContent()) {
+    W.write(Seg.getMode());
+    W.write(Seg.getRefType());
+    W.write(Seg.getIdx());
+    W.writeExpr(Seg.getExpr());
+    W.write(static_cast<uint32_t>(Seg.getInitExprs().size()));
+    for (const auto &Expr : Seg.getInitExprs()) {
+      W.writeExpr(Expr);
+    }
+  }
+
+  // Code section.
+  W.write(Mod.getCodeSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getCodeSection().getContent().size()));
+  for (const auto &Seg : Mod.getCodeSection().getContent()) {
+    W.write(Seg.getSegSize());
+    W.write(static_cast<uint32_t>(Seg.getLocals().size()));
+    for (const auto &Local : Seg.getLocals()) {
+      W.write(Local.first);
+      W.write(Local.second);
+    }
+    W.writeExpr(Seg.getExpr());
+  }
+
+  // Data section.
+  W.write(Mod.getDataSection().getContentSize());
+  W.write(static_cast<uint32_t>(Mod.getDataSection().getContent().size()));
+  for (const auto &Seg : Mod.getDataSection().getContent()) {
+    W.write(Seg.getMode());
+    W.write(Seg.getIdx());
+    W.writeExpr(Seg.getExpr());
+    W.writeArray(Seg.getData());
+  }
+
+  // Data count section.
+  W.write(Mod.getDataCountSection().getContentSize());
+  W.write(
+      static_cast<uint8_t>(Mod.getDataCountSection().getContent() ? 1 : 0));
+  W.write(Mod.getDataCountSection().getContent().value_or(0));
+
+  // Write into a temporary file and rename it, so the concurrent readers
+  // never see the partial image.
+  std::error_code EC;
+  std::filesystem::create_directories(FilePath.parent_path(), EC);
+  auto TmpPath = FilePath;
+  TmpPath += "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream Fout(TmpPath, std::ios::out | std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(W.Buf.data()),
+               static_cast<std::streamsize>(W.Buf.size()));
+    if (!Fout) {
+      std::filesystem::remove(TmpPath, EC);
+      spdlog::error(ErrCode::IllegalPath);
+      spdlog::error(ErrInfo::InfoFile(FilePath));
+      return Unexpect(ErrCode::IllegalPath);
+    }
+  }
+  std::filesystem::rename(TmpPath, FilePath, EC);
+  if (EC) {
+    std::filesystem::remove(TmpPath, EC);
+    spdlog::error(ErrCode::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(FilePath));
+    return Unexpect(ErrCode::IllegalPath);
+  }
+  return {};
+}
+
+// Parse module from flat image. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::parseFlatImage(const std::filesystem::path &FilePath) {
+  std::lock_guard Lock(Mutex);
+  if (auto Res = loadFlatImage(FilePath)) {
+    return Res;
+  } else {
+    spdlog::error(Res.error());
+    spdlog::error(ErrInfo::InfoFile(FilePath));
+    return Unexpect(Res);
+  }
+}
+
+// Load module from flat image. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::loadFlatImage(const std::filesystem::path &FilePath) {
+  FileMgr ImgMgr;
+  if (auto Res = ImgMgr.setPath(FilePath); !Res) {
+    return Unexpect(Res);
+  }
+  auto Mod = std::make_unique<AST::Module>();
+  // The nodes borrow the names and contents from the mapped image.
+  const auto Map = ImgMgr.getFileMap();
+  const bool IsBorrow = static_cast<bool>(Map);
+  Mod->setDataOwner(ImgMgr.getDataOwner());
+  FlatReader R(ImgMgr.getData());
+
+  // Header.
+  if (auto Res = R.read<std::array<Byte, 8>>();
+      unlikely(!Res || *Res != kFlatMagic)) {
+    return Unexpect(ErrCode::MalformedMagic);
+  }
+  if (auto Res = R.read<uint32_t>(); unlikely(!Res || *Res != kFlatVersion)) {
+    return Unexpect(ErrCode::MalformedVersion);
+  }
+  if (auto Res = R.read<uint32_t>(); unlikely(!Res || *Res != kFlatEndian)) {
+    return Unexpect(ErrCode::MalformedVersion);
+  }
+  // The image decoded with other proposals may be different.
+  if (auto Res = R.read<uint64_t>();
+      unlikely(!Res || *Res != getProposalMask(Conf))) {
+    return Unexpect(ErrCode::MalformedVersion);
+  }
+  FLAT_TRY(R.readVec(Mod->getMagic()));
+  FLAT_TRY(R.readVec(Mod->getVersion()));
+
+  auto readSize = [&R](AST::Section &Sec) -> Expect<uint32_t> {
+    if (auto Size = R.read<uint32_t>()) {
+      Sec.setContentSize(*Size);
+    } else {
+      return Unexpect(Size);
+    }
+    return R.read<uint32_t>();
+  };
+  auto setName = [IsBorrow](std::string_view Name, auto &&Set,
+                            auto &&SetView) {
+    if (IsBorrow) {
+      SetView(Name);
+    } else {
+      Set(Name);
+    }
+  };
+
+  // Custom sections.
+  if (auto Cnt = R.read<uint32_t>()) {
+    Mod->getCustomSections().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Sec : Mod->getCustomSections()) {
+    auto Size = R.read<uint32_t>();
+    auto Name = R.readName();
+    auto Offset = R.read<uint64_t>();
+    auto Length = R.read<uint32_t>();
+    auto Hash = R.read<uint64_t>();
+    auto IsLoaded = R.read<uint8_t>();
+    auto Content = R.readArray<Byte>();
+    if (unlikely(!Size || !Name || !Offset || !Length || !Hash || !IsLoaded ||
+                 !Content)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Sec.setContentSize(*Size);
+    Sec.setContentRange(*Offset, *Length);
+    Sec.setContentHash(*Hash);
+    setName(
+        *Name, [&Sec](std::string_view N) { Sec.setName(N); },
+        [&Sec](std::string_view N) { Sec.setNameView(N); });
+    // The content is absent if only the range was recorded.
+    if (*IsLoaded) {
+      if (IsBorrow) {
+        Sec.setContentView(*Content);
+      } else {
+        Sec.setContent(std::vector<Byte>(Content->begin(), Content->end()));
+      }
+    }
+  }
+
+  // Type section.
+  if (auto Cnt = readSize(Mod->getTypeSection())) {
+    Mod->getTypeSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Type : Mod->getTypeSection().getContent()) {
+    FLAT_TRY(R.readVec(Type.getParamTypes()));
+    FLAT_TRY(R.readVec(Type.getReturnTypes()));
+  }
+
+  // Import section.
+  if (auto Cnt = readSize(Mod->getImportSection())) {
+    Mod->getImportSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Desc : Mod->getImportSection().getContent()) {
+    auto ModName = R.readName();
+    auto ExtName = R.readName();
+    auto ExtType = R.read<ExternalType>();
+    auto TypeIdx = R.read<uint32_t>();
+    auto TabRefType = R.read<RefType>();
+    if (unlikely(!ModName || !ExtName || !ExtType || !TypeIdx ||
+                 !TabRefType)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    setName(
+        *ModName, [&Desc](auto N) { Desc.setModuleName(N); },
+        [&Desc](auto N) { Desc.setModuleNameView(N); });
+    setName(
+        *ExtName, [&Desc](auto N) { Desc.setExternalName(N); },
+        [&Desc](auto N) { Desc.setExternalNameView(N); });
+    Desc.setExternalType(*ExtType);
+    Desc.setExternalFuncTypeIdx(*TypeIdx);
+    Desc.getExternalTableType().setRefType(*TabRefType);
+    FLAT_TRY(R.readLimit(Desc.getExternalTableType().getLimit()));
+    FLAT_TRY(R.readLimit(Desc.getExternalMemoryType().getLimit()));
+    auto GlobValType = R.read<ValType>();
+    auto GlobValMut = R.read<ValMut>();
+    if (unlikely(!GlobValType || !GlobValMut)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Desc.getExternalGlobalType().setValType(*GlobValType);
+    Desc.getExternalGlobalType().setValMut(*GlobValMut);
+  }
+
+  // Function section.
+  if (auto Size = R.read<uint32_t>()) {
+    Mod->getFunctionSection().setContentSize(*Size);
+  } else {
+    return Unexpect(Size);
+  }
+  FLAT_TRY(R.readVec(Mod->getFunctionSection().getContent()));
+
+  // Table section.
+  if (auto Cnt = readSize(Mod->getTableSection())) {
+    Mod->getTableSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Type : Mod->getTableSection().getContent()) {
+    if (auto Res = R.read<RefType>()) {
+      Type.setRefType(*Res);
+    } else {
+      return Unexpect(Res);
+    }
+    FLAT_TRY(R.readLimit(Type.getLimit()));
+  }
+
+  // Memory section.
+  if (auto Cnt = readSize(Mod->getMemorySection())) {
+    Mod->getMemorySection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Type : Mod->getMemorySection().getContent()) {
+    FLAT_TRY(R.readLimit(Type.getLimit()));
+  }
+
+  // Global section.
+  if (auto Cnt = readSize(Mod->getGlobalSection())) {
+    Mod->getGlobalSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Seg : Mod->getGlobalSection().getContent()) {
+    auto VType = R.read<ValType>();
+    auto VMut = R.read<ValMut>();
+    if (unlikely(!VType || !VMut)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Seg.getGlobalType().setValType(*VType);
+    Seg.getGlobalType().setValMut(*VMut);
+    FLAT_TRY(R.readExpr(Seg.getExpr()));
+  }
+
+  // Export section.
+  if (auto Cnt = readSize(Mod->getExportSection())) {
+    Mod->getExportSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Desc : Mod->getExportSection().getContent()) {
+    auto ExtName = R.readName();
+    auto ExtType = R.read<ExternalType>();
+    auto ExtIdx = R.read<uint32_t>();
+    if (unlikely(!ExtName || !ExtType || !ExtIdx)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    setName(
+        *ExtName, [&Desc](auto N) { Desc.setExternalName(N); },
+        [&Desc](auto N) { Desc.setExternalNameView(N); });
+    Desc.setExternalType(*ExtType);
+    Desc.setExternalIndex(*ExtIdx);
+  }
+
+  // Start section.
+  {
+    auto Size = R.read<uint32_t>();
+    auto Has = R.read<uint8_t>();
+    auto Idx = R.read<uint32_t>();
+    if (unlikely(!Size || !Has || !Idx)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Mod->getStartSection().setContentSize(*Size);
+    if (*Has) {
+      Mod->getStartSection().setContent(*Idx);
+    }
+  }
+
+  // Element section.
+  if (auto Cnt = readSize(Mod->getElementSection())) {
+    Mod->getElementSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Seg : Mod->getElementSection().getContent()) {
+    auto Mode = R.read<AST::ElementSegment::ElemMode>();
+    auto RType = R.read<RefType>();
+    auto Idx = R.read<uint32_t>();
+    if (unlikely(!Mode || !RType || !Idx)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Seg.setMode(*Mode);
+    Seg.setRefType(*RType);
+    Seg.setIdx(*Idx);
+    FLAT_TRY(R.readExpr(Seg.getExpr()));
+    if (auto Cnt = R.read<uint32_t>()) {
+      Seg.getInitExprs().resize(*Cnt);
+    } else {
+      return Unexpect(Cnt);
+    }
+    for (auto &Expr : Seg.getInitExprs()) {
+      FLAT_TRY(R.readExpr(Expr));
+    }
+  }
+
+  // Code section.
+  if (auto Cnt = readSize(Mod->getCodeSection())) {
+    Mod->getCodeSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Seg : Mod->getCodeSection().getContent()) {
+    auto SegSize = R.read<uint32_t>();
+    auto LocalCnt = R.read<uint32_t>();
+    if (unlikely(!SegSize || !LocalCnt)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Seg.setSegSize(*SegSize);
+    for (uint32_t I = 0; I < *LocalCnt; ++I) {
+      auto Cnt = R.read<uint32_t>();
+      auto VType = R.read<ValType>();
+      if (unlikely(!Cnt || !VType)) {
+        return Unexpect(ErrCode::UnexpectedEnd);
+      }
+      Seg.getLocals().emplace_back(*Cnt, *VType);
+    }
+    FLAT_TRY(R.readExpr(Seg.getExpr()));
+  }
+
+  // Data section.
+  if (auto Cnt = readSize(Mod->getDataSection())) {
+    Mod->getDataSection().getContent().resize(*Cnt);
+  } else {
+    return Unexpect(Cnt);
+  }
+  for (auto &Seg : Mod->getDataSection().getContent()) {
+    auto Mode = R.read<AST::DataSegment::DataMode>();
+    auto Idx = R.read<uint32_t>();
+    if (unlikely(!Mode || !Idx)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Seg.setMode(*Mode);
+    Seg.setIdx(*Idx);
+    FLAT_TRY(R.readExpr(Seg.getExpr()));
+    if (auto Res = R.readArray<Byte>(); unlikely(!Res)) {
+      return Unexpect(Res);
+    } else if (IsBorrow) {
+      Seg.setData(*Res, Map);
+    } else {
+      Seg.setData(std::vector<Byte>(Res->begin(), Res->end()));
+    }
+  }
+
+  // Data count section.
+  {
+    auto Size = R.read<uint32_t>();
+    auto Has = R.read<uint8_t>();
+    auto Cnt = R.read<uint32_t>();
+    if (unlikely(!Size || !Has || !Cnt)) {
+      return Unexpect(ErrCode::UnexpectedEnd);
+    }
+    Mod->getDataCountSection().setContentSize(*Size);
+    if (*Has) {
+      Mod->getDataCountSection().setContent(*Cnt);
+    }
+  }
+
+  if (unlikely(!R.isEnd())) {
+    return Unexpect(ErrCode::MalformedSection);
+  }
+  return Mod;
+}
+
+// Get the flat image cache path. See "include/loader/loader.h".
+std::filesystem::path Loader::getFlatImageCachePath(Span<const Byte> Code) {
+  if (!Conf.getLoaderConfigure().isFlatImageCache() ||
+      Conf.getLoaderConfigure().isLazyFunctionBody()) {
+    return {};
+  }
+  // The flat images are stored in the AOT cache directory of the user.
+  if (auto Res = AOT::Cache::getPath(Code, AOT::Cache::StorageScope::Local,
+                                     "flat"sv);
+      Res && Res->is_absolute()) {
+    return std::move(*Res);
+  }
+  return {};
+}
+
+} // namespace Loader
+} // namespace WasmEdge
@@ -4,6 +4,7 @@
 #include "loader/loader.h"
 
 #include "aot/version.h"
+#include "common/hash.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -112,7 +113,7 @@ Loader::parseModule(const std::filesystem::path &FilePath) {
     return Mod;
   }
   default:
-    if (auto Res = loadModule()) {
+    if (auto Res = loadModuleCached()) {
       if (auto &Symbol = (*Res)->getSymbol()) {
         *Symbol = IntrinsicsTable;
       }
@@ -128,7 +129,13 @@ Loader::parseModule(const std::filesystem::path &FilePath) {
 Expect<std::unique_ptr<AST::Module>>
 Loader::parseModule(Span<const uint8_t> Code) {
   std::lock_guard Lock(Mutex);
-  if (auto Res = FMgr.setCode(Code); !Res) {
+  if (Conf.getLoaderConfigure().isLazyFunctionBody()) {
+    // The lazy function bodies are decoded after loading, so own the data.
+    if (auto Res = FMgr.setCode(std::vector<Byte>(Code.begin(), Code.end()));
+        !Res) {
+      return Unexpect(Res);
+    }
+  } else if (auto Res = FMgr.setCode(Code); !Res) {
     return Unexpect(Res);
   }
   // Filter out the Windows .dll, MacOS .dylib, or Linux .so AOT compiled WASM.
@@ -147,7 +154,63 @@ Loader::parseModule(Span<const uint8_t> Code) {
     break;
   }
   // For other header checking, handle in the module loading.
-  return loadModule();
+  return loadModuleCached();
+}
+
+// Get content of custom section. See "include/loader/loader.h".
+Expect<Span<const Byte>>
+Loader::getCustomSectionContent(const AST::CustomSection &Sec,
+                                Span<const uint8_t> Code) {
+  if (Sec.isContentLoaded()) {
+    return Sec.getContent();
+  }
+  const uint64_t Offset = Sec.getContentOffset();
+  const uint64_t Length = Sec.getContentLength();
+  if (unlikely(Offset > Code.size() || Length > Code.size() - Offset)) {
+    spdlog::error(ErrCode::UnexpectedEnd);
+    spdlog::error(ErrInfo::InfoLoading(Code.size()));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Custom));
+    return Unexpect(ErrCode::UnexpectedEnd);
+  }
+  // Reject the binary other than the one the section was parsed from.
+  const auto Content = Code.subspan(Offset, Length);
+  if (unlikely(hashBytes(Content) != Sec.getContentHash())) {
+    spdlog::error(ErrCode::MalformedSection);
+    spdlog::error("    Mismatched module binary of the custom section {}.",
+                  Sec.getName());
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Custom));
+    return Unexpect(ErrCode::MalformedSection);
+  }
+  return Content;
+}
+
+// Load module with the flat image cache. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>> Loader::loadModuleCached() {
+  // Hash the binary to key the profile counters only if profiling.
+  uint64_t Hash = 0;
+  if (Conf.getStatisticsConfigure().getProfile() ||
+      Conf.getCompilerConfigure().getProfile()) {
+    Hash = Profile::hashModule(FMgr.getData());
+  }
+  const auto FlatPath = getFlatImageCachePath(FMgr.getData());
+  if (!FlatPath.empty()) {
+    // Fall back to loading the binary if the image is missing or stale.
+    if (auto Res = loadFlatImage(FlatPath)) {
+      FMgr.reset();
+      (*Res)->setHash(Hash);
+      return Res;
+    }
+  }
+  if (auto Res = loadModule()) {
+    // The image is saved after the module is validated.
+    if (!(*Res)->getSymbol()) {
+      (*Res)->setFlatImagePath(FlatPath);
+    }
+    (*Res)->setHash(Hash);
+    return Res;
+  } else {
+    return Unexpect(Res);
+  }
 }
 
 // Helper function of checking the valid value types.
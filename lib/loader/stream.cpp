@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "loader/loader.h"
+
+#include <utility>
+
+namespace WasmEdge {
+namespace Loader {
+
+// Push a chunk of module binary. See "include/loader/loader.h".
+Expect<void> Loader::Stream::push(Span<const Byte> Chunk) {
+  std::lock_guard Lock(Ldr.Mutex);
+  if (unlikely(Status != ErrCode::Success)) {
+    return Unexpect(Status);
+  }
+  Buf.insert(Buf.end(), Chunk.begin(), Chunk.end());
+
+  // Load the magic and version when the first 8 bytes arrived.
+  if (!Mod) {
+    if (Buf.size() < 8) {
+      return {};
+    }
+    Mod = std::make_unique<AST::Module>();
+    // The buffer is reallocated by the further pushing, so set it as borrowed
+    // data. The names are copied and the function bodies are decoded eagerly
+    // without a data owner.
+    Ldr.FMgr.setCode(Span<const Byte>(Buf));
+    if (auto Res = Ldr.loadModuleHeader(*Mod); !Res) {
+      Status = Res.error();
+      return Unexpect(Res);
+    }
+    Ldr.HasDataSection = false;
+    Decoded = Ldr.FMgr.getOffset();
+  }
+
+  // Decode the sections which all bytes arrived.
+  while (true) {
+    FileMgr PeekMgr;
+    PeekMgr.setCode(Span<const Byte>(Buf).subspan(Decoded));
+    uint8_t Id = 0x00;
+    if (auto Res = PeekMgr.readByte()) {
+      Id = *Res;
+    } else {
+      return {};
+    }
+    if (auto Res = PeekMgr.readU32()) {
+      if (PeekMgr.getRemainSize() < *Res) {
+        return {};
+      }
+    } else if (Res.error() == ErrCode::UnexpectedEnd) {
+      return {};
+    }
+    // The malformed section size is reported by loading the section.
+    Ldr.FMgr.setCode(Span<const Byte>(Buf));
+    Ldr.FMgr.seek(Decoded);
+    [[maybe_unused]] auto SkipId = Ldr.FMgr.readByte();
+    if (auto Res = Ldr.loadModuleSection(*Mod, Id, Secs); !Res) {
+      Status = Res.error();
+      return Unexpect(Res);
+    }
+    Decoded = Ldr.FMgr.getOffset();
+  }
+}
+
+// Finish the module binary streaming. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>> Loader::Stream::finish() {
+  std::lock_guard Lock(Ldr.Mutex);
+  if (unlikely(Status != ErrCode::Success)) {
+    const auto Code = Status;
+    reset();
+    return Unexpect(Code);
+  }
+
+  // Decode the remaining bytes, which reports the truncated binary.
+  Ldr.FMgr.setCode(Span<const Byte>(Buf));
+  Ldr.FMgr.seek(Decoded);
+  if (!Mod) {
+    Mod = std::make_unique<AST::Module>();
+    if (auto Res = Ldr.loadModuleHeader(*Mod); !Res) {
+      reset();
+      return Unexpect(Res);
+    }
+    Ldr.HasDataSection = false;
+  }
+  if (auto Res = Ldr.loadModuleSections(*Mod, Secs); !Res) {
+    reset();
+    return Unexpect(Res);
+  }
+  if (auto Res = Ldr.checkModule(*Mod); !Res) {
+    reset();
+    return Unexpect(Res);
+  }
+  if (auto &Symbol = Mod->getSymbol()) {
+    *Symbol = Ldr.IntrinsicsTable;
+  }
+  auto Res = std::move(Mod);
+  reset();
+  return Res;
+}
+
+// Reset the stream status. See "include/loader/loader.h".
+void Loader::Stream::reset() noexcept {
+  Ldr.FMgr.reset();
+  Buf.clear();
+  Decoded = 0;
+  Mod.reset();
+  Secs.reset();
+  Status = ErrCode::Success;
+}
+
+} // namespace Loader
+} // namespace WasmEdge
@@ -7,6 +7,8 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 
+#include <algorithm>
+
 #if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||       \
     defined(__arm__)
 #include <sys/mman.h>
@@ -98,8 +100,8 @@ uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
 #endif
 }
 
-uint8_t *Allocator::resize(uint8_t *Pointer, uint32_t OldPageCount,
-                           uint32_t NewPageCount) noexcept {
+uint8_t *Allocator::resize(uint8_t *Pointer, uint64_t OldPageCount,
+                           uint64_t NewPageCount) noexcept {
   assuming(NewPageCount > OldPageCount);
 #if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__)
   if (mmap(Pointer + OldPageCount * kPageSize,
@@ -141,6 +143,64 @@ void Allocator::release(uint8_t *Pointer, uint32_t) noexcept {
 #endif
 }
 
+uint8_t *Allocator::allocate64(uint64_t PageCount,
+                               uint64_t ReservedPageCount
+                               [[maybe_unused]]) noexcept {
+#if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__)
+  auto Reserved = reinterpret_cast<uint8_t *>(
+      mmap(nullptr, std::max(ReservedPageCount, UINT64_C(1)) * kPageSize,
+           PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+  if (Reserved == MAP_FAILED) {
+    return nullptr;
+  }
+  if (PageCount == 0) {
+    return Reserved;
+  }
+  return resize(Reserved, 0, PageCount);
+#elif WASMEDGE_OS_WINDOWS
+  auto Reserved = reinterpret_cast<uint8_t *>(boost::winapi::VirtualAlloc(
+      nullptr, std::max(ReservedPageCount, UINT64_C(1)) * kPageSize,
+      boost::winapi::MEM_RESERVE_, boost::winapi::PAGE_NOACCESS_));
+  if (Reserved == nullptr) {
+    return nullptr;
+  }
+  if (PageCount == 0) {
+    return Reserved;
+  }
+  return resize(Reserved, 0, PageCount);
+#else
+  auto Result = reinterpret_cast<uint8_t *>(
+      std::calloc(std::max(PageCount, UINT64_C(1)), kPageSize));
+  if (Result == nullptr) {
+    return nullptr;
+  }
+  return Result;
+#endif
+}
+
+void Allocator::release64(uint8_t *Pointer,
+                          uint64_t ReservedPageCount
+                          [[maybe_unused]]) noexcept {
+#if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__)
+  if (Pointer == nullptr) {
+    return;
+  }
+  munmap(Pointer, std::max(ReservedPageCount, UINT64_C(1)) * kPageSize);
+#elif WASMEDGE_OS_WINDOWS
+  boost::winapi::VirtualFree(Pointer, 0, boost::winapi::MEM_RELEASE_);
+#else
+  return std::free(Pointer);
+#endif
+}
+
+bool Allocator::isPageMapped() noexcept {
+#if defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
 uint8_t *Allocator::allocate_chunk(uint64_t Size) noexcept {
 #if defined(HAVE_MMAP)
   if (auto Pointer = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
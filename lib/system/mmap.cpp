@@ -12,6 +12,7 @@
 
 #ifdef HAVE_MMAP
 #include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -37,6 +38,13 @@ struct Implement {
     if (File < 0) {
       return;
     }
+    // Truncating the file raises SIGBUS on accessing the mapped pages, so
+    // writers are kept out by a shared lock while mapped. The file locked
+    // exclusively is being written, and is not mapped. The lock is advisory,
+    // and does not stop the writers not taking it.
+    if (flock(File, LOCK_SH | LOCK_NB) != 0) {
+      return;
+    }
 
     {
       struct stat Stat;
@@ -48,6 +56,14 @@ struct Implement {
 
     Address = mmap(nullptr, Size, PROT_READ, MAP_SHARED, File, 0);
   }
+  bool mapPrivate(void *Target, uint64_t Offset, uint64_t Length) noexcept {
+    if (Offset > Size || Length > Size - Offset) {
+      return false;
+    }
+    return mmap(Target, Length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED, File, static_cast<off_t>(Offset)) !=
+           MAP_FAILED;
+  }
   ~Implement() noexcept {
     if (Address != MAP_FAILED) {
       munmap(Address, Size);
@@ -104,12 +120,14 @@ struct Implement {
     }
   }
   bool ok() const noexcept { return Address != nullptr; }
+  bool mapPrivate(void *, uint64_t, uint64_t) noexcept { return false; }
 };
 #else
 static inline bool kSupported = false;
 struct Implement {
   Implement(const std::filesystem::path &Path) noexcept = default;
   bool ok() const noexcept { return false; }
+  bool mapPrivate(void *, uint64_t, uint64_t) noexcept { return false; }
 }
 #endif
 } // namespace
@@ -141,4 +159,22 @@ void *MMap::address() const noexcept {
 
 bool MMap::supported() noexcept { return kSupported; }
 
+uint64_t MMap::pageSize() noexcept {
+#ifdef HAVE_MMAP
+  static const uint64_t Size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  return Size;
+#else
+  return UINT64_C(4096);
+#endif
+}
+
+bool MMap::mapPrivate(void *Target, uint64_t Offset,
+                      uint64_t Size) const noexcept {
+  if (!Handle) {
+    return false;
+  }
+  return reinterpret_cast<Implement *>(Handle)->mapPrivate(Target, Offset,
+                                                           Size);
+}
+
 } // namespace WasmEdge
@@ -9,22 +9,29 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <tuple>
 
 namespace WasmEdge {
 namespace Validator {
 
-namespace {
-
 // Helper function for printing error log of index out of range.
-auto logOutOfRange(ErrCode Code, ErrInfo::IndexCategory Cate, uint32_t Idx,
-                   uint32_t Bound) {
-  spdlog::error(Code);
-  spdlog::error(ErrInfo::InfoForbidIndex(Cate, Idx, Bound));
+Unexpected<ErrCode> FormChecker::logOutOfRange(ErrCode Code,
+                                               ErrInfo::IndexCategory Cate,
+                                               uint32_t Idx,
+                                               uint32_t Bound) const {
+  logError(Code);
+  logError(ErrInfo::InfoForbidIndex(Cate, Idx, Bound));
   return Unexpect(Code);
 }
 
-} // namespace
+FormChecker::ModuleContext &FormChecker::getMutableContext() {
+  // The shared context is read-only by the other checkers.
+  if (Ctx.use_count() > 1) {
+    Ctx = std::make_shared<ModuleContext>(*Ctx);
+  }
+  return *Ctx;
+}
 
 void FormChecker::reset(bool CleanGlobal) {
   ValStack.clear();
@@ -33,16 +40,7 @@ void FormChecker::reset(bool CleanGlobal) {
   Returns.clear();
 
   if (CleanGlobal) {
-    Types.clear();
-    Funcs.clear();
-    Tables.clear();
-    Mems = 0;
-    Globals.clear();
-    Datas.clear();
-    Elems.clear();
-    Refs.clear();
-    NumImportFuncs = 0;
-    NumImportGlobals = 0;
+    Ctx = std::make_shared<ModuleContext>();
   }
 }
 
@@ -62,6 +60,88 @@ Expect<void> FormChecker::validate(AST::InstrView Instrs,
   return checkExpr(Instrs);
 }
 
+void FormChecker::addModuleContext(const AST::Module &Mod) {
+  // Register the contexts in the same order as the validator.
+  auto addConstExprRefs = [this](AST::InstrView Instrs) {
+    for (const auto &Instr : Instrs) {
+      if (Instr.getOpCode() == OpCode::Ref__func) {
+        addRef(Instr.getTargetIndex());
+      }
+    }
+  };
+  for (const auto &Type : Mod.getTypeSection().getContent()) {
+    addType(Type);
+  }
+  for (const auto &Desc : Mod.getImportSection().getContent()) {
+    switch (Desc.getExternalType()) {
+    case ExternalType::Function:
+      if (Desc.getExternalFuncTypeIdx() < Ctx->Types.size()) {
+        addRef(static_cast<uint32_t>(Ctx->Funcs.size()));
+      }
+      addFunc(Desc.getExternalFuncTypeIdx(), true);
+      break;
+    case ExternalType::Table:
+      addTable(Desc.getExternalTableType());
+      break;
+    case ExternalType::Memory:
+      addMemory(Desc.getExternalMemoryType());
+      break;
+    case ExternalType::Global:
+      addGlobal(Desc.getExternalGlobalType(), true);
+      break;
+    default:
+      break;
+    }
+  }
+  for (const auto TypeIdx : Mod.getFunctionSection().getContent()) {
+    addFunc(TypeIdx);
+  }
+  for (const auto &Tab : Mod.getTableSection().getContent()) {
+    addTable(Tab);
+  }
+  for (const auto &Mem : Mod.getMemorySection().getContent()) {
+    addMemory(Mem);
+  }
+  for (const auto &GlobSeg : Mod.getGlobalSection().getContent()) {
+    addConstExprRefs(GlobSeg.getExpr().getInstrs());
+    addGlobal(GlobSeg.getGlobalType());
+  }
+  for (const auto &Desc : Mod.getExportSection().getContent()) {
+    if (Desc.getExternalType() == ExternalType::Function) {
+      addRef(Desc.getExternalIndex());
+    }
+  }
+  for (const auto &ElemSeg : Mod.getElementSection().getContent()) {
+    for (const auto &Expr : ElemSeg.getInitExprs()) {
+      addConstExprRefs(Expr.getInstrs());
+    }
+    addElem(ElemSeg);
+  }
+  if (const auto &Cnt = Mod.getDataCountSection().getContent()) {
+    auto &MCtx = getMutableContext();
+    for (uint32_t I = 0; I < *Cnt; ++I) {
+      MCtx.Datas.emplace_back(I);
+    }
+  }
+}
+
+void FormChecker::startFunction(
+    uint32_t TypeIdx, Span<const std::pair<uint32_t, ValType>> Locals) {
+  reset();
+  const auto &Type = Ctx->Types[TypeIdx];
+  for (auto Val : Type.first) {
+    addLocal(Val);
+  }
+  for (auto Val : Locals) {
+    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
+      addLocal(Val.second);
+    }
+  }
+  Returns.assign(Type.second.begin(), Type.second.end());
+  // Push ctrl frame ([] -> [Returns])
+  pushCtrl({}, Returns);
+}
+
 void FormChecker::addType(const AST::FunctionType &Func) {
   std::vector<VType> Param, Ret;
   Param.reserve(Func.getParamTypes().size());
@@ -72,41 +152,49 @@ void FormChecker::addType(const AST::FunctionType &Func) {
   for (auto Val : Func.getReturnTypes()) {
     Ret.push_back(ASTToVType(Val));
   }
-  Types.emplace_back(std::move(Param), std::move(Ret));
+  getMutableContext().Types.emplace_back(std::move(Param), std::move(Ret));
 }
 
 void FormChecker::addFunc(const uint32_t TypeIdx, const bool IsImport) {
-  if (Types.size() > TypeIdx) {
-    Funcs.emplace_back(TypeIdx);
+  auto &MCtx = getMutableContext();
+  if (MCtx.Types.size() > TypeIdx) {
+    MCtx.Funcs.emplace_back(TypeIdx);
   }
   if (IsImport) {
-    NumImportFuncs++;
+    MCtx.NumImportFuncs++;
   }
 }
 
 void FormChecker::addTable(const AST::TableType &Tab) {
-  Tables.push_back(Tab.getRefType());
+  getMutableContext().Tables.push_back(Tab.getRefType());
 }
 
-void FormChecker::addMemory(const AST::MemoryType &) { Mems++; }
+void FormChecker::addMemory(const AST::MemoryType &Mem) {
+  getMutableContext().Mems.push_back(Mem.getLimit().is64() ? VType::I64
+                                                          : VType::I32);
+}
 
 void FormChecker::addGlobal(const AST::GlobalType &Glob, const bool IsImport) {
   // Type in global is comfirmed in loading phase.
-  Globals.emplace_back(ASTToVType(Glob.getValType()), Glob.getValMut());
+  auto &MCtx = getMutableContext();
+  MCtx.Globals.emplace_back(ASTToVType(Glob.getValType()), Glob.getValMut());
   if (IsImport) {
-    NumImportGlobals++;
+    MCtx.NumImportGlobals++;
   }
 }
 
 void FormChecker::addData(const AST::DataSegment &) {
-  Datas.emplace_back(Datas.size());
+  auto &MCtx = getMutableContext();
+  MCtx.Datas.emplace_back(MCtx.Datas.size());
 }
 
 void FormChecker::addElem(const AST::ElementSegment &Elem) {
-  Elems.emplace_back(Elem.getRefType());
+  getMutableContext().Elems.emplace_back(Elem.getRefType());
 }
 
-void FormChecker::addRef(const uint32_t FuncIdx) { Refs.emplace(FuncIdx); }
+void FormChecker::addRef(const uint32_t FuncIdx) {
+  getMutableContext().Refs.emplace(FuncIdx);
+}
 
 void FormChecker::addLocal(const ValType &V) {
   Locals.push_back(ASTToVType(V));
@@ -219,12 +307,13 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     } else {
       // Type index case. t2* = type[index].returns
       const uint32_t TypeIdx = BType.Data.Idx;
-      if (TypeIdx >= Types.size()) {
+      if (TypeIdx >= Ctx->Types.size()) {
         return logOutOfRange(ErrCode::InvalidFuncTypeIdx,
                              ErrInfo::IndexCategory::FunctionType, TypeIdx,
-                             static_cast<uint32_t>(Types.size()));
+                             static_cast<uint32_t>(Ctx->Types.size()));
       }
-      return ReturnType{Types[TypeIdx].first, Types[TypeIdx].second};
+      const auto &Type = Ctx->Types[TypeIdx];
+      return ReturnType{Type.first, Type.second};
     }
   };
 
@@ -241,16 +330,14 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return static_cast<uint32_t>(CtrlStack.size()) - UINT32_C(1) - N;
   };
 
-  // Helper lambda for checking memory index and perform transformation.
-  auto checkMemAndTrans = [this,
-                           &Instr](Span<const VType> Take,
-                                   Span<const VType> Put) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
+  // Helper lambda for checking memory index.
+  auto checkMemIdx = [this](uint32_t Idx) -> Expect<void> {
+    if (Idx >= Ctx->Mems.size()) {
       return logOutOfRange(ErrCode::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+                           ErrInfo::IndexCategory::Memory, Idx,
+                           static_cast<uint32_t>(Ctx->Mems.size()));
     }
-    return StackTrans(Take, Put);
+    return {};
   };
 
   // Helper lambda for checking lane index and perform transformation.
@@ -265,28 +352,69 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return StackTrans(Take, Put);
   };
 
+  // Helper lambda for checking memory index and offset, and replacing the
+  // address operand by the index type of the target memory.
+  auto checkMemArg = [this, checkMemIdx, &Instr](
+                         Span<const VType> Take,
+                         std::array<VType, 3> &Buf) -> Expect<Span<VType>> {
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
+    }
+    const VType IdxType = Ctx->Mems[Instr.getTargetIndex()];
+    if (IdxType == VType::I32 &&
+        Instr.getMemoryOffset() > std::numeric_limits<uint32_t>::max()) {
+      logError(ErrCode::InvalidMemOffset);
+      logError(ErrInfo::InfoBoundary(Instr.getMemoryOffset()));
+      return Unexpect(ErrCode::InvalidMemOffset);
+    }
+    std::copy(Take.begin(), Take.end(), Buf.begin());
+    Buf[0] = IdxType;
+    return Span<VType>(Buf.data(), Take.size());
+  };
+
   // Helper lambda for checking memory alignment and perform transformation.
-  auto checkAlignAndTrans = [this, checkLaneAndTrans,
+  auto checkAlignAndTrans = [this, checkLaneAndTrans, checkMemArg,
                              &Instr](uint32_t N, Span<const VType> Take,
                                      Span<const VType> Put,
                                      bool CheckLane = false) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
-      return logOutOfRange(ErrCode::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+    std::array<VType, 3> Buf;
+    auto TakeT = checkMemArg(Take, Buf);
+    if (!TakeT) {
+      return Unexpect(TakeT);
     }
     if (Instr.getMemoryAlign() > 31 ||
         (1UL << Instr.getMemoryAlign()) > (N >> 3UL)) {
       // 2 ^ align needs to <= N / 8
-      spdlog::error(ErrCode::InvalidAlignment);
-      spdlog::error(ErrInfo::InfoMismatch(static_cast<uint8_t>(N >> 3),
-                                          Instr.getMemoryAlign()));
+      logError(ErrCode::InvalidAlignment);
+      logError(ErrInfo::InfoMismatch(static_cast<uint8_t>(N >> 3),
+                                     Instr.getMemoryAlign()));
       return Unexpect(ErrCode::InvalidAlignment);
     }
     if (CheckLane) {
-      return checkLaneAndTrans(128 / N, Take, Put);
+      return checkLaneAndTrans(128 / N, *TakeT, Put);
     }
-    return StackTrans(Take, Put);
+    return StackTrans(*TakeT, Put);
+  };
+
+  // Helper lambda for checking atomic memory alignment and perform
+  // transformation.
+  auto checkAtomicAlignAndTrans = [this, checkMemArg, &Instr](
+                                      uint32_t N, Span<const VType> Take,
+                                      Span<const VType> Put) -> Expect<void> {
+    std::array<VType, 3> Buf;
+    auto TakeT = checkMemArg(Take, Buf);
+    if (!TakeT) {
+      return Unexpect(TakeT);
+    }
+    if (Instr.getMemoryAlign() > 31 ||
+        (1UL << Instr.getMemoryAlign()) != (N >> 3UL)) {
+      // 2 ^ align needs to == N / 8
+      logError(ErrCode::InvalidAlignment);
+      logError(ErrInfo::InfoMismatch(static_cast<uint8_t>(N >> 3),
+                                     Instr.getMemoryAlign()));
+      return Unexpect(ErrCode::InvalidAlignment);
+    }
+    return StackTrans(*TakeT, Put);
   };
 
   // Helper lambda for checking vtypes matching.
@@ -303,8 +431,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       for (auto &I : Got) {
         GotV.push_back(VTypeToAST(I));
       }
-      spdlog::error(ErrCode::TypeCheckFailed);
-      spdlog::error(ErrInfo::InfoMismatch(ExpV, GotV));
+      logError(ErrCode::TypeCheckFailed);
+      logError(ErrInfo::InfoMismatch(ExpV, GotV));
       return Unexpect(ErrCode::TypeCheckFailed);
     }
     return {};
@@ -339,13 +467,6 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     }
     // Push ctrl frame ([t1*], [t2*])
     pushCtrl(T1, T2, Instr.getOpCode());
-    if (Instr.getOpCode() == OpCode::If &&
-        Instr.getJumpElse() == Instr.getJumpEnd()) {
-      // No else case in if-else statement.
-      if (auto Res = checkTypesMatching(T2, T1); !Res) {
-        return Unexpect(Res);
-      }
-    }
     return {};
   }
 
@@ -358,6 +479,15 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return {};
   case OpCode::End:
     if (auto Res = popCtrl()) {
+      // No else case in if-else statement. Check at the end because the else
+      // instruction is unknown when checking while decoding.
+      if ((*Res).Code == OpCode::If) {
+        if (auto ResMatch = checkTypesMatching((*Res).EndTypes,
+                                               (*Res).StartTypes);
+            !ResMatch) {
+          return Unexpect(ResMatch);
+        }
+      }
       pushTypes((*Res).EndTypes);
     } else {
       return Unexpect(Res);
@@ -444,36 +574,37 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
 
   case OpCode::Call: {
     auto N = Instr.getTargetIndex();
-    if (N >= Funcs.size()) {
+    if (N >= Ctx->Funcs.size()) {
       return logOutOfRange(ErrCode::InvalidFuncIdx,
                            ErrInfo::IndexCategory::Function, N,
-                           static_cast<uint32_t>(Funcs.size()));
+                           static_cast<uint32_t>(Ctx->Funcs.size()));
     }
-    return StackTrans(Types[Funcs[N]].first, Types[Funcs[N]].second);
+    const auto &Type = Ctx->Types[Ctx->Funcs[N]];
+    return StackTrans(Type.first, Type.second);
   }
   case OpCode::Call_indirect: {
     auto N = Instr.getTargetIndex();
     auto T = Instr.getSourceIndex();
     // Check source table index.
-    if (T >= Tables.size()) {
+    if (T >= Ctx->Tables.size()) {
       return logOutOfRange(ErrCode::InvalidTableIdx,
                            ErrInfo::IndexCategory::Table, T,
-                           static_cast<uint32_t>(Tables.size()));
+                           static_cast<uint32_t>(Ctx->Tables.size()));
     }
-    if (Tables[T] != RefType::FuncRef) {
-      spdlog::error(ErrCode::InvalidTableIdx);
+    if (Ctx->Tables[T] != RefType::FuncRef) {
+      logError(ErrCode::InvalidTableIdx);
       return Unexpect(ErrCode::InvalidTableIdx);
     }
     // Check target function type index.
-    if (N >= Types.size()) {
+    if (N >= Ctx->Types.size()) {
       return logOutOfRange(ErrCode::InvalidFuncTypeIdx,
                            ErrInfo::IndexCategory::FunctionType, N,
-                           static_cast<uint32_t>(Types.size()));
+                           static_cast<uint32_t>(Ctx->Types.size()));
     }
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
-    return StackTrans(Types[N].first, Types[N].second);
+    return StackTrans(Ctx->Types[N].first, Ctx->Types[N].second);
   }
 
   // Reference Instructions.
@@ -482,9 +613,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Ref__is_null:
     if (auto Res = popType()) {
       if (!isRefType(*Res)) {
-        spdlog::error(ErrCode::TypeCheckFailed);
-        spdlog::error(
-            ErrInfo::InfoMismatch(ValType::FuncRef, VTypeToAST(*Res)));
+        logError(ErrCode::TypeCheckFailed);
+        logError(ErrInfo::InfoMismatch(ValType::FuncRef, VTypeToAST(*Res)));
         return Unexpect(ErrCode::TypeCheckFailed);
       }
     } else {
@@ -492,9 +622,9 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     }
     return StackTrans({}, std::array{VType::I32});
   case OpCode::Ref__func:
-    if (Refs.find(Instr.getTargetIndex()) == Refs.cend()) {
+    if (Ctx->Refs.find(Instr.getTargetIndex()) == Ctx->Refs.cend()) {
       // Undeclared function reference.
-      spdlog::error(ErrCode::InvalidRefIdx);
+      logError(ErrCode::InvalidRefIdx);
       return Unexpect(ErrCode::InvalidRefIdx);
     }
     return StackTrans({}, std::array{VType::FuncRef});
@@ -521,19 +651,19 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     }
     // T1 and T2 should be number type.
     if (!isNumType(T1)) {
-      spdlog::error(ErrCode::TypeCheckFailed);
-      spdlog::error(ErrInfo::InfoMismatch(ValType::I32, VTypeToAST(T1)));
+      logError(ErrCode::TypeCheckFailed);
+      logError(ErrInfo::InfoMismatch(ValType::I32, VTypeToAST(T1)));
       return Unexpect(ErrCode::TypeCheckFailed);
     }
     if (!isNumType(T2)) {
-      spdlog::error(ErrCode::TypeCheckFailed);
-      spdlog::error(ErrInfo::InfoMismatch(VTypeToAST(T1), VTypeToAST(T2)));
+      logError(ErrCode::TypeCheckFailed);
+      logError(ErrInfo::InfoMismatch(VTypeToAST(T1), VTypeToAST(T2)));
       return Unexpect(ErrCode::TypeCheckFailed);
     }
     // Error if t1 != t2 && t1 =/= Unknown && t2 =/= Unknown
     if (T1 != T2 && T1 != VType::Unknown && T2 != VType::Unknown) {
-      spdlog::error(ErrCode::TypeCheckFailed);
-      spdlog::error(ErrInfo::InfoMismatch(VTypeToAST(T1), VTypeToAST(T2)));
+      logError(ErrCode::TypeCheckFailed);
+      logError(ErrInfo::InfoMismatch(VTypeToAST(T1), VTypeToAST(T2)));
       return Unexpect(ErrCode::TypeCheckFailed);
     }
     // Push value.
@@ -547,7 +677,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Select_t: {
     // Note: There may be multiple values choise in the future.
     if (Instr.getValTypeList().size() != 1) {
-      spdlog::error(ErrCode::InvalidResultArity);
+      logError(ErrCode::InvalidResultArity);
       return Unexpect(ErrCode::InvalidResultArity);
     }
     VType ExpT = ASTToVType(Instr.getValTypeList()[0]);
@@ -578,20 +708,20 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   }
   case OpCode::Global__set:
     // Global case, check mutation.
-    if (Instr.getTargetIndex() < Globals.size() &&
-        Globals[Instr.getTargetIndex()].second != ValMut::Var) {
+    if (Instr.getTargetIndex() < Ctx->Globals.size() &&
+        Ctx->Globals[Instr.getTargetIndex()].second != ValMut::Var) {
       // Global is immutable
-      spdlog::error(ErrCode::ImmutableGlobal);
+      logError(ErrCode::ImmutableGlobal);
       return Unexpect(ErrCode::ImmutableGlobal);
     }
     [[fallthrough]];
   case OpCode::Global__get: {
-    if (Instr.getTargetIndex() >= Globals.size()) {
+    if (Instr.getTargetIndex() >= Ctx->Globals.size()) {
       return logOutOfRange(
           ErrCode::InvalidGlobalIdx, ErrInfo::IndexCategory::Global,
-          Instr.getTargetIndex(), static_cast<uint32_t>(Globals.size()));
+          Instr.getTargetIndex(), static_cast<uint32_t>(Ctx->Globals.size()));
     }
-    VType ExpT = Globals[Instr.getTargetIndex()].first;
+    VType ExpT = Ctx->Globals[Instr.getTargetIndex()].first;
     if (Instr.getOpCode() == OpCode::Global__set) {
       return StackTrans(std::array{ExpT}, {});
     } else {
@@ -608,12 +738,12 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Table__init:
   case OpCode::Table__copy: {
     // Check target table index to perform.
-    if (Instr.getTargetIndex() >= Tables.size()) {
+    if (Instr.getTargetIndex() >= Ctx->Tables.size()) {
       return logOutOfRange(
           ErrCode::InvalidTableIdx, ErrInfo::IndexCategory::Table,
-          Instr.getTargetIndex(), static_cast<uint32_t>(Tables.size()));
+          Instr.getTargetIndex(), static_cast<uint32_t>(Ctx->Tables.size()));
     }
-    VType ExpT = ASTToVType(Tables[Instr.getTargetIndex()]);
+    VType ExpT = ASTToVType(Ctx->Tables[Instr.getTargetIndex()]);
     if (Instr.getOpCode() == OpCode::Table__get) {
       return StackTrans(std::array{VType::I32}, std::array{ExpT});
     } else if (Instr.getOpCode() == OpCode::Table__set) {
@@ -626,33 +756,33 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       return StackTrans(std::array{VType::I32, ExpT, VType::I32}, {});
     } else if (Instr.getOpCode() == OpCode::Table__init) {
       // Check source element index for initialization.
-      if (Instr.getSourceIndex() >= Elems.size()) {
+      if (Instr.getSourceIndex() >= Ctx->Elems.size()) {
         return logOutOfRange(
             ErrCode::InvalidElemIdx, ErrInfo::IndexCategory::Element,
-            Instr.getSourceIndex(), static_cast<uint32_t>(Elems.size()));
+            Instr.getSourceIndex(), static_cast<uint32_t>(Ctx->Elems.size()));
       }
       // Check is the reference types matched.
-      if (Elems[Instr.getSourceIndex()] != Tables[Instr.getTargetIndex()]) {
-        spdlog::error(ErrCode::TypeCheckFailed);
-        spdlog::error(
-            ErrInfo::InfoMismatch(ToValType(Tables[Instr.getTargetIndex()]),
-                                  ToValType(Elems[Instr.getSourceIndex()])));
+      const auto DstType = Ctx->Tables[Instr.getTargetIndex()];
+      const auto SrcType = Ctx->Elems[Instr.getSourceIndex()];
+      if (SrcType != DstType) {
+        logError(ErrCode::TypeCheckFailed);
+        logError(ErrInfo::InfoMismatch(ToValType(DstType), ToValType(SrcType)));
         return Unexpect(ErrCode::TypeCheckFailed);
       }
       return StackTrans(std::array{VType::I32, VType::I32, VType::I32}, {});
     } else {
       // Check source table index for copying.
-      if (Instr.getSourceIndex() >= Tables.size()) {
+      if (Instr.getSourceIndex() >= Ctx->Tables.size()) {
         return logOutOfRange(
             ErrCode::InvalidTableIdx, ErrInfo::IndexCategory::Table,
-            Instr.getSourceIndex(), static_cast<uint32_t>(Tables.size()));
+            Instr.getSourceIndex(), static_cast<uint32_t>(Ctx->Tables.size()));
       }
       // Check is the reference types matched.
-      if (Tables[Instr.getSourceIndex()] != Tables[Instr.getTargetIndex()]) {
-        spdlog::error(ErrCode::TypeCheckFailed);
-        spdlog::error(
-            ErrInfo::InfoMismatch(ToValType(Tables[Instr.getTargetIndex()]),
-                                  ToValType(Tables[Instr.getSourceIndex()])));
+      const auto DstType = Ctx->Tables[Instr.getTargetIndex()];
+      const auto SrcType = Ctx->Tables[Instr.getSourceIndex()];
+      if (SrcType != DstType) {
+        logError(ErrCode::TypeCheckFailed);
+        logError(ErrInfo::InfoMismatch(ToValType(DstType), ToValType(SrcType)));
         return Unexpect(ErrCode::TypeCheckFailed);
       }
       return StackTrans(std::array{VType::I32, VType::I32, VType::I32}, {});
@@ -660,10 +790,10 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   }
   case OpCode::Elem__drop:
     // Check target element index to drop.
-    if (Instr.getTargetIndex() >= Elems.size()) {
+    if (Instr.getTargetIndex() >= Ctx->Elems.size()) {
       return logOutOfRange(
           ErrCode::InvalidElemIdx, ErrInfo::IndexCategory::Element,
-          Instr.getTargetIndex(), static_cast<uint32_t>(Elems.size()));
+          Instr.getTargetIndex(), static_cast<uint32_t>(Ctx->Elems.size()));
     }
     return {};
 
@@ -719,39 +849,60 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::I64__store32:
     return checkAlignAndTrans(32, std::array{VType::I32, VType::I64}, {});
   case OpCode::Memory__size:
-    return checkMemAndTrans({}, std::array{VType::I32});
-  case OpCode::Memory__grow:
-    return checkMemAndTrans(std::array{VType::I32}, std::array{VType::I32});
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
+    }
+    return StackTrans({}, std::array{Ctx->Mems[Instr.getTargetIndex()]});
+  case OpCode::Memory__grow: {
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
+    }
+    const VType IdxType = Ctx->Mems[Instr.getTargetIndex()];
+    return StackTrans(std::array{IdxType}, std::array{IdxType});
+  }
   case OpCode::Memory__init:
     // Check the target memory index. Memory index should be checked first.
-    if (Instr.getTargetIndex() >= Mems) {
-      return logOutOfRange(ErrCode::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
     }
     // Check the source data index.
-    if (Instr.getSourceIndex() >= Datas.size()) {
+    if (Instr.getSourceIndex() >= Ctx->Datas.size()) {
       return logOutOfRange(ErrCode::InvalidDataIdx,
                            ErrInfo::IndexCategory::Data, Instr.getSourceIndex(),
-                           static_cast<uint32_t>(Datas.size()));
+                           static_cast<uint32_t>(Ctx->Datas.size()));
     }
-    return StackTrans(std::array{VType::I32, VType::I32, VType::I32}, {});
-  case OpCode::Memory__copy:
+    return StackTrans(
+        std::array{Ctx->Mems[Instr.getTargetIndex()], VType::I32, VType::I32},
+        {});
+  case OpCode::Memory__copy: {
     /// Check the source memory index.
-    if (Instr.getSourceIndex() >= Mems) {
-      return logOutOfRange(ErrCode::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getSourceIndex(), Mems);
+    if (auto Res = checkMemIdx(Instr.getSourceIndex()); !Res) {
+      return Unexpect(Res);
     }
-    [[fallthrough]];
-  case OpCode::Memory__fill:
-    return checkMemAndTrans(std::array{VType::I32, VType::I32, VType::I32}, {});
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
+    }
+    // The length is 64-bit only when both memories are 64-bit indexed.
+    const VType DstType = Ctx->Mems[Instr.getTargetIndex()];
+    const VType SrcType = Ctx->Mems[Instr.getSourceIndex()];
+    const VType LenType =
+        (DstType == VType::I64 && SrcType == VType::I64) ? VType::I64
+                                                         : VType::I32;
+    return StackTrans(std::array{DstType, SrcType, LenType}, {});
+  }
+  case OpCode::Memory__fill: {
+    if (auto Res = checkMemIdx(Instr.getTargetIndex()); !Res) {
+      return Unexpect(Res);
+    }
+    const VType IdxType = Ctx->Mems[Instr.getTargetIndex()];
+    return StackTrans(std::array{IdxType, VType::I32, IdxType}, {});
+  }
   case OpCode::Data__drop:
     // Check the target data index.
-    if (Instr.getTargetIndex() >= Datas.size()) {
+    if (Instr.getTargetIndex() >= Ctx->Datas.size()) {
       return logOutOfRange(ErrCode::InvalidDataIdx,
                            ErrInfo::IndexCategory::Data, Instr.getTargetIndex(),
-                           static_cast<uint32_t>(Datas.size()));
+                           static_cast<uint32_t>(Ctx->Datas.size()));
     }
     return {};
 
@@ -1010,7 +1161,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                            uint128_t(0xe0e0e0e0e0e0e0e0U);
     const uint128_t Result = Instr.getNum().get<uint128_t>() & Mask;
     if (Result) {
-      spdlog::error(ErrCode::InvalidLaneIdx);
+      logError(ErrCode::InvalidLaneIdx);
       return Unexpect(ErrCode::InvalidLaneIdx);
     }
     return StackTrans(std::array{VType::V128, VType::V128},
@@ -1269,6 +1420,147 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return StackTrans(std::array{VType::V128, VType::I32},
                       std::array{VType::V128});
 
+  // Threads instructions.
+  case OpCode::Atomic__fence:
+    return {};
+  case OpCode::Memory__atomic__notify:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32, VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::Memory__atomic__wait32:
+    return checkAtomicAlignAndTrans(
+        32, std::array{VType::I32, VType::I32, VType::I64},
+        std::array{VType::I32});
+  case OpCode::Memory__atomic__wait64:
+    return checkAtomicAlignAndTrans(
+        64, std::array{VType::I32, VType::I64, VType::I64},
+        std::array{VType::I32});
+  case OpCode::I32__atomic__load:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I64__atomic__load:
+    return checkAtomicAlignAndTrans(64, std::array{VType::I32},
+                                    std::array{VType::I64});
+  case OpCode::I32__atomic__load8_u:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I32__atomic__load16_u:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I64__atomic__load8_u:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32},
+                                    std::array{VType::I64});
+  case OpCode::I64__atomic__load16_u:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32},
+                                    std::array{VType::I64});
+  case OpCode::I64__atomic__load32_u:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32},
+                                    std::array{VType::I64});
+  case OpCode::I32__atomic__store:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32, VType::I32},
+                                    {});
+  case OpCode::I64__atomic__store:
+    return checkAtomicAlignAndTrans(64, std::array{VType::I32, VType::I64},
+                                    {});
+  case OpCode::I32__atomic__store8:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32, VType::I32},
+                                    {});
+  case OpCode::I32__atomic__store16:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32, VType::I32},
+                                    {});
+  case OpCode::I64__atomic__store8:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32, VType::I64},
+                                    {});
+  case OpCode::I64__atomic__store16:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32, VType::I64},
+                                    {});
+  case OpCode::I64__atomic__store32:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32, VType::I64},
+                                    {});
+  case OpCode::I32__atomic__rmw__add:
+  case OpCode::I32__atomic__rmw__sub:
+  case OpCode::I32__atomic__rmw__and:
+  case OpCode::I32__atomic__rmw__or:
+  case OpCode::I32__atomic__rmw__xor:
+  case OpCode::I32__atomic__rmw__xchg:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32, VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I64__atomic__rmw__add:
+  case OpCode::I64__atomic__rmw__sub:
+  case OpCode::I64__atomic__rmw__and:
+  case OpCode::I64__atomic__rmw__or:
+  case OpCode::I64__atomic__rmw__xor:
+  case OpCode::I64__atomic__rmw__xchg:
+    return checkAtomicAlignAndTrans(64, std::array{VType::I32, VType::I64},
+                                    std::array{VType::I64});
+  case OpCode::I32__atomic__rmw8__add_u:
+  case OpCode::I32__atomic__rmw8__sub_u:
+  case OpCode::I32__atomic__rmw8__and_u:
+  case OpCode::I32__atomic__rmw8__or_u:
+  case OpCode::I32__atomic__rmw8__xor_u:
+  case OpCode::I32__atomic__rmw8__xchg_u:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32, VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I32__atomic__rmw16__add_u:
+  case OpCode::I32__atomic__rmw16__sub_u:
+  case OpCode::I32__atomic__rmw16__and_u:
+  case OpCode::I32__atomic__rmw16__or_u:
+  case OpCode::I32__atomic__rmw16__xor_u:
+  case OpCode::I32__atomic__rmw16__xchg_u:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32, VType::I32},
+                                    std::array{VType::I32});
+  case OpCode::I64__atomic__rmw8__add_u:
+  case OpCode::I64__atomic__rmw8__sub_u:
+  case OpCode::I64__atomic__rmw8__and_u:
+  case OpCode::I64__atomic__rmw8__or_u:
+  case OpCode::I64__atomic__rmw8__xor_u:
+  case OpCode::I64__atomic__rmw8__xchg_u:
+    return checkAtomicAlignAndTrans(8, std::array{VType::I32, VType::I64},
+                                    std::array{VType::I64});
+  case OpCode::I64__atomic__rmw16__add_u:
+  case OpCode::I64__atomic__rmw16__sub_u:
+  case OpCode::I64__atomic__rmw16__and_u:
+  case OpCode::I64__atomic__rmw16__or_u:
+  case OpCode::I64__atomic__rmw16__xor_u:
+  case OpCode::I64__atomic__rmw16__xchg_u:
+    return checkAtomicAlignAndTrans(16, std::array{VType::I32, VType::I64},
+                                    std::array{VType::I64});
+  case OpCode::I64__atomic__rmw32__add_u:
+  case OpCode::I64__atomic__rmw32__sub_u:
+  case OpCode::I64__atomic__rmw32__and_u:
+  case OpCode::I64__atomic__rmw32__or_u:
+  case OpCode::I64__atomic__rmw32__xor_u:
+  case OpCode::I64__atomic__rmw32__xchg_u:
+    return checkAtomicAlignAndTrans(32, std::array{VType::I32, VType::I64},
+                                    std::array{VType::I64});
+  case OpCode::I32__atomic__rmw__cmpxchg:
+    return checkAtomicAlignAndTrans(
+        32, std::array{VType::I32, VType::I32, VType::I32},
+        std::array{VType::I32});
+  case OpCode::I64__atomic__rmw__cmpxchg:
+    return checkAtomicAlignAndTrans(
+        64, std::array{VType::I32, VType::I64, VType::I64},
+        std::array{VType::I64});
+  case OpCode::I32__atomic__rmw8__cmpxchg_u:
+    return checkAtomicAlignAndTrans(
+        8, std::array{VType::I32, VType::I32, VType::I32},
+        std::array{VType::I32});
+  case OpCode::I32__atomic__rmw16__cmpxchg_u:
+    return checkAtomicAlignAndTrans(
+        16, std::array{VType::I32, VType::I32, VType::I32},
+        std::array{VType::I32});
+  case OpCode::I64__atomic__rmw8__cmpxchg_u:
+    return checkAtomicAlignAndTrans(
+        8, std::array{VType::I32, VType::I64, VType::I64},
+        std::array{VType::I64});
+  case OpCode::I64__atomic__rmw16__cmpxchg_u:
+    return checkAtomicAlignAndTrans(
+        16, std::array{VType::I32, VType::I64, VType::I64},
+        std::array{VType::I64});
+  case OpCode::I64__atomic__rmw32__cmpxchg_u:
+    return checkAtomicAlignAndTrans(
+        32, std::array{VType::I32, VType::I64, VType::I64},
+        std::array{VType::I64});
+
   default:
     assumingUnreachable();
   }
@@ -1288,8 +1580,8 @@ Expect<VType> FormChecker::popType() {
       return VType::Unknown;
     }
     // Value stack underflow
-    spdlog::error(ErrCode::TypeCheckFailed);
-    spdlog::error("    Value stack underflow.");
+    logError(ErrCode::TypeCheckFailed);
+    logError("    Value stack underflow.");
     return Unexpect(ErrCode::TypeCheckFailed);
   }
   auto Res = ValStack.back();
@@ -1310,8 +1602,8 @@ Expect<VType> FormChecker::popType(VType E) {
   }
   if (*Res != E) {
     // Expect value on value stack is not matched
-    spdlog::error(ErrCode::TypeCheckFailed);
-    spdlog::error(ErrInfo::InfoMismatch(VTypeToAST(E), VTypeToAST(*Res)));
+    logError(ErrCode::TypeCheckFailed);
+    logError(ErrInfo::InfoMismatch(VTypeToAST(E), VTypeToAST(*Res)));
     return Unexpect(ErrCode::TypeCheckFailed);
   }
   return *Res;
@@ -1335,8 +1627,8 @@ void FormChecker::pushCtrl(Span<const VType> In, Span<const VType> Out,
 Expect<FormChecker::CtrlFrame> FormChecker::popCtrl() {
   if (CtrlStack.empty()) {
     // Ctrl stack is empty when popping.
-    spdlog::error(ErrCode::TypeCheckFailed);
-    spdlog::error("    Control stack underflow.");
+    logError(ErrCode::TypeCheckFailed);
+    logError("    Control stack underflow.");
     return Unexpect(ErrCode::TypeCheckFailed);
   }
   if (auto Res = popTypes(CtrlStack.back().EndTypes); !Res) {
@@ -1344,8 +1636,8 @@ Expect<FormChecker::CtrlFrame> FormChecker::popCtrl() {
   }
   if (ValStack.size() != CtrlStack.back().Height) {
     // Value stack size not matched.
-    spdlog::error(ErrCode::TypeCheckFailed);
-    spdlog::error("    Value stack underflow.");
+    logError(ErrCode::TypeCheckFailed);
+    logError("    Value stack underflow.");
     return Unexpect(ErrCode::TypeCheckFailed);
   }
   auto Head = std::move(CtrlStack.back());
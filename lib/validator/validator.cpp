@@ -6,8 +6,12 @@
 #include "common/errinfo.h"
 #include "common/log.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -15,8 +19,55 @@
 namespace WasmEdge {
 namespace Validator {
 
+namespace {
+
+/// Validate the function body with the locals and the function type.
+Expect<void> checkFunctionBody(FormChecker &Checker, const uint32_t TypeIdx,
+                               Span<const std::pair<uint32_t, ValType>> Locals,
+                               AST::InstrView Instrs) {
+  // Reset stack in FormChecker.
+  Checker.reset();
+  // Add parameters into this frame.
+  for (auto Val : Checker.getTypes()[TypeIdx].first) {
+    Checker.addLocal(Val);
+  }
+  // Add locals into this frame.
+  for (auto Val : Locals) {
+    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
+      Checker.addLocal(Val.second);
+    }
+  }
+  // Validate function body expression.
+  return Checker.validate(Instrs, Checker.getTypes()[TypeIdx].second);
+}
+
+/// Validate the function body and print the error log.
+Expect<void> checkFunction(FormChecker &Checker, const uint32_t TypeIdx,
+                           Span<const std::pair<uint32_t, ValType>> Locals,
+                           AST::InstrView Instrs) {
+  if (auto Res = checkFunctionBody(Checker, TypeIdx, Locals, Instrs); !Res) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Context of validating the lazy function bodies of a module.
+struct LazyCheckContext {
+  LazyCheckContext(const FormChecker &C) : Checker(C) {}
+  std::mutex Mutex;
+  FormChecker Checker;
+};
+
+} // namespace
+
 // Validate Module. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Module &Mod) {
+  // The module is validated already.
+  if (Mod.isValidated()) {
+    return {};
+  }
+
   // https://webassembly.github.io/spec/core/valid/modules.html
   Checker.reset(true);
 
@@ -105,12 +156,14 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
   }
 
   // Multiple memories is for the MultiMemories proposal.
-  if (Checker.getMemories() > 1 && !Conf.hasProposal(Proposal::MultiMemories)) {
+  if (Checker.getMemories().size() > 1 &&
+      !Conf.hasProposal(Proposal::MultiMemories)) {
     spdlog::error(ErrCode::MultiMemories);
     spdlog::error(ErrInfo::InfoProposal(Proposal::MultiMemories));
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return Unexpect(ErrCode::MultiMemories);
   }
+  Mod.setIsValidated();
   return {};
 }
 
@@ -140,12 +193,17 @@ Expect<void> Validator::validate(const AST::MemoryType &Mem) {
   if (auto Res = validate(Lim); !Res) {
     return Unexpect(Res);
   }
-  if (Lim.getMin() > LIMIT_MEMORYTYPE ||
-      (Lim.hasMax() && Lim.getMax() > LIMIT_MEMORYTYPE)) {
+  const uint64_t PageLimit = Lim.is64() ? LIMIT_MEMORYTYPE64 : LIMIT_MEMORYTYPE;
+  if (Lim.getMin() > PageLimit || (Lim.hasMax() && Lim.getMax() > PageLimit)) {
     spdlog::error(ErrCode::InvalidMemPages);
     spdlog::error(ErrInfo::InfoLimit(Lim.hasMax(), Lim.getMin(), Lim.getMax()));
     return Unexpect(ErrCode::InvalidMemPages);
   }
+  if (Lim.isShared() && !Lim.hasMax()) {
+    spdlog::error(ErrCode::SharedMemoryNoMax);
+    spdlog::error(ErrInfo::InfoLimit(Lim.hasMax(), Lim.getMin(), Lim.getMax()));
+    return Unexpect(ErrCode::SharedMemoryNoMax);
+  }
   return {};
 }
 
@@ -204,42 +262,26 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 // Validate Code segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
-  // Reset stack in FormChecker.
-  Checker.reset();
-  // Add parameters into this frame.
-  for (auto Val : Checker.getTypes()[TypeIdx].first) {
-    Checker.addLocal(Val);
-  }
-  // Add locals into this frame.
-  for (auto Val : CodeSeg.getLocals()) {
-    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
-      Checker.addLocal(Val.second);
-    }
-  }
-  // Validate function body expression.
-  if (auto Res = Checker.validate(CodeSeg.getExpr().getInstrs(),
-                                  Checker.getTypes()[TypeIdx].second);
-      !Res) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
-    return Unexpect(Res);
-  }
-  return {};
+  return checkFunction(Checker, TypeIdx, CodeSeg.getLocals(),
+                       CodeSeg.getExpr().getInstrs());
 }
 
 // Validate Data segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
   if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
     // Check memory index in context.
-    const auto &MemNum = Checker.getMemories();
-    if (DataSeg.getIdx() >= MemNum) {
+    const auto &Mems = Checker.getMemories();
+    if (DataSeg.getIdx() >= Mems.size()) {
       spdlog::error(ErrCode::InvalidMemoryIdx);
-      spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory,
-                                             DataSeg.getIdx(), MemNum));
+      spdlog::error(ErrInfo::InfoForbidIndex(
+          ErrInfo::IndexCategory::Memory, DataSeg.getIdx(),
+          static_cast<uint32_t>(Mems.size())));
       return Unexpect(ErrCode::InvalidMemoryIdx);
     }
-    // Check memory initialization is a const expression.
+    // Check memory initialization is a const expression of the index type.
+    const ValType IdxType = Checker.VTypeToAST(Mems[DataSeg.getIdx()]);
     if (auto Res = validateConstExpr(DataSeg.getExpr().getInstrs(),
-                                     std::array{ValType::I32});
+                                     std::array{IdxType});
         !Res) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
       return Unexpect(Res);
@@ -322,10 +364,11 @@ Expect<void> Validator::validate(const AST::ExportDesc &ExpDesc) {
     }
     return {};
   case ExternalType::Memory:
-    if (Id >= Checker.getMemories()) {
+    if (Id >= Checker.getMemories().size()) {
       spdlog::error(ErrCode::InvalidMemoryIdx);
-      spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory, Id,
-                                             Checker.getMemories()));
+      spdlog::error(ErrInfo::InfoForbidIndex(
+          ErrInfo::IndexCategory::Memory, Id,
+          static_cast<uint32_t>(Checker.getMemories().size())));
       return Unexpect(ErrCode::InvalidMemoryIdx);
     }
     return {};
@@ -430,9 +473,19 @@ Expect<void> Validator::validate(const AST::ElementSection &ElemSec) {
 Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
   const auto &CodeVec = CodeSec.getContent();
   const auto &FuncVec = Checker.getFunctions();
+  std::shared_ptr<LazyCheckContext> LazyCtx;
+
+  // Validate the function bodies concurrently, and the functions from the
+  // first failed one are validated sequentially to report the error.
+  uint32_t Checked = 0;
+  if (const uint32_t Threads = Conf.getLoaderConfigure().getParallelThreads();
+      Threads > 1) {
+    Checked = validateParallel(CodeSec, Threads);
+  }
 
   // Validate function body.
-  for (uint32_t Id = 0; Id < static_cast<uint32_t>(CodeVec.size()); ++Id) {
+  for (uint32_t Id = Checked; Id < static_cast<uint32_t>(CodeVec.size());
+       ++Id) {
     // Added functions contains imported functions.
     uint32_t TId = Id + static_cast<uint32_t>(Checker.getNumImportFuncs());
     if (TId >= static_cast<uint32_t>(FuncVec.size())) {
@@ -442,6 +495,36 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
                                    static_cast<uint32_t>(FuncVec.size())));
       return Unexpect(ErrCode::InvalidFuncIdx);
     }
+    if (CodeVec[Id].isLazy()) {
+      // Validate the lazy function body at the first use with the copy of
+      // the current context.
+      if (!LazyCtx) {
+        LazyCtx = std::make_shared<LazyCheckContext>(Checker);
+      }
+      if (CodeVec[Id].setLazyChecker(
+              [LazyCtx, TypeIdx = FuncVec[TId]](
+                  Span<const std::pair<uint32_t, ValType>> Locals,
+                  AST::InstrView Instrs) -> Expect<void> {
+                std::unique_lock Lock(LazyCtx->Mutex);
+                if (auto Res = checkFunction(LazyCtx->Checker, TypeIdx,
+                                             Locals, Instrs);
+                    !Res) {
+                  spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+                  return Unexpect(Res);
+                }
+                return {};
+              })) {
+        continue;
+      }
+      // The body is decoded already, so check it now.
+      if (auto Res = CodeVec[Id].loadLazyBody(); !Res) {
+        return Unexpect(Res);
+      }
+    }
+    if (CodeVec[Id].isValidated()) {
+      // Checked while loading.
+      continue;
+    }
     if (auto Res = validate(CodeVec[Id], FuncVec[TId]); !Res) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
       return Unexpect(Res);
@@ -450,6 +533,40 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
   return {};
 }
 
+// Validate function bodies in parallel. See "include/validator/validator.h".
+uint32_t Validator::validateParallel(const AST::CodeSection &CodeSec,
+                                     uint32_t Threads) {
+  const auto &CodeVec = CodeSec.getContent();
+  const auto &FuncVec = Checker.getFunctions();
+  const uint32_t NumImportFuncs = Checker.getNumImportFuncs();
+  const uint32_t Count = static_cast<uint32_t>(CodeVec.size());
+
+  // The workers only read the shared module context. A function fails if its
+  // index or body is invalid, or its body is lazy, and the workers skip the
+  // functions after the first failed one.
+  std::atomic<uint32_t> Next = 0;
+  std::atomic<uint32_t> Failed = Count;
+  auto Check = [&]() {
+    FormChecker Worker = Checker.createWorker();
+    uint32_t Id;
+    while ((Id = Next.fetch_add(1, std::memory_order_relaxed)) <
+           Failed.load(std::memory_order_relaxed)) {
+      const uint32_t TId = Id + NumImportFuncs;
+      if (TId >= FuncVec.size() || CodeVec[Id].isLazy() ||
+          (!CodeVec[Id].isValidated() &&
+           !checkFunctionBody(Worker, FuncVec[TId], CodeVec[Id].getLocals(),
+                              CodeVec[Id].getExpr().getInstrs()))) {
+        uint32_t Cur = Failed.load(std::memory_order_relaxed);
+        while (Id < Cur && !Failed.compare_exchange_weak(
+                               Cur, Id, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  };
+  WorkerPool::run(Pool, Threads, Count, Check);
+  return Failed.load(std::memory_order_relaxed);
+}
+
 // Validate Data section. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSection &DataSec) {
   for (auto &DataSeg : DataSec.getContent()) {
@@ -7,9 +7,167 @@
 #include "host/wasi/wasimodule.h"
 #include "host/wasmedge_process/processmodule.h"
 
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+#include "aot/compiler.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <random>
+#include <set>
+#include <string>
+#include <system_error>
+
 namespace WasmEdge {
 namespace VM {
 
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+namespace {
+/// Compile the functions at the indices of the code section in process for
+/// the tiered execution, which are cached in the module for its instances.
+std::vector<std::shared_ptr<const AST::Module::CompiledCode>>
+compileHotCodes(const Configure &Conf, const AST::Module &Owner,
+                Span<const uint32_t> CodeIdxs) {
+  using CompiledCode = AST::Module::CompiledCode;
+  return Owner.getCompiledCodes(
+      CodeIdxs, [&Conf, &Owner](Span<const uint32_t> Idxs) {
+        std::vector<std::shared_ptr<const CompiledCode>> Codes(Idxs.size());
+        auto Res = AOT::Compiler(Conf).compileJIT(Owner, Idxs);
+        if (!Res) {
+          return Codes;
+        }
+        *Res->Intrinsics = &Executor::Executor::Intrinsics;
+        const auto &TypeIdxs = Owner.getFunctionSection().getContent();
+        for (size_t I = 0; I < Idxs.size(); ++I) {
+          Codes[I] = std::make_shared<const CompiledCode>(CompiledCode{
+              Res->Types[TypeIdxs[Idxs[I]]], std::move(Res->Codes[Idxs[I]])});
+        }
+        return Codes;
+      });
+}
+
+/// Process-wide worker compiling the modules into the AOT cache in
+/// background. The VMs never wait for it: the queued compilations outlive
+/// their VMs. At the process exit, the static instance is destroyed before the
+/// globals used by the compilation, and cancels and joins the worker. The
+/// running compilation is discarded at its next step.
+class CacheCompiler {
+public:
+  static CacheCompiler &getInstance() {
+    static CacheCompiler Instance;
+    return Instance;
+  }
+
+  ~CacheCompiler() noexcept {
+    stop();
+    if (Worker.joinable()) {
+      Worker.join();
+    }
+  }
+
+  /// Queue the compilation of the WASM binary into the cache path. A cache
+  /// path is compiled once at the same time.
+  void push(const Configure &Conf, Span<const Byte> Code,
+            std::filesystem::path CachePath) {
+    std::unique_lock Lock(Mutex);
+    if (Stopped.load(std::memory_order_relaxed) ||
+        !Pending.insert(CachePath).second) {
+      return;
+    }
+    Queue.push_back(
+        {Conf, std::vector<Byte>(Code.begin(), Code.end()), CachePath});
+    if (!Worker.joinable()) {
+      Worker = std::thread(&CacheCompiler::run, this);
+    }
+    Cond.notify_one();
+  }
+
+private:
+  struct Compilation {
+    Configure Conf;
+    std::vector<Byte> Data;
+    std::filesystem::path CachePath;
+  };
+
+  CacheCompiler() noexcept {
+    // The statics constructed after the instance are destroyed before it, so
+    // construct the logger used by the worker first.
+    spdlog::default_logger();
+  }
+
+  /// Drop the queued compilations, and discard the running one at its next
+  /// step.
+  void stop() {
+    std::unique_lock Lock(Mutex);
+    Stopped.store(true, std::memory_order_relaxed);
+    Queue.clear();
+    Cond.notify_one();
+  }
+
+  void run() {
+    std::unique_lock Lock(Mutex);
+    while (true) {
+      Cond.wait(Lock, [this]() {
+        return Stopped.load(std::memory_order_relaxed) || !Queue.empty();
+      });
+      if (Stopped.load(std::memory_order_relaxed)) {
+        return;
+      }
+      auto Job = std::move(Queue.front());
+      Queue.pop_front();
+      Lock.unlock();
+      compile(Job);
+      Lock.lock();
+      Pending.erase(Job.CachePath);
+    }
+  }
+
+  void compile(const Compilation &Job) const {
+    auto IsStopped = [this]() {
+      return Stopped.load(std::memory_order_relaxed);
+    };
+    // The loading and validation errors are reported by the VM already.
+    Loader::Loader Ldr(Job.Conf);
+    std::unique_ptr<AST::Module> Mod;
+    if (auto Res = Ldr.parseModule(Job.Data); Res && !IsStopped()) {
+      Mod = std::move(*Res);
+    } else {
+      return;
+    }
+    Validator::Validator Valid(Job.Conf);
+    if (!Valid.validate(*Mod) || IsStopped()) {
+      return;
+    }
+    Configure CompileConf(Job.Conf);
+    CompileConf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+    // The cache path is not keyed by the profile.
+    CompileConf.getCompilerConfigure().setProfile(nullptr);
+    // Compile into a temporary file and rename it, so the concurrent loaders
+    // never see the partial library.
+    std::error_code EC;
+    std::filesystem::create_directories(Job.CachePath.parent_path(), EC);
+    auto TmpPath = Job.CachePath;
+    TmpPath += "." + std::to_string(std::random_device()()) + ".tmp";
+    AOT::Compiler Compiler(CompileConf);
+    if (Compiler.compile(Job.Data, *Mod, TmpPath) && !IsStopped()) {
+      std::filesystem::rename(TmpPath, Job.CachePath, EC);
+    }
+    std::filesystem::remove(TmpPath, EC);
+  }
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::deque<Compilation> Queue;
+  /// Cache paths queued or being compiled.
+  std::set<std::filesystem::path> Pending;
+  std::atomic<bool> Stopped = false;
+  std::thread Worker;
+};
+} // namespace
+#endif
+
 VM::VM(const Configure &Conf)
     : Conf(Conf), Stage(VMStage::Inited),
       LoaderEngine(Conf, &Executor::Executor::Intrinsics),
@@ -25,7 +183,29 @@ VM::VM(const Configure &Conf, Runtime::StoreManager &S)
   unsafeInitVM();
 }
 
+VM::~VM() {
+  {
+    std::unique_lock Lock(HotMutex);
+    HotQueue.clear();
+    HotStopped = true;
+  }
+  HotCond.notify_all();
+  if (HotWorker.joinable()) {
+    HotWorker.join();
+  }
+}
+
 void VM::unsafeInitVM() {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Conf.getRuntimeConfigure().getTieredThreshold() > 0 ||
+      Conf.getRuntimeConfigure().isLazyJIT()) {
+    ExecutorEngine.setHotFunctionHandler(
+        [this](Runtime::StoreManager &StoreMgr,
+               const Runtime::Instance::FunctionInstance &Func) {
+          unsafeCompileHotFunction(StoreMgr, Func);
+        });
+  }
+#endif
   // Create import modules from configuration.
   if (Conf.hasHostRegistration(HostRegistration::Wasi)) {
     std::unique_ptr<Runtime::ImportObject> WasiMod =
@@ -41,6 +221,196 @@ void VM::unsafeInitVM() {
   }
 }
 
+Expect<std::unique_ptr<AST::Module>>
+VM::unsafeParseModule(const std::filesystem::path &Path) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Conf.getRuntimeConfigure().isAOTCache()) {
+    if (auto Code = Loader::Loader::loadFile(Path)) {
+      return unsafeParseModule(*Code, &Path);
+    }
+  }
+#endif
+  auto Res = LoaderEngine.parseModule(Path);
+  if (Res) {
+    unsafeCompileJIT(**Res);
+  }
+  return Res;
+}
+
+Expect<std::unique_ptr<AST::Module>>
+VM::unsafeParseModule(Span<const Byte> Code) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (Conf.getRuntimeConfigure().isAOTCache()) {
+    return unsafeParseModule(Code, nullptr);
+  }
+#endif
+  auto Res = LoaderEngine.parseModule(Code);
+  if (Res) {
+    unsafeCompileJIT(**Res);
+  }
+  return Res;
+}
+
+Expect<std::unique_ptr<AST::Module>>
+VM::unsafeParseModule(Span<const Byte> Code,
+                      const std::filesystem::path *Path) {
+  std::filesystem::path CachePath;
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  CachePath = AOT::Compiler::getCachePath(Code, Conf);
+  // Fall back to the module binary if the compiled library is unavailable.
+  if (std::error_code EC;
+      !CachePath.empty() && std::filesystem::exists(CachePath, EC)) {
+    if (auto Res = LoaderEngine.parseModule(CachePath)) {
+      return Res;
+    }
+  }
+#endif
+  auto Res =
+      Path ? LoaderEngine.parseModule(*Path) : LoaderEngine.parseModule(Code);
+  // The modules loaded from the compiled libraries are not compiled again.
+  if (Res && !(*Res)->getSymbol() && !CachePath.empty()) {
+    unsafeCompileInBackground(Code, std::move(CachePath));
+  }
+  if (Res) {
+    unsafeCompileJIT(**Res);
+  }
+  return Res;
+}
+
+void VM::unsafeCompileJIT([[maybe_unused]] AST::Module &Mod) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  if (!Conf.getRuntimeConfigure().isJIT() || Mod.getSymbol()) {
+    return;
+  }
+  // The invalid modules are reported by the validation later.
+  if (!ValidatorEngine.validate(Mod)) {
+    return;
+  }
+  // Fall back to the interpreter if the JIT compilation failed.
+  if (auto Res = AOT::Compiler(Conf).compileJIT(Mod); !Res) {
+    spdlog::error("    JIT compilation failed, fall back to interpreter.");
+    return;
+  }
+  *Mod.getSymbol() = &Executor::Executor::Intrinsics;
+#endif
+}
+
+void VM::unsafeCompileHotFunction(
+    [[maybe_unused]] Runtime::StoreManager &StoreMgr,
+    [[maybe_unused]] const Runtime::Instance::FunctionInstance &Func) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  // Only the functions borrowing the instructions from the shared module are
+  // compiled, which is kept alive by the function instances.
+  auto Owner = Func.getOwner();
+  if (!Owner) {
+    return;
+  }
+  const uint32_t CodeIdx = Func.getCodeIdx();
+
+  // The lazy JIT compiles the function before its first call returns. The
+  // concurrent first calls on the other threads are interpreted meanwhile.
+  if (Conf.getRuntimeConfigure().isLazyJIT()) {
+    // Keep interpreting the function if the compilation failed.
+    if (auto Code = compileHotCodes(Conf, *Owner, {&CodeIdx, 1}).front()) {
+      Func.setTieredCode(std::move(Code));
+    }
+    return;
+  }
+  std::unique_lock Lock(HotMutex);
+  if (!HotWorker.joinable()) {
+    HotWorker = std::thread(&VM::runHotWorker, this);
+  }
+  HotQueue.push_back(
+      {std::move(Owner), Func.getModuleAddr(), CodeIdx, HotGeneration});
+  HotCond.notify_all();
+#endif
+}
+
+void VM::runHotWorker() {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  std::unique_lock Lock(HotMutex);
+  while (true) {
+    HotCond.wait(Lock, [this]() { return HotStopped || !HotQueue.empty(); });
+    if (HotStopped) {
+      return;
+    }
+    auto Batch = std::move(HotQueue);
+    HotQueue.clear();
+    Lock.unlock();
+
+    // The hot functions of a module are compiled together.
+    std::sort(Batch.begin(), Batch.end(),
+              [](const HotFunction &LHS, const HotFunction &RHS) {
+                return LHS.Owner < RHS.Owner;
+              });
+    for (auto It = Batch.begin(); It != Batch.end();) {
+      auto End = std::find_if(It, Batch.end(), [&It](const HotFunction &F) {
+        return F.Owner != It->Owner;
+      });
+      std::vector<uint32_t> CodeIdxs;
+      for (auto I = It; I != End; ++I) {
+        CodeIdxs.push_back(I->CodeIdx);
+      }
+      auto Codes = compileHotCodes(Conf, *It->Owner, CodeIdxs);
+      Lock.lock();
+      for (size_t I = 0; I < Codes.size(); ++I) {
+        // Keep interpreting the function if the compilation failed, or the
+        // function instance is gone.
+        if (Codes[I]) {
+          if (auto *FuncInst = findHotFunction(It[I])) {
+            FuncInst->setTieredCode(std::move(Codes[I]));
+          }
+        }
+      }
+      Lock.unlock();
+      It = End;
+    }
+    Batch.clear();
+    Lock.lock();
+  }
+#endif
+}
+
+Runtime::Instance::FunctionInstance *
+VM::findHotFunction(const HotFunction &Hot) {
+  // The store is reset after the compilation was queued.
+  if (Hot.Generation != HotGeneration) {
+    return nullptr;
+  }
+  auto ModInst = StoreRef.getModule(Hot.ModuleAddr);
+  if (!ModInst) {
+    return nullptr;
+  }
+  auto FuncAddr =
+      (*ModInst)->getFuncAddr((*ModInst)->getFuncImportNum() + Hot.CodeIdx);
+  if (!FuncAddr) {
+    return nullptr;
+  }
+  auto FuncInst = StoreRef.getFunction(*FuncAddr);
+  // The store may be modified without this VM, so check the function is still
+  // instantiated from the same module.
+  if (!FuncInst || !(*FuncInst)->isWasmFunction() ||
+      (*FuncInst)->getOwner() != Hot.Owner ||
+      (*FuncInst)->getCodeIdx() != Hot.CodeIdx) {
+    return nullptr;
+  }
+  return *FuncInst;
+}
+
+void VM::unsafeCancelHotCompilations() {
+  std::unique_lock Lock(HotMutex);
+  HotQueue.clear();
+  ++HotGeneration;
+}
+
+void VM::unsafeCompileInBackground(
+    [[maybe_unused]] Span<const Byte> Code,
+    [[maybe_unused]] std::filesystem::path CachePath) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  CacheCompiler::getInstance().push(Conf, Code, std::move(CachePath));
+#endif
+}
+
 Expect<void> VM::unsafeRegisterModule(std::string_view Name,
                                       const std::filesystem::path &Path) {
   if (Stage == VMStage::Instantiated) {
@@ -49,8 +419,9 @@ Expect<void> VM::unsafeRegisterModule(std::string_view Name,
     Stage = VMStage::Validated;
   }
   // Load module.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
-    return unsafeRegisterModule(Name, *(*Res).get());
+  if (auto Res = unsafeParseModule(Path)) {
+    return unsafeRegisterModule(
+        Name, std::shared_ptr<const AST::Module>(std::move(*Res)));
   } else {
     return Unexpect(Res);
   }
@@ -64,8 +435,9 @@ Expect<void> VM::unsafeRegisterModule(std::string_view Name,
     Stage = VMStage::Validated;
   }
   // Load module.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
-    return unsafeRegisterModule(Name, *(*Res).get());
+  if (auto Res = unsafeParseModule(Code)) {
+    return unsafeRegisterModule(
+        Name, std::shared_ptr<const AST::Module>(std::move(*Res)));
   } else {
     return Unexpect(Res);
   }
@@ -77,6 +449,8 @@ Expect<void> VM::unsafeRegisterModule(const Runtime::ImportObject &Obj) {
     // Therefore the instantiation should restart.
     Stage = VMStage::Validated;
   }
+  // Registering a module resets the instantiated module in store.
+  unsafeCancelHotCompilations();
   return ExecutorEngine.registerModule(StoreRef, Obj);
 }
 
@@ -88,12 +462,31 @@ Expect<void> VM::unsafeRegisterModule(std::string_view Name,
     Stage = VMStage::Validated;
   }
   // Validate module.
-  if (auto Res = ValidatorEngine.validate(Module); !Res) {
+  if (auto Res = unsafeValidate(Module); !Res) {
     return Unexpect(Res);
   }
+  // Registering a module resets the instantiated module in store.
+  unsafeCancelHotCompilations();
   return ExecutorEngine.registerModule(StoreRef, Module, Name);
 }
 
+Expect<void>
+VM::unsafeRegisterModule(std::string_view Name,
+                         std::shared_ptr<const AST::Module> Module) {
+  if (Stage == VMStage::Instantiated) {
+    // When registering module, instantiated module in store will be reset.
+    // Therefore the instantiation should restart.
+    Stage = VMStage::Validated;
+  }
+  // Validate module.
+  if (auto Res = unsafeValidate(*Module); !Res) {
+    return Unexpect(Res);
+  }
+  // Registering a module resets the instantiated module in store.
+  unsafeCancelHotCompilations();
+  return ExecutorEngine.registerModule(StoreRef, std::move(Module), Name);
+}
+
 Expect<std::vector<std::pair<ValVariant, ValType>>>
 VM::unsafeRunWasmFile(const std::filesystem::path &Path, std::string_view Func,
                       Span<const ValVariant> Params,
@@ -104,8 +497,10 @@ VM::unsafeRunWasmFile(const std::filesystem::path &Path, std::string_view Func,
     Stage = VMStage::Validated;
   }
   // Load module.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
-    return unsafeRunWasmFile(*(*Res).get(), Func, Params, ParamTypes);
+  if (auto Res = unsafeParseModule(Path)) {
+    return unsafeRunWasmFile(
+        std::shared_ptr<const AST::Module>(std::move(*Res)), Func, Params,
+        ParamTypes);
   } else {
     return Unexpect(Res);
   }
@@ -121,8 +516,10 @@ VM::unsafeRunWasmFile(Span<const Byte> Code, std::string_view Func,
     Stage = VMStage::Validated;
   }
   // Load module.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
-    return unsafeRunWasmFile(*(*Res).get(), Func, Params, ParamTypes);
+  if (auto Res = unsafeParseModule(Code)) {
+    return unsafeRunWasmFile(
+        std::shared_ptr<const AST::Module>(std::move(*Res)), Func, Params,
+        ParamTypes);
   } else {
     return Unexpect(Res);
   }
@@ -137,9 +534,10 @@ VM::unsafeRunWasmFile(const AST::Module &Module, std::string_view Func,
     // Therefore the instantiation should restart.
     Stage = VMStage::Validated;
   }
-  if (auto Res = ValidatorEngine.validate(Module); !Res) {
+  if (auto Res = unsafeValidate(Module); !Res) {
     return Unexpect(Res);
   }
+  unsafeCancelHotCompilations();
   if (auto Res = ExecutorEngine.instantiateModule(StoreRef, Module); !Res) {
     return Unexpect(Res);
   }
@@ -154,6 +552,34 @@ VM::unsafeRunWasmFile(const AST::Module &Module, std::string_view Func,
   }
 }
 
+Expect<std::vector<std::pair<ValVariant, ValType>>>
+VM::unsafeRunWasmFile(std::shared_ptr<const AST::Module> Module,
+                      std::string_view Func, Span<const ValVariant> Params,
+                      Span<const ValType> ParamTypes) {
+  if (Stage == VMStage::Instantiated) {
+    // When running another module, instantiated module in store will be reset.
+    // Therefore the instantiation should restart.
+    Stage = VMStage::Validated;
+  }
+  if (auto Res = unsafeValidate(*Module); !Res) {
+    return Unexpect(Res);
+  }
+  unsafeCancelHotCompilations();
+  if (auto Res = ExecutorEngine.instantiateModule(StoreRef, std::move(Module));
+      !Res) {
+    return Unexpect(Res);
+  }
+  // Get module instance.
+  if (auto Res = StoreRef.getActiveModule()) {
+    // Execute function and return values with the module instance.
+    return unsafeExecute(*Res, Func, Params, ParamTypes);
+  } else {
+    spdlog::error(Res.error());
+    spdlog::error(ErrInfo::InfoExecuting("", Func));
+    return Unexpect(Res);
+  }
+}
+
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
 VM::asyncRunWasmFile(const std::filesystem::path &Path, std::string_view Func,
                      Span<const ValVariant> Params,
@@ -199,9 +625,24 @@ VM::asyncRunWasmFile(const AST::Module &Module, std::string_view Func,
           std::vector(ParamTypes.begin(), ParamTypes.end())};
 }
 
+Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+VM::asyncRunWasmFile(std::shared_ptr<const AST::Module> Module,
+                     std::string_view Func, Span<const ValVariant> Params,
+                     Span<const ValType> ParamTypes) {
+  Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
+      std::shared_ptr<const AST::Module>, std::string_view,
+      Span<const ValVariant>, Span<const ValType>) = &VM::runWasmFile;
+  return {FPtr,
+          *this,
+          std::move(Module),
+          std::string(Func),
+          std::vector(Params.begin(), Params.end()),
+          std::vector(ParamTypes.begin(), ParamTypes.end())};
+}
+
 Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
   // If not load successfully, the previous status will be reserved.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
+  if (auto Res = unsafeParseModule(Path)) {
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -212,7 +653,7 @@ Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
 
 Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
   // If not load successfully, the previous status will be reserved.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
+  if (auto Res = unsafeParseModule(Code)) {
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -222,7 +663,13 @@ Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
 }
 
 Expect<void> VM::unsafeLoadWasm(const AST::Module &Module) {
-  Mod = std::make_unique<AST::Module>(Module);
+  Mod = std::make_shared<const AST::Module>(Module);
+  Stage = VMStage::Loaded;
+  return {};
+}
+
+Expect<void> VM::unsafeLoadWasm(std::shared_ptr<const AST::Module> Module) {
+  Mod = std::move(Module);
   Stage = VMStage::Loaded;
   return {};
 }
@@ -233,7 +680,7 @@ Expect<void> VM::unsafeValidate() {
     spdlog::error(ErrCode::WrongVMWorkflow);
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
-  if (auto Res = ValidatorEngine.validate(*Mod.get())) {
+  if (auto Res = unsafeValidate(*Mod)) {
     Stage = VMStage::Validated;
     return {};
   } else {
@@ -241,13 +688,28 @@ Expect<void> VM::unsafeValidate() {
   }
 }
 
+Expect<void> VM::unsafeValidate(const AST::Module &Module) {
+  const bool WasValidated = Module.isValidated();
+  if (auto Res = ValidatorEngine.validate(Module); !Res) {
+    return Unexpect(Res);
+  }
+  // Saving the flat image is best-effort, and the module is still usable.
+  if (!WasValidated && !Module.getFlatImagePath().empty()) {
+    [[maybe_unused]] auto Res =
+        LoaderEngine.saveFlatImage(Module, Module.getFlatImagePath());
+  }
+  return {};
+}
+
 Expect<void> VM::unsafeInstantiate() {
   if (Stage < VMStage::Validated) {
     // When module is not validated, not instantiate.
     spdlog::error(ErrCode::WrongVMWorkflow);
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
-  if (auto Res = ExecutorEngine.instantiateModule(StoreRef, *Mod.get())) {
+  // Instantiating resets the store, which the queued hot functions refer to.
+  unsafeCancelHotCompilations();
+  if (auto Res = ExecutorEngine.instantiateModule(StoreRef, Mod)) {
     Stage = VMStage::Instantiated;
     return {};
   } else {
@@ -335,6 +797,8 @@ VM::asyncExecute(std::string_view ModName, std::string_view Func,
 }
 
 void VM::unsafeCleanup() {
+  // The compilations refer to the function instances in the store.
+  unsafeCancelHotCompilations();
   Mod.reset();
   StoreRef.reset();
   Stat.clear();
@@ -14,6 +14,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "aot/cache.h"
 #include "aot/compiler.h"
 #include "common/defines.h"
 #include "common/log.h"
@@ -271,6 +272,192 @@ INSTANTIATE_TEST_SUITE_P(TestUnit, NativeCoreTest,
 INSTANTIATE_TEST_SUITE_P(TestUnit, CustomWasmCoreTest,
                          testing::ValuesIn(T.enumerate()));
 
+// Four functions "f0" to "f3" returning 10 to 13.
+std::array<WasmEdge::Byte, 68> FourFunctions{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x00, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x07, 0x15,
+    0x04, 0x02, 0x66, 0x30, 0x00, 0x00, 0x02, 0x66, 0x31, 0x00, 0x01, 0x02,
+    0x66, 0x32, 0x00, 0x02, 0x02, 0x66, 0x33, 0x00, 0x03, 0x0a, 0x15, 0x04,
+    0x04, 0x00, 0x41, 0x0a, 0x0b, 0x04, 0x00, 0x41, 0x0b, 0x0b, 0x04, 0x00,
+    0x41, 0x0c, 0x0b, 0x04, 0x00, 0x41, 0x0d, 0x0b};
+
+/// Load the compiled four functions into the VM, and check their results.
+void checkFourFunctions(WasmEdge::VM::VM &VM,
+                        const std::filesystem::path &Path) {
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  for (uint32_t I = 0; I < 4; ++I) {
+    const std::string Name = "f" + std::to_string(I);
+    auto Res = VM.execute(Name);
+    ASSERT_TRUE(Res);
+    ASSERT_EQ(Res->size(), 1U);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 10U + I);
+  }
+}
+
+TEST(ParallelCompile, JobsTest) {
+  // The four functions are split into the partitions compiled in parallel.
+  const auto &Wasm = FourFunctions;
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setParallelThreads(4);
+  Conf.getCompilerConfigure().setOutputFormat(
+      CompilerConfigure::OutputFormat::Native);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  auto Module = *Loader.parseModule(Wasm);
+  ASSERT_TRUE(ValidatorEngine.validate(*Module));
+
+  // The threads of the compiler are reused by the later compilations.
+  for (uint32_t Round = 0; Round < 3; ++Round) {
+    auto Path = std::filesystem::temp_directory_path() /
+                std::filesystem::u8path("AOTcoreTestJobs" EXTENSION);
+    ASSERT_TRUE(Compiler.compile(Wasm, *Module, Path));
+    {
+      WasmEdge::VM::VM VM(Conf);
+      checkFourFunctions(VM, Path);
+    }
+    std::filesystem::remove(Path);
+  }
+}
+
+TEST(IncrementalCache, OutputPathTest) {
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setIncrementalCache(true);
+  Conf.getCompilerConfigure().setOutputFormat(
+      CompilerConfigure::OutputFormat::Native);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  auto Module = *Loader.parseModule(FourFunctions);
+  ASSERT_TRUE(ValidatorEngine.validate(*Module));
+
+  auto Objects = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Local, "objects"sv);
+  ASSERT_TRUE(Objects);
+  const auto ObjectsDir = Objects->parent_path();
+  auto CountObjects = [&ObjectsDir]() {
+    std::error_code EC;
+    size_t Count = 0;
+    for (std::filesystem::directory_iterator It(ObjectsDir, EC), End;
+         !EC && It != End; It.increment(EC)) {
+      ++Count;
+    }
+    return Count;
+  };
+  WasmEdge::AOT::Cache::clear(WasmEdge::AOT::Cache::StorageScope::Local,
+                              "objects"sv);
+
+  // The objects cached by the first compilation are hit by the recompilation
+  // into the other output paths, and no object is added.
+  size_t Cached = 0;
+  for (uint32_t Round = 0; Round < 3; ++Round) {
+    auto Path = std::filesystem::temp_directory_path() /
+                std::filesystem::u8path("AOTcoreTestCache" +
+                                        std::to_string(Round) +
+                                        std::string(EXTENSION));
+    WasmEdge::AOT::Compiler Compiler(Conf);
+    ASSERT_TRUE(Compiler.compile(FourFunctions, *Module, Path));
+    if (Round == 0) {
+      Cached = CountObjects();
+      EXPECT_GT(Cached, 0U);
+    } else {
+      EXPECT_EQ(CountObjects(), Cached);
+    }
+    {
+      WasmEdge::VM::VM VM(Conf);
+      checkFourFunctions(VM, Path);
+    }
+    std::filesystem::remove(Path);
+  }
+  WasmEdge::AOT::Cache::clear(WasmEdge::AOT::Cache::StorageScope::Local,
+                              "objects"sv);
+}
+
+TEST(CPULevels, VariantsTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  auto Module = *Loader.parseModule(FourFunctions);
+  ASSERT_TRUE(ValidatorEngine.validate(*Module));
+
+  // The universal WASM output holds the variants of all levels, and the
+  // loader selects the highest one supported by the running CPU.
+  using CPULevel = CompilerConfigure::CPULevel;
+  auto &CompilerConf = Conf.getCompilerConfigure();
+  for (auto Level :
+       {CPULevel::Baseline, CPULevel::V2, CPULevel::V3, CPULevel::V4}) {
+    CompilerConf.addCPULevel(Level);
+  }
+  auto Path = std::filesystem::temp_directory_path() /
+              std::filesystem::u8path("AOTcoreTestVariants.wasm"sv);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  ASSERT_TRUE(Compiler.compile(FourFunctions, *Module, Path));
+  {
+    WasmEdge::VM::VM VM(Conf);
+    checkFourFunctions(VM, Path);
+  }
+
+  // The baseline variant is selected on all CPUs.
+  CompilerConf.clearCPULevels();
+  CompilerConf.addCPULevel(CPULevel::Baseline);
+  ASSERT_TRUE(WasmEdge::AOT::Compiler(Conf).compile(FourFunctions, *Module,
+                                                    Path));
+  {
+    WasmEdge::VM::VM VM(Conf);
+    checkFourFunctions(VM, Path);
+  }
+  std::filesystem::remove(Path);
+}
+
+TEST(JITCompile, ExecuteTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+
+  // The module compiled in process runs the compiled functions.
+  {
+    std::shared_ptr<AST::Module> Module = *Loader.parseModule(FourFunctions);
+    ASSERT_TRUE(ValidatorEngine.validate(*Module));
+    ASSERT_TRUE(WasmEdge::AOT::Compiler(Conf).compileJIT(*Module));
+    ASSERT_TRUE(Module->getSymbol());
+    for (const auto &Code : Module->getCodeSection().getContent()) {
+      EXPECT_TRUE(Code.getSymbol());
+    }
+    *Module->getSymbol() = &WasmEdge::Executor::Executor::Intrinsics;
+
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(std::shared_ptr<const AST::Module>(Module)));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    for (uint32_t I = 0; I < 4; ++I) {
+      auto Res = VM.execute("f" + std::to_string(I));
+      ASSERT_TRUE(Res);
+      ASSERT_EQ(Res->size(), 1U);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 10U + I);
+    }
+  }
+
+  // The VM compiles the loaded modules with the JIT enabled.
+  {
+    Conf.getRuntimeConfigure().setJIT(true);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(FourFunctions));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const auto *ModInst = *VM.getStoreManager().getActiveModule();
+    for (uint32_t I = 0; I < 4; ++I) {
+      auto *FuncInst =
+          *VM.getStoreManager().getFunction(*ModInst->getFuncAddr(I));
+      EXPECT_TRUE(FuncInst->isCompiledFunction());
+      auto Res = VM.execute("f" + std::to_string(I));
+      ASSERT_TRUE(Res);
+      ASSERT_EQ(Res->size(), 1U);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 10U + I);
+    }
+  }
+}
+
 TEST(AsyncRunWsmFile, NativeInterruptTest) {
   WasmEdge::Configure Conf;
   Conf.getCompilerConfigure().setInterruptible(true);
@@ -5,12 +5,14 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -402,6 +404,43 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureSetMaxMemoryPage(Conf, 1234U);
   EXPECT_NE(WasmEdge_ConfigureGetMaxMemoryPage(ConfNull), 1234U);
   EXPECT_EQ(WasmEdge_ConfigureGetMaxMemoryPage(Conf), 1234U);
+  WasmEdge_ConfigureSetMaxMemory64Page(ConfNull, UINT64_C(0x100000000));
+  WasmEdge_ConfigureSetMaxMemory64Page(Conf, UINT64_C(0x100000000));
+  EXPECT_NE(WasmEdge_ConfigureGetMaxMemory64Page(ConfNull),
+            UINT64_C(0x100000000));
+  EXPECT_EQ(WasmEdge_ConfigureGetMaxMemory64Page(Conf), UINT64_C(0x100000000));
+  WasmEdge_ConfigureSetAOTCache(ConfNull, true);
+  WasmEdge_ConfigureSetAOTCache(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsAOTCache(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsAOTCache(Conf), true);
+  WasmEdge_ConfigureSetJIT(ConfNull, true);
+  WasmEdge_ConfigureSetJIT(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsJIT(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsJIT(Conf), true);
+  WasmEdge_ConfigureSetTieredThreshold(ConfNull, 1000);
+  WasmEdge_ConfigureSetTieredThreshold(Conf, 1000);
+  EXPECT_EQ(WasmEdge_ConfigureGetTieredThreshold(ConfNull), 0U);
+  EXPECT_EQ(WasmEdge_ConfigureGetTieredThreshold(Conf), 1000U);
+  WasmEdge_ConfigureSetLazyJIT(ConfNull, true);
+  WasmEdge_ConfigureSetLazyJIT(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsLazyJIT(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsLazyJIT(Conf), true);
+  WasmEdge_ConfigureLoaderSetParallelThreads(ConfNull, 4U);
+  WasmEdge_ConfigureLoaderSetParallelThreads(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureLoaderGetParallelThreads(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureLoaderGetParallelThreads(Conf), 4U);
+  WasmEdge_ConfigureLoaderSetLazyFunctionBody(ConfNull, true);
+  WasmEdge_ConfigureLoaderSetLazyFunctionBody(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureLoaderIsLazyFunctionBody(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureLoaderIsLazyFunctionBody(Conf));
+  WasmEdge_ConfigureLoaderSetFlatImageCache(ConfNull, true);
+  WasmEdge_ConfigureLoaderSetFlatImageCache(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureLoaderIsFlatImageCache(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureLoaderIsFlatImageCache(Conf));
+  WasmEdge_ConfigureLoaderSetFusedValidation(ConfNull, true);
+  WasmEdge_ConfigureLoaderSetFusedValidation(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureLoaderIsFusedValidation(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureLoaderIsFusedValidation(Conf));
   // Tests for AOT compiler configurations.
   WasmEdge_ConfigureCompilerSetOptimizationLevel(
       ConfNull, WasmEdge_CompilerOptimizationLevel_Os);
@@ -431,6 +470,27 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureCompilerSetInterruptible(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureCompilerIsInterruptible(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureCompilerIsInterruptible(Conf), true);
+  WasmEdge_ConfigureCompilerSetParallelThreads(ConfNull, 4U);
+  WasmEdge_ConfigureCompilerSetParallelThreads(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureCompilerGetParallelThreads(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetParallelThreads(Conf), 4U);
+  WasmEdge_ConfigureCompilerSetIncrementalCache(ConfNull, true);
+  WasmEdge_ConfigureCompilerSetIncrementalCache(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureCompilerIsIncrementalCache(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerIsIncrementalCache(Conf), true);
+  WasmEdge_ConfigureCompilerAddCPULevel(ConfNull,
+                                        WasmEdge_CompilerCPULevel_V3);
+  WasmEdge_ConfigureCompilerAddCPULevel(Conf, WasmEdge_CompilerCPULevel_V3);
+  EXPECT_FALSE(WasmEdge_ConfigureCompilerHasCPULevel(
+      ConfNull, WasmEdge_CompilerCPULevel_V3));
+  EXPECT_TRUE(WasmEdge_ConfigureCompilerHasCPULevel(
+      Conf, WasmEdge_CompilerCPULevel_V3));
+  EXPECT_FALSE(WasmEdge_ConfigureCompilerHasCPULevel(
+      Conf, WasmEdge_CompilerCPULevel_V4));
+  WasmEdge_ConfigureCompilerClearCPULevels(ConfNull);
+  WasmEdge_ConfigureCompilerClearCPULevels(Conf);
+  EXPECT_FALSE(WasmEdge_ConfigureCompilerHasCPULevel(
+      Conf, WasmEdge_CompilerCPULevel_V3));
   // Tests for Statistics configurations.
   WasmEdge_ConfigureStatisticsSetInstructionCounting(ConfNull, true);
   WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
@@ -451,6 +511,59 @@ TEST(APICoreTest, Configure) {
   EXPECT_TRUE(true);
 }
 
+TEST(APICoreTest, MemoryBudget) {
+  WasmEdge_MemoryBudgetContext *Budget = WasmEdge_MemoryBudgetCreate(1);
+  EXPECT_NE(Budget, nullptr);
+  WasmEdge_MemoryBudgetSetLimit(nullptr, 2);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetLimit(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetLimit(Budget), 1U);
+  WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureSetMemoryBudget(nullptr, Budget);
+  WasmEdge_ConfigureSetMemoryBudget(Conf, Budget);
+  WasmEdge_VMContext *VM1 = WasmEdge_VMCreate(Conf, nullptr);
+  WasmEdge_ImportObjectContext *ImpObj = createExternModule("extern");
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_VMRegisterModuleFromImport(VM1, ImpObj)));
+
+  // The test module has a memory with 1 page.
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromFile(VM1, TPath)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM1)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM1)));
+  EXPECT_EQ(WasmEdge_VMGetMemoryUsage(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_VMGetMemoryUsage(VM1), 1U);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetUsage(Budget), 1U);
+
+  // Only one VM can be alive on a thread. Share the budget with a VM on
+  // another thread.
+  std::thread([Conf, Budget, ImpObj]() {
+    WasmEdge_VMContext *VM2 = WasmEdge_VMCreate(Conf, nullptr);
+    EXPECT_TRUE(
+        WasmEdge_ResultOK(WasmEdge_VMRegisterModuleFromImport(VM2, ImpObj)));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromFile(VM2, TPath)));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM2)));
+    EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_MemoryLimitExceeded,
+                           WasmEdge_VMInstantiate(VM2)));
+    EXPECT_EQ(WasmEdge_VMGetMemoryUsage(VM2), 0U);
+
+    // Raise the limit and instantiate again.
+    WasmEdge_MemoryBudgetSetLimit(Budget, 2);
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM2)));
+    EXPECT_EQ(WasmEdge_VMGetMemoryUsage(VM2), 1U);
+    EXPECT_EQ(WasmEdge_MemoryBudgetGetUsage(Budget), 2U);
+    EXPECT_EQ(WasmEdge_MemoryBudgetGetPeak(Budget), 2U);
+    EXPECT_EQ(WasmEdge_VMGetMemoryPeak(VM2), 1U);
+    WasmEdge_VMDelete(VM2);
+  }).join();
+  WasmEdge_ConfigureDelete(Conf);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetUsage(Budget), 1U);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetPeak(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetPeak(Budget), 2U);
+  WasmEdge_VMDelete(VM1);
+  EXPECT_EQ(WasmEdge_MemoryBudgetGetUsage(Budget), 0U);
+  WasmEdge_ImportObjectDelete(ImpObj);
+  WasmEdge_MemoryBudgetDelete(Budget);
+}
+
 TEST(APICoreTest, FunctionType) {
   std::vector<WasmEdge_ValType> Param = {
       WasmEdge_ValType_I32,  WasmEdge_ValType_I64, WasmEdge_ValType_ExternRef,
@@ -487,8 +600,16 @@ TEST(APICoreTest, FunctionType) {
 }
 
 TEST(APICoreTest, TableType) {
-  WasmEdge_Limit Lim1 = {.HasMax = true, .Min = 10, .Max = 20};
-  WasmEdge_Limit Lim2 = {.HasMax = false, .Min = 30, .Max = 30};
+  WasmEdge_Limit Lim1 = {.HasMax = true,
+                         .Min = 10,
+                         .Max = 20,
+                         .Shared = false,
+                         .Is64 = false};
+  WasmEdge_Limit Lim2 = {.HasMax = false,
+                         .Min = 30,
+                         .Max = 30,
+                         .Shared = false,
+                         .Is64 = false};
   WasmEdge_TableTypeContext *TType =
       WasmEdge_TableTypeCreate(WasmEdge_RefType_ExternRef, Lim1);
   EXPECT_EQ(WasmEdge_TableTypeGetRefType(TType), WasmEdge_RefType_ExternRef);
@@ -506,8 +627,16 @@ TEST(APICoreTest, TableType) {
 }
 
 TEST(APICoreTest, MemoryType) {
-  WasmEdge_Limit Lim1 = {.HasMax = true, .Min = 10, .Max = 20};
-  WasmEdge_Limit Lim2 = {.HasMax = false, .Min = 30, .Max = 30};
+  WasmEdge_Limit Lim1 = {.HasMax = true,
+                         .Min = 10,
+                         .Max = 20,
+                         .Shared = false,
+                         .Is64 = false};
+  WasmEdge_Limit Lim2 = {.HasMax = false,
+                         .Min = 30,
+                         .Max = 30,
+                         .Shared = false,
+                         .Is64 = false};
   WasmEdge_MemoryTypeContext *MType = WasmEdge_MemoryTypeCreate(Lim1);
   EXPECT_TRUE(WasmEdge_LimitIsEqual(WasmEdge_MemoryTypeGetLimit(MType), Lim1));
   EXPECT_FALSE(
@@ -519,6 +648,10 @@ TEST(APICoreTest, MemoryType) {
   WasmEdge_MemoryTypeDelete(nullptr);
   WasmEdge_MemoryTypeDelete(MType);
   WasmEdge_MemoryTypeDelete(nullptr);
+  Lim1.Shared = true;
+  MType = WasmEdge_MemoryTypeCreate(Lim1);
+  EXPECT_TRUE(WasmEdge_LimitIsEqual(WasmEdge_MemoryTypeGetLimit(MType), Lim1));
+  WasmEdge_MemoryTypeDelete(MType);
 }
 
 TEST(APICoreTest, GlobalType) {
@@ -679,7 +812,7 @@ TEST(APICoreTest, ImportType) {
   EXPECT_EQ(WasmEdge_TableTypeGetRefType(
                 WasmEdge_ImportTypeGetTableType(Mod, ImpTypes[11])),
             WasmEdge_RefType_ExternRef);
-  Lim = {.HasMax = true, .Min = 10, .Max = 30};
+  Lim = {.HasMax = true, .Min = 10, .Max = 30, .Shared = false, .Is64 = false};
   EXPECT_TRUE(WasmEdge_LimitIsEqual(
       WasmEdge_TableTypeGetLimit(
           WasmEdge_ImportTypeGetTableType(Mod, ImpTypes[11])),
@@ -691,7 +824,7 @@ TEST(APICoreTest, ImportType) {
   EXPECT_EQ(WasmEdge_ImportTypeGetMemoryType(nullptr, ImpTypes[13]), nullptr);
   EXPECT_EQ(WasmEdge_ImportTypeGetMemoryType(Mod, ImpTypes[0]), nullptr);
   EXPECT_NE(WasmEdge_ImportTypeGetMemoryType(Mod, ImpTypes[13]), nullptr);
-  Lim = {.HasMax = false, .Min = 2, .Max = 2};
+  Lim = {.HasMax = false, .Min = 2, .Max = 2, .Shared = false, .Is64 = false};
   EXPECT_TRUE(WasmEdge_LimitIsEqual(
       WasmEdge_MemoryTypeGetLimit(
           WasmEdge_ImportTypeGetMemoryType(Mod, ImpTypes[13])),
@@ -835,7 +968,7 @@ TEST(APICoreTest, ExportType) {
   EXPECT_EQ(WasmEdge_TableTypeGetRefType(
                 WasmEdge_ExportTypeGetTableType(Mod, ExpTypes[12])),
             WasmEdge_RefType_ExternRef);
-  Lim = {.HasMax = false, .Min = 10, .Max = 10};
+  Lim = {.HasMax = false, .Min = 10, .Max = 10, .Shared = false, .Is64 = false};
   EXPECT_TRUE(WasmEdge_LimitIsEqual(
       WasmEdge_TableTypeGetLimit(
           WasmEdge_ExportTypeGetTableType(Mod, ExpTypes[12])),
@@ -847,7 +980,7 @@ TEST(APICoreTest, ExportType) {
   EXPECT_EQ(WasmEdge_ExportTypeGetMemoryType(nullptr, ExpTypes[13]), nullptr);
   EXPECT_EQ(WasmEdge_ExportTypeGetMemoryType(Mod, ExpTypes[0]), nullptr);
   EXPECT_NE(WasmEdge_ExportTypeGetMemoryType(Mod, ExpTypes[13]), nullptr);
-  Lim = {.HasMax = true, .Min = 1, .Max = 3};
+  Lim = {.HasMax = true, .Min = 1, .Max = 3, .Shared = false, .Is64 = false};
   EXPECT_TRUE(WasmEdge_LimitIsEqual(
       WasmEdge_MemoryTypeGetLimit(
           WasmEdge_ExportTypeGetMemoryType(Mod, ExpTypes[13])),
@@ -1000,6 +1133,93 @@ TEST(APICoreTest, Loader) {
                                      static_cast<uint32_t>(Buf.size()))));
 #endif
 
+  // Parse from the streamed chunks
+  WasmEdge_LoaderStreamContext *Stream = WasmEdge_LoaderStreamCreate(Conf);
+  EXPECT_NE(Stream, nullptr);
+  EXPECT_TRUE(readToVector(TPath, Buf));
+  for (size_t I = 0; I < Buf.size(); I += 7) {
+    const auto Len = static_cast<uint32_t>(std::min<size_t>(7, Buf.size() - I));
+    EXPECT_TRUE(
+        WasmEdge_ResultOK(WasmEdge_LoaderStreamPush(Stream, &Buf[I], Len)));
+  }
+  Mod = nullptr;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderStreamFinish(Stream, ModPtr)));
+  EXPECT_NE(Mod, nullptr);
+  WasmEdge_ASTModuleDelete(Mod);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_LoaderStreamPush(nullptr, Buf.data(), 8)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_LoaderStreamFinish(Stream, nullptr)));
+  // Truncated binary is reported when finishing.
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderStreamPush(
+      Stream, Buf.data(), static_cast<uint32_t>(Buf.size() - 1))));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_UnexpectedEnd,
+                         WasmEdge_LoaderStreamFinish(Stream, ModPtr)));
+  WasmEdge_LoaderStreamDelete(Stream);
+  WasmEdge_LoaderStreamDelete(nullptr);
+
+  // Custom section contents of the modules parsed from buffer and file
+  std::vector<uint8_t> CustomBuf = {
+      0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, // Header
+      0x00U, 0x06U, 0x02U, 0x6EU, 0x6DU, 0x01U, 0x02U, 0x03U  // Custom "nm"
+  };
+  const uint8_t *Content = nullptr;
+  uint32_t ContentLen = 0;
+  Mod = nullptr;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderParseFromBuffer(
+      Loader, ModPtr, CustomBuf.data(),
+      static_cast<uint32_t>(CustomBuf.size()))));
+  EXPECT_EQ(WasmEdge_ASTModuleListCustomSectionsLength(Mod), 1U);
+  EXPECT_EQ(WasmEdge_ASTModuleListCustomSectionsLength(nullptr), 0U);
+  WasmEdge_String SecName = WasmEdge_ASTModuleGetCustomSectionName(Mod, 0);
+  EXPECT_EQ(std::string_view(SecName.Buf, SecName.Length), "nm");
+  EXPECT_EQ(WasmEdge_ASTModuleGetCustomSectionName(Mod, 1).Buf, nullptr);
+  // The content is got from the buffer the module is parsed from.
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_UnexpectedEnd,
+                         WasmEdge_ASTModuleGetCustomSectionContent(
+                             Mod, 0, nullptr, 0, &Content, &ContentLen)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_ASTModuleGetCustomSectionContent(
+      Mod, 0, CustomBuf.data(), static_cast<uint32_t>(CustomBuf.size()),
+      &Content, &ContentLen)));
+  EXPECT_EQ(Content, CustomBuf.data() + 13);
+  EXPECT_EQ(ContentLen, 3U);
+  {
+    auto OtherBuf = CustomBuf;
+    OtherBuf.back() = 0x04U;
+    EXPECT_TRUE(isErrMatch(
+        WasmEdge_ErrCode_InvalidSection,
+        WasmEdge_ASTModuleGetCustomSectionContent(
+            Mod, 0, OtherBuf.data(), static_cast<uint32_t>(OtherBuf.size()),
+            &Content, &ContentLen)));
+  }
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ASTModuleGetCustomSectionContent(
+                             Mod, 1, nullptr, 0, &Content, &ContentLen)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ASTModuleGetCustomSectionContent(
+                             Mod, 0, nullptr, 0, nullptr, &ContentLen)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ASTModuleGetCustomSectionContent(
+                             nullptr, 0, nullptr, 0, &Content, &ContentLen)));
+  WasmEdge_ASTModuleDelete(Mod);
+  {
+    std::ofstream Fout("apiTestCustomSection.wasm", std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(CustomBuf.data()),
+               static_cast<std::streamsize>(CustomBuf.size()));
+  }
+  Mod = nullptr;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderParseFromFile(
+      Loader, ModPtr, "apiTestCustomSection.wasm")));
+  std::remove("apiTestCustomSection.wasm");
+  // The content is kept in the module parsed from file.
+  ContentLen = 0;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_ASTModuleGetCustomSectionContent(
+      Mod, 0, nullptr, 0, &Content, &ContentLen)));
+  ASSERT_EQ(ContentLen, 3U);
+  EXPECT_EQ(std::vector<uint8_t>(Content, Content + ContentLen),
+            (std::vector<uint8_t>{0x01U, 0x02U, 0x03U}));
+  WasmEdge_ASTModuleDelete(Mod);
+
   // AST module deletion
   WasmEdge_ASTModuleDelete(nullptr);
   EXPECT_TRUE(true);
@@ -1033,11 +1253,93 @@ TEST(APICoreTest, Validator) {
   EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
                          WasmEdge_ValidatorValidate(nullptr, nullptr)));
 
+  // Validation with threads
+  WasmEdge_ConfigureLoaderSetParallelThreads(Conf, 4U);
+  WasmEdge_ValidatorContext *ParValidator = WasmEdge_ValidatorCreate(Conf);
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_ValidatorValidate(ParValidator, Mod)));
+  WasmEdge_ValidatorDelete(ParValidator);
+
   WasmEdge_ASTModuleDelete(Mod);
   WasmEdge_ValidatorDelete(Validator);
   WasmEdge_ConfigureDelete(Conf);
 }
 
+TEST(APICoreTest, ValidatorParallel) {
+  // Module of 64 functions of type () -> () with the given bodies.
+  auto MakeWasm = [](const std::vector<std::vector<uint8_t>> &Bodies) {
+    std::vector<uint8_t> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U,
+                                 0x00U, 0x00U, 0x01U, 0x04U, 0x01U, 0x60U,
+                                 0x00U, 0x00U, 0x03U, 0x41U, 0x40U};
+    Wasm.insert(Wasm.end(), Bodies.size(), 0x00U);
+    std::vector<uint8_t> Code = {static_cast<uint8_t>(Bodies.size())};
+    for (const auto &Body : Bodies) {
+      Code.push_back(static_cast<uint8_t>(Body.size()));
+      Code.insert(Code.end(), Body.begin(), Body.end());
+    }
+    Wasm.push_back(0x0AU);
+    for (uint32_t Size = static_cast<uint32_t>(Code.size()); true;
+         Size >>= 7) {
+      if (Size < 0x80U) {
+        Wasm.push_back(static_cast<uint8_t>(Size));
+        break;
+      }
+      Wasm.push_back(static_cast<uint8_t>(Size | 0x80U));
+    }
+    Wasm.insert(Wasm.end(), Code.begin(), Code.end());
+    return Wasm;
+  };
+  // Validate the module sequentially and with threads, and get the results.
+  auto Validate = [](const std::vector<uint8_t> &Wasm, uint32_t Threads) {
+    WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
+    WasmEdge_ConfigureLoaderSetParallelThreads(Conf, Threads);
+    WasmEdge_LoaderContext *Loader = WasmEdge_LoaderCreate(Conf);
+    WasmEdge_ValidatorContext *Validator = WasmEdge_ValidatorCreate(Conf);
+    WasmEdge_ASTModuleContext *Mod = nullptr;
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderParseFromBuffer(
+        Loader, &Mod, Wasm.data(), static_cast<uint32_t>(Wasm.size()))));
+    WasmEdge_Result Res = WasmEdge_ValidatorValidate(Validator, Mod);
+    WasmEdge_ASTModuleDelete(Mod);
+    WasmEdge_ValidatorDelete(Validator);
+    WasmEdge_LoaderDelete(Loader);
+    WasmEdge_ConfigureDelete(Conf);
+    return Res;
+  };
+
+  // (func) for the valid bodies.
+  std::vector<std::vector<uint8_t>> Bodies(64, {0x00U, 0x01U, 0x0BU});
+  // (func (drop (local.get 5)))
+  Bodies[20] = {0x00U, 0x20U, 0x05U, 0x1AU, 0x0BU};
+  // (func (i32.const 0))
+  Bodies[30] = {0x00U, 0x41U, 0x00U, 0x0BU};
+  // (func (call 99))
+  Bodies[50] = {0x00U, 0x10U, 0x63U, 0x0BU};
+
+  // The error of the lowest function index is returned as the sequential
+  // validation does, whichever worker finds its error first.
+  auto Wasm = MakeWasm(Bodies);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_InvalidLocalIdx, Validate(Wasm, 0)));
+  for (uint32_t I = 0; I < 8; ++I) {
+    EXPECT_TRUE(
+        isErrMatch(WasmEdge_ErrCode_InvalidLocalIdx, Validate(Wasm, 4)));
+  }
+  Bodies[20] = {0x00U, 0x01U, 0x0BU};
+  Wasm = MakeWasm(Bodies);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_TypeCheckFailed, Validate(Wasm, 0)));
+  for (uint32_t I = 0; I < 8; ++I) {
+    EXPECT_TRUE(
+        isErrMatch(WasmEdge_ErrCode_TypeCheckFailed, Validate(Wasm, 4)));
+  }
+  Bodies[30] = {0x00U, 0x01U, 0x0BU};
+  Wasm = MakeWasm(Bodies);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_InvalidFuncIdx, Validate(Wasm, 0)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_InvalidFuncIdx, Validate(Wasm, 4)));
+  Bodies[50] = {0x00U, 0x01U, 0x0BU};
+  Wasm = MakeWasm(Bodies);
+  EXPECT_TRUE(WasmEdge_ResultOK(Validate(Wasm, 0)));
+  EXPECT_TRUE(WasmEdge_ResultOK(Validate(Wasm, 4)));
+}
+
 TEST(APICoreTest, ExecutorWithStatistics) {
   // Create contexts
   WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
@@ -1832,7 +2134,11 @@ TEST(APICoreTest, Instance) {
   EXPECT_EQ(TabCxt, nullptr);
   TabType = WasmEdge_TableTypeCreate(
       WasmEdge_RefType_ExternRef,
-      WasmEdge_Limit{.HasMax = false, .Min = 10, .Max = 10});
+      WasmEdge_Limit{.HasMax = false,
+                     .Min = 10,
+                     .Max = 10,
+                     .Shared = false,
+                     .Is64 = false});
   TabCxt = WasmEdge_TableInstanceCreate(TabType);
   WasmEdge_TableTypeDelete(TabType);
   EXPECT_NE(TabCxt, nullptr);
@@ -1840,7 +2146,11 @@ TEST(APICoreTest, Instance) {
   EXPECT_TRUE(true);
   TabType = WasmEdge_TableTypeCreate(
       WasmEdge_RefType_ExternRef,
-      WasmEdge_Limit{.HasMax = true, .Min = 10, .Max = 20});
+      WasmEdge_Limit{.HasMax = true,
+                     .Min = 10,
+                     .Max = 20,
+                     .Shared = false,
+                     .Is64 = false});
   TabCxt = WasmEdge_TableInstanceCreate(TabType);
   WasmEdge_TableTypeDelete(TabType);
   EXPECT_NE(TabCxt, nullptr);
@@ -1908,14 +2218,22 @@ TEST(APICoreTest, Instance) {
   MemCxt = WasmEdge_MemoryInstanceCreate(nullptr);
   EXPECT_EQ(MemCxt, nullptr);
   MemType = WasmEdge_MemoryTypeCreate(
-      WasmEdge_Limit{.HasMax = false, .Min = 1, .Max = 1});
+      WasmEdge_Limit{.HasMax = false,
+                     .Min = 1,
+                     .Max = 1,
+                     .Shared = false,
+                     .Is64 = false});
   MemCxt = WasmEdge_MemoryInstanceCreate(MemType);
   WasmEdge_MemoryTypeDelete(MemType);
   EXPECT_NE(MemCxt, nullptr);
   WasmEdge_MemoryInstanceDelete(MemCxt);
   EXPECT_TRUE(true);
   MemType = WasmEdge_MemoryTypeCreate(
-      WasmEdge_Limit{.HasMax = true, .Min = 1, .Max = 3});
+      WasmEdge_Limit{.HasMax = true,
+                     .Min = 1,
+                     .Max = 3,
+                     .Shared = false,
+                     .Is64 = false});
   MemCxt = WasmEdge_MemoryInstanceCreate(MemType);
   WasmEdge_MemoryTypeDelete(MemType);
   EXPECT_NE(MemCxt, nullptr);
@@ -2146,7 +2464,11 @@ TEST(APICoreTest, ImportObject) {
   WasmEdge_FunctionTypeDelete(HostFType);
 
   // Add host table "table"
-  WasmEdge_Limit TabLimit = {.HasMax = true, .Min = 10, .Max = 20};
+  WasmEdge_Limit TabLimit = {.HasMax = true,
+                             .Min = 10,
+                             .Max = 20,
+                             .Shared = false,
+                             .Is64 = false};
   HostTType = WasmEdge_TableTypeCreate(WasmEdge_RefType_FuncRef, TabLimit);
   HostTable = WasmEdge_TableInstanceCreate(HostTType);
   HostName = WasmEdge_StringCreateByCString("table");
@@ -2160,7 +2482,11 @@ TEST(APICoreTest, ImportObject) {
   WasmEdge_StringDelete(HostName);
 
   // Add host memory "memory"
-  WasmEdge_Limit MemLimit = {.HasMax = true, .Min = 1, .Max = 2};
+  WasmEdge_Limit MemLimit = {.HasMax = true,
+                             .Min = 1,
+                             .Max = 2,
+                             .Shared = false,
+                             .Is64 = false};
   HostMType = WasmEdge_MemoryTypeCreate(MemLimit);
   HostMemory = WasmEdge_MemoryInstanceCreate(HostMType);
   HostName = WasmEdge_StringCreateByCString("memory");
@@ -2252,6 +2578,82 @@ TEST(APICoreTest, ImportObject) {
   WasmEdge_VMDelete(VM);
 }
 
+TEST(APICoreTest, DataSegmentFromFile) {
+  // Generate a module whose data segment is equally aligned in the file and
+  // in the memory, so the whole pages of it are mapped from the file.
+  const uint32_t Offset = 65536 - 50, Len = 2 * 65536 + 100;
+  auto pushU32 = [](std::vector<uint8_t> &Vec, uint32_t Val) {
+    // Padded to 5 bytes to fix the length.
+    for (uint32_t I = 0; I < 4; I++) {
+      Vec.push_back(static_cast<uint8_t>((Val & 0x7FU) | 0x80U));
+      Val >>= 7;
+    }
+    Vec.push_back(static_cast<uint8_t>(Val));
+  };
+  std::vector<uint8_t> Wasm = {
+      0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, // Header
+      0x05U, 0x03U, 0x01U, 0x00U, 0x04U,                      // Memory 4
+      0x07U, 0x07U, 0x01U, 0x03U, 0x6DU, 0x65U, 0x6DU, 0x02U, 0x00U // Export
+  };
+  // The data starts at 20 bytes after the data section. Pad with a custom
+  // section with an empty name.
+  const uint32_t DataSecPos = (Offset - 20) % 65536;
+  Wasm.push_back(0x00U);
+  pushU32(Wasm, DataSecPos - static_cast<uint32_t>(Wasm.size()) - 5);
+  Wasm.resize(DataSecPos, 0x00U);
+  Wasm.push_back(0x0BU);
+  pushU32(Wasm, Len + 14);
+  Wasm.insert(Wasm.end(), {0x01U, 0x00U, 0x41U});
+  pushU32(Wasm, Offset);
+  Wasm.push_back(0x0BU);
+  pushU32(Wasm, Len);
+  for (uint32_t I = 0; I < Len; I++) {
+    Wasm.push_back(static_cast<uint8_t>(I * 7 % 251));
+  }
+  const char *Path = "dataSegmentFromFile.wasm";
+  {
+    std::ofstream F(Path, std::ios::binary);
+    F.write(reinterpret_cast<const char *>(Wasm.data()),
+            static_cast<std::streamsize>(Wasm.size()));
+  }
+
+  WasmEdge_String MemName = WasmEdge_StringCreateByCString("mem");
+  std::vector<uint8_t> Buf(Len + 20), Expected(Len + 20, 0x00U);
+  std::copy(Wasm.end() - Len, Wasm.end(), Expected.begin() + 10);
+  WasmEdge_VMContext *VM1 = WasmEdge_VMCreate(nullptr, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromFile(VM1, Path)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM1)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM1)));
+  WasmEdge_MemoryInstanceContext *MemCxt =
+      WasmEdge_StoreFindMemory(WasmEdge_VMGetStoreContext(VM1), MemName);
+  ASSERT_NE(MemCxt, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGetData(
+      MemCxt, Buf.data(), Offset - 10, Len + 20)));
+  EXPECT_EQ(Buf, Expected);
+
+  // Writing the memory should not affect the file and the other instances.
+  std::fill(Buf.begin(), Buf.end(), 0xFFU);
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceSetData(MemCxt, Buf.data(), Offset - 10, Len)));
+  // Only one VM can be alive on a thread.
+  WasmEdge_VMDelete(VM1);
+  WasmEdge_VMContext *VM2 = WasmEdge_VMCreate(nullptr, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromFile(VM2, Path)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM2)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM2)));
+  MemCxt = WasmEdge_StoreFindMemory(WasmEdge_VMGetStoreContext(VM2), MemName);
+  ASSERT_NE(MemCxt, nullptr);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGetData(
+      MemCxt, Buf.data(), Offset - 10, Len + 20)));
+  EXPECT_EQ(Buf, Expected);
+  std::vector<uint8_t> File;
+  EXPECT_TRUE(readToVector(Path, File));
+  EXPECT_EQ(File, Wasm);
+  WasmEdge_VMDelete(VM2);
+  WasmEdge_StringDelete(MemName);
+  std::remove(Path);
+}
+
 TEST(APICoreTest, Async) {
   WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
   WasmEdge_ImportObjectContext *ImpObj = createExternModule("extern");
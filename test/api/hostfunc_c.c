@@ -149,7 +149,11 @@ WasmEdge_ImportObjectContext *createSpecTestModule(void) {
   WasmEdge_StringDelete(HostName);
 
   // Add host table "table"
-  WasmEdge_Limit TabLimit = {.HasMax = true, .Min = 10, .Max = 20};
+  WasmEdge_Limit TabLimit = {.HasMax = true,
+                             .Min = 10,
+                             .Max = 20,
+                             .Shared = false,
+                             .Is64 = false};
   HostTType = WasmEdge_TableTypeCreate(WasmEdge_RefType_FuncRef, TabLimit);
   HostTable = WasmEdge_TableInstanceCreate(HostTType);
   WasmEdge_TableTypeDelete(HostTType);
@@ -158,7 +162,11 @@ WasmEdge_ImportObjectContext *createSpecTestModule(void) {
   WasmEdge_StringDelete(HostName);
 
   // Add host memory "memory"
-  WasmEdge_Limit MemLimit = {.HasMax = true, .Min = 1, .Max = 2};
+  WasmEdge_Limit MemLimit = {.HasMax = true,
+                             .Min = 1,
+                             .Max = 2,
+                             .Shared = false,
+                             .Is64 = false};
   HostMType = WasmEdge_MemoryTypeCreate(MemLimit);
   HostMemory = WasmEdge_MemoryInstanceCreate(HostMType);
   WasmEdge_MemoryTypeDelete(HostMType);
@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/configure.h"
+#include "common/statistics.h"
+#include "executor/executor.h"
+#include "loader/loader.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+#include "runtime/storemgr.h"
+#include "validator/validator.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+
+// (func (export "loop") (param i32)
+//   (loop (br_if 0 (local.tee 0 (i32.sub (local.get 0) (i32.const 1))))))
+// (func (export "call"))
+const std::array<Byte, 61> HotWasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x08U,
+    0x02U, 0x60U, 0x01U, 0x7FU, 0x00U, 0x60U, 0x00U, 0x00U, 0x03U, 0x03U,
+    0x02U, 0x00U, 0x01U, 0x07U, 0x0FU, 0x02U, 0x04U, 0x6CU, 0x6FU, 0x6FU,
+    0x70U, 0x00U, 0x00U, 0x04U, 0x63U, 0x61U, 0x6CU, 0x6CU, 0x00U, 0x01U,
+    0x0AU, 0x13U, 0x02U, 0x0EU, 0x00U, 0x03U, 0x40U, 0x20U, 0x00U, 0x41U,
+    0x01U, 0x6BU, 0x22U, 0x00U, 0x0DU, 0x00U, 0x0BU, 0x0BU, 0x02U, 0x00U,
+    0x0BU};
+
+// (import "host" "add" (func (param i32 i32) (result i32)))
+// (memory 1)
+const std::array<Byte, 36> HostImportWasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x07U,
+    0x01U, 0x60U, 0x02U, 0x7FU, 0x7FU, 0x01U, 0x7FU, 0x02U, 0x0CU, 0x01U,
+    0x04U, 0x68U, 0x6FU, 0x73U, 0x74U, 0x03U, 0x61U, 0x64U, 0x64U, 0x00U,
+    0x00U, 0x05U, 0x03U, 0x01U, 0x00U, 0x01U};
+
+// (memory i64 1 65537)
+// (func (export "grow") (result i64) (memory.grow (i64.const 65536)))
+// (func (export "size") (result i64) (memory.size))
+// (func (export "store") (param i64 i64)
+//   (i64.store (local.get 0) (local.get 1)))
+// (func (export "load") (param i64) (result i64) (i64.load (local.get 0)))
+// (func (export "loadOff") (param i64) (result i64)
+//   (i64.load offset=0x100000000 (local.get 0)))
+const std::array<Byte, 130> Memory64Wasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x0FU,
+    0x03U, 0x60U, 0x00U, 0x01U, 0x7EU, 0x60U, 0x02U, 0x7EU, 0x7EU, 0x00U,
+    0x60U, 0x01U, 0x7EU, 0x01U, 0x7EU, 0x03U, 0x06U, 0x05U, 0x00U, 0x00U,
+    0x01U, 0x02U, 0x02U, 0x05U, 0x06U, 0x01U, 0x05U, 0x01U, 0x81U, 0x80U,
+    0x04U, 0x07U, 0x28U, 0x05U, 0x04U, 0x67U, 0x72U, 0x6FU, 0x77U, 0x00U,
+    0x00U, 0x04U, 0x73U, 0x69U, 0x7AU, 0x65U, 0x00U, 0x01U, 0x05U, 0x73U,
+    0x74U, 0x6FU, 0x72U, 0x65U, 0x00U, 0x02U, 0x04U, 0x6CU, 0x6FU, 0x61U,
+    0x64U, 0x00U, 0x03U, 0x07U, 0x6CU, 0x6FU, 0x61U, 0x64U, 0x4FU, 0x66U,
+    0x66U, 0x00U, 0x04U, 0x0AU, 0x2DU, 0x05U, 0x08U, 0x00U, 0x42U, 0x80U,
+    0x80U, 0x04U, 0x40U, 0x00U, 0x0BU, 0x04U, 0x00U, 0x3FU, 0x00U, 0x0BU,
+    0x09U, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x37U, 0x03U, 0x00U, 0x0BU,
+    0x07U, 0x00U, 0x20U, 0x00U, 0x29U, 0x03U, 0x00U, 0x0BU, 0x0BU, 0x00U,
+    0x20U, 0x00U, 0x29U, 0x03U, 0x80U, 0x80U, 0x80U, 0x80U, 0x10U, 0x0BU};
+
+class HostAdd : public Runtime::HostFunction<HostAdd> {
+public:
+  HostAdd(const uint64_t Cost = 0) : HostFunction(Cost) {}
+  Expect<uint32_t> body(Runtime::Instance::MemoryInstance *, uint32_t A,
+                        uint32_t B) {
+    if (A == UINT32_MAX) {
+      return Unexpect(ErrCode::ExecutionFailed);
+    }
+    return A + B;
+  }
+};
+
+class HostModule : public Runtime::ImportObject {
+public:
+  HostModule(const uint64_t Cost) : ImportObject("host") {
+    addHostFunc("add", std::make_unique<HostAdd>(Cost));
+  }
+};
+
+// The intrinsics table of the modules marked as compiled.
+const AST::Module::IntrinsicsTable *IntrinsicsPtr =
+    &Executor::Executor::Intrinsics;
+
+// (func (result i32) (i32.const 7))
+// (func (export "f") (result i32) (i32.const 42))
+// (memory 1)
+const std::array<Byte, 45> CalleeWasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x05U,
+    0x01U, 0x60U, 0x00U, 0x01U, 0x7FU, 0x03U, 0x03U, 0x02U, 0x00U, 0x00U,
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, 0x07U, 0x05U, 0x01U, 0x01U, 0x66U,
+    0x00U, 0x01U, 0x0AU, 0x0BU, 0x02U, 0x04U, 0x00U, 0x41U, 0x07U, 0x0BU,
+    0x04U, 0x00U, 0x41U, 0x2AU, 0x0BU};
+
+// (import "host" "add" (func (param i32 i32) (result i32)))
+// (import "callee" "f" (func (result i32)))
+// (func (export "g") (result i32) (i32.const 0))
+// (memory 1)
+const std::array<Byte, 70> CallerWasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x0BU,
+    0x02U, 0x60U, 0x00U, 0x01U, 0x7FU, 0x60U, 0x02U, 0x7FU, 0x7FU, 0x01U,
+    0x7FU, 0x02U, 0x17U, 0x02U, 0x04U, 0x68U, 0x6FU, 0x73U, 0x74U, 0x03U,
+    0x61U, 0x64U, 0x64U, 0x00U, 0x01U, 0x06U, 0x63U, 0x61U, 0x6CU, 0x6CU,
+    0x65U, 0x65U, 0x01U, 0x66U, 0x00U, 0x00U, 0x03U, 0x02U, 0x01U, 0x00U,
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, 0x07U, 0x05U, 0x01U, 0x01U, 0x67U,
+    0x00U, 0x02U, 0x0AU, 0x06U, 0x01U, 0x04U, 0x00U, 0x41U, 0x00U, 0x0BU};
+
+// The execution context passed to the compiled functions, in the layout of
+// the executor. Only the import entries are read by the stubs below.
+struct StubContext {
+  void *Data[7];
+  const Runtime::Instance::ModuleInstance::FuncImportEntry *FuncImports;
+};
+
+template <typename... ArgsT>
+void callIntrinsic(AST::Module::Intrinsics Id, ArgsT... Args) {
+  reinterpret_cast<void (*)(ArgsT...)>(
+      Executor::Executor::Intrinsics[uint8_t(Id)])(Args...);
+}
+
+// The fake compiled callee returns the value its code points to.
+void constWrapper(void *, void *Code, const ValVariant *, ValVariant *Rets) {
+  Rets[0] = *static_cast<const uint32_t *>(Code);
+}
+
+// The fake compiled caller enters the module of the imported function 1 as
+// its import stub does, calls the function 0 of that module, leaves it, and
+// then calls the imported function 1 itself.
+void stubWrapper(void *ExecCtx, void *, const ValVariant *, ValVariant *Rets) {
+  const auto &Entry = static_cast<StubContext *>(ExecCtx)->FuncImports[1];
+  ValVariant Callee, Caller;
+  callIntrinsic(AST::Module::Intrinsics::kEnterModule, Entry.ModuleAddr);
+  callIntrinsic(AST::Module::Intrinsics::kCall, UINT32_C(0),
+                static_cast<const ValVariant *>(nullptr), &Callee);
+  callIntrinsic(AST::Module::Intrinsics::kLeaveModule);
+  callIntrinsic(AST::Module::Intrinsics::kCall, UINT32_C(1),
+                static_cast<const ValVariant *>(nullptr), &Caller);
+  Rets[0] = Callee.get<uint32_t>() * 100 + Caller.get<uint32_t>();
+}
+
+std::unique_ptr<AST::Module> parseAndValidate(const Configure &Conf,
+                                              Span<const Byte> Wasm) {
+  Loader::Loader Ldr(Conf);
+  auto Mod = Ldr.parseModule(Wasm);
+  EXPECT_TRUE(Mod);
+  if (!Mod) {
+    return nullptr;
+  }
+  Validator::Validator Valid(Conf);
+  EXPECT_TRUE(Valid.validate(**Mod));
+  return std::move(*Mod);
+}
+
+TEST(ExecutorTest, HotFunction__Threshold) {
+  Configure Conf;
+  Conf.getRuntimeConfigure().setTieredThreshold(4);
+  auto Mod = parseAndValidate(Conf, HotWasm);
+  ASSERT_TRUE(Mod);
+
+  Runtime::StoreManager StoreMgr;
+  Executor::Executor Exec(Conf);
+  std::vector<const Runtime::Instance::FunctionInstance *> Fired;
+  Exec.setHotFunctionHandler(
+      [&Fired](Runtime::StoreManager &,
+               const Runtime::Instance::FunctionInstance &Func) {
+        Fired.push_back(&Func);
+      });
+  ASSERT_TRUE(Exec.instantiateModule(StoreMgr, std::move(Mod)));
+  auto *ModInst = *StoreMgr.getActiveModule();
+  const auto LoopAddr = *ModInst->findFuncExports("loop"sv);
+  const auto CallAddr = *ModInst->findFuncExports("call"sv);
+  const auto *LoopFunc = *StoreMgr.getFunction(LoopAddr);
+  const auto *CallFunc = *StoreMgr.getFunction(CallAddr);
+
+  // The calls are counted.
+  for (uint32_t I = 0; I < 3; ++I) {
+    ASSERT_TRUE(Exec.invoke(StoreMgr, CallAddr, {}, {}));
+  }
+  EXPECT_TRUE(Fired.empty());
+  ASSERT_TRUE(Exec.invoke(StoreMgr, CallAddr, {}, {}));
+  ASSERT_EQ(Fired.size(), 1U);
+  EXPECT_EQ(Fired[0], CallFunc);
+  for (uint32_t I = 0; I < 10; ++I) {
+    ASSERT_TRUE(Exec.invoke(StoreMgr, CallAddr, {}, {}));
+  }
+  EXPECT_EQ(Fired.size(), 1U);
+
+  // The call and the 2 loop iterations are counted.
+  const std::array<ValType, 1> Types{ValType::I32};
+  const std::array<ValVariant, 1> Three{UINT32_C(3)};
+  ASSERT_TRUE(Exec.invoke(StoreMgr, LoopAddr, Three, Types));
+  EXPECT_EQ(Fired.size(), 1U);
+  const std::array<ValVariant, 1> One{UINT32_C(1)};
+  ASSERT_TRUE(Exec.invoke(StoreMgr, LoopAddr, One, Types));
+  ASSERT_EQ(Fired.size(), 2U);
+  EXPECT_EQ(Fired[1], LoopFunc);
+  const std::array<ValVariant, 1> Many{UINT32_C(100)};
+  ASSERT_TRUE(Exec.invoke(StoreMgr, LoopAddr, Many, Types));
+  EXPECT_EQ(Fired.size(), 2U);
+}
+
+TEST(ExecutorTest, HotFunction__Concurrent) {
+  Configure Conf;
+  auto Mod = parseAndValidate(Conf, HotWasm);
+  ASSERT_TRUE(Mod);
+  const auto &Code = Mod->getCodeSection().getContent()[1];
+  const Runtime::Instance::FunctionInstance Func(
+      0, Mod->getTypeSection().getContent()[1], 1, Code.getLocals(),
+      Code.getExpr());
+  EXPECT_EQ(Func.getCodeIdx(), 1U);
+
+  // Only one of the concurrent counts reaches the threshold.
+  std::atomic<uint32_t> Reached = 0;
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < 8; ++I) {
+    Threads.emplace_back([&Func, &Reached]() {
+      for (uint32_t J = 0; J < 1000; ++J) {
+        if (Func.countHot(4000)) {
+          ++Reached;
+        }
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Reached.load(), 1U);
+  EXPECT_FALSE(Func.countHot(4000));
+}
+
+TEST(ExecutorTest, TieredCode__Publish) {
+  Configure Conf;
+  auto Mod = parseAndValidate(Conf, HotWasm);
+  ASSERT_TRUE(Mod);
+  const auto &Code = Mod->getCodeSection().getContent()[1];
+  Runtime::Instance::FunctionInstance Func(
+      0, Mod->getTypeSection().getContent()[1], 1, Code.getLocals(),
+      Code.getExpr());
+  EXPECT_EQ(Func.getTieredCode(), nullptr);
+
+  // The code set on a thread is seen completely by the readers.
+  static uint8_t Marker = 0;
+  auto Tiered = std::make_shared<const AST::Module::CompiledCode>(
+      AST::Module::CompiledCode{{}, Symbol<void>(&Marker)});
+  const auto *Expected = Tiered.get();
+  std::thread Writer(
+      [&Func, &Tiered]() { Func.setTieredCode(std::move(Tiered)); });
+  const Runtime::Instance::FunctionInstance::TieredCode *Seen = nullptr;
+  while (!(Seen = Func.getTieredCode())) {
+    std::this_thread::yield();
+  }
+  Writer.join();
+  EXPECT_EQ(Seen, Expected);
+  EXPECT_EQ(Seen->Code.get(), &Marker);
+  EXPECT_FALSE(Seen->Wrapper);
+
+  // The moved instance keeps the code.
+  Runtime::Instance::FunctionInstance Moved(std::move(Func));
+  EXPECT_EQ(Moved.getTieredCode(), Expected);
+}
+
+TEST(ExecutorTest, HostFunction__NativeEntry) {
+  HostAdd Add;
+  const auto Entry = Add.getNativeEntry();
+  ASSERT_NE(Entry, nullptr);
+  std::array<ValVariant, 2> Args{UINT32_C(40), UINT32_C(2)};
+  std::array<ValVariant, 1> Rets{UINT32_C(0)};
+  EXPECT_EQ(Entry(&Add, nullptr, Args.data(), Rets.data()), ErrCode::Success);
+  EXPECT_EQ(Rets[0].get<uint32_t>(), 42U);
+
+  // The errors of the host function are returned as the codes to trap with.
+  Args[0] = UINT32_MAX;
+  EXPECT_EQ(Entry(&Add, nullptr, Args.data(), Rets.data()),
+            ErrCode::ExecutionFailed);
+}
+
+TEST(ExecutorTest, FuncImport__HostEntry) {
+  // Instantiate the compiled module importing the host function, and check
+  // whether the native entry is called directly.
+  auto IsDirect = [](const Configure &Conf, Statistics::Statistics *Stat,
+                     const uint64_t Cost) {
+    auto Mod = parseAndValidate(Conf, HostImportWasm);
+    if (!Mod) {
+      return false;
+    }
+    Mod->setSymbol(
+        Symbol<const AST::Module::IntrinsicsTable *>(&IntrinsicsPtr));
+    HostModule Host(Cost);
+    Runtime::StoreManager StoreMgr;
+    Executor::Executor Exec(Conf, Stat);
+    EXPECT_TRUE(Exec.registerModule(StoreMgr, Host));
+    EXPECT_TRUE(Exec.instantiateModule(StoreMgr, *Mod));
+    const auto *ModInst = *StoreMgr.getActiveModule();
+    EXPECT_EQ(ModInst->FuncImportEntries.size(), 1U);
+    const auto &Entry = ModInst->FuncImportEntries[0];
+    EXPECT_EQ(Entry.Symbol, nullptr);
+    if (!Entry.Entry) {
+      EXPECT_EQ(Entry.Func, nullptr);
+      return false;
+    }
+    const auto *FuncInst = *StoreMgr.getFunction(*ModInst->getFuncAddr(0));
+    EXPECT_EQ(Entry.Entry, reinterpret_cast<void *>(&HostAdd::nativeEntry));
+    EXPECT_EQ(Entry.Func, &FuncInst->getHostFunc());
+    EXPECT_EQ(Entry.Memory, *StoreMgr.getMemory(*ModInst->getMemAddr(0)));
+    return true;
+  };
+
+  Configure Conf;
+  EXPECT_TRUE(IsDirect(Conf, nullptr, 5));
+  Statistics::Statistics Stat;
+  EXPECT_TRUE(IsDirect(Conf, &Stat, 0));
+  // The cost is charged by the executor.
+  EXPECT_FALSE(IsDirect(Conf, &Stat, 5));
+  // The time is recorded by the executor.
+  Conf.getStatisticsConfigure().setTimeMeasuring(true);
+  EXPECT_FALSE(IsDirect(Conf, &Stat, 0));
+  EXPECT_TRUE(IsDirect(Conf, nullptr, 0));
+}
+
+TEST(ExecutorTest, FuncImport__CompiledEntry) {
+  Configure Conf;
+  static uint32_t Seven = 7, FortyTwo = 42, Marker = 0;
+  auto CalleeMod = parseAndValidate(Conf, CalleeWasm);
+  auto CallerMod = parseAndValidate(Conf, CallerWasm);
+  ASSERT_TRUE(CalleeMod && CallerMod);
+  CalleeMod->setSymbol(
+      Symbol<const AST::Module::IntrinsicsTable *>(&IntrinsicsPtr));
+  CalleeMod->getTypeSection().getContent()[0].setSymbol(
+      Symbol<AST::FunctionType::Wrapper>(&constWrapper));
+  auto &CalleeCodes = CalleeMod->getCodeSection().getContent();
+  CalleeCodes[0].setSymbol(Symbol<void>(&Seven));
+  CalleeCodes[1].setSymbol(Symbol<void>(&FortyTwo));
+  CallerMod->setSymbol(
+      Symbol<const AST::Module::IntrinsicsTable *>(&IntrinsicsPtr));
+  CallerMod->getTypeSection().getContent()[0].setSymbol(
+      Symbol<AST::FunctionType::Wrapper>(&stubWrapper));
+  CallerMod->getCodeSection().getContent()[0].setSymbol(
+      Symbol<void>(&Marker));
+
+  HostModule Host(0);
+  Runtime::StoreManager StoreMgr;
+  Executor::Executor Exec(Conf);
+  ASSERT_TRUE(Exec.registerModule(StoreMgr, Host));
+  ASSERT_TRUE(Exec.registerModule(StoreMgr, *CalleeMod, "callee"));
+  ASSERT_TRUE(Exec.instantiateModule(StoreMgr, *CallerMod));
+  const auto *CalleeModInst = *StoreMgr.findModule("callee"sv);
+  const auto *CallerModInst = *StoreMgr.getActiveModule();
+
+  // The entry of the compiled import points to the data of its module.
+  ASSERT_EQ(CallerModInst->FuncImportEntries.size(), 2U);
+  const auto &Entry = CallerModInst->FuncImportEntries[1];
+  EXPECT_EQ(Entry.Entry, nullptr);
+  EXPECT_EQ(Entry.Symbol, &FortyTwo);
+  EXPECT_EQ(Entry.Memories, CalleeModInst->MemoryPtrs.data());
+  EXPECT_EQ(Entry.Globals, CalleeModInst->GlobalPtrs.data());
+  EXPECT_EQ(Entry.MemorySizes, CalleeModInst->MemorySizePtrs.data());
+  EXPECT_EQ(Entry.FuncImports, CalleeModInst->FuncImportEntries.data());
+  EXPECT_EQ(Entry.ModuleAddr, CalleeModInst->Addr);
+  const auto *CalleeMem = *StoreMgr.getMemory(*CalleeModInst->getMemAddr(0));
+  EXPECT_EQ(Entry.Memories[0], CalleeMem->getDataPtr());
+  EXPECT_EQ(Entry.MemorySizes[0], CalleeMem->getDataSizePtr());
+
+  // The calls between the entering and the leaving are resolved in the
+  // module of the import, and the others in the caller module.
+  const auto GAddr = *CallerModInst->findFuncExports("g"sv);
+  auto Res = Exec.invoke(StoreMgr, GAddr, {}, {});
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 1U);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 742U);
+}
+
+TEST(ExecutorTest, Memory64__Over4G) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Memory64);
+  auto Mod = parseAndValidate(Conf, Memory64Wasm);
+  ASSERT_TRUE(Mod);
+
+  // The page count and the addresses over 4 GiB are not truncated.
+  {
+    Runtime::StoreManager StoreMgr;
+    Executor::Executor Exec(Conf);
+    ASSERT_TRUE(Exec.instantiateModule(StoreMgr, *Mod));
+    const auto *ModInst = *StoreMgr.getActiveModule();
+    auto Invoke = [&](std::string_view Name,
+                      std::vector<uint64_t> Args) -> Expect<uint64_t> {
+      const auto Addr = *ModInst->findFuncExports(Name);
+      std::vector<ValVariant> Params(Args.begin(), Args.end());
+      std::vector<ValType> Types(Args.size(), ValType::I64);
+      if (auto Res = Exec.invoke(StoreMgr, Addr, Params, Types); !Res) {
+        return Unexpect(Res);
+      } else if (Res->empty()) {
+        return 0;
+      } else {
+        return (*Res)[0].first.get<uint64_t>();
+      }
+    };
+
+    constexpr uint64_t End = UINT64_C(0x100010000);
+    constexpr uint64_t Val = UINT64_C(0x1122334455667788);
+    EXPECT_EQ(*Invoke("size"sv, {}), 1U);
+    EXPECT_EQ(*Invoke("grow"sv, {}), 1U);
+    EXPECT_EQ(*Invoke("size"sv, {}), 65537U);
+    ASSERT_TRUE(Invoke("store"sv, {UINT64_C(0x100000008), Val}));
+    EXPECT_EQ(*Invoke("load"sv, {UINT64_C(0x100000008)}), Val);
+    EXPECT_EQ(*Invoke("loadOff"sv, {UINT64_C(8)}), Val);
+    EXPECT_EQ(*Invoke("load"sv, {UINT64_C(8)}), 0U);
+    EXPECT_TRUE(Invoke("load"sv, {End - 8}));
+    EXPECT_FALSE(Invoke("load"sv, {End - 4}));
+    EXPECT_FALSE(Invoke("loadOff"sv, {UINT64_C(0x10000)}));
+    EXPECT_FALSE(Invoke("loadOff"sv, {UINT64_MAX}));
+    EXPECT_EQ(*Invoke("grow"sv, {}), UINT64_MAX);
+  }
+
+  // The 64-bit memories are limited by their own page limit.
+  {
+    Conf.getRuntimeConfigure().setMaxMemory64Page(2);
+    Runtime::StoreManager LimitedStoreMgr;
+    Executor::Executor LimitedExec(Conf);
+    ASSERT_TRUE(LimitedExec.instantiateModule(LimitedStoreMgr, *Mod));
+    const auto *LimitedModInst = *LimitedStoreMgr.getActiveModule();
+    auto Res = LimitedExec.invoke(
+        LimitedStoreMgr, *LimitedModInst->findFuncExports("grow"sv), {}, {});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint64_t>(), UINT64_MAX);
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -106,4 +106,29 @@ TEST(ExpressionTest, LoadExpression) {
   EXPECT_FALSE(LdrNoRefType.parseModule(prefixedVec(Vec)));
 }
 
+TEST(ExpressionTest, CopyExpression) {
+  WasmEdge::Configure CopyConf;
+  WasmEdge::Loader::Loader CopyLdr(CopyConf);
+  std::vector<uint8_t> Vec = {
+      0x0AU,               // Code section
+      0x07U,               // Content size = 7
+      0x01U,               // Vector length = 1
+      0x05U,               // Code segment size = 5
+      0x00U,               // Local vec(0)
+      0x45U, 0x46U, 0x47U, // Valid OpCodes.
+      0x0BU                // OpCode End.
+  };
+  auto Res = CopyLdr.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Res);
+
+  // The copied instructions keep the capacity larger than the size.
+  WasmEdge::AST::Module Copy(**Res);
+  auto &Instrs = Copy.getCodeSection().getContent()[0].getExpr().getInstrs();
+  EXPECT_EQ(Instrs.size(), 4U);
+  EXPECT_GT(Instrs.capacity(), Instrs.size());
+  WasmEdge::AST::Expression Assigned;
+  Assigned = Copy.getCodeSection().getContent()[0].getExpr();
+  EXPECT_GT(Assigned.getInstrs().capacity(), Assigned.getInstrs().size());
+}
+
 } // namespace
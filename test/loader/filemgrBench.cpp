@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/loader/filemgrBench.cpp - LEB128 decoding benchmark -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmark of decoding LEB128 integers by FileMgr,
+/// compared with the byte by byte decoding of the previous FileMgr.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/filemgr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+
+using WasmEdge::ErrCode;
+using WasmEdge::Expect;
+using WasmEdge::Unexpect;
+using WasmEdge::unlikely;
+
+/// The previous FileMgr decoding the unsigned LEB128 byte by byte, with the
+/// same status, boundary, and section checks, as the baseline.
+class BaselineFileMgr {
+public:
+  BaselineFileMgr(const std::vector<uint8_t> &Code)
+      : Data(Code.data()), Size(Code.size()) {}
+
+  void setSectionSize(uint64_t SecSize) {
+    SecPos = std::min(Pos + SecSize, Size);
+  }
+
+  Expect<uint32_t> readU32() {
+    if (unlikely(Status != ErrCode::Success)) {
+      return Unexpect(Status);
+    }
+    LastPos = Pos;
+    uint32_t Result = 0;
+    uint32_t Offset = 0;
+    uint8_t Byte = 0x80;
+    while (Byte & 0x80) {
+      if (unlikely(Offset >= 32)) {
+        Status = ErrCode::IntegerTooLong;
+        return Unexpect(Status);
+      }
+      if (unlikely(Pos >= Size)) {
+        LastPos = Pos;
+        Status = ErrCode::UnexpectedEnd;
+        return Unexpect(Status);
+      }
+      Byte = Data[Pos++];
+      Result |= (Byte & UINT32_C(0x7F)) << Offset;
+      if (Offset == 28 && unlikely((Byte & UINT32_C(0x70)) != 0)) {
+        Status = ErrCode::IntegerTooLarge;
+        return Unexpect(Status);
+      }
+      Offset += 7;
+    }
+    if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
+      LastPos = SecPos.value();
+      Status = ErrCode::UnexpectedEnd;
+      return Unexpect(Status);
+    }
+    return Result;
+  }
+
+  Expect<uint64_t> readU64() {
+    if (Status != ErrCode::Success) {
+      return Unexpect(Status);
+    }
+    LastPos = Pos;
+    uint64_t Result = 0;
+    uint64_t Offset = 0;
+    uint8_t Byte = 0x80;
+    while (Byte & 0x80) {
+      if (unlikely(Offset >= 64)) {
+        Status = ErrCode::IntegerTooLong;
+        return Unexpect(Status);
+      }
+      if (unlikely(Pos >= Size)) {
+        LastPos = Pos;
+        Status = ErrCode::UnexpectedEnd;
+        return Unexpect(Status);
+      }
+      Byte = Data[Pos++];
+      Result |= (Byte & UINT64_C(0x7F)) << Offset;
+      if (Offset == 63 && unlikely((Byte & UINT32_C(0x7E)) != 0)) {
+        Status = ErrCode::IntegerTooLarge;
+        return Unexpect(Status);
+      }
+      Offset += 7;
+    }
+    if (SecPos.has_value() && unlikely(Pos > SecPos.value())) {
+      LastPos = SecPos.value();
+      Status = ErrCode::UnexpectedEnd;
+      return Unexpect(Status);
+    }
+    return Result;
+  }
+
+private:
+  const uint8_t *Data;
+  uint64_t Size;
+  uint64_t Pos = 0;
+  uint64_t LastPos = 0;
+  std::optional<uint64_t> SecPos;
+  ErrCode Status = ErrCode::Success;
+};
+
+/// Generate the LEB128 encodings of the 32-bit values in the typical sizes of
+/// the indices and the constants in a module.
+std::vector<uint8_t> generate(uint32_t Count) {
+  std::mt19937_64 Rng(0x5EED);
+  std::vector<uint8_t> Bytes;
+  for (uint32_t I = 0; I < Count; ++I) {
+    const auto Bits = std::min(UINT32_C(32),
+                               static_cast<uint32_t>(7 * (Rng() % 5 + 1)));
+    uint64_t Value = Rng() >> (64 - Bits);
+    do {
+      const uint8_t Byte = Value & 0x7FU;
+      Value >>= 7;
+      Bytes.push_back(Value ? (Byte | 0x80U) : Byte);
+    } while (Value);
+  }
+  return Bytes;
+}
+
+template <typename F> double measure(F &&Func) {
+  const auto Start = std::chrono::steady_clock::now();
+  Func();
+  const auto End = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(End - Start).count();
+}
+
+} // namespace
+
+int main() {
+  constexpr uint32_t Count = 1 << 24;
+  const auto Bytes = generate(Count);
+
+  // All the integers are read in a section as in the module loading.
+  uint64_t BaseSum = 0;
+  const double BaseTime = measure([&]() {
+    BaselineFileMgr Mgr(Bytes);
+    Mgr.setSectionSize(Bytes.size());
+    for (uint32_t I = 0; I < Count; ++I) {
+      BaseSum += *Mgr.readU64();
+    }
+  });
+
+  uint64_t BaseSum32 = 0;
+  const double BaseTime32 = measure([&]() {
+    BaselineFileMgr Mgr(Bytes);
+    Mgr.setSectionSize(Bytes.size());
+    for (uint32_t I = 0; I < Count; ++I) {
+      BaseSum32 += *Mgr.readU32();
+    }
+  });
+
+  uint64_t Sum = 0;
+  const double Time = measure([&]() {
+    WasmEdge::FileMgr Mgr;
+    Mgr.setCode(Bytes);
+    Mgr.setSectionSize(Bytes.size());
+    for (uint32_t I = 0; I < Count; ++I) {
+      Sum += *Mgr.readU64();
+    }
+  });
+
+  uint64_t Sum32 = 0;
+  const double Time32 = measure([&]() {
+    WasmEdge::FileMgr Mgr;
+    Mgr.setCode(Bytes);
+    Mgr.setSectionSize(Bytes.size());
+    for (uint32_t I = 0; I < Count; ++I) {
+      Sum32 += *Mgr.readU32();
+    }
+  });
+
+  if (Sum != BaseSum || Sum32 != BaseSum32 || BaseSum32 != BaseSum) {
+    std::fprintf(stderr, "checksum mismatch\n");
+    return 1;
+  }
+  const double MB = static_cast<double>(Bytes.size()) / 1e6;
+  std::printf("%u LEB128 integers in %.1f MB\n", Count, MB);
+  std::printf("previous readU64:  %8.2f ms %8.1f MB/s\n", BaseTime,
+              MB / BaseTime * 1e3);
+  std::printf("FileMgr::readU64:  %8.2f ms %8.1f MB/s\n", Time,
+              MB / Time * 1e3);
+  std::printf("previous readU32:  %8.2f ms %8.1f MB/s\n", BaseTime32,
+              MB / BaseTime32 * 1e3);
+  std::printf("FileMgr::readU32:  %8.2f ms %8.1f MB/s\n", Time32,
+              MB / Time32 * 1e3);
+  return 0;
+}
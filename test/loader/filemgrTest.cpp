@@ -12,14 +12,24 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "common/config.h"
 #include "loader/filemgr.h"
 
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <random>
 #include <string>
 #include <vector>
 
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 WasmEdge::FileMgr Mgr;
@@ -98,6 +108,31 @@ TEST(FileManagerTest, File__ReadBytes) {
   EXPECT_EQ(10U, Mgr.getOffset());
 }
 
+TEST(FileManagerTest, File__ReadBytesView) {
+  // Test unsigned char list reading as views into the mapped file.
+  WasmEdge::Expect<WasmEdge::Span<const uint8_t>> ReadBytes;
+  ASSERT_TRUE(Mgr.setPath("filemgrTestData/readByteTest.bin"));
+  auto Map = Mgr.getFileMap();
+  ASSERT_TRUE(Map);
+  ASSERT_TRUE(ReadBytes = Mgr.readBytesView(3));
+  EXPECT_EQ(Map->address(), ReadBytes->data());
+  EXPECT_EQ(3U, ReadBytes->size());
+  EXPECT_EQ(0x1F, ReadBytes.value()[2]);
+  const auto Head = *ReadBytes;
+  ASSERT_TRUE(ReadBytes = Mgr.readBytesView(7));
+  EXPECT_EQ(0x2E, ReadBytes.value()[0]);
+  EXPECT_EQ(0x88, ReadBytes.value()[6]);
+  ASSERT_FALSE(ReadBytes = Mgr.readBytesView(1));
+  EXPECT_EQ(10U, Mgr.getOffset());
+  // The view is kept valid by the mapped file after resetting.
+  Mgr.reset();
+  EXPECT_EQ(0xFF, Head[1]);
+  ASSERT_TRUE(Mgr.setCode(std::vector<uint8_t>{0x00, 0xFF}));
+  EXPECT_FALSE(Mgr.getFileMap());
+  ASSERT_TRUE(ReadBytes = Mgr.readBytesView(2));
+  EXPECT_EQ(0xFF, ReadBytes.value()[1]);
+}
+
 TEST(FileManagerTest, File__ReadUnsigned32) {
   // 4. Test unsigned 32bit integer decoding.
   WasmEdge::Expect<uint32_t> ReadNum;
@@ -305,6 +340,27 @@ TEST(FileManagerTest, File__ReadName) {
   EXPECT_EQ(15U, Mgr.getOffset());
 }
 
+TEST(FileManagerTest, File__ReadNameView) {
+  // Test utf-8 string reading as views into the mapped file.
+  WasmEdge::Expect<std::string_view> ReadStr;
+  ASSERT_TRUE(Mgr.setPath("filemgrTestData/readNameTest.bin"));
+  ASSERT_TRUE(Mgr.hasDataOwner());
+  ASSERT_TRUE(ReadStr = Mgr.readNameView());
+  EXPECT_EQ("", ReadStr.value());
+  ASSERT_TRUE(ReadStr = Mgr.readNameView());
+  EXPECT_EQ("test", ReadStr.value());
+  EXPECT_EQ(static_cast<const char *>(Mgr.getFileMap()->address()) + 2,
+            ReadStr->data());
+  ASSERT_TRUE(ReadStr = Mgr.readNameView());
+  EXPECT_EQ(" ", ReadStr.value());
+  ASSERT_TRUE(ReadStr = Mgr.readNameView());
+  EXPECT_EQ("Loader", ReadStr.value());
+  ASSERT_FALSE(ReadStr = Mgr.readNameView());
+  EXPECT_EQ(15U, Mgr.getOffset());
+  ASSERT_TRUE(Mgr.setCode(WasmEdge::Span<const uint8_t>()));
+  EXPECT_FALSE(Mgr.hasDataOwner());
+}
+
 TEST(FileManagerTest, File__ReadUnsigned32TooLong) {
   // 11. Test unsigned 32bit integer decoding in too long case.
   WasmEdge::Expect<uint32_t> ReadNum;
@@ -796,6 +852,83 @@ TEST(FileManagerTest, SetSectionSize) {
   Mgr.setSectionSize(200);
   Mgr.setSectionSize(UINT64_MAX);
 }
+
+#ifdef HAVE_MMAP
+TEST(FileManagerTest, File__Lock) {
+  // 41. Test the lock of the mapped file.
+  const char *Path = "filemgrLockTest.bin";
+  const std::vector<WasmEdge::Byte> Expected{0x00U, 0x61U, 0x73U, 0x6DU};
+  {
+    std::ofstream File(Path, std::ios::binary);
+    File.write(reinterpret_cast<const char *>(Expected.data()),
+               static_cast<std::streamsize>(Expected.size()));
+  }
+  const int Fd = open(Path, O_RDONLY);
+  ASSERT_GE(Fd, 0);
+
+  // The writers taking an exclusive lock are kept out while mapped.
+  WasmEdge::FileMgr LockMgr;
+  ASSERT_TRUE(LockMgr.setPath(Path));
+  EXPECT_NE(LockMgr.getFileMap(), nullptr);
+  EXPECT_NE(flock(Fd, LOCK_EX | LOCK_NB), 0);
+  LockMgr.reset();
+  EXPECT_EQ(flock(Fd, LOCK_EX | LOCK_NB), 0);
+
+  // The file locked exclusively is read as a copy.
+  ASSERT_TRUE(LockMgr.setPath(Path));
+  EXPECT_EQ(LockMgr.getFileMap(), nullptr);
+  EXPECT_TRUE(LockMgr.hasDataOwner());
+  const auto Data = LockMgr.getData();
+  EXPECT_EQ(std::vector<WasmEdge::Byte>(Data.begin(), Data.end()), Expected);
+  close(Fd);
+  LockMgr.reset();
+  std::remove(Path);
+}
+#endif
+
+TEST(FileManagerTest, Vector__FastLEB128) {
+  // 42. Test the fast LEB128 decoding matches the decoding near the data end.
+  std::mt19937_64 Rng(0x5EED);
+  auto Compare = [](auto Read, const std::vector<uint8_t> &Bytes,
+                    uint64_t SecSize) {
+    WasmEdge::FileMgr Near, Far;
+    auto Padded = Bytes;
+    Padded.resize(Bytes.size() + 16, 0x80U);
+    ASSERT_TRUE(Near.setCode(Bytes));
+    ASSERT_TRUE(Far.setCode(Padded));
+    Near.setSectionSize(SecSize);
+    Far.setSectionSize(SecSize);
+    const auto NearRes = Read(Near);
+    const auto FarRes = Read(Far);
+    ASSERT_EQ(static_cast<bool>(NearRes), static_cast<bool>(FarRes));
+    if (NearRes) {
+      EXPECT_EQ(*NearRes, *FarRes);
+      EXPECT_EQ(Near.getOffset(), Far.getOffset());
+    } else {
+      EXPECT_EQ(NearRes.error(), FarRes.error());
+      EXPECT_EQ(Near.getLastOffset(), Far.getLastOffset());
+    }
+  };
+  for (uint32_t I = 0; I < 20000; ++I) {
+    // Encode a random value with random padding, and mess up the last byte.
+    const uint32_t Len = static_cast<uint32_t>(Rng() % 10) + 1;
+    std::vector<uint8_t> Bytes(Len);
+    uint64_t Bits = Rng() >> (Rng() % 64);
+    for (uint32_t J = 0; J < Len; ++J) {
+      Bytes[J] = static_cast<uint8_t>((Bits & 0x7FU) | 0x80U);
+      Bits >>= 7;
+    }
+    Bytes.back() &= 0x7FU;
+    if (Rng() % 4 == 0) {
+      Bytes.back() ^= static_cast<uint8_t>(1U << (Rng() % 7));
+    }
+    const uint64_t SecSize = Rng() % 8 == 0 ? Rng() % Len : UINT64_MAX;
+    Compare([](WasmEdge::FileMgr &M) { return M.readU32(); }, Bytes, SecSize);
+    Compare([](WasmEdge::FileMgr &M) { return M.readU64(); }, Bytes, SecSize);
+    Compare([](WasmEdge::FileMgr &M) { return M.readS32(); }, Bytes, SecSize);
+    Compare([](WasmEdge::FileMgr &M) { return M.readS64(); }, Bytes, SecSize);
+  }
+}
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
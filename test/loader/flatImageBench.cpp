@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/loader/flatImageBench.cpp - Flat image benchmark ----===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the benchmark of loading a module from its flat image,
+/// compared with decoding the module binary. Both are validated after loaded.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/loader.h"
+#include "validator/validator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace {
+
+void pushU32(std::vector<uint8_t> &Vec, uint32_t Value) {
+  do {
+    const uint8_t Byte = Value & 0x7FU;
+    Value >>= 7;
+    Vec.push_back(Value ? (Byte | 0x80U) : Byte);
+  } while (Value);
+}
+
+void pushSection(std::vector<uint8_t> &Wasm, uint8_t Id,
+                 const std::vector<uint8_t> &Content) {
+  Wasm.push_back(Id);
+  pushU32(Wasm, static_cast<uint32_t>(Content.size()));
+  Wasm.insert(Wasm.end(), Content.begin(), Content.end());
+}
+
+/// Generate a module of the functions (i32) -> i32 with the blocks, the
+/// branches, the locals and the arithmetic instructions.
+std::vector<uint8_t> generate(uint32_t FuncCount, uint32_t BlockCount) {
+  std::mt19937 Rng(0x5EED);
+  std::vector<uint8_t> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU,
+                               0x01U, 0x00U, 0x00U, 0x00U};
+  pushSection(Wasm, 0x01U, {0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU});
+  std::vector<uint8_t> Funcs;
+  pushU32(Funcs, FuncCount);
+  Funcs.insert(Funcs.end(), FuncCount, 0x00U);
+  pushSection(Wasm, 0x03U, Funcs);
+
+  std::vector<uint8_t> Codes;
+  pushU32(Codes, FuncCount);
+  for (uint32_t I = 0; I < FuncCount; ++I) {
+    // One i32 local besides the parameter.
+    std::vector<uint8_t> Body = {0x01U, 0x01U, 0x7FU};
+    for (uint32_t J = 0; J < BlockCount; ++J) {
+      // block (local.set 1 (i32.add (local.get 0) (i32.const C)))
+      //   (br_if 0 (i32.eqz (local.get 1))) end
+      Body.insert(Body.end(), {0x02U, 0x40U, 0x20U, 0x00U, 0x41U});
+      pushU32(Body, Rng() & 0xFFFFFU);
+      Body.insert(Body.end(), {0x6AU, 0x21U, 0x01U, 0x20U, 0x01U, 0x45U,
+                               0x0DU, 0x00U, 0x0BU});
+    }
+    Body.insert(Body.end(), {0x20U, 0x01U, 0x0BU});
+    pushU32(Codes, static_cast<uint32_t>(Body.size()));
+    Codes.insert(Codes.end(), Body.begin(), Body.end());
+  }
+  pushSection(Wasm, 0x0AU, Codes);
+  return Wasm;
+}
+
+template <typename F> double measure(F &&Func) {
+  double Best = 0.0;
+  for (int I = 0; I < 5; ++I) {
+    const auto Start = std::chrono::steady_clock::now();
+    if (!Func()) {
+      return -1.0;
+    }
+    const auto End = std::chrono::steady_clock::now();
+    const double Time =
+        std::chrono::duration<double, std::milli>(End - Start).count();
+    Best = I == 0 ? Time : std::min(Best, Time);
+  }
+  return Best;
+}
+
+} // namespace
+
+int main() {
+  const auto Wasm = generate(4096, 64);
+  const std::filesystem::path WasmPath = "flatImageBench.wasm";
+  const std::filesystem::path FlatPath = "flatImageBench.flat";
+  {
+    std::ofstream File(WasmPath, std::ios::binary);
+    File.write(reinterpret_cast<const char *>(Wasm.data()),
+               static_cast<std::streamsize>(Wasm.size()));
+  }
+
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Ldr(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  {
+    auto Res = Ldr.parseModule(WasmPath);
+    if (!Res || !Valid.validate(**Res) || !Ldr.saveFlatImage(**Res, FlatPath)) {
+      std::fprintf(stderr, "failed to save the flat image\n");
+      return 1;
+    }
+  }
+
+  // Both modules are loaded from the files, and validated.
+  const double DecodeTime = measure([&]() {
+    auto Res = Ldr.parseModule(WasmPath);
+    return Res && Valid.validate(**Res);
+  });
+  const double FlatTime = measure([&]() {
+    auto Res = Ldr.parseFlatImage(FlatPath);
+    return Res && Valid.validate(**Res);
+  });
+
+  std::error_code EC;
+  const auto FlatSize = std::filesystem::file_size(FlatPath, EC);
+  std::filesystem::remove(WasmPath, EC);
+  std::filesystem::remove(FlatPath, EC);
+  if (DecodeTime < 0.0 || FlatTime < 0.0) {
+    std::fprintf(stderr, "failed to load the module\n");
+    return 1;
+  }
+  std::printf("module %zu bytes, flat image %ju bytes\n", Wasm.size(),
+              static_cast<uintmax_t>(FlatSize));
+  std::printf("decode and validate:     %8.2f ms\n", DecodeTime);
+  std::printf("flat image and validate: %8.2f ms\n", FlatTime);
+  return 0;
+}
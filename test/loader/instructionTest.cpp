@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <gtest/gtest.h>
+#include <type_traits>
 #include <vector>
 
 namespace {
@@ -392,6 +393,65 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
   EXPECT_FALSE(Ldr.parseModule(prefixedVec(Vec)));
 }
 
+TEST(InstructionTest, LoadImmediatesSideTable) {
+  // 5. Test the variable-length immediates in the side table.
+  //
+  //   1.  Load the label lists of br_table instructions.
+  //   2.  Load the value type list of select_t instruction.
+  //   3.  Copy the instructions referring to the side table.
+  //   4.  Bind the instructions to the other side table.
+
+  static_assert(std::is_trivially_copyable_v<WasmEdge::AST::Instruction>);
+  EXPECT_LE(sizeof(WasmEdge::AST::Instruction), 24U);
+
+  std::vector<uint8_t> Vec = {
+      0x0AU,               // Code section
+      0x12U,               // Content size = 18
+      0x01U,               // Vector length = 1
+      0x10U,               // Code segment size = 16
+      0x00U,               // Local vec(0)
+      0x0EU,               // OpCode Br_table.
+      0x02U,               // Vector length = 2
+      0x01U, 0x02U,        // vec[0], vec[1]
+      0x03U,               // Label index.
+      0x1CU,               // OpCode Select_t.
+      0x01U,               // Vector length = 1
+      0x7EU,               // Value type i64
+      0x0EU,               // OpCode Br_table.
+      0x03U,               // Vector length = 3
+      0x04U, 0x05U, 0x06U, // vec[0], vec[1], vec[2]
+      0x07U,               // Label index.
+      0x0BU                // Expression End.
+  };
+  auto Mod = Ldr.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Mod);
+  const auto &Expr = (*Mod)->getCodeSection().getContent()[0].getExpr();
+  ASSERT_TRUE(Expr.getSideTable());
+  WasmEdge::AST::InstrVec Instrs(Expr.getInstrs().begin(),
+                                 Expr.getInstrs().end());
+  ASSERT_EQ(Instrs.size(), 4U);
+
+  auto Labels = Instrs[0].getLabelList();
+  EXPECT_EQ(std::vector<uint32_t>(Labels.begin(), Labels.end()),
+            (std::vector<uint32_t>{1, 2}));
+  EXPECT_EQ(Instrs[0].getTargetIndex(), 3U);
+  ASSERT_EQ(Instrs[1].getValTypeList().size(), 1U);
+  EXPECT_EQ(Instrs[1].getValTypeList()[0], WasmEdge::ValType::I64);
+  Labels = Instrs[2].getLabelList();
+  EXPECT_EQ(std::vector<uint32_t>(Labels.begin(), Labels.end()),
+            (std::vector<uint32_t>{4, 5, 6}));
+  EXPECT_EQ(Instrs[2].getTargetIndex(), 7U);
+
+  // 4. Test binding the lists exceeding the side table fails.
+  WasmEdge::AST::InstrSideTable Side;
+  Side.Labels = {1, 2, 3, 4};
+  EXPECT_FALSE(Side.bind(Instrs));
+  Side.Labels = {1, 2, 3, 4, 5};
+  Side.ValTypes = {WasmEdge::ValType::I32};
+  EXPECT_TRUE(Side.bind(Instrs));
+  EXPECT_EQ(Instrs[2].getLabelList().data(), Side.Labels.data() + 2);
+}
+
 TEST(InstructionTest, LoadCallControlInstruction) {
   std::vector<uint8_t> Vec;
 
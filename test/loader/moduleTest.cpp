@@ -14,9 +14,19 @@
 //===----------------------------------------------------------------------===//
 
 #include "loader/loader.h"
+#include "validator/validator.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -220,6 +230,442 @@ TEST(ModuleTest, LoadDupSecModule) {
   EXPECT_FALSE(Ldr.parseModule(Vec));
 }
 
+TEST(ModuleTest, LoadModuleBorrowNames) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                    // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                    // Version
+      0x00U, 0x06U, 0x02U, 0x6EU, 0x6DU,             // Custom section "nm"
+      0x01U, 0x02U, 0x03U,                           //   Content
+      0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U,      // Type section
+      0x02U, 0x09U, 0x01U, 0x03U, 0x65U, 0x6EU, 0x76U, // Import "env"
+      0x01U, 0x66U, 0x00U, 0x00U,                    //   "f" function
+      0x07U, 0x05U, 0x01U, 0x01U, 0x67U, 0x00U, 0x00U  // Export "g"
+  };
+  auto Check = [](const WasmEdge::AST::Module &Mod) {
+    ASSERT_EQ(Mod.getCustomSections().size(), 1U);
+    const auto &CustomSec = Mod.getCustomSections()[0];
+    EXPECT_EQ(CustomSec.getName(), "nm");
+    EXPECT_EQ(CustomSec.getContentOffset(), 13U);
+    EXPECT_EQ(CustomSec.getContentLength(), 3U);
+    ASSERT_EQ(Mod.getImportSection().getContent().size(), 1U);
+    const auto &ImpDesc = Mod.getImportSection().getContent()[0];
+    EXPECT_EQ(ImpDesc.getModuleName(), "env");
+    EXPECT_EQ(ImpDesc.getExternalName(), "f");
+    ASSERT_EQ(Mod.getExportSection().getContent().size(), 1U);
+    EXPECT_EQ(Mod.getExportSection().getContent()[0].getExternalName(), "g");
+  };
+
+  // 1. Test the names are copied from the borrowed buffer.
+  std::unique_ptr<WasmEdge::AST::Module> Mod;
+  {
+    auto Buf = Vec;
+    WasmEdge::Configure BorrowConf;
+    WasmEdge::Loader::Loader BorrowLdr(BorrowConf);
+    auto Res = BorrowLdr.parseModule(Buf);
+    ASSERT_TRUE(Res);
+    Mod = std::move(*Res);
+    Buf.assign(Buf.size(), 0x00U);
+  }
+  EXPECT_FALSE(Mod->getDataOwner());
+  Check(*Mod);
+  // The custom section content is got from the binary on demand, which is
+  // checked to be the one the module is parsed from.
+  const std::shared_ptr<const WasmEdge::AST::Module> Shared = std::move(Mod);
+  const auto &CustomSec = Shared->getCustomSections()[0];
+  EXPECT_FALSE(CustomSec.isContentLoaded());
+  EXPECT_TRUE(CustomSec.getContent().empty());
+  EXPECT_FALSE(WasmEdge::Loader::Loader::getCustomSectionContent(CustomSec));
+  EXPECT_FALSE(WasmEdge::Loader::Loader::getCustomSectionContent(
+      CustomSec, WasmEdge::Span<const uint8_t>(Vec).first(15)));
+  {
+    auto Other = Vec;
+    Other[14] = 0x04U;
+    EXPECT_FALSE(
+        WasmEdge::Loader::Loader::getCustomSectionContent(CustomSec, Other));
+  }
+  auto Content =
+      WasmEdge::Loader::Loader::getCustomSectionContent(CustomSec, Vec);
+  ASSERT_TRUE(Content);
+  EXPECT_EQ(Content->data(), Vec.data() + 13);
+  EXPECT_EQ(std::vector<uint8_t>(Content->begin(), Content->end()),
+            (std::vector<uint8_t>{0x01U, 0x02U, 0x03U}));
+
+  // 2. Test the names and contents are borrowed from the mapped file, which
+  // is kept alive by the module.
+  const std::filesystem::path Path = "moduleTestBorrowNames.wasm";
+  {
+    std::ofstream Fout(Path, std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(Vec.data()),
+               static_cast<std::streamsize>(Vec.size()));
+  }
+  {
+    WasmEdge::Configure FileConf;
+    WasmEdge::Loader::Loader FileLdr(FileConf);
+    auto Res = FileLdr.parseModule(Path);
+    ASSERT_TRUE(Res);
+    Mod = std::move(*Res);
+  }
+  std::filesystem::remove(Path);
+  ASSERT_TRUE(Mod->getDataOwner());
+  Check(*Mod);
+  EXPECT_TRUE(Mod->getCustomSections()[0].isContentLoaded());
+  const auto *Base = static_cast<const WasmEdge::MMap *>(
+                         Mod->getDataOwner().get())
+                         ->address();
+  EXPECT_EQ(Mod->getExportSection().getContent()[0].getExternalName().data(),
+            static_cast<const char *>(Base) + Vec.size() - 3);
+  EXPECT_EQ(Mod->getCustomSections()[0].getContent().data(),
+            static_cast<const uint8_t *>(Base) + 13);
+  // The content is got from the module without the binary.
+  auto Borrowed = WasmEdge::Loader::Loader::getCustomSectionContent(
+      Mod->getCustomSections()[0]);
+  ASSERT_TRUE(Borrowed);
+  EXPECT_EQ(Borrowed->data(), static_cast<const uint8_t *>(Base) + 13);
+}
+
+TEST(ModuleTest, LoadModuleStream) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U,        // Type section
+      0x03U, 0x02U, 0x01U, 0x00U,                      // Function section
+      0x07U, 0x05U, 0x01U, 0x01U, 0x66U, 0x00U, 0x00U, // Export section
+      0x0AU, 0x04U, 0x01U, 0x02U, 0x00U, 0x0BU         // Code section
+  };
+  WasmEdge::Configure StreamConf;
+  WasmEdge::Loader::Loader::Stream Stream(StreamConf);
+
+  // 1. Test load module pushed byte by byte.
+  for (auto B : Vec) {
+    ASSERT_TRUE(Stream.push(WasmEdge::Span<const uint8_t>(&B, 1)));
+  }
+  auto Res = Stream.finish();
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)->getFunctionSection().getContent().size(), 1U);
+  EXPECT_EQ((*Res)->getCodeSection().getContent().size(), 1U);
+  ASSERT_EQ((*Res)->getExportSection().getContent().size(), 1U);
+  EXPECT_EQ((*Res)->getExportSection().getContent()[0].getExternalName(), "f");
+
+  // 2. Test load truncated module.
+  ASSERT_TRUE(Stream.push(WasmEdge::Span<const uint8_t>(Vec).first(20)));
+  EXPECT_FALSE(Stream.finish());
+
+  // 3. Test the malformed section fails the pushing.
+  Vec[9] = 0x05U;
+  EXPECT_FALSE(Stream.push(Vec));
+  EXPECT_FALSE(Stream.push(Vec));
+  EXPECT_FALSE(Stream.finish());
+
+  // 4. Test the stream is reset after finishing.
+  Vec[9] = 0x04U;
+  ASSERT_TRUE(Stream.push(Vec));
+  EXPECT_TRUE(Stream.finish());
+}
+
+TEST(ModuleTest, LoadModuleStreamOwnedNames) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x00U, 0x04U, 0x02U, 0x6EU, 0x6DU, 0x01U,        // Custom section "nm"
+      0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U,        // Type section
+      0x02U, 0x07U, 0x01U, 0x01U, 0x6DU, 0x01U, 0x69U, // Import section
+      0x00U, 0x00U,                                    //   func "m" "i"
+      0x03U, 0x02U, 0x01U, 0x00U,                      // Function section
+      0x07U, 0x05U, 0x01U, 0x01U, 0x66U, 0x00U, 0x01U, // Export section
+      0x0AU, 0x04U, 0x01U, 0x02U, 0x00U, 0x0BU         // Code section
+  };
+  WasmEdge::Configure StreamConf;
+  StreamConf.getLoaderConfigure().setLazyFunctionBody(true);
+  WasmEdge::Loader::Loader::Stream Stream(StreamConf);
+
+  // 1. Test the names outlive the stream buffer and the bodies are decoded.
+  for (size_t I = 0; I < Vec.size(); I += 3) {
+    ASSERT_TRUE(Stream.push(WasmEdge::Span<const uint8_t>(Vec).subspan(
+        I, std::min<size_t>(3, Vec.size() - I))));
+  }
+  auto Res = Stream.finish();
+  ASSERT_TRUE(Res);
+  auto Mod = std::move(*Res);
+
+  // 2. Test pushing a second stream reuses and overwrites the buffer.
+  std::vector<uint8_t> Other = Vec;
+  Other[11] = Other[12] = Other[24] = Other[26] = Other[37] = 0x78U;
+  ASSERT_TRUE(Stream.push(Other));
+  auto OtherRes = Stream.finish();
+  ASSERT_TRUE(OtherRes);
+  EXPECT_EQ((*OtherRes)->getImportSection().getContent()[0].getModuleName(),
+            "x");
+
+  ASSERT_EQ(Mod->getCustomSections().size(), 1U);
+  EXPECT_EQ(Mod->getCustomSections()[0].getName(), "nm");
+  ASSERT_EQ(Mod->getImportSection().getContent().size(), 1U);
+  EXPECT_EQ(Mod->getImportSection().getContent()[0].getModuleName(), "m");
+  EXPECT_EQ(Mod->getImportSection().getContent()[0].getExternalName(), "i");
+  ASSERT_EQ(Mod->getExportSection().getContent().size(), 1U);
+  EXPECT_EQ(Mod->getExportSection().getContent()[0].getExternalName(), "f");
+  ASSERT_EQ(Mod->getCodeSection().getContent().size(), 1U);
+  EXPECT_FALSE(Mod->getCodeSection().getContent()[0].isLazy());
+  EXPECT_EQ(Mod->getCodeSection().getContent()[0].getExpr().getInstrs().size(),
+            1U);
+}
+
+TEST(ModuleTest, LoadModuleLazyBodyValidation) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,               // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,               // Version
+      0x01U, 0x05U, 0x01U, 0x60U, 0x00U, 0x01U, // Type section
+      0x7FU,                                    //   () -> i32
+      0x03U, 0x02U, 0x01U, 0x00U,               // Function section
+      0x0AU, 0x05U, 0x01U, 0x03U, 0x00U,        // Code section
+      0x01U, 0x0BU                              //   nop, end
+  };
+  WasmEdge::Configure LazyConf;
+  LazyConf.getLoaderConfigure().setLazyFunctionBody(true);
+  WasmEdge::Loader::Loader LazyLdr(LazyConf);
+  WasmEdge::Validator::Validator LazyValid(LazyConf);
+
+  // 1. Test the invalid lazy body fails at the first use.
+  {
+    auto Res = LazyLdr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    const auto &CodeSeg = (*Res)->getCodeSection().getContent()[0];
+    ASSERT_TRUE(CodeSeg.isLazy());
+    EXPECT_TRUE(LazyValid.validate(**Res));
+    EXPECT_FALSE(CodeSeg.loadLazyBody());
+  }
+
+  // 2. Test the lazy body decoded before the validation is checked.
+  {
+    auto Res = LazyLdr.parseModule(Vec);
+    ASSERT_TRUE(Res);
+    const auto &CodeSeg = (*Res)->getCodeSection().getContent()[0];
+    ASSERT_TRUE(CodeSeg.loadLazyBody());
+    EXPECT_FALSE(LazyValid.validate(**Res));
+  }
+}
+
+TEST(ModuleTest, LoadModuleFlatImage) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x00U, 0x06U, 0x02U, 0x6EU, 0x6DU,               // Custom section "nm"
+      0x01U, 0x02U, 0x03U,                             //   Content
+      0x01U, 0x06U, 0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, // Type section
+      0x7FU,                                           //   (i32) -> i32
+      0x03U, 0x02U, 0x01U, 0x00U,                      // Function section
+      0x05U, 0x03U, 0x01U, 0x00U, 0x01U,               // Memory section
+      0x07U, 0x05U, 0x01U, 0x01U, 0x66U, 0x00U, 0x00U, // Export section
+      0x0AU, 0x17U, 0x01U, 0x15U, 0x00U,               // Code section
+      0x02U, 0x40U, 0x20U, 0x00U,                      //   block, local.get
+      0x0EU, 0x02U, 0x00U, 0x00U, 0x00U, 0x0BU,        //   br_table, end
+      0x41U, 0x01U, 0x41U, 0x02U, 0x20U, 0x00U,        //   i32.const x2
+      0x1CU, 0x01U, 0x7FU, 0x0BU,                      //   select t, end
+      0x0BU, 0x09U, 0x01U, 0x00U, 0x41U, 0x00U, 0x0BU, // Data section
+      0x03U, 0xAAU, 0xBBU, 0xCCU                       //   Data
+  };
+  const std::filesystem::path Path = "moduleTestFlatImage.flat";
+  WasmEdge::Configure FlatConf;
+  WasmEdge::Loader::Loader FlatLdr(FlatConf);
+  auto Res = FlatLdr.parseModule(Vec);
+  ASSERT_TRUE(Res);
+  const auto &Mod = **Res;
+  EXPECT_FALSE(Mod.isValidated());
+
+  // 1. Test only the validated module is saved.
+  EXPECT_FALSE(FlatLdr.saveFlatImage(Mod, Path));
+  EXPECT_FALSE(std::filesystem::exists(Path));
+  WasmEdge::Validator::Validator FlatValid(FlatConf);
+  ASSERT_TRUE(FlatValid.validate(Mod));
+  EXPECT_TRUE(Mod.isValidated());
+
+  // 2. Test the module is the same after saving and loading the flat image.
+  ASSERT_TRUE(FlatLdr.saveFlatImage(Mod, Path));
+  auto ImgRes = FlatLdr.parseFlatImage(Path);
+  ASSERT_TRUE(ImgRes);
+  const auto &Img = **ImgRes;
+  // The image is not trusted and validated again.
+  EXPECT_FALSE(Img.isValidated());
+  EXPECT_TRUE(FlatValid.validate(Img));
+  ASSERT_EQ(Img.getCustomSections().size(), 1U);
+  EXPECT_EQ(Img.getCustomSections()[0].getName(), "nm");
+  EXPECT_FALSE(Img.getCustomSections()[0].isContentLoaded());
+  EXPECT_EQ(Img.getCustomSections()[0].getContentOffset(), 13U);
+  EXPECT_EQ(Img.getCustomSections()[0].getContentLength(), 3U);
+  ASSERT_EQ(Img.getTypeSection().getContent().size(), 1U);
+  EXPECT_EQ(Img.getTypeSection().getContent()[0].getParamTypes(),
+            Mod.getTypeSection().getContent()[0].getParamTypes());
+  ASSERT_EQ(Img.getFunctionSection().getContent().size(), 1U);
+  EXPECT_EQ(Img.getFunctionSection().getContent()[0], 0U);
+  ASSERT_EQ(Img.getMemorySection().getContent().size(), 1U);
+  EXPECT_EQ(Img.getMemorySection().getContent()[0].getLimit().getMin(), 1U);
+  ASSERT_EQ(Img.getExportSection().getContent().size(), 1U);
+  EXPECT_EQ(Img.getExportSection().getContent()[0].getExternalName(), "f");
+  ASSERT_EQ(Img.getCodeSection().getContent().size(), 1U);
+  const auto Instrs =
+      Img.getCodeSection().getContent()[0].getExpr().getInstrs();
+  const auto OrgInstrs =
+      Mod.getCodeSection().getContent()[0].getExpr().getInstrs();
+  ASSERT_EQ(Instrs.size(), OrgInstrs.size());
+  for (size_t I = 0; I < Instrs.size(); ++I) {
+    EXPECT_EQ(Instrs[I].getOpCode(), OrgInstrs[I].getOpCode());
+    EXPECT_EQ(Instrs[I].getOffset(), OrgInstrs[I].getOffset());
+    EXPECT_EQ(Instrs[I].getJumpEnd(), OrgInstrs[I].getJumpEnd());
+  }
+  // The immediates refer to the side table of the loaded image.
+  EXPECT_EQ(Instrs[2].getOpCode(), WasmEdge::OpCode::Br_table);
+  EXPECT_EQ(std::vector<uint32_t>(Instrs[2].getLabelList().begin(),
+                                  Instrs[2].getLabelList().end()),
+            std::vector<uint32_t>(OrgInstrs[2].getLabelList().begin(),
+                                  OrgInstrs[2].getLabelList().end()));
+  EXPECT_NE(Instrs[2].getLabelList().data(),
+            OrgInstrs[2].getLabelList().data());
+  EXPECT_EQ(Instrs[7].getOpCode(), WasmEdge::OpCode::Select_t);
+  ASSERT_EQ(Instrs[7].getValTypeList().size(), 1U);
+  EXPECT_EQ(Instrs[7].getValTypeList()[0], WasmEdge::ValType::I32);
+  ASSERT_EQ(Img.getDataSection().getContent().size(), 1U);
+  EXPECT_EQ(std::vector<uint8_t>(
+                Img.getDataSection().getContent()[0].getData().begin(),
+                Img.getDataSection().getContent()[0].getData().end()),
+            (std::vector<uint8_t>{0xAAU, 0xBBU, 0xCCU}));
+
+  // 3. Test the image is deterministic.
+  {
+    const std::filesystem::path OtherPath = "moduleTestFlatImage2.flat";
+    ASSERT_TRUE(FlatLdr.saveFlatImage(Img, OtherPath));
+    auto ReadFile = [](const std::filesystem::path &P) {
+      std::ifstream Fin(P, std::ios::binary);
+      return std::vector<char>(std::istreambuf_iterator<char>(Fin), {});
+    };
+    EXPECT_EQ(ReadFile(Path), ReadFile(OtherPath));
+    std::filesystem::remove(OtherPath);
+  }
+
+  // 4. Test the image saved with the other proposals is rejected.
+  {
+    WasmEdge::Configure OtherConf;
+    OtherConf.removeProposal(WasmEdge::Proposal::SIMD);
+    WasmEdge::Loader::Loader OtherLdr(OtherConf);
+    EXPECT_FALSE(OtherLdr.parseFlatImage(Path));
+  }
+
+  // 5. Test the truncated image is rejected.
+  ImgRes->reset();
+  const auto Size = std::filesystem::file_size(Path);
+  std::filesystem::resize_file(Path, Size / 2);
+  EXPECT_FALSE(FlatLdr.parseFlatImage(Path));
+  std::filesystem::remove(Path);
+}
+
+TEST(ModuleTest, LoadModuleFusedValidation) {
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x01U, 0x05U, 0x01U, 0x60U, 0x00U, 0x01U, 0x7FU, // Type section
+      0x03U, 0x05U, 0x04U, 0x00U, 0x00U, 0x00U, 0x00U, // Function section
+      0x0AU, 0x1FU, 0x04U,                             // Code section
+      0x04U, 0x00U, 0x41U, 0x01U, 0x0BU,               //   i32.const
+      0x04U, 0x00U, 0x42U, 0x01U, 0x0BU,               //   i64.const
+      0x09U, 0x00U, 0x41U, 0x01U, 0x04U, 0x40U,        //   if
+      0x0BU, 0x41U, 0x02U, 0x0BU,                      //   end, i32.const
+      0x09U, 0x00U, 0x41U, 0x01U, 0x04U, 0x7FU,        //   if (result i32)
+      0x41U, 0x02U, 0x0BU, 0x0BU                       //   i32.const, end
+  };
+  WasmEdge::Configure FusedConf;
+  FusedConf.getLoaderConfigure().setFusedValidation(true);
+  WasmEdge::Loader::Loader FusedLdr(FusedConf);
+  WasmEdge::Validator::Validator FusedValid(FusedConf);
+
+  // 1. Test the valid function bodies are checked while loading, and the
+  // invalid ones are left to the validator.
+  auto Res = FusedLdr.parseModule(Vec);
+  ASSERT_TRUE(Res);
+  const auto &CodeSegs = (*Res)->getCodeSection().getContent();
+  ASSERT_EQ(CodeSegs.size(), 4U);
+  EXPECT_TRUE(CodeSegs[0].isValidated());
+  EXPECT_FALSE(CodeSegs[1].isValidated());
+  EXPECT_TRUE(CodeSegs[2].isValidated());
+  EXPECT_FALSE(CodeSegs[3].isValidated());
+  EXPECT_FALSE(FusedValid.validate(**Res));
+
+  // 2. Test the module of the valid function bodies. Replace the i64.const by
+  // i32.const, and the last body by `i32.const, drop, i32.const, nop, nop`.
+  Vec[32] = 0x41U;
+  const std::vector<uint8_t> Body = {0x1AU, 0x41U, 0x02U, 0x01U, 0x01U};
+  std::copy(Body.begin(), Body.end(), Vec.begin() + 49);
+  Res = FusedLdr.parseModule(Vec);
+  ASSERT_TRUE(Res);
+  for (const auto &CodeSeg : (*Res)->getCodeSection().getContent()) {
+    EXPECT_TRUE(CodeSeg.isValidated());
+  }
+  EXPECT_TRUE(FusedValid.validate(**Res));
+
+  // 3. Test the function bodies are not checked by default.
+  Res = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Res);
+  for (const auto &CodeSeg : (*Res)->getCodeSection().getContent()) {
+    EXPECT_FALSE(CodeSeg.isValidated());
+  }
+}
+
+TEST(ModuleTest, CompiledCodeCache) {
+  using CompiledCode = WasmEdge::AST::Module::CompiledCode;
+  using CodeVec = std::vector<std::shared_ptr<const CompiledCode>>;
+  WasmEdge::AST::Module Mod;
+  std::atomic<uint32_t> Compiles = 0;
+  std::vector<uint32_t> Compiled;
+  auto Compiler = [&Compiles, &Compiled](WasmEdge::Span<const uint32_t> Idxs) {
+    ++Compiles;
+    // Keep the concurrent requests waiting for the compilation.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Compiled.insert(Compiled.end(), Idxs.begin(), Idxs.end());
+    CodeVec Codes;
+    for (const auto Idx : Idxs) {
+      Codes.push_back(Idx == 3 ? nullptr : std::make_shared<CompiledCode>());
+    }
+    return Codes;
+  };
+
+  // 1. Test the concurrent requests compile once and share the code.
+  std::vector<std::shared_ptr<const CompiledCode>> Results(8);
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < Results.size(); ++I) {
+    Threads.emplace_back([&Mod, &Compiler, &Results, I]() {
+      Results[I] = Mod.getCompiledCode(1, Compiler);
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Compiles.load(), 1U);
+  ASSERT_TRUE(Results[0]);
+  for (const auto &Result : Results) {
+    EXPECT_EQ(Result, Results[0]);
+  }
+
+  // 2. Test the copies of the module share the code.
+  const WasmEdge::AST::Module Copy(Mod);
+  EXPECT_EQ(Copy.getCompiledCode(1, Compiler), Results[0]);
+  EXPECT_EQ(Compiles.load(), 1U);
+
+  // 3. Test only the functions not compiled yet are compiled in a batch.
+  Compiled.clear();
+  const std::array<uint32_t, 5> Idxs{2U, 1U, 0U, 2U, 3U};
+  auto Codes = Mod.getCompiledCodes(Idxs, Compiler);
+  EXPECT_EQ(Compiles.load(), 2U);
+  EXPECT_EQ(Compiled, std::vector<uint32_t>({0U, 2U, 3U}));
+  ASSERT_EQ(Codes.size(), Idxs.size());
+  EXPECT_TRUE(Codes[0]);
+  EXPECT_EQ(Codes[1], Results[0]);
+  EXPECT_TRUE(Codes[2]);
+  EXPECT_NE(Codes[0], Codes[2]);
+  EXPECT_EQ(Codes[3], Codes[0]);
+
+  // 4. Test the failed compilation is not retried.
+  EXPECT_FALSE(Codes[4]);
+  EXPECT_FALSE(Copy.getCompiledCode(3, Compiler));
+  EXPECT_EQ(Compiles.load(), 2U);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
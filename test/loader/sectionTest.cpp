@@ -499,6 +499,94 @@ TEST(SectionTest, LoadCodeSection) {
   EXPECT_TRUE(Ldr.parseModule(prefixedVec(Vec)));
 }
 
+TEST(SectionTest, LoadCodeSectionParallel) {
+  // 12. Test load code section in parallel.
+  //
+  //   1.  Load valid code segments.
+  //   2.  Load code segments with an illegal opcode.
+  //   3.  Load code segments with a malformed segment size.
+  //   4.  Load code segments with a mismatched segment size.
+
+  WasmEdge::Configure ParConf;
+  ParConf.getLoaderConfigure().setParallelThreads(4);
+  WasmEdge::Loader::Loader ParLdr(ParConf);
+
+  // Generate 200 functions of `(local i32) i32.const I, drop, end`. The
+  // segment of the function BadIdx is replaced by the raw bytes.
+  auto GenModule = [](uint32_t BadIdx, const std::vector<uint8_t> &Raw) {
+    std::vector<uint8_t> Vec = {
+        0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, // Type section
+        0x03U, 0xCAU, 0x01U, 0xC8U, 0x01U         // Function section
+    };
+    Vec.insert(Vec.end(), 200, 0x00U);
+    std::vector<uint8_t> Content = {0xC8U, 0x01U}; // Vector length = 200
+    for (uint32_t I = 0; I < 200; ++I) {
+      if (I == BadIdx) {
+        Content.insert(Content.end(), Raw.begin(), Raw.end());
+      } else {
+        Content.insert(Content.end(), {0x06U, 0x01U, 0x01U, 0x7FU, 0x41U,
+                                       static_cast<uint8_t>(I & 0x3FU), 0x1AU,
+                                       0x0BU});
+      }
+    }
+    Vec.push_back(0x0AU); // Code section
+    for (uint32_t Size = static_cast<uint32_t>(Content.size()); Size;) {
+      const uint8_t Byte = Size & 0x7FU;
+      Size >>= 7;
+      Vec.push_back(Size ? (Byte | 0x80U) : Byte);
+    }
+    Vec.insert(Vec.end(), Content.begin(), Content.end());
+    return prefixedVec(Vec);
+  };
+  auto ExpectSame = [](const WasmEdge::AST::Module &Seq,
+                       const WasmEdge::AST::Module &Par) {
+    auto SeqSegs = Seq.getCodeSection().getContent();
+    auto ParSegs = Par.getCodeSection().getContent();
+    ASSERT_EQ(ParSegs.size(), SeqSegs.size());
+    for (uint32_t I = 0; I < SeqSegs.size(); ++I) {
+      EXPECT_EQ(ParSegs[I].getSegSize(), SeqSegs[I].getSegSize());
+      EXPECT_EQ(ParSegs[I].getLocals().size(), SeqSegs[I].getLocals().size());
+      auto SeqInstrs = SeqSegs[I].getExpr().getInstrs();
+      auto ParInstrs = ParSegs[I].getExpr().getInstrs();
+      ASSERT_EQ(ParInstrs.size(), SeqInstrs.size());
+      for (uint32_t J = 0; J < SeqInstrs.size(); ++J) {
+        EXPECT_EQ(ParInstrs[J].getOpCode(), SeqInstrs[J].getOpCode());
+        EXPECT_EQ(ParInstrs[J].getOffset(), SeqInstrs[J].getOffset());
+      }
+    }
+  };
+
+  auto Vec = GenModule(UINT32_MAX, {});
+  auto SeqRes = Ldr.parseModule(Vec);
+  auto ParRes = ParLdr.parseModule(Vec);
+  ASSERT_TRUE(SeqRes && ParRes);
+  ASSERT_EQ((*ParRes)->getCodeSection().getContent().size(), 200U);
+  ExpectSame(**SeqRes, **ParRes);
+
+  // Illegal opcode 0xFF in the function 150.
+  Vec = GenModule(150, {0x03U, 0x00U, 0xFFU, 0x0BU});
+  SeqRes = Ldr.parseModule(Vec);
+  ParRes = ParLdr.parseModule(Vec);
+  ASSERT_FALSE(SeqRes);
+  ASSERT_FALSE(ParRes);
+  EXPECT_EQ(ParRes.error(), SeqRes.error());
+
+  // Too long segment size of the function 100.
+  Vec = GenModule(100, {0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x00U});
+  SeqRes = Ldr.parseModule(Vec);
+  ParRes = ParLdr.parseModule(Vec);
+  ASSERT_FALSE(SeqRes);
+  ASSERT_FALSE(ParRes);
+  EXPECT_EQ(ParRes.error(), SeqRes.error());
+
+  // Segment size of the function 50 is less than its body.
+  Vec = GenModule(50, {0x03U, 0x01U, 0x01U, 0x7FU, 0x41U, 0x05U, 0x1AU, 0x0BU});
+  SeqRes = Ldr.parseModule(Vec);
+  ParRes = ParLdr.parseModule(Vec);
+  ASSERT_TRUE(SeqRes && ParRes);
+  ExpectSame(**SeqRes, **ParRes);
+}
+
 TEST(SectionTest, LoadDataSection) {
   std::vector<uint8_t> Vec;
 
@@ -344,6 +344,8 @@ TEST(TypeTest, LoadMemoryType) {
   //   3.  Load limit with only min.
   //   4.  Load invalid limit with fail of loading max.
   //   5.  Load limit with min and max.
+  //   6.  Load shared limit with and without Threads proposal.
+  //   7.  Load 64-bit limit with and without Memory64 proposal.
 
   Vec = {
       0x05U, // Memory section
@@ -388,6 +390,51 @@ TEST(TypeTest, LoadMemoryType) {
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU  // Max = 4294967295
   };
   EXPECT_TRUE(Ldr.parseModule(prefixedVec(Vec)));
+
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  WasmEdge::Loader::Loader LdrThreads(Conf);
+  Conf.removeProposal(WasmEdge::Proposal::Threads);
+
+  Vec = {
+      0x05U, // Memory section
+      0x04U, // Content size = 4
+      0x01U, // Vector length = 1
+      0x03U, // Shared with min and max
+      0x01U, // Min = 1
+      0x02U  // Max = 2
+  };
+  EXPECT_FALSE(Ldr.parseModule(prefixedVec(Vec)));
+  if (auto Mod = LdrThreads.parseModule(prefixedVec(Vec))) {
+    const auto &Lim = (*Mod)->getMemorySection().getContent()[0].getLimit();
+    EXPECT_TRUE(Lim.isShared());
+    EXPECT_TRUE(Lim.hasMax());
+    EXPECT_EQ(Lim.getMax(), 2U);
+  } else {
+    EXPECT_TRUE(false);
+  }
+
+  Conf.addProposal(WasmEdge::Proposal::Memory64);
+  WasmEdge::Loader::Loader LdrMemory64(Conf);
+  Conf.removeProposal(WasmEdge::Proposal::Memory64);
+
+  Vec = {
+      0x05U,                            // Memory section
+      0x08U,                            // Content size = 8
+      0x01U,                            // Vector length = 1
+      0x05U,                            // 64-bit with min and max
+      0x01U,                            // Min = 1
+      0x80U, 0x80U, 0x80U, 0x80U, 0x20U // Max = 8589934592
+  };
+  EXPECT_FALSE(Ldr.parseModule(prefixedVec(Vec)));
+  if (auto Mod = LdrMemory64.parseModule(prefixedVec(Vec))) {
+    const auto &Lim = (*Mod)->getMemorySection().getContent()[0].getLimit();
+    EXPECT_TRUE(Lim.is64());
+    EXPECT_FALSE(Lim.isShared());
+    EXPECT_EQ(Lim.getMin(), 1U);
+    EXPECT_EQ(Lim.getMax(), UINT64_C(8589934592));
+  } else {
+    EXPECT_TRUE(false);
+  }
 }
 
 TEST(TypeTest, LoadGlobalType) {
@@ -2,9 +2,11 @@
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
 #include "common/configure.h"
+#include "common/memorybudget.h"
 #include "runtime/instance/memory.h"
 
 #include <gtest/gtest.h>
+#include <memory>
 
 namespace {
 
@@ -37,6 +39,40 @@ TEST(MemLimitTest, Limit__Pages) {
   ASSERT_TRUE(Inst5.growPage(127));
 }
 
+TEST(MemLimitTest, Budget__Pages) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  using WasmEdge::MemoryBudget;
+  auto Shared = std::make_shared<MemoryBudget>(100);
+  auto Budget1 = std::make_shared<MemoryBudget>(UINT64_MAX, Shared);
+  auto Budget2 = std::make_shared<MemoryBudget>(UINT64_MAX, Shared);
+
+  MemInst Inst1(WasmEdge::AST::MemoryType(60), 65536, Budget1);
+  ASSERT_FALSE(Inst1.getDataPtr() == nullptr);
+  EXPECT_EQ(Shared->getUsage(), 60U);
+  {
+    MemInst Inst2(WasmEdge::AST::MemoryType(50), 65536, Budget2);
+    ASSERT_TRUE(Inst2.getDataPtr() == nullptr);
+    EXPECT_EQ(Shared->getUsage(), 60U);
+    EXPECT_EQ(Budget2->getUsage(), 0U);
+
+    MemInst Inst3(WasmEdge::AST::MemoryType(30), 65536, Budget2);
+    ASSERT_FALSE(Inst3.getDataPtr() == nullptr);
+    ASSERT_FALSE(Inst3.growPage(20));
+    ASSERT_TRUE(Inst3.growPage(10));
+    EXPECT_EQ(Shared->getUsage(), 100U);
+    EXPECT_EQ(Budget2->getUsage(), 40U);
+    ASSERT_FALSE(Inst1.growPage(1));
+
+    Shared->setLimit(120);
+    ASSERT_TRUE(Inst1.growPage(20));
+    EXPECT_EQ(Budget1->getUsage(), 80U);
+  }
+  EXPECT_EQ(Shared->getUsage(), 80U);
+  EXPECT_EQ(Shared->getPeak(), 120U);
+  EXPECT_EQ(Budget2->getUsage(), 0U);
+  EXPECT_EQ(Budget2->getPeak(), 40U);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
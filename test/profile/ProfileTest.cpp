@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/profile.h"
+#include "vm/vm.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+using Count = std::pair<uint64_t, uint64_t>;
+
+// (func (export "f") (param i32) (result i32)
+//   (if (result i32) (local.get 0) (then (i32.const 1)) (else (i32.const 0))))
+const std::array<WasmEdge::Byte, 43> Wasm{
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, 0x01U, 0x06U,
+    0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, 0x03U, 0x02U, 0x01U, 0x00U,
+    0x07U, 0x05U, 0x01U, 0x01U, 0x66U, 0x00U, 0x00U, 0x0AU, 0x0EU, 0x01U,
+    0x0CU, 0x00U, 0x20U, 0x00U, 0x04U, 0x7FU, 0x41U, 0x01U, 0x05U, 0x41U,
+    0x00U, 0x0BU, 0x0BU};
+// Offsets of the first instruction and the `if` instruction.
+constexpr uint32_t EntryOffset = 32;
+constexpr uint32_t IfOffset = 34;
+
+// The same module exporting the function as "g", so the offsets are the same
+// in the two binaries.
+std::array<WasmEdge::Byte, 43> makeOtherWasm() {
+  auto Other = Wasm;
+  Other[24] = 0x67U;
+  return Other;
+}
+
+void executeF(WasmEdge::VM::VM &VM, std::string_view ModName,
+              std::string_view FuncName, std::initializer_list<uint32_t> Args) {
+  for (const uint32_t Arg : Args) {
+    const std::array<WasmEdge::ValVariant, 1> Params{Arg};
+    const std::array<WasmEdge::ValType, 1> Types{WasmEdge::ValType::I32};
+    auto Res = ModName.empty() ? VM.execute(FuncName, Params, Types)
+                               : VM.execute(ModName, FuncName, Params, Types);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), Arg);
+  }
+}
+
+TEST(ProfileTest, Collect__Interpreter) {
+  auto Prof = std::make_shared<WasmEdge::Profile>();
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setProfile(Prof);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  executeF(VM, {}, "f"sv, {1U, 1U, 0U});
+
+  const uint64_t Hash = WasmEdge::Profile::hashModule(Wasm);
+  EXPECT_TRUE(Prof->hasModule(Hash));
+  EXPECT_EQ(Prof->getEntryCount(Hash, EntryOffset), 3U);
+  EXPECT_EQ(Prof->getBranchCount(Hash, IfOffset), Count(2, 1));
+  EXPECT_EQ(Prof->getBranchCount(Hash, EntryOffset), Count(0, 0));
+}
+
+TEST(ProfileTest, Collect__SharedByModules) {
+  // The modules sharing a profile count at the same offsets separately.
+  const auto Other = makeOtherWasm();
+  auto Prof = std::make_shared<WasmEdge::Profile>();
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setProfile(Prof);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule("other"sv, Other));
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  executeF(VM, {}, "f"sv, {1U, 1U, 0U});
+  executeF(VM, "other"sv, "g"sv, {0U});
+
+  const uint64_t Hash = WasmEdge::Profile::hashModule(Wasm);
+  const uint64_t OtherHash = WasmEdge::Profile::hashModule(Other);
+  ASSERT_NE(Hash, OtherHash);
+  EXPECT_EQ(Prof->getEntryCount(Hash, EntryOffset), 3U);
+  EXPECT_EQ(Prof->getBranchCount(Hash, IfOffset), Count(2, 1));
+  EXPECT_EQ(Prof->getEntryCount(OtherHash, EntryOffset), 1U);
+  EXPECT_EQ(Prof->getBranchCount(OtherHash, IfOffset), Count(0, 1));
+  EXPECT_FALSE(Prof->hasModule(Hash ^ OtherHash));
+}
+
+TEST(ProfileTest, SaveLoad__Merge) {
+  const uint64_t Hash = WasmEdge::Profile::hashModule(Wasm);
+  const uint64_t OtherHash = WasmEdge::Profile::hashModule(makeOtherWasm());
+  WasmEdge::Profile Prof;
+  EXPECT_TRUE(Prof.empty());
+  Prof.addEntry(Hash, EntryOffset);
+  Prof.addBranch(Hash, IfOffset, true);
+  Prof.addBranch(Hash, IfOffset, false);
+  Prof.addBranch(Hash, IfOffset, false);
+  Prof.addEntry(OtherHash, EntryOffset);
+
+  const auto Path =
+      std::filesystem::temp_directory_path() / "wasmedgeProfileTest.profile";
+  ASSERT_TRUE(Prof.save(Path));
+  WasmEdge::Profile Merged;
+  ASSERT_TRUE(Merged.load(Path));
+  ASSERT_TRUE(Merged.load(Path));
+  EXPECT_EQ(Merged.getEntryCount(Hash, EntryOffset), 2U);
+  EXPECT_EQ(Merged.getBranchCount(Hash, IfOffset), Count(2, 4));
+  EXPECT_EQ(Merged.getEntryCount(OtherHash, EntryOffset), 2U);
+  EXPECT_EQ(Merged.getBranchCount(OtherHash, IfOffset), Count(0, 0));
+
+  // The malformed files keep the counters unchanged.
+  {
+    std::ofstream Fout(Path, std::ios::out | std::ios::trunc);
+    Fout << "wasmedge-profile 2\nm 1\ne 32 1\nx 34\n";
+  }
+  EXPECT_FALSE(Merged.load(Path));
+  EXPECT_EQ(Merged.getEntryCount(Hash, EntryOffset), 2U);
+  EXPECT_FALSE(Merged.hasModule(1));
+  {
+    // The counters without the module hash.
+    std::ofstream Fout(Path, std::ios::out | std::ios::trunc);
+    Fout << "wasmedge-profile 2\ne 32 1\n";
+  }
+  EXPECT_FALSE(Merged.load(Path));
+  {
+    // The profiles of the version 1 are not keyed by the modules.
+    std::ofstream Fout(Path, std::ios::out | std::ios::trunc);
+    Fout << "wasmedge-profile 1\ne 32 1\n";
+  }
+  EXPECT_FALSE(Merged.load(Path));
+  std::filesystem::remove(Path);
+  EXPECT_FALSE(Merged.load(Path));
+
+  Merged.clear();
+  EXPECT_TRUE(Merged.empty());
+}
+
+TEST(ProfileTest, Collect__Threads) {
+  // The threads count to their own shards, which are merged when read.
+  WasmEdge::Profile Prof;
+  const uint64_t Hash = WasmEdge::Profile::hashModule(Wasm);
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Threads.emplace_back([&Prof, Hash]() {
+      for (uint32_t J = 0; J < 1000; ++J) {
+        Prof.addEntry(Hash, EntryOffset);
+        Prof.addBranch(Hash, IfOffset, J % 2 == 0);
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Prof.getEntryCount(Hash, EntryOffset), 4000U);
+  EXPECT_EQ(Prof.getBranchCount(Hash, IfOffset), Count(2000U, 2000U));
+
+  // The counters of a thread outlive it, and a new profile at the same
+  // address does not see them.
+  Prof.clear();
+  EXPECT_TRUE(Prof.empty());
+  Prof.addEntry(Hash, EntryOffset);
+  EXPECT_EQ(Prof.getEntryCount(Hash, EntryOffset), 1U);
+  {
+    auto Other = std::make_unique<WasmEdge::Profile>();
+    Other->addEntry(Hash, EntryOffset);
+    EXPECT_EQ(Other->getEntryCount(Hash, EntryOffset), 1U);
+  }
+  auto Next = std::make_unique<WasmEdge::Profile>();
+  EXPECT_TRUE(Next->empty());
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -22,8 +22,11 @@
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -162,6 +165,85 @@ std::array<uint64_t, 4> Answers{
     UINT64_C(9019442596657776185),
 };
 
+/// Run the mt19937 with a VM per thread, since an executor is bound to the
+/// thread creating it, and only one executor can be alive on a thread. All
+/// VMs are set up before calling Ready, and run after it.
+void runMT19937OnThreads(
+    const WasmEdge::Configure &Conf,
+    const std::function<void(WasmEdge::VM::VM &, uint64_t)> &Setup,
+    const std::function<void()> &Ready) {
+  std::array<std::promise<void>, 4> SetupDone;
+  std::promise<void> Go;
+  const std::shared_future<void> GoFuture = Go.get_future().share();
+  std::array<std::thread, 4> Threads;
+  for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+    Threads[Index] = std::thread([&, Index]() {
+      WasmEdge::VM::VM VM(Conf);
+      Setup(VM, Index);
+      SetupDone[Index].set_value();
+      GoFuture.wait();
+      auto Result = VM.execute(
+          "mt19937",
+          std::array<const WasmEdge::ValVariant, 3>{
+              UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000) + Index},
+          std::array<const WasmEdge::ValType, 3>{WasmEdge::ValType::I32,
+                                                 WasmEdge::ValType::I64,
+                                                 WasmEdge::ValType::I64});
+      ASSERT_TRUE(Result);
+      ASSERT_EQ((*Result)[0].second, WasmEdge::ValType::I64);
+      EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[Index]);
+    });
+  }
+  for (auto &Done : SetupDone) {
+    Done.get_future().wait();
+  }
+  Ready();
+  Go.set_value();
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+// Module with a shared memory:
+// (module
+//   (memory (export "memory") 1 1 shared)
+//   (func (export "add") (param $n i32) (result i32)
+//     (loop $l
+//       (drop (i32.atomic.rmw.add (i32.const 0) (i32.const 1)))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (i32.atomic.load (i32.const 0)))
+//   (func (export "wait") (param $addr i32) (param $timeout i64) (result i32)
+//     (memory.atomic.wait32 (local.get $addr) (i32.const 0)
+//                           (local.get $timeout)))
+//   (func (export "notify") (param $addr i32) (result i32)
+//     (memory.atomic.notify (local.get $addr) (i32.const 1)))
+//   (func (export "load") (param $addr i32) (result i32)
+//     (i32.atomic.load (local.get $addr))))
+std::array<WasmEdge::Byte, 142> SharedMemoryAtomics{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7e, 0x01, 0x7f, 0x03, 0x05,
+    0x04, 0x00, 0x01, 0x00, 0x00, 0x05, 0x04, 0x01, 0x03, 0x01, 0x01, 0x07,
+    0x27, 0x05, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00, 0x03,
+    0x61, 0x64, 0x64, 0x00, 0x00, 0x04, 0x77, 0x61, 0x69, 0x74, 0x00, 0x01,
+    0x06, 0x6e, 0x6f, 0x74, 0x69, 0x66, 0x79, 0x00, 0x02, 0x04, 0x6c, 0x6f,
+    0x61, 0x64, 0x00, 0x03, 0x0a, 0x40, 0x04, 0x1d, 0x00, 0x03, 0x40, 0x41,
+    0x00, 0x41, 0x01, 0xfe, 0x1e, 0x02, 0x00, 0x1a, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x41, 0x00, 0xfe, 0x10, 0x02, 0x00,
+    0x0b, 0x0c, 0x00, 0x20, 0x00, 0x41, 0x00, 0x20, 0x01, 0xfe, 0x01, 0x02,
+    0x00, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x41, 0x01, 0xfe, 0x00, 0x02, 0x00,
+    0x0b, 0x08, 0x00, 0x20, 0x00, 0xfe, 0x10, 0x02, 0x00, 0x0b,
+};
+
+// (module
+//   (func (export "ok") (result i32) (i32.const 42))
+//   (func (export "bad") (result i32) (i64.const 1)))
+std::array<WasmEdge::Byte, 47> LazyInvalidBody{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x00, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x0c, 0x02, 0x02,
+    0x6f, 0x6b, 0x00, 0x00, 0x03, 0x62, 0x61, 0x64, 0x00, 0x01, 0x0a, 0x0b,
+    0x02, 0x04, 0x00, 0x41, 0x2a, 0x0b, 0x04, 0x00, 0x42, 0x01, 0x0b,
+};
+
 using namespace std::literals;
 
 TEST(AsyncExecute, ThreadTest) {
@@ -225,6 +307,217 @@ TEST(AsyncExecute, GasThreadTest) {
   }
 }
 
+TEST(AsyncExecute, SharedModuleThreadTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Loader(Conf);
+  auto Res = Loader.parseModule(MersenneTwister19937);
+  ASSERT_TRUE(Res);
+  std::shared_ptr<const WasmEdge::AST::Module> Mod = std::move(*Res);
+
+  std::array<const WasmEdge::AST::Instruction *, 4> Instrs{};
+  runMT19937OnThreads(
+      Conf,
+      [&Mod, &Instrs](WasmEdge::VM::VM &VM, uint64_t Index) {
+        ASSERT_TRUE(VM.loadWasm(Mod));
+        ASSERT_TRUE(VM.validate());
+        ASSERT_TRUE(VM.instantiate());
+        auto &StoreMgr = VM.getStoreManager();
+        auto *ModInst = *StoreMgr.getActiveModule();
+        auto *FuncInst = *StoreMgr.getFunction(*ModInst->getFuncAddr(0));
+        Instrs[Index] = FuncInst->getInstrs().data();
+      },
+      [&Mod, &Instrs]() {
+        // The function instances of all VMs borrow the same instructions.
+        for (const auto *Instr : Instrs) {
+          EXPECT_EQ(Instr, Instrs[0]);
+        }
+        // The instantiated functions keep the module alive.
+        Mod.reset();
+      });
+}
+
+TEST(AsyncExecute, LazyFunctionBodyThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.getLoaderConfigure().setLazyFunctionBody(true);
+  WasmEdge::Loader::Loader Loader(Conf);
+  auto Res = Loader.parseModule(MersenneTwister19937);
+  ASSERT_TRUE(Res);
+  std::shared_ptr<const WasmEdge::AST::Module> Mod = std::move(*Res);
+
+  // The function body is decoded once by the first caller of all VMs.
+  runMT19937OnThreads(
+      Conf,
+      [&Mod](WasmEdge::VM::VM &VM, uint64_t) {
+        ASSERT_TRUE(VM.loadWasm(Mod));
+        ASSERT_TRUE(VM.validate());
+        ASSERT_TRUE(VM.instantiate());
+      },
+      [&Mod]() { Mod.reset(); });
+}
+
+TEST(AsyncExecute, LazyInvalidBodyTest) {
+  WasmEdge::Configure Conf;
+  Conf.getLoaderConfigure().setLazyFunctionBody(true);
+  {
+    WasmEdge::VM::VM VM(Conf);
+    // The invalid function body is not checked before the first call.
+    ASSERT_TRUE(VM.loadWasm(LazyInvalidBody));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    auto Result = VM.execute("ok");
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), UINT32_C(42));
+    for (int I = 0; I < 2; ++I) {
+      Result = VM.execute("bad");
+      ASSERT_FALSE(Result);
+      EXPECT_EQ(Result.error(), WasmEdge::ErrCode::TypeCheckFailed);
+    }
+  }
+
+  // The invalid function body is rejected in the eager mode.
+  {
+    Conf.getLoaderConfigure().setLazyFunctionBody(false);
+    WasmEdge::VM::VM EagerVM(Conf);
+    ASSERT_TRUE(EagerVM.loadWasm(LazyInvalidBody));
+    EXPECT_FALSE(EagerVM.validate());
+  }
+}
+
+TEST(AsyncExecute, AtomicRMWThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(SharedMemoryAtomics));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  {
+    std::array<WasmEdge::VM::Async<WasmEdge::Expect<std::vector<
+                   std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>>,
+               4>
+        AsyncResults;
+    for (auto &Result : AsyncResults) {
+      Result = VM.asyncExecute(
+          "add", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(10000)},
+          std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32});
+    }
+    for (auto &AsyncResult : AsyncResults) {
+      ASSERT_TRUE(AsyncResult.get());
+    }
+  }
+  auto Result = VM.execute(
+      "load", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(0)},
+      std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), UINT32_C(40000));
+
+  // Unaligned atomic access traps.
+  Result = VM.execute(
+      "load", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(1)},
+      std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32});
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::UnalignedAtomicAccess);
+}
+
+TEST(AsyncExecute, AtomicWaitNotifyThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(SharedMemoryAtomics));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  // Timed out.
+  auto Result = VM.execute(
+      "wait",
+      std::array<const WasmEdge::ValVariant, 2>{UINT32_C(4), INT64_C(1000)},
+      std::array<const WasmEdge::ValType, 2>{WasmEdge::ValType::I32,
+                                             WasmEdge::ValType::I64});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), UINT32_C(2));
+
+  // Woken by notify.
+  auto AsyncResult = VM.asyncExecute(
+      "wait",
+      std::array<const WasmEdge::ValVariant, 2>{UINT32_C(4), INT64_C(-1)},
+      std::array<const WasmEdge::ValType, 2>{WasmEdge::ValType::I32,
+                                             WasmEdge::ValType::I64});
+  uint32_t Woken = 0;
+  while (Woken == 0) {
+    std::this_thread::sleep_for(1ms);
+    auto Notify = VM.execute(
+        "notify", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(4)},
+        std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32});
+    ASSERT_TRUE(Notify);
+    Woken = (*Notify)[0].first.get<uint32_t>();
+  }
+  EXPECT_EQ(Woken, UINT32_C(1));
+  auto WaitResult = AsyncResult.get();
+  ASSERT_TRUE(WaitResult);
+  EXPECT_EQ((*WaitResult)[0].first.get<uint32_t>(), UINT32_C(0));
+
+  // Not equal to the expected value.
+  ASSERT_TRUE(VM.execute(
+      "add", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(1)},
+      std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32}));
+  Result = VM.execute(
+      "wait",
+      std::array<const WasmEdge::ValVariant, 2>{UINT32_C(0), INT64_C(-1)},
+      std::array<const WasmEdge::ValType, 2>{WasmEdge::ValType::I32,
+                                             WasmEdge::ValType::I64});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), UINT32_C(1));
+}
+
+TEST(AsyncExecute, AtomicWaitNotifyOrderThreadTest) {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(SharedMemoryAtomics));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto Wait = [&VM](int64_t Timeout) {
+    return VM.asyncExecute(
+        "wait",
+        std::array<const WasmEdge::ValVariant, 2>{UINT32_C(4), Timeout},
+        std::array<const WasmEdge::ValType, 2>{WasmEdge::ValType::I32,
+                                               WasmEdge::ValType::I64});
+  };
+  auto Notify = [&VM]() {
+    auto Result = VM.execute(
+        "notify", std::array<const WasmEdge::ValVariant, 1>{UINT32_C(4)},
+        std::array<const WasmEdge::ValType, 1>{WasmEdge::ValType::I32});
+    EXPECT_TRUE(Result);
+    return Result ? (*Result)[0].first.get<uint32_t>() : UINT32_C(0);
+  };
+
+  // The timeout beyond the range of the clock waits until notified.
+  auto Long = Wait(INT64_MAX);
+  uint32_t Woken = 0;
+  for (uint32_t I = 0; I < 10000 && Woken == 0; ++I) {
+    std::this_thread::sleep_for(1ms);
+    Woken = Notify();
+  }
+  EXPECT_EQ(Woken, UINT32_C(1));
+  auto LongResult = Long.get();
+  ASSERT_TRUE(LongResult);
+  EXPECT_EQ((*LongResult)[0].first.get<uint32_t>(), UINT32_C(0));
+
+  // The waiters are woken in the order of their waiting.
+  auto First = Wait(-1);
+  std::this_thread::sleep_for(100ms);
+  auto Second = Wait(-1);
+  std::this_thread::sleep_for(100ms);
+  EXPECT_EQ(Notify(), UINT32_C(1));
+  EXPECT_TRUE(First.waitFor(10s));
+  EXPECT_FALSE(Second.waitFor(100ms));
+  EXPECT_EQ(Notify(), UINT32_C(1));
+  auto FirstResult = First.get();
+  auto SecondResult = Second.get();
+  ASSERT_TRUE(FirstResult && SecondResult);
+  EXPECT_EQ((*FirstResult)[0].first.get<uint32_t>(), UINT32_C(0));
+  EXPECT_EQ((*SecondResult)[0].first.get<uint32_t>(), UINT32_C(0));
+}
+
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
 
 #if WASMEDGE_OS_LINUX
@@ -4,10 +4,12 @@
 #include "aot/compiler.h"
 #include "common/configure.h"
 #include "common/filesystem.h"
+#include "common/profile.h"
 #include "common/version.h"
 #include "loader/loader.h"
 #include "po/argument_parser.h"
 #include "validator/validator.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -32,12 +34,30 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> ConfGenericBinary(
       PO::Description("Generate a generic binary"sv));
 
+  PO::List<std::string> ConfCPULevel(
+      PO::Description(
+          "Add a code variant of the CPU level into the universal Wasm output, which is selected by the running CPU. Values: baseline, v2, v3, v4 for the x86-64 microarchitecture levels. The levels specified several times are all added."sv),
+      PO::MetaVar("LEVEL"sv));
+
   PO::Option<PO::Toggle> ConfDumpIR(
       PO::Description("Dump LLVM IR to `wasm.ll` and `wasm-opt.ll`."sv));
 
   PO::Option<PO::Toggle> ConfInterruptible(
       PO::Description("Generate a interruptible binary"sv));
 
+  PO::Option<PO::Toggle> ConfIncremental(PO::Description(
+      "Cache the object codes of the module partitions, and reuse the unchanged ones in the next compilation"sv));
+
+  PO::Option<uint64_t> ConfJobs(
+      PO::Description(
+          "Number of threads to optimize and generate codes, default value is 1"sv),
+      PO::MetaVar("JOBS"sv), PO::DefaultValue<uint64_t>(1));
+
+  PO::List<std::string> ConfProfile(
+      PO::Description(
+          "Optimize with the profile saved by `wasmedge --profile-output`. The profiles specified several times are merged."sv),
+      PO::MetaVar("PROFILE"sv));
+
   PO::Option<PO::Toggle> ConfEnableInstructionCounting(PO::Description(
       "Enable generating code for counting Wasm instructions executed."sv));
   PO::Option<PO::Toggle> ConfEnableGasMeasuring(PO::Description(
@@ -62,6 +82,10 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> PropSIMD(PO::Description("Disable SIMD proposal"sv));
   PO::Option<PO::Toggle> PropMultiMem(
       PO::Description("Enable Multiple memories proposal"sv));
+  PO::Option<PO::Toggle> PropThreads(
+      PO::Description("Enable Threads proposal"sv));
+  PO::Option<PO::Toggle> PropMemory64(
+      PO::Description("Enable Memory64 proposal"sv));
   PO::Option<PO::Toggle> PropAll(PO::Description("Enable all features"sv));
 
   auto Parser = PO::ArgumentParser();
@@ -69,12 +93,16 @@ int main(int Argc, const char *Argv[]) {
            .add_option(SoName)
            .add_option("dump"sv, ConfDumpIR)
            .add_option("interruptible"sv, ConfInterruptible)
+           .add_option("jobs"sv, ConfJobs)
+           .add_option("incremental"sv, ConfIncremental)
+           .add_option("profile"sv, ConfProfile)
            .add_option("enable-instruction-count"sv,
                        ConfEnableInstructionCounting)
            .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
            .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
            .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
            .add_option("generic-binary"sv, ConfGenericBinary)
+           .add_option("cpu-level"sv, ConfCPULevel)
            .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
            .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
            .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -83,6 +111,8 @@ int main(int Argc, const char *Argv[]) {
            .add_option("disable-reference-types"sv, PropRefTypes)
            .add_option("disable-simd"sv, PropSIMD)
            .add_option("enable-multi-memory"sv, PropMultiMem)
+           .add_option("enable-threads"sv, PropThreads)
+           .add_option("enable-memory64"sv, PropMemory64)
            .add_option("enable-all"sv, PropAll)
            .parse(Argc, Argv)) {
     return EXIT_FAILURE;
@@ -117,8 +147,16 @@ int main(int Argc, const char *Argv[]) {
   if (PropMultiMem.value()) {
     Conf.addProposal(WasmEdge::Proposal::MultiMemories);
   }
+  if (PropThreads.value()) {
+    Conf.addProposal(WasmEdge::Proposal::Threads);
+  }
+  if (PropMemory64.value()) {
+    Conf.addProposal(WasmEdge::Proposal::Memory64);
+  }
   if (PropAll.value()) {
     Conf.addProposal(WasmEdge::Proposal::MultiMemories);
+    Conf.addProposal(WasmEdge::Proposal::Threads);
+    Conf.addProposal(WasmEdge::Proposal::Memory64);
   }
 
   std::filesystem::path InputPath = std::filesystem::absolute(WasmName.value());
@@ -159,6 +197,22 @@ int main(int Argc, const char *Argv[]) {
     if (ConfInterruptible.value()) {
       Conf.getCompilerConfigure().setInterruptible(true);
     }
+    Conf.getCompilerConfigure().setParallelThreads(static_cast<uint32_t>(
+        std::min<uint64_t>(ConfJobs.value(), UINT32_MAX)));
+    if (ConfIncremental.value()) {
+      Conf.getCompilerConfigure().setIncrementalCache(true);
+    }
+    if (ConfProfile.value().size() > 0) {
+      auto Prof = std::make_shared<WasmEdge::Profile>();
+      for (const auto &Path : ConfProfile.value()) {
+        if (auto Res = Prof->load(Path); !Res) {
+          const auto Err = static_cast<uint32_t>(Res.error());
+          spdlog::error("Load profile failed. Error code: {}", Err);
+          return EXIT_FAILURE;
+        }
+      }
+      Conf.getCompilerConfigure().setProfile(std::move(Prof));
+    }
     if (ConfEnableAllStatistics.value()) {
       Conf.getStatisticsConfigure().setInstructionCounting(true);
       Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -177,6 +231,21 @@ int main(int Argc, const char *Argv[]) {
     if (ConfGenericBinary.value()) {
       Conf.getCompilerConfigure().setGenericBinary(true);
     }
+    for (const auto &Level : ConfCPULevel.value()) {
+      using CPULevel = WasmEdge::CompilerConfigure::CPULevel;
+      if (Level == "baseline"sv) {
+        Conf.getCompilerConfigure().addCPULevel(CPULevel::Baseline);
+      } else if (Level == "v2"sv) {
+        Conf.getCompilerConfigure().addCPULevel(CPULevel::V2);
+      } else if (Level == "v3"sv) {
+        Conf.getCompilerConfigure().addCPULevel(CPULevel::V3);
+      } else if (Level == "v4"sv) {
+        Conf.getCompilerConfigure().addCPULevel(CPULevel::V4);
+      } else {
+        spdlog::error("Unknown CPU level: {}", Level);
+        return EXIT_FAILURE;
+      }
+    }
     if (OutputPath.extension().u8string() == ".so"sv) {
       Conf.getCompilerConfigure().setOutputFormat(
           WasmEdge::CompilerConfigure::OutputFormat::Native);
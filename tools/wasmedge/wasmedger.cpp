@@ -3,6 +3,7 @@
 
 #include "common/configure.h"
 #include "common/filesystem.h"
+#include "common/profile.h"
 #include "common/types.h"
 #include "common/version.h"
 #include "host/wasi/wasimodule.h"
@@ -14,6 +15,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -62,6 +64,10 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> PropSIMD(PO::Description("Disable SIMD proposal"sv));
   PO::Option<PO::Toggle> PropMultiMem(
       PO::Description("Enable Multiple memories proposal"sv));
+  PO::Option<PO::Toggle> PropThreads(
+      PO::Description("Enable Threads proposal"sv));
+  PO::Option<PO::Toggle> PropMemory64(
+      PO::Description("Enable Memory64 proposal"sv));
   PO::Option<PO::Toggle> PropAll(PO::Description("Enable all features"sv));
 
   PO::Option<PO::Toggle> ConfEnableInstructionCounting(PO::Description(
@@ -73,6 +79,22 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> ConfEnableAllStatistics(PO::Description(
       "Enable generating code for all statistics options include instruction counting, gas measuring, and execution time"sv));
 
+  PO::Option<PO::Toggle> ConfEnableJIT(PO::Description(
+      "Enable compiling the Wasm module into the native code in process before execution."sv));
+
+  PO::Option<PO::Toggle> ConfEnableLazyJIT(PO::Description(
+      "Enable compiling each Wasm function into the native code in process at its first call."sv));
+
+  PO::List<int> TieredThreshold(
+      PO::Description(
+          "Interpret the Wasm functions first, and compile them into the native code in background after the count of calls and loop iterations."sv),
+      PO::MetaVar("COUNT"sv));
+
+  PO::List<std::string> ProfileOut(
+      PO::Description(
+          "Count the function entries and the branches of the interpreted functions, and save them to the file for `wasmedgec --profile`."sv),
+      PO::MetaVar("PROFILE"sv));
+
   PO::Option<uint64_t> TimeLim(
       PO::Description(
           "Limitation of maximum time(in milliseconds) for execution, default value is 0 for no limitations"sv),
@@ -106,6 +128,10 @@ int main(int Argc, const char *Argv[]) {
            .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
            .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
            .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
+           .add_option("enable-jit"sv, ConfEnableJIT)
+           .add_option("enable-lazy-jit"sv, ConfEnableLazyJIT)
+           .add_option("tiered-threshold"sv, TieredThreshold)
+           .add_option("profile-output"sv, ProfileOut)
            .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
            .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
            .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -114,6 +140,8 @@ int main(int Argc, const char *Argv[]) {
            .add_option("disable-reference-types"sv, PropRefTypes)
            .add_option("disable-simd"sv, PropSIMD)
            .add_option("enable-multi-memory"sv, PropMultiMem)
+           .add_option("enable-threads"sv, PropThreads)
+           .add_option("enable-memory64"sv, PropMemory64)
            .add_option("enable-all"sv, PropAll)
            .add_option("time-limit"sv, TimeLim)
            .add_option("gas-limit"sv, GasLim)
@@ -153,8 +181,16 @@ int main(int Argc, const char *Argv[]) {
   if (PropMultiMem.value()) {
     Conf.addProposal(WasmEdge::Proposal::MultiMemories);
   }
+  if (PropThreads.value()) {
+    Conf.addProposal(WasmEdge::Proposal::Threads);
+  }
+  if (PropMemory64.value()) {
+    Conf.addProposal(WasmEdge::Proposal::Memory64);
+  }
   if (PropAll.value()) {
     Conf.addProposal(WasmEdge::Proposal::MultiMemories);
+    Conf.addProposal(WasmEdge::Proposal::Threads);
+    Conf.addProposal(WasmEdge::Proposal::Memory64);
   }
 
   std::optional<std::chrono::system_clock::time_point> Timeout;
@@ -171,6 +207,16 @@ int main(int Argc, const char *Argv[]) {
     Conf.getRuntimeConfigure().setMaxMemoryPage(
         static_cast<uint32_t>(MemLim.value().back()));
   }
+  if (ConfEnableJIT.value()) {
+    Conf.getRuntimeConfigure().setJIT(true);
+  }
+  if (ConfEnableLazyJIT.value()) {
+    Conf.getRuntimeConfigure().setLazyJIT(true);
+  }
+  if (TieredThreshold.value().size() > 0) {
+    Conf.getRuntimeConfigure().setTieredThreshold(
+        static_cast<uint32_t>(TieredThreshold.value().back()));
+  }
   if (ConfEnableAllStatistics.value()) {
     Conf.getStatisticsConfigure().setInstructionCounting(true);
     Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -186,6 +232,16 @@ int main(int Argc, const char *Argv[]) {
       Conf.getStatisticsConfigure().setTimeMeasuring(true);
     }
   }
+  std::shared_ptr<WasmEdge::Profile> Prof;
+  if (ProfileOut.value().size() > 0) {
+    Prof = std::make_shared<WasmEdge::Profile>();
+    Conf.getStatisticsConfigure().setProfile(Prof);
+  }
+  auto SaveProfile = [&Prof, &ProfileOut]() {
+    if (Prof && !Prof->save(ProfileOut.value().back())) {
+      spdlog::error("Save profile failed.");
+    }
+  };
 
   Conf.addHostRegistration(WasmEdge::HostRegistration::Wasi);
   Conf.addHostRegistration(WasmEdge::HostRegistration::WasmEdge_Process);
@@ -221,8 +277,9 @@ int main(int Argc, const char *Argv[]) {
         AsyncResult.cancel();
       }
     }
-    if (auto Result = AsyncResult.get();
-        Result || Result.error() == WasmEdge::ErrCode::Terminated) {
+    auto Result = AsyncResult.get();
+    SaveProfile();
+    if (Result || Result.error() == WasmEdge::ErrCode::Terminated) {
       return static_cast<int>(WasiMod->getEnv().getExitCode());
     } else {
       return EXIT_FAILURE;
@@ -324,7 +381,9 @@ int main(int Argc, const char *Argv[]) {
         AsyncResult.cancel();
       }
     }
-    if (auto Result = AsyncResult.get()) {
+    auto Result = AsyncResult.get();
+    SaveProfile();
+    if (Result) {
       /// Print results.
       for (size_t I = 0; I < Result->size(); ++I) {
         switch ((*Result)[I].second) {